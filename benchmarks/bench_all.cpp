@@ -0,0 +1,686 @@
+/**
+ * @file bench_all.cpp
+ */
+
+#include <algorithm>     // for std::sort
+#include <chrono>        // for std::chrono
+#include <cstddef>       // for std::size_t
+#include <cstdint>       // for std::int64_t, std::uint64_t, std::uintmax_t
+#include <cstdio>        // for std::FILE, std::tmpfile, std::fclose, std::fflush
+#include <cstdlib>       // for EXIT_FAILURE, EXIT_SUCCESS
+#include <exception>     // for std::exception
+#include <filesystem>    // for std::filesystem
+#include <fstream>       // for std::ofstream
+#include <functional>    // for std::function
+#include <iostream>      // for std::cout
+#include <iterator>      // for std::back_inserter
+#include <numeric>       // for std::accumulate
+#include <stdexcept>     // for std::runtime_error
+#include <string>        // for std::string, std::stoul
+#include <string_view>   // for std::string_view
+#include <system_error>  // for std::error_code
+#include <utility>       // for std::move, std::pair
+#include <vector>        // for std::vector
+
+#include <fmt/core.h>
+#include <fmt/format.h>
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN  // Exclude rarely-used stuff from Windows headers
+#include <windows.h>         // for SetConsoleCP, SetConsoleOutputCP, CP_UTF8
+#endif
+
+#include "app.hpp"
+#include "core/args.hpp"
+#include "core/backup.hpp"
+#include "core/escape.hpp"
+#include "core/io.hpp"
+#include "core/render.hpp"
+#include "core/search.hpp"
+#include "core/simd.hpp"
+#include "core/snapshot.hpp"
+#include "core/store.hpp"
+#include "modules/disk.hpp"
+#include "modules/web.hpp"
+#include "version.hpp"
+
+namespace {
+
+/**
+ * @brief Class that represents a deterministic pseudo-random number generator (SplitMix64).
+ *
+ * The standard distributions are implementation-defined, so they would generate different tables on different platforms, which would make results incomparable.
+ *
+ * @note This class is marked as `final` to prevent inheritance.
+ */
+class Random final {
+  public:
+    /**
+     * @brief Construct a new Random object.
+     *
+     * @param seed Initial state (e.g., "42").
+     */
+    explicit Random(const std::uint64_t seed)
+        : state_(seed) {}
+
+    /**
+     * @brief Get the next pseudo-random number.
+     *
+     * @return Uniformly distributed 64-bit number.
+     */
+    [[nodiscard]] std::uint64_t next()
+    {
+        std::uint64_t z = (this->state_ += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    /**
+     * @brief Get a pseudo-random number below a bound.
+     *
+     * @param bound Exclusive upper bound (e.g., "10"). Must be greater than zero.
+     *
+     * @return Number in the range [0, bound).
+     */
+    [[nodiscard]] std::size_t below(const std::size_t bound)
+    {
+        return static_cast<std::size_t>(this->next() % bound);
+    }
+
+  private:
+    /**
+     * @brief Current state.
+     */
+    std::uint64_t state_;
+};
+
+/**
+ * @brief Class that represents a temporary directory for the generated tables as a RAII object.
+ *
+ * @note This class is marked as `final` to prevent inheritance.
+ */
+class ScratchDirectory final {
+  public:
+    /**
+     * @brief Construct a new ScratchDirectory object, removing any leftovers from a previous run.
+     */
+    ScratchDirectory()
+        : directory_(std::filesystem::temp_directory_path() / "yt-table-benchmarks")
+    {
+        std::filesystem::remove_all(this->directory_);
+        std::filesystem::create_directories(this->directory_);
+    }
+
+    /**
+     * @brief Destroy the ScratchDirectory object, removing the directory recursively.
+     */
+    ~ScratchDirectory()
+    {
+        std::error_code ec;
+        std::filesystem::remove_all(this->directory_, ec);
+    }
+
+    ScratchDirectory(const ScratchDirectory &) = delete;
+    ScratchDirectory &operator=(const ScratchDirectory &) = delete;
+
+    /**
+     * @brief Get the path to the directory.
+     *
+     * @return Path to the directory (e.g., "/tmp/yt-table-benchmarks").
+     */
+    [[nodiscard]] const std::filesystem::path &get() const
+    {
+        return this->directory_;
+    }
+
+  private:
+    /**
+     * @brief Path to the directory.
+     */
+    const std::filesystem::path directory_;
+};
+
+/**
+ * @brief Struct that represents the timings of a single benchmark.
+ */
+struct Result final {
+    std::string benchmark;
+    std::string variant;
+    std::size_t channels;
+    std::uintmax_t file_bytes;
+    std::vector<std::int64_t> samples_ns;
+};
+
+/**
+ * @brief Words that channel names and descriptions are made of, including multi-byte UTF-8, so that the scanner and the sort see realistic bytes.
+ */
+constexpr std::string_view words[] = {
+    "Noriyaro", "Drift", "Engineering", "Explained", "Repairs", "Garage", "Tokyo", "Studio",
+    "チャンネル", "日本語", "ドリフト", "Café", "Straße", "Ωmega", "Музыка", "Ñandú", "🚗", "한국어",
+};
+
+/**
+ * @brief Generate a deterministic table of YouTube channels in random name order.
+ *
+ * Names are two or three words followed by a number, so they are unique. Descriptions are mostly short, with a long tail of paragraph-sized ones. Links are unique handles.
+ *
+ * @param count Number of channels (e.g., "1000").
+ * @param seed Seed of the generator (e.g., "42").
+ *
+ * @return Unsorted vector of YouTube channels.
+ */
+[[nodiscard]] std::vector<core::io::Channel> generate_channels(const std::size_t count,
+                                                               const std::uint64_t seed)
+{
+    Random random(seed);
+    constexpr std::size_t word_count = sizeof(words) / sizeof(words[0]);
+    const auto append_words = [&](std::string &out,
+                                  const std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            if (i > 0) {
+                out += ' ';
+            }
+            out += words[random.below(word_count)];
+        }
+    };
+
+    std::vector<core::io::Channel> channels;
+    channels.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        std::string name;
+        append_words(name, 2 + random.below(2));
+        name += fmt::format(" {}", i);
+
+        // 70% short, 25% medium, 5% long descriptions
+        const std::size_t roll = random.below(100);
+        const std::size_t description_words = roll < 70 ? 1 + random.below(4) : roll < 95 ? 5 + random.below(16) : 20 + random.below(41);
+        std::string description;
+        append_words(description, description_words);
+
+        channels.emplace_back(name, fmt::format("https://www.youtube.com/@channel{:x}", random.next()), description);
+    }
+    return channels;
+}
+
+/**
+ * @brief Time a function repeatedly.
+ *
+ * @param repetitions Number of timed runs (e.g., "5").
+ * @param prepare Function to call before each run, outside of the timing (e.g., to copy the input).
+ * @param run Function to time.
+ *
+ * @return Duration of each run in nanoseconds.
+ */
+[[nodiscard]] std::vector<std::int64_t> measure(const std::size_t repetitions,
+                                                const std::function<void()> &prepare,
+                                                const std::function<void()> &run)
+{
+    std::vector<std::int64_t> samples;
+    samples.reserve(repetitions);
+    for (std::size_t i = 0; i < repetitions; ++i) {
+        if (prepare) {
+            prepare();
+        }
+        const auto start = std::chrono::steady_clock::now();
+        run();
+        const auto stop = std::chrono::steady_clock::now();
+        samples.emplace_back(static_cast<std::int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count()));
+    }
+    return samples;
+}
+
+/**
+ * @brief Get a readable name for a durability level.
+ *
+ * @param durability Durability level (e.g., "core::io::Durability::Full").
+ *
+ * @return Lowercase name (e.g., "full").
+ */
+[[nodiscard]] std::string_view durability_name(const core::io::Durability durability)
+{
+    switch (durability) {
+    case core::io::Durability::None:
+        return "none";
+    case core::io::Durability::Data:
+        return "data";
+    case core::io::Durability::Full:
+        return "full";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief Run every benchmark on a table of the given size.
+ *
+ * @param directory Directory for the generated files.
+ * @param count Number of channels (e.g., "1000").
+ * @param repetitions Number of timed runs per benchmark (e.g., "5").
+ * @param results Vector to append the results to.
+ */
+void run_benchmarks(const std::filesystem::path &directory,
+                    const std::size_t count,
+                    const std::size_t repetitions,
+                    std::vector<Result> &results)
+{
+    const std::filesystem::path path = directory / fmt::format("table_{}.html", count);
+    const std::vector<core::io::Channel> generated = generate_channels(count, 42);
+    const auto report = [&](const std::string &benchmark,
+                            const std::string &variant,
+                            std::vector<std::int64_t> samples) {
+        const std::uintmax_t bytes = std::filesystem::exists(path) ? std::filesystem::file_size(path) : 0;
+        std::sort(samples.begin(), samples.end());
+        fmt::print(stderr, "{:<28} {:<16} {:>8} channels: median {:>10.3f} ms\n", benchmark, variant, count, static_cast<double>(samples[samples.size() / 2]) / 1e6);
+        results.push_back(Result{benchmark, variant, count, bytes, std::move(samples)});
+    };
+
+    // Sorting by name, as done by "core::io::load"
+    std::vector<core::io::Channel> unsorted;
+    report("sort", "by_name", measure(repetitions, [&]() { unsorted = generated; }, [&]() {
+               std::sort(unsorted.begin(), unsorted.end(), [](const core::io::Channel &a, const core::io::Channel &b) { return a.name < b.name; });
+           }));
+
+    // Saving at every durability level; the sorted copy is what the application writes
+    const std::vector<core::io::Channel> sorted = unsorted;
+    for (const core::io::Durability durability : {core::io::Durability::None, core::io::Durability::Data, core::io::Durability::Full}) {
+        report("core::io::save", fmt::format("durability={}", durability_name(durability)), measure(repetitions, nullptr, [&]() { core::io::save(path, sorted, durability); }));
+    }
+
+    // Loading, without the backup copy, so only the parse is measured, on as many threads as the file is large enough for, then on a single thread
+    report("core::io::load", "no_backup", measure(repetitions, nullptr, [&]() {
+               if (core::io::load(path, false).size() != count) {
+                   throw std::runtime_error("Loaded the wrong number of channels");
+               }
+           }));
+    report("core::io::load", "one_thread", measure(repetitions, nullptr, [&]() {
+               if (core::io::load(path, false, 1).size() != count) {
+                   throw std::runtime_error("Loaded the wrong number of channels");
+               }
+           }));
+
+    // Backing up, which every load does: a full copy the first time, then only a hash while the file is unchanged
+    report("core::backup::create", "changed", measure(repetitions, [&]() {
+               for (const core::backup::Generation &generation : core::backup::list(path)) {
+                   std::filesystem::remove(generation.path);
+               }
+           }, [&]() { static_cast<void>(core::backup::create(path)); }));
+    report("core::backup::create", "unchanged", measure(repetitions, nullptr, [&]() { static_cast<void>(core::backup::create(path)); }));
+
+    // Opening a table, which is what the application does on startup (including the backup), first by parsing the HTML, then from the snapshot
+    const std::filesystem::path snapshot_path = core::snapshot::get_path(path);
+    report("modules::disk::Table", "open", measure(repetitions, [&]() { std::filesystem::remove(snapshot_path); }, [&]() {
+               const modules::disk::Table table(path, core::io::Durability::None);
+               // Keep the destructor from writing the snapshot inside the timed region
+               std::filesystem::remove(snapshot_path);
+           }));
+    {
+        const modules::disk::Table table(path, core::io::Durability::None);
+    }
+    report("modules::disk::Table", "open_snapshot", measure(repetitions, nullptr, [&]() {
+               const modules::disk::Table table(path, core::io::Durability::None);
+           }));
+
+    // Single edits at random positions, each appended to the journal, which is compacted into the file once it passes the threshold; syncing is disabled, so the I/O volume is measured rather than the disk's flush latency
+    {
+        modules::disk::Table table(path, core::io::Durability::None);
+        const std::vector<core::io::Channel> extra = generate_channels(repetitions, 7);
+        std::size_t next = 0;
+        report("modules::disk::Table::add", "durability=none", measure(repetitions, nullptr, [&]() {
+                   if (!table.add(extra[next++])) {
+                       throw std::runtime_error("Failed to add a generated channel");
+                   }
+               }));
+        next = 0;
+        report("modules::disk::Table::remove", "durability=none", measure(repetitions, nullptr, [&]() {
+                   if (!table.remove(extra[next++].name)) {
+                       throw std::runtime_error("Failed to remove a generated channel");
+                   }
+               }));
+
+        // The same edits inside an outer batch, as the shell makes them: each one is a single append to the journal, and the file is rewritten once when the batch ends
+        {
+            modules::disk::Table::Batch session(table);
+            next = 0;
+            report("modules::disk::Table::add", "journal", measure(repetitions, nullptr, [&]() {
+                       modules::disk::Table::Batch command(table);
+                       if (!table.add(extra[next++])) {
+                           throw std::runtime_error("Failed to add a generated channel");
+                       }
+                   }));
+            next = 0;
+            report("modules::disk::Table::remove", "journal", measure(repetitions, nullptr, [&]() {
+                       modules::disk::Table::Batch command(table);
+                       if (!table.remove(extra[next++].name)) {
+                           throw std::runtime_error("Failed to remove a generated channel");
+                       }
+                   }));
+        }
+
+        // A batch with a single edit, committed on its own as the shell does after a pause between commands, which rewrites the whole file
+        {
+            const core::io::Channel channel("Benchmark channel", "https://www.youtube.com/@benchmark", "Added and removed");
+            bool is_added = false;
+            report("modules::disk::Table::commit", "one_row", measure(repetitions, nullptr, [&]() {
+                       modules::disk::Table::Batch command(table);
+                       is_added = !is_added;
+                       if (is_added ? !table.add(channel) : !table.remove(channel.name)) {
+                           throw std::runtime_error("Failed to edit the benchmark channel");
+                       }
+                       command.commit();
+                   }));
+        }
+
+        // Picking up an edit that another program made to a row in the middle of the file, as the shell does before each command; only the chunks around the edit are parsed, and the edit is undone between runs
+        {
+            table.watch();
+            const std::string original(core::io::MappedFile(path).view());
+            const core::store::ChannelView middle = table.get_channels()[table.get_channels().size() / 2];
+            std::string edited = original;
+            edited.insert(edited.find('<', edited.find(std::string(middle.link))), "!");
+            bool is_edited = false;
+            report("modules::disk::Table::refresh", "one_row", measure(repetitions, [&]() {
+                       is_edited = !is_edited;
+                       std::ofstream(path, std::ios::binary | std::ios::trunc) << (is_edited ? edited : original);
+                   }, [&]() {
+                       if (!table.refresh()) {
+                           throw std::runtime_error("Failed to pick up the edit");
+                       }
+                   }));
+        }
+
+        // Printing the list, as done by the "ls" command
+        report("app::print_channel_names", "tmpfile", measure(repetitions, nullptr, [&]() {
+                   std::FILE *output = std::tmpfile();
+                   if (output == nullptr) {
+                       throw std::runtime_error("Failed to create a temporary file");
+                   }
+                   app::print_channel_names(table.get_channels(), output);
+                   std::fflush(output);
+                   std::fclose(output);
+               }));
+
+        // Printing a page from the middle of the list, as done by "ls --range", which only visits the channels of the page
+        core::args::ListOptions page;
+        page.offset = table.get_channels().size() / 2;
+        page.limit = 100;
+        page.format = core::args::ListFormat::Compact;
+        report("app::print_channels", "100 rows", measure(repetitions, nullptr, [&]() {
+                   std::FILE *output = std::tmpfile();
+                   if (output == nullptr) {
+                       throw std::runtime_error("Failed to create a temporary file");
+                   }
+                   app::print_channels(table.get_channels(), page, output);
+                   std::fflush(output);
+                   std::fclose(output);
+               }));
+
+        // Searching, as done by the "find" command: the first search builds the index, later ones only look it up; the query has typos, and its words are in most channels, so most posting lists are long
+        core::search::TrigramIndex index;
+        report("core::search::TrigramIndex", "build", measure(repetitions, [&]() { index.clear(); }, [&]() {
+                   index.reserve(table.get_channels().size());
+                   for (const core::store::ChannelView channel : table.get_channels()) {
+                       index.insert(channel.name, channel.link, channel.description);
+                   }
+               }));
+        report("core::search::TrigramIndex", "find", measure(repetitions, nullptr, [&]() {
+                   if (index.find("Garaje Tokio", 20).empty()) {
+                       throw std::runtime_error("Failed to find a generated channel");
+                   }
+               }));
+
+        // Rendering every export format; copying a buffer of the HTML document's size gives the memcpy baseline to compare against
+        const std::string html = core::render::render(table.get_channels(), core::render::Format::Html);
+        std::string copy;
+        report("memcpy", "html_size", measure(repetitions, [&]() { copy.clear(); copy.shrink_to_fit(); }, [&]() { copy.assign(html); }));
+        for (const auto &[format, name] : {std::pair{core::render::Format::Html, "html"}, std::pair{core::render::Format::Markdown, "markdown"}, std::pair{core::render::Format::Csv, "csv"}, std::pair{core::render::Format::Json, "json"}}) {
+            report("core::render::render", fmt::format("format={}", name), measure(repetitions, nullptr, [&]() {
+                       if (core::render::render(table.get_channels(), format).empty()) {
+                           throw std::runtime_error("Rendered an empty document");
+                       }
+                   }));
+        }
+
+        // Escaping the fields for HTML, which every save does; the fields of a generated table have no special characters, which is the common case, so escaping is one search of the fields plus a copy
+        std::string fields;
+        for (const core::store::ChannelView channel : table.get_channels()) {
+            fields.append(channel.name);
+            fields.append(channel.link);
+            fields.append(channel.description);
+        }
+        report("memcpy", "fields_size", measure(repetitions, [&]() { copy.clear(); copy.shrink_to_fit(); }, [&]() { copy.assign(fields); }));
+        report("core::escape::escape", "plain", measure(repetitions, [&]() { copy.clear(); copy.shrink_to_fit(); }, [&]() { copy = core::escape::escape(fields); }));
+        report("core::escape::unescape", "plain", measure(repetitions, [&]() { copy.clear(); copy.shrink_to_fit(); }, [&]() { copy = core::escape::unescape(fields); }));
+
+        // Searching the fields for special characters with each kernel, which is the one search of "core::simd" that is vectorized
+        for (const auto &[kernel, name] : {std::pair{core::simd::Kernel::Scalar, "scalar"}, std::pair{core::simd::Kernel::Sse2, "sse2"}, std::pair{core::simd::Kernel::Avx2, "avx2"}}) {
+            if (!core::simd::is_supported(kernel)) {
+                continue;
+            }
+            report("core::simd::find_any_of", fmt::format("kernel={}", name), measure(repetitions, nullptr, [&]() {
+                       if (core::simd::find_any_of(fields, core::escape::special_characters, 0, kernel) != fields.size()) {
+                           throw std::runtime_error("Found a special character in the generated fields");
+                       }
+                   }));
+        }
+
+        // Serving, as done by the "serve" command: the first update renders every segment, later ones only the segment around a changed channel (the change is undone between runs); each segment is compressed once, on the first gzip request
+        core::store::ChannelStore channels = table.get_channels();
+        modules::web::Document document;
+        report("modules::web::Document::update", "full", measure(repetitions, [&]() { document = modules::web::Document(); }, [&]() {
+                   static_cast<void>(document.update(channels));
+               }));
+        const std::size_t middle = channels.size() / 2;
+        const std::string name(channels.name(middle));
+        const std::string link(channels.link(middle));
+        const std::string description(channels.description(middle));
+        bool is_edited = false;
+        report("modules::web::Document::update", "one_row", measure(repetitions, [&]() {
+                   channels.erase(channels.find(name).value());
+                   is_edited = !is_edited;
+                   static_cast<void>(channels.insert(name, link, is_edited ? description + "!" : description));
+               }, [&]() {
+                   if (!document.update(channels) || document.get_rendered_segments() != 1) {
+                       throw std::runtime_error("Failed to render only the changed segment");
+                   }
+               }));
+        report("modules::web::Document::get_parts", "gzip_first", measure(repetitions, [&]() { document = modules::web::Document(); static_cast<void>(document.update(channels)); }, [&]() {
+                   static_cast<void>(document.get_parts(true));
+               }));
+    }
+
+    // The same table split into one file per leading letter: opening loads the shard files in parallel, and committing a single edit rewrites only the file of its shard
+    {
+        const std::filesystem::path sharded_path = directory / fmt::format("sharded_{}.html", count);
+        std::filesystem::copy_file(path, sharded_path, std::filesystem::copy_options::overwrite_existing);
+        modules::disk::Table(sharded_path, core::io::Durability::None).set_sharded(true);
+        report("modules::disk::Table", "open_sharded", measure(repetitions, nullptr, [&]() {
+                   const modules::disk::Table table(sharded_path, core::io::Durability::None);
+               }));
+        modules::disk::Table table(sharded_path, core::io::Durability::None);
+        const core::io::Channel channel("Sharded benchmark channel", "https://www.youtube.com/@sharded-benchmark", "Added and removed");
+        bool is_added = false;
+        report("modules::disk::Table::commit", "one_row_sharded", measure(repetitions, nullptr, [&]() {
+                   modules::disk::Table::Batch command(table);
+                   is_added = !is_added;
+                   if (is_added ? !table.add(channel) : !table.remove(channel.name)) {
+                       throw std::runtime_error("Failed to edit the benchmark channel");
+                   }
+                   command.commit();
+               }));
+    }
+
+    std::filesystem::remove(path);
+}
+
+/**
+ * @brief Escape a string for JSON.
+ *
+ * @param text Text to escape (e.g., "durability=full").
+ *
+ * @return Escaped text, without the surrounding quotes.
+ */
+[[nodiscard]] std::string escape_json(const std::string_view text)
+{
+    std::string escaped;
+    escaped.reserve(text.size());
+    for (const char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20) {
+            escaped += fmt::format("\\u{:04x}", static_cast<unsigned>(c));
+        }
+        else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+/**
+ * @brief Render the results as JSON.
+ *
+ * @param results Results of every benchmark.
+ *
+ * @return JSON document, with one object per benchmark and table size.
+ */
+[[nodiscard]] std::string to_json(const std::vector<Result> &results)
+{
+    std::string json;
+    fmt::format_to(std::back_inserter(json), "{{\n  \"version\": \"{}\",\n  \"unit\": \"ns\",\n  \"results\": [\n", escape_json(PROJECT_VERSION));
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const Result &result = results[i];
+        const std::vector<std::int64_t> &samples = result.samples_ns;
+        const std::int64_t total = std::accumulate(samples.cbegin(), samples.cend(), std::int64_t{0});
+        fmt::format_to(std::back_inserter(json),
+                       "    {{\"benchmark\": \"{}\", \"variant\": \"{}\", \"channels\": {}, \"file_bytes\": {}, \"repetitions\": {}, "
+                       "\"min\": {}, \"median\": {}, \"mean\": {}, \"max\": {}}}{}\n",
+                       escape_json(result.benchmark), escape_json(result.variant), result.channels, result.file_bytes, samples.size(),
+                       samples.front(), samples[samples.size() / 2], total / static_cast<std::int64_t>(samples.size()), samples.back(),
+                       i + 1 < results.size() ? "," : "");
+    }
+    json += "  ]\n}\n";
+    return json;
+}
+
+/**
+ * @brief Parse a positive number from the command line.
+ *
+ * @param text Text to parse (e.g., "1000").
+ *
+ * @return Parsed number (e.g., "1000").
+ *
+ * @throws std::runtime_error If the text is not a positive number.
+ */
+[[nodiscard]] std::size_t parse_count(const std::string &text)
+{
+    if (text.empty() || text.size() > 9 || text.find_first_not_of("0123456789") != std::string::npos || std::stoul(text) == 0) {
+        throw std::runtime_error(fmt::format("Invalid number: '{}'", text));
+    }
+    return static_cast<std::size_t>(std::stoul(text));
+}
+
+/**
+ * @brief Parse a comma-separated list of table sizes.
+ *
+ * @param text List of sizes (e.g., "1000,10000").
+ *
+ * @return Vector of sizes (e.g., {1000, 10000}).
+ *
+ * @throws std::runtime_error If a size is not a positive number.
+ */
+[[nodiscard]] std::vector<std::size_t> parse_sizes(const std::string &text)
+{
+    std::vector<std::size_t> sizes;
+    std::size_t begin = 0;
+    while (true) {
+        const std::size_t end = text.find(',', begin);
+        sizes.emplace_back(parse_count(text.substr(begin, end - begin)));
+        if (end == std::string::npos) {
+            return sizes;
+        }
+        begin = end + 1;
+    }
+}
+
+constexpr std::string_view usage = "Usage: benchmarks [--sizes N[,N...]] [--repetitions N] [--output FILE]\n"
+                                   "\n"
+                                   "Time loading, saving, editing, sorting and printing of generated tables, and print the results as JSON.\n"
+                                   "\n"
+                                   "Optional arguments:\n"
+                                   "  --sizes        comma-separated table sizes (default: 1000,10000,100000,1000000)\n"
+                                   "  --repetitions  timed runs per benchmark (default: 10, 5 and 3 for tables above 10k and 100k channels)\n"
+                                   "  --output       write the JSON to a file instead of stdout\n";
+
+}  // namespace
+
+/**
+ * @brief Entry-point of the benchmarks.
+ *
+ * @param argc Number of command-line arguments (e.g., "3").
+ * @param argv Array of command-line arguments (e.g., {"./benchmarks", "--sizes", "1000"}).
+ *
+ * @return EXIT_SUCCESS if every benchmark ran, EXIT_FAILURE otherwise.
+ */
+int main(int argc,
+         char **argv)
+{
+#if defined(_WIN32)  // Setup UTF-8 input/output
+    SetConsoleCP(CP_UTF8);
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+    try {
+        std::vector<std::size_t> sizes = {1000, 10000, 100000, 1000000};
+        std::size_t repetitions = 0;
+        std::filesystem::path output;
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view arg = argv[i];
+            if (arg == "-h" || arg == "--help") {
+                fmt::print("{}", usage);
+                return EXIT_SUCCESS;
+            }
+            if (i + 1 >= argc) {
+                fmt::print(stderr, "Missing value for '{}'\n\n{}", arg, usage);
+                return EXIT_FAILURE;
+            }
+            const std::string value = argv[++i];
+            if (arg == "--sizes") {
+                sizes = parse_sizes(value);
+            }
+            else if (arg == "--repetitions") {
+                repetitions = parse_count(value);
+            }
+            else if (arg == "--output") {
+                output = value;
+            }
+            else {
+                fmt::print(stderr, "Unknown argument: '{}'\n\n{}", arg, usage);
+                return EXIT_FAILURE;
+            }
+        }
+
+        const ScratchDirectory directory;
+        std::vector<Result> results;
+        for (const std::size_t count : sizes) {
+            const std::size_t runs = repetitions > 0 ? repetitions : count > 100000 ? 3 : count > 10000 ? 5 : 10;
+            run_benchmarks(directory.get(), count, runs, results);
+        }
+
+        const std::string json = to_json(results);
+        if (output.empty()) {
+            std::cout << json;
+        }
+        else {
+            std::ofstream file(output, std::ios::binary);
+            file << json;
+            if (!file) {
+                throw std::runtime_error(fmt::format("Failed to write '{}'", output.string()));
+            }
+        }
+    }
+    catch (const std::exception &e) {
+        fmt::print(stderr, "{}\n", e.what());
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
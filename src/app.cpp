@@ -2,19 +2,49 @@
  * @file app.cpp
  */
 
-#include <iostream>   // for std::cin
-#include <stdexcept>  // for std::runtime_error
-#include <string>     // for std::string, std::getline
-#include <vector>     // for std::vector
+#include <array>         // for std::array
+#include <charconv>      // for std::from_chars
+#include <chrono>        // for std::chrono
+#include <cstddef>       // for std::size_t
+#include <cstdint>       // for std::uintmax_t
+#include <cstdio>        // for std::FILE, std::fflush, std::fwrite, stdin, stdout
+#include <filesystem>    // for std::filesystem
+#include <functional>    // for std::function
+#include <iostream>      // for std::cin
+#include <iterator>      // for std::back_inserter
+#include <optional>      // for std::optional, std::nullopt
+#include <stdexcept>     // for std::runtime_error, std::invalid_argument
+#include <string>        // for std::string, std::getline
+#include <string_view>   // for std::string_view
+#include <system_error>  // for std::errc
+#include <utility>       // for std::pair
+#include <vector>        // for std::vector
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN  // Exclude rarely-used stuff from Windows headers
+#include <io.h>              // for _isatty, _fileno
+#include <windows.h>         // for WaitForSingleObject, GetStdHandle, GetConsoleScreenBufferInfo
+#else                        // Assume POSIX for macOS and GNU/Linux
+#include <poll.h>            // for poll, struct pollfd, POLLIN
+#include <sys/ioctl.h>       // for ioctl, struct winsize, TIOCGWINSZ
+#include <unistd.h>          // for isatty, STDIN_FILENO, STDOUT_FILENO
+#endif
 
 #include <fmt/core.h>
+#include <fmt/format.h>
 
 #include "app.hpp"
+#include "core/args.hpp"
+#include "core/backup.hpp"
+#include "core/import.hpp"
 #include "core/io.hpp"
 #include "core/paths.hpp"
+#include "core/render.hpp"
+#include "core/search.hpp"
 #include "core/shell.hpp"
+#include "core/store.hpp"
 #include "core/strings.hpp"
 #include "modules/disk.hpp"
+#include "modules/web.hpp"
 #include "version.hpp"
 
 namespace app {
@@ -22,31 +52,56 @@ namespace app {
 namespace {
 
 /**
- * @brief Private helper function to print the names of the channels.
+ * @brief Private helper variable that contains how long the shell waits for the next command before writing pending changes to disk.
+ */
+constexpr std::chrono::milliseconds autosave_delay{1500};
+
+/**
+ * @brief Private helper variable that contains how many imported records are added to the table at once.
+ */
+constexpr std::size_t import_batch_size = 4096;
+
+/**
+ * @brief Private helper variable that contains how many channels the "find" command prints at most.
+ */
+constexpr std::size_t find_limit = 20;
+
+/**
+ * @brief Private helper variable that contains how often the "serve" command checks the file for changes while no requests arrive.
+ */
+constexpr std::chrono::milliseconds serve_poll_interval{250};
+
+/**
+ * @brief Private helper variable that contains the label of each field in the text format of the "ls" command, in the order of "core::args::Field".
+ */
+constexpr std::array<std::string_view, 3> field_labels = {"Name", "Link", "Description"};
+
+/**
+ * @brief Wait until input is available on stdin or until the timeout expires.
  *
- * The function will first print a leading newline, then the number of channels, and then each channel's name, link, description, and a trailing newline.
+ * @param timeout How long to wait (e.g., "1500ms").
  *
- * @param channels Vector of YouTube channels.
+ * @return True if input is available (or the platform cannot tell), false if the timeout expired.
  */
-void print_channel_names(const std::vector<core::io::Channel> &channels)
+[[nodiscard]] bool wait_for_input(const std::chrono::milliseconds timeout)
 {
-    fmt::print("\nChannels ({}):\n", channels.size());
-    for (const auto &channel : channels) {
-        fmt::print("  Name: {}\n"
-                   "  Link: {}\n"
-                   "  Description: {}\n\n",
-                   channel.name, channel.link, channel.description);
-    }
-    // If empty, print a newline, otherwise, the last channel will have a trailing newline
-    if (channels.empty()) {
-        fmt::print("\n");
+    // Input that is already buffered by the stream doesn't show up on the descriptor
+    if (std::cin.rdbuf()->in_avail() > 0) {
+        return true;
     }
+#if defined(_WIN32)
+    return WaitForSingleObject(GetStdHandle(STD_INPUT_HANDLE), static_cast<DWORD>(timeout.count())) != WAIT_TIMEOUT;
+#else
+    struct pollfd fd = {STDIN_FILENO, POLLIN, 0};
+    return poll(&fd, 1, static_cast<int>(timeout.count())) != 0;
+#endif
 }
 
 /**
  * @brief Get user input from the console.
  *
  * @param prompt Prompt to display before the input (e.g., "Name: ").
+ * @param on_idle Function to call once if no input arrives within "autosave_delay" (default: none).
  *
  * @return Trimmed string containing the user input.
  *
@@ -54,11 +109,17 @@ void print_channel_names(const std::vector<core::io::Channel> &channels)
  *
  * @note The function will continuously prompt until a non-empty string is entered, trimming leading and trailing whitespace before checking for emptiness.
  */
-[[nodiscard]] std::string get_input(const std::string &prompt)
+[[nodiscard]] std::string get_input(const std::string &prompt,
+                                    const std::function<void()> &on_idle = nullptr)
 {
     std::string input;
     while (true) {
         fmt::print("{}", prompt);
+        // Flush the prompt, because the idle callback may run before the user types anything
+        std::fflush(stdout);
+        if (on_idle && !wait_for_input(autosave_delay)) {
+            on_idle();
+        }
         if (!std::getline(std::cin, input)) {
             // Add a newline to separate the error message from the prompt
             fmt::print("\n");
@@ -77,81 +138,929 @@ void print_channel_names(const std::vector<core::io::Channel> &channels)
     }
 }
 
-}  // namespace
+/**
+ * @brief Private helper function to parse a pasted channel line.
+ *
+ * @param line Line in the format "name | description | link" (e.g., "Noriyaro | JP Drifting | https://www.youtube.com/@noriyaro/videos").
+ * @param channel Channel to fill in.
+ *
+ * @return True if the line has three non-empty fields, false otherwise.
+ */
+[[nodiscard]] bool parse_pasted_channel(const std::string &line,
+                                        core::io::Channel &channel)
+{
+    std::vector<std::string> fields;
+    std::size_t begin = 0;
+    while (true) {
+        const std::size_t end = line.find('|', begin);
+        fields.emplace_back(core::strings::trim_whitespace(line.substr(begin, end - begin)));
+        if (end == std::string::npos) {
+            break;
+        }
+        begin = end + 1;
+    }
+    if (fields.size() != 3 || fields[0].empty() || fields[1].empty() || fields[2].empty()) {
+        return false;
+    }
+    channel = core::io::Channel{fields[0], fields[2], fields[1]};
+    return true;
+}
+
+/**
+ * @brief Private helper function to check if stdin is a terminal.
+ *
+ * @return True if stdin is a terminal, false if it is redirected from a file or a pipe.
+ */
+[[nodiscard]] bool is_stdin_terminal()
+{
+#if defined(_WIN32)
+    return _isatty(_fileno(stdin)) != 0;
+#else
+    return isatty(STDIN_FILENO) != 0;
+#endif
+}
+
+/**
+ * @brief Private helper function to check if stdout is a terminal.
+ *
+ * @return True if stdout is a terminal, false if it is redirected to a file or a pipe.
+ */
+[[nodiscard]] bool is_stdout_terminal()
+{
+#if defined(_WIN32)
+    return _isatty(_fileno(stdout)) != 0;
+#else
+    return isatty(STDOUT_FILENO) != 0;
+#endif
+}
+
+/**
+ * @brief Private helper function to get the size of the terminal that stdout is connected to.
+ *
+ * @return Number of rows and columns (e.g., {24, 80}), or {24, 80} if the size is unknown.
+ */
+[[nodiscard]] std::pair<std::size_t, std::size_t> get_terminal_size()
+{
+#if defined(_WIN32)
+    CONSOLE_SCREEN_BUFFER_INFO info;
+    if (GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info) && info.srWindow.Bottom > info.srWindow.Top && info.srWindow.Right > info.srWindow.Left) {
+        return {static_cast<std::size_t>(info.srWindow.Bottom - info.srWindow.Top + 1), static_cast<std::size_t>(info.srWindow.Right - info.srWindow.Left + 1)};
+    }
+#else
+    struct winsize size = {};
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_row > 0 && size.ws_col > 0) {
+        return {size.ws_row, size.ws_col};
+    }
+#endif
+    return {24, 80};
+}
+
+/**
+ * @brief Private helper function to write text to stdout one screen at a time, waiting for Enter between screens.
+ *
+ * Text that fits on the screen is written at once, without a prompt. Lines longer than the terminal is wide count as the number of rows they wrap to.
+ *
+ * @param text Text to write, made of lines that end with a newline.
+ */
+void page(const std::string_view text)
+{
+    const auto [rows, columns] = get_terminal_size();
+    // Keep the last row for the prompt
+    const std::size_t page_rows = rows > 1 ? rows - 1 : 1;
+    std::size_t begin = 0;
+    while (begin < text.size()) {
+        // Take whole lines until the screen is full, but always at least one line
+        std::size_t end = begin;
+        std::size_t used = 0;
+        while (end < text.size()) {
+            const std::size_t newline = text.find('\n', end);
+            const std::size_t line_end = newline == std::string_view::npos ? text.size() : newline + 1;
+            // Count characters rather than bytes, skipping UTF-8 continuation bytes
+            std::size_t width = 0;
+            for (std::size_t i = end; i < line_end; ++i) {
+                width += (text[i] != '\n' && (static_cast<unsigned char>(text[i]) & 0xC0) != 0x80) ? 1u : 0u;
+            }
+            const std::size_t line_rows = width == 0 ? 1 : (width + columns - 1) / columns;
+            if (used > 0 && used + line_rows > page_rows) {
+                break;
+            }
+            used += line_rows;
+            end = line_end;
+        }
+        std::fwrite(text.data() + begin, 1, end - begin, stdout);
+        begin = end;
+        if (begin == text.size()) {
+            break;
+        }
+
+        // Wait for the next page, then erase the prompt, so that the pages join up
+        fmt::print("-- More ({}%), Enter: next page, q: quit -- ", begin * 100 / text.size());
+        std::fflush(stdout);
+        std::string answer;
+        if (!std::getline(std::cin, answer)) {
+            return;
+        }
+#if !defined(_WIN32)
+        fmt::print("\x1b[1A\x1b[2K");
+#endif
+        if (core::strings::trim_whitespace(answer) == "q") {
+            return;
+        }
+    }
+}
 
-void run()
+/**
+ * @brief Private helper function to parse the inline options of the shell's "ls" command.
+ *
+ * @param argument Options separated by whitespace, as "--key value" or "--key=value" (e.g., "--range 1-20 --format compact").
+ *
+ * @return Parsed options.
+ *
+ * @throws std::invalid_argument If an option is unknown, has no value, or has an invalid value.
+ */
+[[nodiscard]] core::args::ListOptions parse_list_options(const std::string &argument)
 {
-    // Load the HTML table from disk
-    modules::disk::Table table(core::paths::get_resources_directory("yt-table") / "subscriptions.html");
+    std::vector<std::string> words;
+    std::size_t begin = argument.find_first_not_of(" \t");
+    while (begin != std::string::npos) {
+        const std::size_t end = argument.find_first_of(" \t", begin);
+        words.emplace_back(argument.substr(begin, end - begin));
+        begin = argument.find_first_not_of(" \t", end);
+    }
+    core::args::ListOptions options;
+    for (std::size_t i = 0; i < words.size(); ++i) {
+        const std::size_t equals = words[i].find('=');
+        const std::string key = words[i].substr(0, equals);
+        std::string value;
+        if (equals != std::string::npos) {
+            value = words[i].substr(equals + 1);
+        }
+        else if (i + 1 < words.size()) {
+            value = words[++i];
+        }
+        else {
+            throw std::invalid_argument(fmt::format("Missing value for option: {}", key));
+        }
+        if (!core::args::parse_list_option(options, key, value)) {
+            throw std::invalid_argument(fmt::format("Invalid option for 'ls': {}", key));
+        }
+    }
+    return options;
+}
 
-    // Print the path to the loaded table
-    fmt::print("Loaded: {}\n", table.get_filepath().string());
+/**
+ * @brief Struct that counts the outcome of an import.
+ *
+ * @note This struct is marked as `final` to prevent inheritance.
+ */
+struct ImportSummary final {
+    /**
+     * @brief Number of channels added to the table.
+     */
+    std::size_t added = 0;
 
-    // Define the prompt
-    const std::string prompt = "[yt-table] $ ";
+    /**
+     * @brief Number of channels skipped because their link is already in the table.
+     */
+    std::size_t duplicates = 0;
 
-    // Print the list of channels before the main loop
-    print_channel_names(table.get_channels());
+    /**
+     * @brief Number of records skipped because they are invalid.
+     */
+    std::size_t invalid = 0;
+};
 
-    // Start main shell-like loop
+/**
+ * @brief Private helper function to import the channels of a subscription export into a table.
+ *
+ * Records are added in batches of "import_batch_size", so that each batch is merged into the sorted table at once. Records without a description get "Imported". The caller should hold a Table::Batch, so that the table is written once at the end.
+ *
+ * @param table Table to add the channels to.
+ * @param path Path to the file, whose format is guessed from its extension (e.g., "~/subscriptions.csv").
+ * @param on_error Function to call for each skipped record, with its exit code and a message that includes the line number.
+ * @param on_progress Function to call after each chunk of the file (default: none).
+ *
+ * @return Number of added and skipped channels.
+ *
+ * @throws std::runtime_error If the format is unknown, or if the file cannot be read or the table cannot be written.
+ */
+[[nodiscard]] ImportSummary import_channels(modules::disk::Table &table,
+                                            const std::filesystem::path &path,
+                                            const std::function<void(ExitCode, const std::string &)> &on_error,
+                                            const std::function<void(const core::import::Progress &)> &on_progress = nullptr)
+{
+    const std::optional<core::import::Format> format = core::import::detect_format(path);
+    if (!format) {
+        throw std::runtime_error(fmt::format("Failed to import file '{}': unknown format, expected .csv, .jsonl or .opml", path.string()));
+    }
+
+    ImportSummary summary;
+    const std::string filename = path.filename().string();
+    std::vector<core::io::Channel> channels;
+    std::vector<std::size_t> lines;
+    channels.reserve(import_batch_size);
+    lines.reserve(import_batch_size);
+    const auto add_pending = [&]() {
+        const std::vector<bool> added = table.add(channels);
+        for (std::size_t i = 0; i < channels.size(); ++i) {
+            if (added[i]) {
+                ++summary.added;
+                continue;
+            }
+            ++summary.duplicates;
+            on_error(ExitCode::Duplicate, fmt::format("{}:{}: skipped duplicate channel '{}'", filename, lines[i], channels[i].name));
+        }
+        channels.clear();
+        lines.clear();
+    };
+
+    const auto on_record = [&](const core::import::Record &record) {
+        if (!record.error.empty()) {
+            ++summary.invalid;
+            on_error(ExitCode::Invalid, fmt::format("{}:{}: skipped invalid record: {}", filename, record.line, record.error));
+            return;
+        }
+        channels.push_back(record.channel);
+        if (channels.back().description.empty()) {
+            channels.back().description = "Imported";
+        }
+        lines.push_back(record.line);
+        if (channels.size() >= import_batch_size) {
+            add_pending();
+        }
+    };
+    core::import::read(path, *format, on_record, on_progress);
+    add_pending();
+    return summary;
+}
+
+/**
+ * @brief Private helper function to serve a table until the program is stopped (e.g., with Ctrl+C).
+ *
+ * Between requests, the changes made to the file by other programs (e.g., the shell, or "yt-table add") are picked up, and the pages open in web browsers reload. If the changed file cannot be loaded (e.g., it is malformed), the previous version is served until the file is fixed.
+ *
+ * @param table Table to serve, which must be watched (see "modules::disk::Table::watch").
+ * @param server Server of the table.
+ *
+ * @throws std::runtime_error If waiting for connections fails.
+ */
+[[noreturn]] void serve(modules::disk::Table &table,
+                        modules::web::Server &server)
+{
+    std::string last_error;
     while (true) {
-        // Get user input using the UNIX-like prompt
-        const std::string input = get_input(prompt);
+        server.poll(serve_poll_interval);
+        try {
+            if (table.refresh() && server.publish(table.get_channels())) {
+                fmt::print("Reloaded {} ({} channels)\n", table.get_filepath().string(), table.get_channels().size());
+                std::fflush(stdout);
+            }
+            last_error.clear();
+        }
+        catch (const std::runtime_error &e) {
+            // The file is checked again on every poll, so only report each error once
+            if (last_error != e.what()) {
+                last_error = e.what();
+                fmt::print(stderr, "{}; serving the previous version until the file is fixed\n", last_error);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Class that runs shell commands against a table, either interactively or from a script.
+ *
+ * Interactively, prompts and results are printed to stdout, and pending changes are written after a moment of inactivity. In script mode (i.e., stdin is not a terminal), no prompts or results are printed, errors are printed to stderr with their line number, and all changes are written with a single save at the end.
+ *
+ * In both modes, "add" and "remove" accept their arguments on the same line (e.g., "add Noriyaro | JP Drifting | https://www.youtube.com/@noriyaro/videos", "remove Noriyaro"), or on the following lines.
+ *
+ * @note This class is marked as `final` to prevent inheritance.
+ */
+class Shell final {
+  public:
+    /**
+     * @brief Construct a new Shell object.
+     *
+     * @param table Table to run the commands against.
+     * @param interactive If true, print prompts and results, otherwise run as a script.
+     */
+    explicit Shell(modules::disk::Table &table,
+                   const bool interactive)
+        : table_(table),
+          interactive_(interactive) {}
+
+    /**
+     * @brief Run commands until "exit" or the end of the input.
+     *
+     * @return ExitCode::Success, or in script mode, the exit code of the first failed command.
+     *
+     * @throws std::runtime_error If the table cannot be written, or if the interactive input ends (EOF).
+     */
+    [[nodiscard]] ExitCode run()
+    {
+        // Defer all writes, so that consecutive commands are coalesced into a single save
+        // Pending changes are written on "exit" and "open", after a moment of inactivity (interactive only), and when leaving this function (e.g., on EOF)
+        // Until then, each command's changes are synced to the table's journal, so they survive a crash
+        modules::disk::Table::Batch batch(this->table_);
+
+        // Pick up the edits that other programs (e.g., a text editor) make to the file while the shell runs
+        this->table_.watch();
+
+        if (this->interactive_) {
+            // Print the path to the loaded table
+            fmt::print("Loaded: {}\n", this->table_.get_filepath().string());
+
+            // Print the list of channels before the main loop
+            print_channel_names(this->table_.get_channels());
+        }
+
+        // Start main shell-like loop, using the UNIX-like prompt
+        const auto flush_if_dirty = [this]() {
+            // A file that another program left malformed is reported, and the changes wait in the journal until it is fixed
+            try {
+                this->table_.flush();
+            }
+            catch (const std::runtime_error &e) {
+                this->fail(ExitCode::Failure, e.what());
+            }
+        };
+        while (const std::optional<std::string> input = this->read("[yt-table] $ ", flush_if_dirty)) {
+            modules::disk::Table::Batch command(this->table_);
+            const bool keep_going = this->execute(*input);
+            command.commit();
+            if (!keep_going) {
+                break;
+            }
+        }
+        batch.commit();
+        return this->status_;
+    }
+
+  private:
+    /**
+     * @brief Table to run the commands against.
+     */
+    modules::disk::Table &table_;
+
+    /**
+     * @brief Whether to print prompts and results.
+     */
+    const bool interactive_;
+
+    /**
+     * @brief Number of lines read so far, used in script error messages.
+     */
+    std::size_t line_number_ = 0;
+
+    /**
+     * @brief Exit code of the first failed command.
+     */
+    ExitCode status_ = ExitCode::Success;
+
+    /**
+     * @brief Read the next non-empty line.
+     *
+     * @param prompt Prompt to display before the input, if interactive (e.g., "Enter name: ").
+     * @param on_idle Function to call once if no input arrives within "autosave_delay", if interactive (default: none).
+     *
+     * @return Trimmed line, or std::nullopt at the end of a script. Lines starting with "#" are skipped in scripts.
+     *
+     * @throws std::runtime_error If an I/O error occurs, or if the interactive input ends (EOF).
+     */
+    [[nodiscard]] std::optional<std::string> read(const std::string &prompt,
+                                                  const std::function<void()> &on_idle = nullptr)
+    {
+        if (this->interactive_) {
+            return get_input(prompt, on_idle);
+        }
+        std::string line;
+        while (std::getline(std::cin, line)) {
+            ++this->line_number_;
+            line = core::strings::trim_whitespace(line);
+            if (!line.empty() && line.front() != '#') {
+                return line;
+            }
+        }
+        if (!std::cin.eof()) {
+            throw std::runtime_error("I/O error while reading the script");
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * @brief Print the result of a successful command, if interactive.
+     *
+     * @param message Result (e.g., "Channel 'Noriyaro' added").
+     */
+    void report(const std::string &message) const
+    {
+        if (this->interactive_) {
+            fmt::print("{}\n", message);
+        }
+    }
+
+    /**
+     * @brief Report a failed command. In script mode, the message goes to stderr, and the first failure sets the exit code.
+     *
+     * @param code Exit code of the failure (e.g., "ExitCode::NotFound").
+     * @param message Description of the failure (e.g., "Channel 'Noriyaro' not found").
+     */
+    void fail(const ExitCode code,
+              const std::string &message)
+    {
+        if (this->interactive_) {
+            fmt::print("{}\n", message);
+            return;
+        }
+        fmt::print(stderr, "line {}: {}\n", this->line_number_, message);
+        if (this->status_ == ExitCode::Success) {
+            this->status_ = code;
+        }
+    }
+
+    /**
+     * @brief Pick up the changes made to the file by other programs, reporting them if interactive.
+     *
+     * @return True if the table matches the file, false if the changed file cannot be loaded (e.g., it is malformed), in which case the command must not run.
+     */
+    [[nodiscard]] bool refresh()
+    {
+        try {
+            if (this->table_.refresh()) {
+                this->report(fmt::format("Reloaded {}, which was changed by another program ({} channels)", this->table_.get_filepath().string(), this->table_.get_channels().size()));
+            }
+            return true;
+        }
+        catch (const std::runtime_error &e) {
+            this->fail(ExitCode::Failure, fmt::format("{}; fix the file, then try again", e.what()));
+            return false;
+        }
+    }
+
+    /**
+     * @brief Add a channel, reporting duplicates.
+     *
+     * @param channel Channel to add.
+     */
+    void add(const core::io::Channel &channel)
+    {
+        // Reject the same channel under a different spelling of its link
+        if (this->table_.add(channel)) {
+            this->report(fmt::format("Channel '{}' added", channel.name));
+        }
+        else {
+            this->fail(ExitCode::Duplicate, fmt::format("Channel '{}' not added, its link is already in the table", channel.name));
+        }
+    }
+
+    /**
+     * @brief Run a single command.
+     *
+     * @param input Trimmed command line (e.g., "remove Noriyaro").
+     *
+     * @return False if the shell should stop (i.e., on "exit" or at the end of a script), true otherwise.
+     */
+    [[nodiscard]] bool execute(const std::string &input)
+    {
+        // Split the command from its inline argument (e.g., "remove Noriyaro")
+        const std::size_t space = input.find_first_of(" \t");
+        const std::string command = input.substr(0, space);
+        const std::string argument = space == std::string::npos ? "" : core::strings::trim_whitespace(input.substr(space));
+
+        // Let the command see the changes made by other programs; "exit" works even if the changed file is malformed
+        if (command != "exit" && !this->refresh()) {
+            return true;
+        }
 
         // Break the loop
-        if (input == "exit") {
-            break;
+        if (command == "exit") {
+            return false;
         }
         // Show the help message
-        else if (input == "help") {
+        else if (command == "help") {
             fmt::print("Commands:\n"
                        "  help     print this help message\n"
                        "  version  print the version\n"
-                       "  ls       print the list of channels\n"
+                       "  ls       print the list of channels (--offset N, --limit N, --range FIRST-LAST, --fields, --format)\n"
+                       "  find     search channels by name or description, tolerating typos (query)\n"
                        "  open     open the html table in a web browser\n"
                        "  add      add a new channel (name, description, link)\n"
+                       "  paste    add many channels, one per line (name | description | link)\n"
                        "  remove   remove a channel (name)\n"
+                       "  import   add the channels of a .csv, .jsonl or .opml file (path)\n"
+                       "  export   write the table as html, virtual, markdown, csv or json (format, path)\n"
+                       "  layout   print or switch the layout: single, or sharded into one file per letter\n"
+                       "  dedupe   remove channels whose links point to the same channel\n"
+                       "  backups  print the list of backups, newest first\n"
+                       "  restore  replace the table with a backup (number from 'backups')\n"
                        "  exit     exit the program\n");
         }
-        else if (input == "version") {
+        else if (command == "version") {
             fmt::print("yt-table {}\n", PROJECT_VERSION);
         }
-        // Display the list of channels
-        else if (input == "ls") {
-            print_channel_names(table.get_channels());
+        // Display the list of channels, or a slice of it (e.g., "ls --range 1-20 --format compact")
+        else if (command == "ls") {
+            try {
+                print_channels(this->table_.get_channels(), parse_list_options(argument));
+            }
+            catch (const std::invalid_argument &e) {
+                this->fail(ExitCode::Usage, e.what());
+            }
+        }
+        // Display the channels that are most similar to a query (e.g., "find noriyoro")
+        else if (command == "find") {
+            const std::optional<std::string> query = argument.empty() ? this->read("Enter query: ") : argument;
+            if (!query) {
+                this->fail(ExitCode::Usage, "Unexpected end of input in 'find'");
+                return false;
+            }
+            const std::vector<core::search::Match> matches = this->table_.find(*query, find_limit);
+            const core::store::ChannelStore &channels = this->table_.get_channels();
+            fmt::print("\nMatches for '{}' ({}):\n", *query, matches.size());
+            for (const core::search::Match &match : matches) {
+                // Channels may share a name, so the link tells which one matched
+                const std::optional<std::size_t> index = channels.find(match.name, match.link);
+                if (!index) {
+                    continue;
+                }
+                fmt::print("  Name: {}\n"
+                           "  Link: {}\n"
+                           "  Description: {}\n"
+                           "  Similarity: {:.0f}%\n\n",
+                           channels.name(*index), channels.link(*index), channels.description(*index), match.score * 100);
+            }
+            if (matches.empty()) {
+                fmt::print("\n");
+            }
         }
         // Open the HTML table in a web browser
-        else if (input == "open") {
-            fmt::print("Opening: {}\n", table.get_filepath().string());
-            core::shell::open_web_browser(table.get_filepath().string());
+        else if (command == "open") {
+            // The browser must see the latest changes
+            this->table_.flush();
+            this->report(fmt::format("Opening: {}", this->table_.get_filepath().string()));
+            core::shell::open_web_browser(this->table_.get_filepath().string());
         }
-        // Add a new channel
-        else if (input == "add") {
-            const std::string name = get_input("Enter name: ");
-            const std::string description = get_input("Enter description: ");
-            const std::string link = get_input("Enter link: ");
-
-            table.add(core::io::Channel{name, link, description});
-
-            fmt::print("Channel '{}' added\n", name);
+        // Add a new channel, either inline ("add name | description | link") or on the following lines
+        else if (command == "add") {
+            core::io::Channel channel{"", "", ""};
+            if (!argument.empty()) {
+                if (!parse_pasted_channel(argument, channel)) {
+                    this->fail(ExitCode::Usage, fmt::format("Invalid channel: {}", argument));
+                    return true;
+                }
+            }
+            else {
+                const std::optional<std::string> name = this->read("Enter name: ");
+                const std::optional<std::string> description = name ? this->read("Enter description: ") : std::nullopt;
+                const std::optional<std::string> link = description ? this->read("Enter link: ") : std::nullopt;
+                if (!link) {
+                    this->fail(ExitCode::Usage, "Unexpected end of input in 'add'");
+                    return false;
+                }
+                channel = core::io::Channel{*name, *link, *description};
+            }
+            this->add(channel);
+        }
+        // Add many channels at once
+        else if (command == "paste") {
+            if (this->interactive_) {
+                fmt::print("Paste channels, one per line (name | description | link), then an empty line:\n");
+            }
+            std::size_t added = 0;
+            std::size_t duplicates = 0;
+            std::string line;
+            while (std::getline(std::cin, line)) {
+                ++this->line_number_;
+                line = core::strings::trim_whitespace(line);
+                if (line.empty()) {
+                    break;
+                }
+                core::io::Channel channel{"", "", ""};
+                if (!parse_pasted_channel(line, channel)) {
+                    this->fail(ExitCode::Usage, fmt::format("Skipped invalid line: {}", line));
+                    continue;
+                }
+                if (!this->table_.add(channel)) {
+                    this->fail(ExitCode::Duplicate, fmt::format("Skipped duplicate channel: {}", channel.name));
+                    ++duplicates;
+                    continue;
+                }
+                ++added;
+            }
+            // Write the whole paste with a single save; scripts save once at the end anyway
+            if (this->interactive_) {
+                this->table_.flush();
+            }
+            this->report(fmt::format("Added {} channels, skipped {} duplicates", added, duplicates));
         }
-        // Remove a channel
-        else if (input == "remove") {
-            std::string name = get_input("Enter name: ");
+        // Remove a channel, either inline ("remove name") or on the following line
+        else if (command == "remove") {
+            const std::optional<std::string> name = argument.empty() ? this->read("Enter name: ") : argument;
+            if (!name) {
+                this->fail(ExitCode::Usage, "Unexpected end of input in 'remove'");
+                return false;
+            }
 
             // If the channel was found, remove it
-            if (table.remove(name)) {
-                fmt::print("Channel '{}' removed\n", name);
+            if (this->table_.remove(*name)) {
+                this->report(fmt::format("Channel '{}' removed", *name));
             }
             else {
-                fmt::print("Channel '{}' not found\n", name);
+                this->fail(ExitCode::NotFound, fmt::format("Channel '{}' not found", *name));
+            }
+        }
+        // Add the channels of a subscription export (e.g., "import ~/subscriptions.csv")
+        else if (command == "import") {
+            const std::optional<std::string> file = argument.empty() ? this->read("Enter path: ") : argument;
+            if (!file) {
+                this->fail(ExitCode::Usage, "Unexpected end of input in 'import'");
+                return false;
+            }
+
+            // Show progress on large files, updating only when the percentage changes
+            std::uintmax_t shown = 101;
+            const auto show_progress = [&shown](const core::import::Progress &progress) {
+                const std::uintmax_t percent = progress.total_bytes == 0 ? 100 : progress.bytes_read * 100 / progress.total_bytes;
+                if (percent != shown) {
+                    shown = percent;
+                    fmt::print("\rImporting: {}% ({} records)", percent, progress.records);
+                    std::fflush(stdout);
+                }
+            };
+            ImportSummary summary;
+            try {
+                summary = import_channels(
+                    this->table_, *file,
+                    [this](const ExitCode code, const std::string &message) {
+                        this->fail(code, message);
+                    },
+                    this->interactive_ ? std::function<void(const core::import::Progress &)>(show_progress) : nullptr);
+            }
+            catch (const std::runtime_error &e) {
+                // A missing or unreadable file should not end the shell; records added before the error are kept
+                this->fail(ExitCode::Failure, e.what());
+            }
+            if (this->interactive_) {
+                fmt::print("\r");
+                this->table_.flush();
+            }
+            this->report(fmt::format("Added {} channels, skipped {} duplicates and {} invalid records", summary.added, summary.duplicates, summary.invalid));
+        }
+        // Write the table in another format (e.g., "export md ~/subscriptions.md")
+        else if (command == "export") {
+            const std::size_t separator = argument.find_first_of(" \t");
+            const std::string format_name = argument.substr(0, separator);
+            const std::string file = separator == std::string::npos ? "" : core::strings::trim_whitespace(argument.substr(separator));
+            const std::optional<core::render::Format> format = core::render::parse_format(format_name);
+            if (!format || file.empty()) {
+                this->fail(ExitCode::Usage, fmt::format("Usage: export html|virtual|markdown|csv|json PATH, got: {}", input));
+                return true;
+            }
+            try {
+                core::io::write_file(file, core::render::render(this->table_.get_channels(), *format));
+                this->report(fmt::format("Exported {} channels to: {}", this->table_.get_channels().size(), file));
+            }
+            catch (const std::runtime_error &e) {
+                this->fail(ExitCode::Failure, e.what());
+            }
+        }
+        // Switch between a single file and one file per leading letter (e.g., "layout sharded"), or print the current layout
+        else if (command == "layout") {
+            if (argument.empty()) {
+                fmt::print("Layout: {}\n", this->table_.is_sharded() ? "sharded" : "single");
+                return true;
+            }
+            if (argument != "single" && argument != "sharded") {
+                this->fail(ExitCode::Usage, fmt::format("Usage: layout [single|sharded], got: {}", input));
+                return true;
+            }
+            try {
+                this->table_.set_sharded(argument == "sharded");
+                this->report(fmt::format("Switched to the {} layout: {}", argument, this->table_.get_filepath().string()));
+            }
+            catch (const std::runtime_error &e) {
+                this->fail(ExitCode::Failure, e.what());
+            }
+        }
+        // Remove channels whose links point to the same channel
+        else if (command == "dedupe") {
+            const std::size_t removed = this->table_.dedupe();
+            this->report(fmt::format("Removed {} duplicate channels", removed));
+        }
+        // Display the list of backups, numbered for "restore"
+        else if (command == "backups") {
+            const std::vector<core::backup::Generation> generations = core::backup::list(this->table_.get_filepath());
+            fmt::print("Backups ({}):\n", generations.size());
+            for (std::size_t i = 0; i < generations.size(); ++i) {
+                fmt::print("  {:>2}  {}  {} bytes\n", i + 1, core::backup::format_time(generations[i].time), generations[i].size);
+            }
+        }
+        // Replace the table with a backup (e.g., "restore 2")
+        else if (command == "restore") {
+            const std::optional<std::string> text = argument.empty() ? this->read("Enter backup number: ") : argument;
+            if (!text) {
+                this->fail(ExitCode::Usage, "Unexpected end of input in 'restore'");
+                return false;
+            }
+            std::size_t number = 0;
+            const auto [end, error] = std::from_chars(text->data(), text->data() + text->size(), number);
+            if (error != std::errc() || end != text->data() + text->size()) {
+                this->fail(ExitCode::Usage, fmt::format("Invalid backup number: {}", *text));
+                return true;
+            }
+            try {
+                const core::backup::Generation generation = this->table_.restore(number);
+                this->report(fmt::format("Restored the backup from {} ({} channels)", core::backup::format_time(generation.time), this->table_.get_channels().size()));
+            }
+            catch (const std::runtime_error &e) {
+                this->fail(ExitCode::NotFound, e.what());
             }
         }
         // Unknown command
         else {
-            fmt::print("Unknown command: {}\n", input);
+            this->fail(ExitCode::Usage, fmt::format("Unknown command: {}", input));
+        }
+        return true;
+    }
+};
+
+}  // namespace
+
+void format_channels(std::string &buffer,
+                     const core::store::ChannelStore &channels,
+                     const core::args::ListOptions &options)
+{
+    // Only the channels of the slice are visited, by their position in the store
+    const std::size_t size = channels.size();
+    const std::size_t first = options.offset < size ? options.offset : size;
+    const std::size_t count = options.limit && *options.limit < size - first ? *options.limit : size - first;
+    const std::size_t last = first + count;
+    const auto get_field = [&channels](const core::args::Field field,
+                                       const std::size_t index) {
+        switch (field) {
+        case core::args::Field::Name:
+            return channels.name(index);
+        case core::args::Field::Link:
+            return channels.link(index);
+        case core::args::Field::Description:
+            return channels.description(index);
+        }
+        return std::string_view();
+    };
+    const auto append_fields = [&buffer, &options, &get_field](const std::size_t index,
+                                                               const std::string_view separator) {
+        for (std::size_t i = 0; i < options.fields.size(); ++i) {
+            if (i > 0) {
+                buffer.append(separator);
+            }
+            buffer.append(get_field(options.fields[i], index));
+        }
+        buffer.push_back('\n');
+    };
+
+    switch (options.format) {
+    case core::args::ListFormat::Text:
+        if (count == size) {
+            fmt::format_to(std::back_inserter(buffer), "\nChannels ({}):\n", size);
+        }
+        else if (count == 0) {
+            fmt::format_to(std::back_inserter(buffer), "\nChannels (0 of {}):\n", size);
+        }
+        else {
+            fmt::format_to(std::back_inserter(buffer), "\nChannels {}-{} of {}:\n", first + 1, last, size);
+        }
+        for (std::size_t index = first; index < last; ++index) {
+            for (const core::args::Field field : options.fields) {
+                buffer.append("  ");
+                buffer.append(field_labels[static_cast<std::size_t>(field)]);
+                buffer.append(": ");
+                buffer.append(get_field(field, index));
+                buffer.push_back('\n');
+            }
+            buffer.push_back('\n');
+        }
+        // If empty, print a newline, otherwise, the last channel will have a trailing newline
+        if (count == 0) {
+            buffer.push_back('\n');
+        }
+        break;
+    case core::args::ListFormat::Names:
+        for (std::size_t index = first; index < last; ++index) {
+            buffer.append(channels.name(index));
+            buffer.push_back('\n');
+        }
+        break;
+    case core::args::ListFormat::Tsv:
+        for (std::size_t index = first; index < last; ++index) {
+            append_fields(index, "\t");
+        }
+        break;
+    case core::args::ListFormat::Compact: {
+        // Right-align the numbers, so that the fields line up
+        const std::size_t width = fmt::formatted_size("{}", last);
+        for (std::size_t index = first; index < last; ++index) {
+            fmt::format_to(std::back_inserter(buffer), "{:>{}}  ", index + 1, width);
+            append_fields(index, " | ");
+        }
+        break;
+    }
+    }
+}
+
+void print_channels(const core::store::ChannelStore &channels,
+                    const core::args::ListOptions &options,
+                    std::FILE *output)
+{
+    std::string buffer;
+    format_channels(buffer, channels, options);
+    // Page the list if a person is reading it, otherwise write it at once
+    if (output == stdout && is_stdout_terminal() && is_stdin_terminal()) {
+        page(buffer);
+    }
+    else {
+        std::fwrite(buffer.data(), 1, buffer.size(), output);
+    }
+}
+
+void print_channel_names(const core::store::ChannelStore &channels,
+                         std::FILE *output)
+{
+    print_channels(channels, core::args::ListOptions{}, output);
+}
+
+ExitCode run(const core::args::Args &args)
+{
+    // The HTML table lives in a platform-specific directory
+    const std::filesystem::path path = core::paths::get_resources_directory("yt-table") / "subscriptions.html";
+
+    switch (args.get_command()) {
+    case core::args::Command::Add: {
+        // A one-off command leaves the file up to date, since nothing else would compact the journal
+        modules::disk::Table table(path);
+        modules::disk::Table::Batch batch(table);
+        if (!table.add(core::io::Channel{args.get_name(), args.get_link(), args.get_description()})) {
+            fmt::print(stderr, "Channel '{}' not added, its link is already in the table\n", args.get_name());
+            return ExitCode::Duplicate;
+        }
+        batch.commit();
+        return ExitCode::Success;
+    }
+    case core::args::Command::Remove: {
+        modules::disk::Table table(path);
+        modules::disk::Table::Batch batch(table);
+        if (!table.remove(args.get_name())) {
+            fmt::print(stderr, "Channel '{}' not found\n", args.get_name());
+            return ExitCode::NotFound;
+        }
+        batch.commit();
+        return ExitCode::Success;
+    }
+    case core::args::Command::List: {
+        const modules::disk::Table table(path);
+        print_channels(table.get_channels(), args.get_list_options());
+        return ExitCode::Success;
+    }
+    case core::args::Command::Render: {
+        const modules::disk::Table table(path);
+        const std::string document = core::render::render(table.get_channels(), args.get_render_format());
+        if (args.get_output() == "-") {
+            std::fwrite(document.data(), 1, document.size(), stdout);
+        }
+        else {
+            core::io::write_file(args.get_output(), document);
         }
+        return ExitCode::Success;
+    }
+    case core::args::Command::Import: {
+        modules::disk::Table table(path);
+        modules::disk::Table::Batch batch(table);
+        ExitCode status = ExitCode::Success;
+        const ImportSummary summary = import_channels(table, args.get_input(), [&status](const ExitCode code, const std::string &message) {
+            fmt::print(stderr, "{}\n", message);
+            if (status == ExitCode::Success) {
+                status = code;
+            }
+        });
+        batch.commit();
+        fmt::print("Added {} channels, skipped {} duplicates and {} invalid records\n", summary.added, summary.duplicates, summary.invalid);
+        return status;
     }
+    case core::args::Command::Serve: {
+        modules::disk::Table table(path);
+        table.watch();
+        modules::web::Server server(table.get_channels(), args.get_port());
+        fmt::print("Serving {} at http://127.0.0.1:{}/ (press Ctrl+C to stop)\n", path.string(), server.get_port());
+        std::fflush(stdout);
+        serve(table, server);
+    }
+    case core::args::Command::Shell:
+        break;
+    }
+
+    // Without a command, run the shell, without prompts if stdin is a script
+    modules::disk::Table table(path);
+    Shell shell(table, is_stdin_terminal());
+    return shell.run();
 }
 
 }  // namespace app
@@ -6,11 +6,99 @@
 
 #pragma once
 
+#include <cstdio>  // for std::FILE, stdout
+#include <string>  // for std::string
+
+#include "core/args.hpp"
+#include "core/store.hpp"
+
 namespace app {
 
+/**
+ * @brief Format a slice of the channels as the "ls" command prints it.
+ *
+ * Only the channels in the slice are visited, so formatting a page of a large table costs as much as the page, not the table.
+ *
+ * In the text format, the function first adds a leading newline, then the number of channels (or the numbers of the first and last channel of a partial slice), and then the selected fields of each channel and a trailing newline.
+ *
+ * @param buffer Buffer to append to.
+ * @param channels Store of YouTube channels.
+ * @param options Slice, fields and format to use (e.g., "--range 1-20 --format compact").
+ */
+void format_channels(std::string &buffer,
+                     const core::store::ChannelStore &channels,
+                     const core::args::ListOptions &options);
+
+/**
+ * @brief Print a slice of the channels as the "ls" command does.
+ *
+ * The output is formatted into a single buffer and written at once. If the output is stdout, and both stdin and stdout are terminals, it is shown one screen at a time instead, waiting for Enter between screens ("q" quits).
+ *
+ * @param channels Store of YouTube channels.
+ * @param options Slice, fields and format to use (see "format_channels").
+ * @param output Stream to print to (default: stdout).
+ */
+void print_channels(const core::store::ChannelStore &channels,
+                    const core::args::ListOptions &options,
+                    std::FILE *output = stdout);
+
+/**
+ * @brief Print the names of the channels.
+ *
+ * The function will first print a leading newline, then the number of channels, and then each channel's name, link, description, and a trailing newline (see "print_channels").
+ *
+ * @param channels Store of YouTube channels.
+ * @param output Stream to print to (default: stdout).
+ */
+void print_channel_names(const core::store::ChannelStore &channels,
+                         std::FILE *output = stdout);
+
+/**
+ * @brief Exit codes of the application, so that scripts can tell failures apart.
+ */
+enum class ExitCode : int {
+    /**
+     * @brief Every command succeeded.
+     */
+    Success = 0,
+
+    /**
+     * @brief An error occurred (e.g., the table cannot be read or written).
+     */
+    Failure = 1,
+
+    /**
+     * @brief Invalid command-line arguments, or an invalid command in a script.
+     */
+    Usage = 2,
+
+    /**
+     * @brief The channel to remove was not found.
+     */
+    NotFound = 3,
+
+    /**
+     * @brief The channel to add is already in the table.
+     */
+    Duplicate = 4,
+
+    /**
+     * @brief A record of the imported file is invalid (e.g., it has no link).
+     */
+    Invalid = 5,
+};
+
 /**
  * @brief Run the application.
+ *
+ * Without a command, run the shell. If stdin is a terminal, the shell is interactive. Otherwise, commands are read from stdin without prompts, and every change is written with a single save at the end.
+ *
+ * @param args Parsed command-line arguments.
+ *
+ * @return Exit code (e.g., "ExitCode::NotFound" if "remove" did not find the channel). In script mode, this is the exit code of the first failed command; the remaining commands still run.
+ *
+ * @throws std::runtime_error If the table cannot be loaded or written, or if the interactive input ends (EOF).
  */
-void run();
+[[nodiscard]] ExitCode run(const core::args::Args &args);
 
 }  // namespace app
@@ -2,50 +2,344 @@
  * @file args.cpp
  */
 
-#include <string>  // for std::string
+#include <charconv>      // for std::from_chars
+#include <cstddef>       // for std::size_t
+#include <cstdint>       // for std::uint16_t
+#include <limits>        // for std::numeric_limits
+#include <optional>      // for std::optional
+#include <stdexcept>     // for std::invalid_argument
+#include <string>        // for std::string
+#include <string_view>   // for std::string_view
+#include <system_error>  // for std::errc
+#include <utility>       // for std::move
+#include <vector>        // for std::vector
 
 #include <fmt/core.h>
 
 #include "args.hpp"
+#include "render.hpp"
+#include "strings.hpp"
 #include "version.hpp"
 
 namespace core::args {
 
+namespace {
+
+/**
+ * @brief Private helper variable that contains the formatted help message.
+ */
+constexpr std::string_view help_message =
+    "Usage: yt-table [-h] [-v] [command [options]]\n"
+    "\n"
+    "Manage YouTube subscriptions locally through a shell-like interface.\n"
+    "Without a command, start the shell. If stdin is not a terminal, read the shell commands from stdin without prompts, and save once at the end.\n"
+    "\n"
+    "Commands:\n"
+    "  add --name NAME --link LINK --desc DESCRIPTION  add a channel\n"
+    "  remove --name NAME                              remove a channel\n"
+    "  ls [--format text|names|tsv|compact]            print the list of channels\n"
+    "     [--offset N] [--limit N]                     only print a slice of the list\n"
+    "     [--range FIRST-LAST]                         only print channels FIRST to LAST, numbered from 1\n"
+    "     [--fields name,link,desc]                    only print these fields, in this order\n"
+    "  render [--format FORMAT] [PATH|-]               write the table to a file, or to stdout (default)\n"
+    "                                                  as html (default), virtual, markdown (or md), csv or json\n"
+    "  import PATH                                     add the channels of a .csv, .jsonl or .opml file\n"
+    "  serve [--port N]                                serve the table at http://127.0.0.1:N/ (default: 8080),\n"
+    "                                                  reloading the page when the table changes\n"
+    "\n"
+    "Optional arguments:\n"
+    "  -h, --help     prints help message and exits\n"
+    "  -v, --version  prints version and exits\n"
+    "\n"
+    "Exit codes:\n"
+    "  0  success\n"
+    "  1  error (e.g., the table cannot be read or written)\n"
+    "  2  invalid arguments or script command\n"
+    "  3  channel not found\n"
+    "  4  channel already in the table\n"
+    "  5  invalid record in the imported file\n";
+
+/**
+ * @brief Private helper function to build an error that includes the help message.
+ *
+ * @param message Description of the error (e.g., "Invalid argument: hello").
+ *
+ * @return Error to throw.
+ */
+[[nodiscard]] ArgsError make_error(const std::string &message)
+{
+    return ArgsError(fmt::format("Error: {}\n\n{}", message, help_message));
+}
+
+/**
+ * @brief Private helper function to parse a non-negative number.
+ *
+ * @param text Text to parse (e.g., "20").
+ *
+ * @return Parsed number, or std::nullopt if the text is not a number.
+ */
+[[nodiscard]] std::optional<std::size_t> parse_number(const std::string_view text)
+{
+    std::size_t number = 0;
+    const char *end = text.data() + text.size();
+    const auto [ptr, ec] = std::from_chars(text.data(), end, number);
+    if (text.empty() || ec != std::errc() || ptr != end) {
+        return std::nullopt;
+    }
+    return number;
+}
+
+}  // namespace
+
+bool parse_list_option(ListOptions &options,
+                       const std::string_view key,
+                       const std::string_view value)
+{
+    if (key == "--format") {
+        if (value == "text") {
+            options.format = ListFormat::Text;
+        }
+        else if (value == "names") {
+            options.format = ListFormat::Names;
+        }
+        else if (value == "tsv") {
+            options.format = ListFormat::Tsv;
+        }
+        else if (value == "compact") {
+            options.format = ListFormat::Compact;
+        }
+        else {
+            throw std::invalid_argument(fmt::format("Invalid format: {}", value));
+        }
+    }
+    else if (key == "--offset" || key == "--limit") {
+        const std::optional<std::size_t> number = parse_number(value);
+        if (!number) {
+            throw std::invalid_argument(fmt::format("Invalid number for {}: {}", key, value));
+        }
+        if (key == "--offset") {
+            options.offset = *number;
+        }
+        else {
+            options.limit = *number;
+        }
+    }
+    else if (key == "--range") {
+        const std::size_t dash = value.find('-');
+        const std::optional<std::size_t> first = parse_number(value.substr(0, dash));
+        const std::optional<std::size_t> last = dash == std::string_view::npos ? std::nullopt : parse_number(value.substr(dash + 1));
+        if (!first || !last || *first == 0 || *last < *first) {
+            throw std::invalid_argument(fmt::format("Invalid range: {}", value));
+        }
+        options.offset = *first - 1;
+        options.limit = *last - *first + 1;
+    }
+    else if (key == "--fields") {
+        std::vector<Field> fields;
+        std::size_t begin = 0;
+        while (true) {
+            const std::size_t comma = value.find(',', begin);
+            const std::string_view field = value.substr(begin, comma - begin);
+            if (field == "name") {
+                fields.push_back(Field::Name);
+            }
+            else if (field == "link") {
+                fields.push_back(Field::Link);
+            }
+            else if (field == "desc" || field == "description") {
+                fields.push_back(Field::Description);
+            }
+            else {
+                throw std::invalid_argument(fmt::format("Invalid field: {}", field));
+            }
+            if (comma == std::string_view::npos) {
+                break;
+            }
+            begin = comma + 1;
+        }
+        options.fields = std::move(fields);
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
 Args::Args(const int argc,
            char **argv)
 {
-    // If no arguments, do nothing
+    // If no arguments, run the shell
     if (argc == 1) {
         return;
     }
-    // If one or more arguments
+
+    // Get the first argument as a string
+    const std::string arg = argv[1];
+
+    if (arg == "-h" || arg == "--help") {
+        // If "-h" or "--help" is passed as the first argument, throw ArgsMessage with the help message
+        throw ArgsMessage(std::string(help_message));
+    }
+    else if (arg == "-v" || arg == "--version") {
+        // If "-v" or "--version" is passed as the first argument, throw ArgsMessage with the version
+        throw ArgsMessage(fmt::format("{}", PROJECT_VERSION));
+    }
+    else if (arg == "add") {
+        this->command_ = Command::Add;
+    }
+    else if (arg == "remove") {
+        this->command_ = Command::Remove;
+    }
+    else if (arg == "ls") {
+        this->command_ = Command::List;
+    }
+    else if (arg == "render") {
+        this->command_ = Command::Render;
+    }
+    else if (arg == "import") {
+        this->command_ = Command::Import;
+    }
+    else if (arg == "serve") {
+        this->command_ = Command::Serve;
+    }
     else {
-        // Define the formatted help message
-        const std::string help_message =
-            "Usage: yt-table [-h] [-v]\n"
-            "\n"
-            "Manage YouTube subscriptions locally through a shell-like interface.\n"
-            "\n"
-            "Optional arguments:\n"
-            "  -h, --help     prints help message and exits\n"
-            "  -v, --version  prints version and exits\n";
-
-        // Get the first argument as a string
-        const std::string arg = argv[1];
-
-        if (arg == "-h" || arg == "--help") {
-            // If "-h" or "--help" is passed as the first argument, throw ArgsMessage with the help message
-            throw ArgsMessage(help_message);
-        }
-        else if (arg == "-v" || arg == "--version") {
-            // If "-v" or "--version" is passed as the first argument, throw ArgsMessage with the version
-            throw ArgsMessage(fmt::format("{}", PROJECT_VERSION));
+        // Otherwise, throw ArgsError with the help message
+        throw make_error(fmt::format("Invalid argument: {}", arg));
+    }
+
+    // Parse the options of the command
+    bool has_path = false;
+    for (int i = 2; i < argc; ++i) {
+        const std::string option = argv[i];
+        if (option == "-h" || option == "--help") {
+            throw ArgsMessage(std::string(help_message));
+        }
+
+        // Positional argument, only accepted by "render" and "import"
+        if (option.size() < 2 || option.compare(0, 2, "--") != 0) {
+            if ((this->command_ != Command::Render && this->command_ != Command::Import) || has_path) {
+                throw make_error(fmt::format("Unexpected argument for '{}': {}", arg, option));
+            }
+            (this->command_ == Command::Render ? this->output_ : this->input_) = option;
+            has_path = true;
+            continue;
+        }
+
+        // Split "--key=value", or take the value from the next argument
+        const std::size_t equals = option.find('=');
+        const std::string key = option.substr(0, equals);
+        std::string value;
+        if (equals != std::string::npos) {
+            value = option.substr(equals + 1);
+        }
+        else if (i + 1 < argc) {
+            value = argv[++i];
         }
         else {
-            // Otherwise, throw ArgsError with the help message
-            throw ArgsError(fmt::format("Error: Invalid argument: {}\n\n{}", arg, help_message));
+            throw make_error(fmt::format("Missing value for option: {}", key));
+        }
+
+        if (key == "--name" && (this->command_ == Command::Add || this->command_ == Command::Remove)) {
+            this->name_ = strings::trim_whitespace(value);
         }
+        else if (key == "--link" && this->command_ == Command::Add) {
+            this->link_ = strings::trim_whitespace(value);
+        }
+        else if (key == "--desc" && this->command_ == Command::Add) {
+            this->description_ = strings::trim_whitespace(value);
+        }
+        else if (this->command_ == Command::List) {
+            try {
+                if (!parse_list_option(this->list_options_, key, value)) {
+                    throw make_error(fmt::format("Invalid option for '{}': {}", arg, key));
+                }
+            }
+            catch (const std::invalid_argument &e) {
+                throw make_error(e.what());
+            }
+        }
+        else if (key == "--format" && this->command_ == Command::Render) {
+            const std::optional<render::Format> format = render::parse_format(value);
+            if (!format) {
+                throw make_error(fmt::format("Invalid format: {}", value));
+            }
+            this->render_format_ = *format;
+        }
+        else if (key == "--port" && this->command_ == Command::Serve) {
+            const std::optional<std::size_t> port = parse_number(value);
+            if (!port || *port > std::numeric_limits<std::uint16_t>::max()) {
+                throw make_error(fmt::format("Invalid port: {}", value));
+            }
+            this->port_ = static_cast<std::uint16_t>(*port);
+        }
+        else {
+            throw make_error(fmt::format("Invalid option for '{}': {}", arg, key));
+        }
+    }
+
+    // Check that every required option was given
+    if ((this->command_ == Command::Add || this->command_ == Command::Remove) && this->name_.empty()) {
+        throw make_error(fmt::format("Missing option for '{}': --name", arg));
+    }
+    if (this->command_ == Command::Add && this->link_.empty()) {
+        throw make_error("Missing option for 'add': --link");
+    }
+    if (this->command_ == Command::Add && this->description_.empty()) {
+        throw make_error("Missing option for 'add': --desc");
+    }
+    if (this->command_ == Command::Import && this->input_.empty()) {
+        throw make_error("Missing argument for 'import': PATH");
     }
 }
 
+Command Args::get_command() const
+{
+    return this->command_;
+}
+
+const std::string &Args::get_name() const
+{
+    return this->name_;
+}
+
+const std::string &Args::get_link() const
+{
+    return this->link_;
+}
+
+const std::string &Args::get_description() const
+{
+    return this->description_;
+}
+
+ListFormat Args::get_format() const
+{
+    return this->list_options_.format;
+}
+
+const ListOptions &Args::get_list_options() const
+{
+    return this->list_options_;
+}
+
+render::Format Args::get_render_format() const
+{
+    return this->render_format_;
+}
+
+const std::string &Args::get_output() const
+{
+    return this->output_;
+}
+
+const std::string &Args::get_input() const
+{
+    return this->input_;
+}
+
+std::uint16_t Args::get_port() const
+{
+    return this->port_;
+}
+
 }  // namespace core::args
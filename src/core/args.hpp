@@ -6,7 +6,15 @@
 
 #pragma once
 
-#include <stdexcept>  // for std::runtime_error
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint16_t
+#include <optional>     // for std::optional
+#include <stdexcept>    // for std::runtime_error
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+#include <vector>       // for std::vector
+
+#include "render.hpp"
 
 namespace core::args {
 
@@ -34,10 +42,146 @@ class ArgsError final : public std::runtime_error {
     using std::runtime_error::runtime_error;
 };
 
+/**
+ * @brief Command selected on the command line.
+ */
+enum class Command {
+    /**
+     * @brief No command; run the interactive shell, or the script read from stdin if it is not a terminal.
+     */
+    Shell,
+
+    /**
+     * @brief Add a channel ("add --name NAME --link LINK --desc DESCRIPTION").
+     */
+    Add,
+
+    /**
+     * @brief Remove a channel ("remove --name NAME").
+     */
+    Remove,
+
+    /**
+     * @brief Print the list of channels ("ls [--format FORMAT] [--offset N] [--limit N] [--range FIRST-LAST] [--fields FIELDS]").
+     */
+    List,
+
+    /**
+     * @brief Write the table to a file or to stdout ("render [--format FORMAT] [PATH|-]").
+     */
+    Render,
+
+    /**
+     * @brief Add the channels of a subscription export ("import PATH").
+     */
+    Import,
+
+    /**
+     * @brief Serve the table to a web browser on the loopback interface, reloading it on changes ("serve [--port N]").
+     */
+    Serve,
+};
+
+/**
+ * @brief Output format of the "ls" command.
+ */
+enum class ListFormat {
+    /**
+     * @brief Same output as the shell's "ls" command.
+     */
+    Text,
+
+    /**
+     * @brief One name per line.
+     */
+    Names,
+
+    /**
+     * @brief One channel per line, as "name<TAB>link<TAB>description".
+     */
+    Tsv,
+
+    /**
+     * @brief One channel per line, numbered, as "number  name | link | description".
+     */
+    Compact,
+};
+
+/**
+ * @brief Field of a channel that the "ls" command prints.
+ */
+enum class Field {
+    /**
+     * @brief YouTube Channel's name.
+     */
+    Name,
+
+    /**
+     * @brief YouTube Channel's link.
+     */
+    Link,
+
+    /**
+     * @brief YouTube Channel's description.
+     */
+    Description,
+};
+
+/**
+ * @brief Struct that represents the options of the "ls" command, on the command line and in the shell.
+ *
+ * @note This struct is marked as `final` to prevent inheritance.
+ */
+struct ListOptions final {
+    /**
+     * @brief Output format (e.g., "ListFormat::Compact").
+     */
+    ListFormat format = ListFormat::Text;
+
+    /**
+     * @brief Number of channels to skip from the start of the list (e.g., "100").
+     */
+    std::size_t offset = 0;
+
+    /**
+     * @brief Largest number of channels to print (e.g., "20"), or none to print every channel after the offset.
+     */
+    std::optional<std::size_t> limit;
+
+    /**
+     * @brief Fields to print, in order. The "ListFormat::Names" format only prints names.
+     */
+    std::vector<Field> fields = {Field::Name, Field::Link, Field::Description};
+};
+
+/**
+ * @brief Apply a single option of the "ls" command.
+ *
+ * The following options are accepted:
+ * - "--format": "text", "names", "tsv" or "compact".
+ * - "--offset": number of channels to skip (e.g., "100").
+ * - "--limit": largest number of channels to print (e.g., "20").
+ * - "--range": channels to print, numbered from 1, both inclusive (e.g., "101-120"); this sets both the offset and the limit.
+ * - "--fields": comma-separated fields to print, in order (e.g., "name,link"), from "name", "link" and "desc" (or "description").
+ *
+ * @param options Options to update.
+ * @param key Name of the option, including the dashes (e.g., "--limit").
+ * @param value Value of the option (e.g., "20").
+ *
+ * @return True if the option was applied, false if "key" is not an option of the "ls" command.
+ *
+ * @throws std::invalid_argument If the value is invalid for the option.
+ */
+[[nodiscard]] bool parse_list_option(ListOptions &options,
+                                     const std::string_view key,
+                                     const std::string_view value);
+
 /**
  * @brief Class that represents command-line arguments.
  *
- * On construction, the class parses the command-line arguments. If no arguments are provided, the class does nothing. If help or version is requested, the class throws an exception. Similarly, if an error occurs, the class also throws an exception.
+ * On construction, the class parses the command-line arguments. If no arguments are provided, the class selects the shell. If help or version is requested, the class throws an exception. Similarly, if an error occurs, the class also throws an exception.
+ *
+ * Options accept their value either as the next argument or after an equals sign (e.g., "--name Noriyaro" or "--name=Noriyaro").
  *
  * @note This class is marked as `final` to prevent inheritance.
  */
@@ -54,6 +198,122 @@ class Args final {
      */
     explicit Args(const int argc,
                   char **argv);
+
+    /**
+     * @brief Get the selected command.
+     *
+     * @return Command (e.g., "Command::Add").
+     */
+    [[nodiscard]] Command get_command() const;
+
+    /**
+     * @brief Get the channel name given with "--name".
+     *
+     * @return YouTube Channel's name (e.g., "Noriyaro"), or an empty string if not given.
+     */
+    [[nodiscard]] const std::string &get_name() const;
+
+    /**
+     * @brief Get the channel link given with "--link".
+     *
+     * @return YouTube Channel's link (e.g., "https://www.youtube.com/@noriyaro/videos"), or an empty string if not given.
+     */
+    [[nodiscard]] const std::string &get_link() const;
+
+    /**
+     * @brief Get the channel description given with "--desc".
+     *
+     * @return YouTube Channel's description (e.g., "JP Drifting"), or an empty string if not given.
+     */
+    [[nodiscard]] const std::string &get_description() const;
+
+    /**
+     * @brief Get the output format given with "--format".
+     *
+     * @return Output format (default: ListFormat::Text).
+     */
+    [[nodiscard]] ListFormat get_format() const;
+
+    /**
+     * @brief Get the options of the "ls" command, including the output format.
+     *
+     * @return Options of the "ls" command (default: every channel, every field, ListFormat::Text).
+     */
+    [[nodiscard]] const ListOptions &get_list_options() const;
+
+    /**
+     * @brief Get the document format given with "--format" to the "render" command.
+     *
+     * @return Document format (default: render::Format::Html).
+     */
+    [[nodiscard]] render::Format get_render_format() const;
+
+    /**
+     * @brief Get the output path of the "render" command.
+     *
+     * @return Path to write to (e.g., "~/table.html"), or "-" for stdout (default).
+     */
+    [[nodiscard]] const std::string &get_output() const;
+
+    /**
+     * @brief Get the input path of the "import" command.
+     *
+     * @return Path to read from (e.g., "~/subscriptions.csv"), or an empty string if not given.
+     */
+    [[nodiscard]] const std::string &get_input() const;
+
+    /**
+     * @brief Get the TCP port given with "--port" to the "serve" command.
+     *
+     * @return Port (default: 8080), or 0 for any free port.
+     */
+    [[nodiscard]] std::uint16_t get_port() const;
+
+  private:
+    /**
+     * @brief Selected command.
+     */
+    Command command_ = Command::Shell;
+
+    /**
+     * @brief Channel name given with "--name".
+     */
+    std::string name_;
+
+    /**
+     * @brief Channel link given with "--link".
+     */
+    std::string link_;
+
+    /**
+     * @brief Channel description given with "--desc".
+     */
+    std::string description_;
+
+    /**
+     * @brief Options of the "ls" command, including the output format given with "--format".
+     */
+    ListOptions list_options_;
+
+    /**
+     * @brief Document format given with "--format" to the "render" command.
+     */
+    render::Format render_format_ = render::Format::Html;
+
+    /**
+     * @brief Output path of the "render" command.
+     */
+    std::string output_ = "-";
+
+    /**
+     * @brief Input path of the "import" command.
+     */
+    std::string input_;
+
+    /**
+     * @brief TCP port of the "serve" command.
+     */
+    std::uint16_t port_ = 8080;
 };
 
 }  // namespace core::args
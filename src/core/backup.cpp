@@ -0,0 +1,304 @@
+/**
+ * @file backup.cpp
+ */
+
+#include <algorithm>     // for std::sort
+#include <cerrno>        // for errno, EINTR, ENOSYS, EXDEV, EINVAL, EOPNOTSUPP
+#include <charconv>      // for std::from_chars
+#include <chrono>        // for std::chrono
+#include <cstddef>       // for std::size_t
+#include <cstdint>       // for std::int64_t, std::uint64_t
+#include <exception>     // for std::exception
+#include <filesystem>    // for std::filesystem
+#include <optional>      // for std::optional, std::nullopt
+#include <stdexcept>     // for std::runtime_error
+#include <string>        // for std::string
+#include <string_view>   // for std::string_view
+#include <system_error>  // for std::error_code, std::errc
+#include <vector>        // for std::vector
+#if defined(__linux__)
+#include <fcntl.h>          // for open, O_RDONLY, O_WRONLY, O_CREAT, O_TRUNC, O_CLOEXEC
+#include <linux/fs.h>       // for FICLONE
+#include <sys/ioctl.h>      // for ioctl
+#include <sys/types.h>      // for ssize_t
+#include <unistd.h>         // for close, copy_file_range
+#elif defined(__APPLE__)
+#include <sys/clonefile.h>  // for clonefile
+#endif
+
+#include <fmt/core.h>
+
+#include "backup.hpp"
+#include "io.hpp"
+#include "snapshot.hpp"
+
+namespace core::backup {
+
+namespace {
+
+/**
+ * @brief Private helper variable that contains the length of a backup's timestamp (e.g., "20261016-124700-123").
+ */
+constexpr std::size_t timestamp_length = 19;
+
+/**
+ * @brief Private helper variable that contains the length of a backup's hash in hexadecimal (e.g., "1f2e3d4c5b6a7988").
+ */
+constexpr std::size_t hash_length = 16;
+
+/**
+ * @brief Private helper variable that contains the extension of every backup.
+ */
+constexpr std::string_view extension = ".bak";
+
+/**
+ * @brief Private helper variable that contains the number of milliseconds in a day.
+ */
+constexpr std::int64_t milliseconds_per_day = 86'400'000;
+
+/**
+ * @brief Private helper function to format a time as a backup timestamp.
+ *
+ * @param time Time in milliseconds since 1970-01-01 UTC (e.g., "1792154820123").
+ *
+ * @return Timestamp, as "YYYYMMDD-HHMMSS-mmm" in UTC (e.g., "20261016-124700-123"), which sorts like the time itself.
+ */
+[[nodiscard]] std::string to_timestamp(const std::int64_t time)
+{
+    // Split the time into days since 1970-01-01 and milliseconds into the day
+    std::int64_t days = time / milliseconds_per_day;
+    std::int64_t rest = time % milliseconds_per_day;
+    if (rest < 0) {
+        rest += milliseconds_per_day;
+        --days;
+    }
+
+    // Convert the days to a civil date (Howard Hinnant's "civil_from_days"), since C++17 has no calendar
+    days += 719'468;
+    const std::int64_t era = (days >= 0 ? days : days - 146'096) / 146'097;
+    const std::int64_t day_of_era = days - era * 146'097;
+    const std::int64_t year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36'524 - day_of_era / 146'096) / 365;
+    const std::int64_t day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    const std::int64_t shifted_month = (5 * day_of_year + 2) / 153;
+    const std::int64_t day = day_of_year - (153 * shifted_month + 2) / 5 + 1;
+    const std::int64_t month = shifted_month < 10 ? shifted_month + 3 : shifted_month - 9;
+    const std::int64_t year = year_of_era + era * 400 + (month <= 2 ? 1 : 0);
+
+    return fmt::format("{:04}{:02}{:02}-{:02}{:02}{:02}-{:03}", year, month, day, rest / 3'600'000, rest / 60'000 % 60, rest / 1000 % 60, rest % 1000);
+}
+
+/**
+ * @brief Private helper function to parse a backup timestamp.
+ *
+ * @param text Timestamp, as "YYYYMMDD-HHMMSS-mmm" in UTC (e.g., "20261016-124700-123").
+ *
+ * @return Time in milliseconds since 1970-01-01 UTC (e.g., "1792154820123"), or std::nullopt if the text is not a timestamp.
+ */
+[[nodiscard]] std::optional<std::int64_t> parse_timestamp(const std::string_view text)
+{
+    if (text.size() != timestamp_length) {
+        return std::nullopt;
+    }
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        const bool separator = i == 8 || i == 15;
+        if (separator ? text[i] != '-' : (text[i] < '0' || text[i] > '9')) {
+            return std::nullopt;
+        }
+    }
+    const auto number = [text](const std::size_t offset, const std::size_t length) {
+        std::int64_t value = 0;
+        for (std::size_t i = offset; i < offset + length; ++i) {
+            value = value * 10 + (text[i] - '0');
+        }
+        return value;
+    };
+    const std::int64_t year = number(0, 4);
+    const std::int64_t month = number(4, 2);
+    const std::int64_t day = number(6, 2);
+    if (month < 1 || month > 12 || day < 1 || day > 31) {
+        return std::nullopt;
+    }
+
+    // Convert the civil date to days since 1970-01-01 (Howard Hinnant's "days_from_civil")
+    const std::int64_t shifted_year = month <= 2 ? year - 1 : year;
+    const std::int64_t era = shifted_year / 400;
+    const std::int64_t year_of_era = shifted_year - era * 400;
+    const std::int64_t day_of_year = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const std::int64_t day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    const std::int64_t days = era * 146'097 + day_of_era - 719'468;
+
+    return days * milliseconds_per_day + number(9, 2) * 3'600'000 + number(11, 2) * 60'000 + number(13, 2) * 1000 + number(16, 3);
+}
+
+/**
+ * @brief Private helper function to copy a file as cheaply as the platform allows.
+ *
+ * On GNU/Linux, the copy is a reflink (FICLONE) if the filesystem supports it, and an in-kernel "copy_file_range" otherwise. On macOS, it is a "clonefile". Everywhere else, and whenever these fail, it is "std::filesystem::copy_file".
+ *
+ * @param source Path to the file to copy (e.g., "~/data.html").
+ * @param destination Path to the copy, which must not exist (e.g., "~/data.html.tmp").
+ *
+ * @throws std::runtime_error If the file cannot be copied.
+ */
+void copy_contents(const std::filesystem::path &source,
+                   const std::filesystem::path &destination)
+{
+#if defined(__linux__)
+    const int in = open(source.c_str(), O_RDONLY | O_CLOEXEC);
+    if (in == -1) {
+        throw std::runtime_error("Failed to open file for reading");
+    }
+    const int out = open(destination.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+    if (out == -1) {
+        close(in);
+        throw std::runtime_error("Failed to open file for writing");
+    }
+
+    // Share the source's extents on copy-on-write filesystems, otherwise copy inside the kernel without a round trip through user space
+    bool ok = ioctl(out, FICLONE, in) == 0;
+    bool unsupported = false;
+    while (!ok) {
+        const ssize_t done = copy_file_range(in, nullptr, out, nullptr, std::size_t{1} << 30, 0);
+        if (done == 0) {
+            ok = true;
+        }
+        else if (done == -1 && errno != EINTR) {
+            // Old kernels and some filesystems (e.g., network ones) cannot do it
+            unsupported = errno == ENOSYS || errno == EXDEV || errno == EINVAL || errno == EOPNOTSUPP;
+            break;
+        }
+    }
+    ok = (close(out) == 0) && ok;
+    close(in);
+    if (ok) {
+        return;
+    }
+    if (!unsupported) {
+        throw std::runtime_error("Failed to copy file");
+    }
+#elif defined(__APPLE__)
+    // Clone the file on APFS, which shares its blocks until either copy is changed
+    if (clonefile(source.c_str(), destination.c_str(), 0) == 0) {
+        return;
+    }
+#endif
+    std::filesystem::copy_file(source, destination, std::filesystem::copy_options::overwrite_existing);
+}
+
+}  // namespace
+
+std::string format_time(const std::int64_t time)
+{
+    const std::string timestamp = to_timestamp(time);
+    return fmt::format("{}-{}-{} {}:{}:{} UTC", timestamp.substr(0, 4), timestamp.substr(4, 2), timestamp.substr(6, 2), timestamp.substr(9, 2), timestamp.substr(11, 2), timestamp.substr(13, 2));
+}
+
+std::vector<Generation> list(const std::filesystem::path &path)
+{
+    // Backups are named "<file name>.<timestamp>.<hash>.bak"
+    const std::string prefix = path.filename().string() + ".";
+    const std::filesystem::path directory = path.has_parent_path() ? path.parent_path() : std::filesystem::path(".");
+    std::vector<Generation> generations;
+    std::error_code ec;
+    for (const std::filesystem::directory_entry &entry : std::filesystem::directory_iterator(directory, ec)) {
+        const std::string name = entry.path().filename().string();
+        if (name.size() != prefix.size() + timestamp_length + 1 + hash_length + extension.size() || name.compare(0, prefix.size(), prefix) != 0 || name.compare(name.size() - extension.size(), extension.size(), extension) != 0) {
+            continue;
+        }
+        const std::string_view middle = std::string_view(name).substr(prefix.size(), timestamp_length + 1 + hash_length);
+        const std::string_view timestamp = middle.substr(0, timestamp_length);
+        const std::string_view hash_text = middle.substr(timestamp_length + 1);
+        const std::optional<std::int64_t> time = parse_timestamp(timestamp);
+        std::uint64_t hash = 0;
+        const auto [end, error] = std::from_chars(hash_text.data(), hash_text.data() + hash_text.size(), hash, 16);
+        std::error_code size_ec;
+        const std::uintmax_t size = entry.file_size(size_ec);
+        if (!time || middle[timestamp_length] != '.' || error != std::errc() || end != hash_text.data() + hash_text.size() || size_ec) {
+            continue;
+        }
+        generations.push_back(Generation{entry.path(), *time, hash, size});
+    }
+
+    // Newest first
+    std::sort(generations.begin(), generations.end(), [](const Generation &a, const Generation &b) {
+        return a.time != b.time ? a.time > b.time : a.path > b.path;
+    });
+    return generations;
+}
+
+bool create(const std::filesystem::path &path,
+            const std::size_t generations)
+{
+    try {
+        std::vector<Generation> existing = list(path);
+
+        // Skip the copy if the newest backup already has the same contents, which is the common case of a file that did not change since the last run
+        bool created = false;
+        const io::MappedFile file(path);
+        const std::uint64_t hash = snapshot::hash_contents(file.view());
+        if (existing.empty() || existing.front().hash != hash || existing.front().size != file.view().size()) {
+            // Keep the times unique and increasing, even if two backups are taken within a millisecond or the clock goes back
+            std::int64_t time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+            if (!existing.empty() && time <= existing.front().time) {
+                time = existing.front().time + 1;
+            }
+            std::filesystem::path backup_path = path;
+            backup_path += fmt::format(".{}.{:016x}{}", to_timestamp(time), hash, extension);
+            std::filesystem::path temp_path = backup_path;
+            temp_path += ".tmp";
+            try {
+                std::filesystem::remove(temp_path);
+                copy_contents(path, temp_path);
+                std::filesystem::rename(temp_path, backup_path);
+            }
+            catch (...) {
+                std::error_code ec;
+                std::filesystem::remove(temp_path, ec);
+                throw;
+            }
+            existing.insert(existing.begin(), Generation{backup_path, time, hash, file.view().size()});
+            created = true;
+        }
+
+        // Delete the oldest backups; a backup that cannot be deleted is retried next time
+        const std::size_t keep = generations == 0 ? 1 : generations;
+        for (std::size_t i = keep; i < existing.size(); ++i) {
+            std::error_code ec;
+            std::filesystem::remove(existing[i].path, ec);
+        }
+        return created;
+    }
+    catch (const std::exception &e) {
+        throw std::runtime_error(fmt::format("Failed to back up file '{}': {}", path.string(), e.what()));
+    }
+}
+
+Generation restore(const std::filesystem::path &path,
+                   const std::size_t number,
+                   const io::Durability durability)
+{
+    const std::vector<Generation> generations = list(path);
+    if (number == 0 || number > generations.size()) {
+        throw std::runtime_error(fmt::format("Failed to restore file '{}': No backup number {} (there are {})", path.string(), number, generations.size()));
+    }
+    const Generation &generation = generations[number - 1];
+    try {
+        // Never replace the file with a backup that was damaged since it was taken
+        const io::MappedFile file(generation.path);
+        if (snapshot::hash_contents(file.view()) != generation.hash || file.view().size() != generation.size) {
+            throw std::runtime_error("Backup is corrupt");
+        }
+
+        // Keep the current contents, without deleting any backup (including the one being restored)
+        if (std::filesystem::exists(path)) {
+            static_cast<void>(create(path, generations.size() + 1));
+        }
+        io::write_file(path, file.view(), durability);
+    }
+    catch (const std::exception &e) {
+        throw std::runtime_error(fmt::format("Failed to restore file '{}' from '{}': {}", path.string(), generation.path.filename().string(), e.what()));
+    }
+    return generation;
+}
+
+}  // namespace core::backup
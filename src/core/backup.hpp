@@ -0,0 +1,101 @@
+/**
+ * @file backup.hpp
+ *
+ * @brief Rotating, content-addressed backups of files.
+ */
+
+#pragma once
+
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::int64_t, std::uint64_t, std::uintmax_t
+#include <filesystem>   // for std::filesystem
+#include <string>       // for std::string
+#include <vector>       // for std::vector
+
+#include "io.hpp"
+
+namespace core::backup {
+
+/**
+ * @brief Number of backups of a file that are kept by default. Older ones are deleted when a new one is created.
+ */
+inline constexpr std::size_t default_generations = 10;
+
+/**
+ * @brief Struct that represents one backup of a file.
+ *
+ * Backups live next to the file, named after it, the time they were taken, and the hash of their contents (e.g., "subscriptions.html.20261016-124700-123.1f2e3d4c5b6a7988.bak"), so they can be listed, ordered and verified without reading them.
+ */
+struct Generation final {
+    /**
+     * @brief Path to the backup (e.g., "~/subscriptions.html.20261016-124700-123.1f2e3d4c5b6a7988.bak").
+     */
+    std::filesystem::path path;
+
+    /**
+     * @brief Time the backup was taken, in milliseconds since 1970-01-01 UTC (e.g., "1792154820123"). Backups of the same file never share a time.
+     */
+    std::int64_t time;
+
+    /**
+     * @brief Hash of the contents (see "core::snapshot::hash_contents").
+     */
+    std::uint64_t hash;
+
+    /**
+     * @brief Size of the backup in bytes (e.g., "4096").
+     */
+    std::uintmax_t size;
+};
+
+/**
+ * @brief Format the time of a backup for display.
+ *
+ * @param time Time in milliseconds since 1970-01-01 UTC (e.g., "1792154820123").
+ *
+ * @return Readable time (e.g., "2026-10-16 12:47:00 UTC").
+ */
+[[nodiscard]] std::string format_time(const std::int64_t time);
+
+/**
+ * @brief List the backups of a file, newest first.
+ *
+ * @param path Path to the file (e.g., "~/subscriptions.html").
+ *
+ * @return Backups of the file, newest first, or an empty vector if there are none.
+ */
+[[nodiscard]] std::vector<Generation> list(const std::filesystem::path &path);
+
+/**
+ * @brief Back up a file, unless the newest backup already has the same contents, then delete the oldest backups.
+ *
+ * The copy is made with a copy-on-write clone where the filesystem supports it (e.g., Btrfs, XFS, APFS), so it shares storage with the file, and falls back to an in-kernel copy otherwise. It is written under a temporary name and renamed, so a crash never leaves a partial backup behind.
+ *
+ * @param path Path to the file (e.g., "~/subscriptions.html").
+ * @param generations Number of backups to keep, including the new one (default: "default_generations"). Zero is treated as one.
+ *
+ * @return True if a backup was created, false if the newest backup already matched the file.
+ *
+ * @throws std::runtime_error If the file cannot be read or copied.
+ */
+bool create(const std::filesystem::path &path,
+            const std::size_t generations = default_generations);
+
+/**
+ * @brief Replace a file with one of its backups.
+ *
+ * The backup is verified against its hash first. The current file is backed up before it is replaced, so restoring can be undone by restoring that backup.
+ *
+ * @param path Path to the file (e.g., "~/subscriptions.html").
+ * @param number Number of the backup in "list", starting at 1 for the newest (e.g., "2").
+ * @param durability How hard to try to get the restored file onto stable storage (default: core::io::Durability::Full).
+ *
+ * @return Backup that was restored.
+ *
+ * @throws std::runtime_error If there is no such backup, the backup is corrupt, or the file cannot be written.
+ */
+Generation restore(const std::filesystem::path &path,
+                   const std::size_t number,
+                   const io::Durability durability = io::Durability::Full);
+
+}  // namespace core::backup
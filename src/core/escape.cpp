@@ -0,0 +1,150 @@
+/**
+ * @file escape.cpp
+ */
+
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint32_t
+#include <optional>     // for std::optional, std::nullopt
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+
+#include "escape.hpp"
+#include "simd.hpp"
+#include "strings.hpp"
+
+namespace core::escape {
+
+namespace {
+
+/**
+ * @brief Private helper function to decode a character reference, without its "&" and ";".
+ *
+ * @param name Name of the reference (e.g., "amp" or "#x30CE").
+ *
+ * @return Code point (e.g., "0x30CE"), or std::nullopt if the reference is not known (see "append_unescaped").
+ */
+[[nodiscard]] std::optional<std::uint32_t> decode_reference(const std::string_view name)
+{
+    if (name.size() >= 2 && name[0] == '#') {
+        // Numeric references have at most 8 digits, which keeps the value in range
+        const bool hex = name[1] == 'x' || name[1] == 'X';
+        const std::string_view digits = name.substr(hex ? 2 : 1);
+        if (digits.empty() || digits.size() > 8) {
+            return std::nullopt;
+        }
+        std::uint32_t value = 0;
+        for (const char c : digits) {
+            if (c >= '0' && c <= '9') {
+                value = value * (hex ? 16 : 10) + static_cast<std::uint32_t>(c - '0');
+            }
+            else if (hex && ((c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F'))) {
+                value = value * 16 + static_cast<std::uint32_t>((c | 0x20) - 'a' + 10);
+            }
+            else {
+                return std::nullopt;
+            }
+        }
+        // Like a web browser, replace NUL, which "append_utf8" keeps
+        return value == 0 ? 0xFFFD : value;
+    }
+    if (name == "amp") {
+        return '&';
+    }
+    if (name == "lt") {
+        return '<';
+    }
+    if (name == "gt") {
+        return '>';
+    }
+    if (name == "quot") {
+        return '"';
+    }
+    if (name == "apos") {
+        return '\'';
+    }
+    if (name == "nbsp") {
+        return 0xA0;
+    }
+    return std::nullopt;
+}
+
+}  // namespace
+
+void append_escaped(std::string &buffer,
+                    const std::string_view text)
+{
+    // Most text has no special characters, so it is copied in one go
+    std::size_t special = find_special(text);
+    if (special == text.size()) {
+        buffer.append(text);
+        return;
+    }
+
+    // Otherwise, copy the runs between special characters in one go
+    std::size_t begin = 0;
+    while (special < text.size()) {
+        buffer.append(text, begin, special - begin);
+        switch (text[special]) {
+        case '&':
+            buffer.append("&amp;");
+            break;
+        case '<':
+            buffer.append("&lt;");
+            break;
+        case '>':
+            buffer.append("&gt;");
+            break;
+        case '"':
+            buffer.append("&quot;");
+            break;
+        default:
+            // "&#39;" is shorter than "&apos;", and older browsers know it
+            buffer.append("&#39;");
+            break;
+        }
+        begin = special + 1;
+        special = simd::find_any_of(text, special_characters, begin);
+    }
+    buffer.append(text, begin);
+}
+
+std::string escape(const std::string_view text)
+{
+    std::string escaped;
+    escaped.reserve(text.size());
+    append_escaped(escaped, text);
+    return escaped;
+}
+
+void append_unescaped(std::string &buffer,
+                      const std::string_view text)
+{
+    // The longest known reference is "&#x10FFFF;", so a ";" further away means the "&" starts none
+    constexpr std::size_t max_name_size = 10;
+    std::size_t begin = 0;
+    for (std::size_t amp = text.find('&'); amp != std::string_view::npos; amp = text.find('&', amp + 1)) {
+        const std::size_t end = text.substr(amp + 1, max_name_size + 1).find(';');
+        if (end == std::string_view::npos) {
+            continue;
+        }
+        const std::optional<std::uint32_t> code_point = decode_reference(text.substr(amp + 1, end));
+        if (!code_point) {
+            continue;
+        }
+        buffer.append(text, begin, amp - begin);
+        strings::append_utf8(buffer, *code_point);
+        begin = amp + end + 2;
+        amp = begin - 1;
+    }
+    buffer.append(text, begin);
+}
+
+std::string unescape(const std::string_view text)
+{
+    std::string unescaped;
+    unescaped.reserve(text.size());
+    append_unescaped(unescaped, text);
+    return unescaped;
+}
+
+}  // namespace core::escape
@@ -0,0 +1,87 @@
+/**
+ * @file escape.hpp
+ *
+ * @brief Escape text for HTML, and decode the character references of HTML text.
+ */
+
+#pragma once
+
+#include <cstddef>      // for std::size_t
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+
+#include "simd.hpp"
+
+namespace core::escape {
+
+/**
+ * @brief Characters that are replaced by a character reference when escaping, which makes text safe both between tags and inside a quoted attribute value.
+ */
+inline constexpr std::string_view special_characters = "&<>\"'";
+
+/**
+ * @brief Find the first special character (see "special_characters") in a text.
+ *
+ * @param text Text to search (e.g., "Tom & Jerry").
+ *
+ * @return Offset of the first special character (e.g., "4"), or the size of the text if there is none.
+ */
+[[nodiscard]] inline std::size_t find_special(const std::string_view text)
+{
+    return simd::find_any_of(text, special_characters);
+}
+
+/**
+ * @brief Append text with its special characters replaced by character references.
+ *
+ * Text without special characters is appended with a single copy, after one vectorized pass to find that out.
+ *
+ * @param buffer Buffer to append to.
+ * @param text Text to escape (e.g., "Tom & Jerry <3").
+ */
+void append_escaped(std::string &buffer,
+                    const std::string_view text);
+
+/**
+ * @brief Escape text for HTML.
+ *
+ * @param text Text to escape (e.g., "Tom & Jerry <3").
+ *
+ * @return Escaped text (e.g., "Tom &amp; Jerry &lt;3"), which "unescape" turns back into the original text.
+ */
+[[nodiscard]] std::string escape(const std::string_view text);
+
+/**
+ * @brief Append text with its character references decoded.
+ *
+ * Numeric references (e.g., "&#x30CE;" or "&#12494;") and the named references "&amp;", "&apos;", "&gt;", "&lt;", "&nbsp;" and "&quot;" are decoded; code points that are not valid are replaced with U+FFFD. Anything else that starts with "&" (e.g., "Tom & Jerry" or "&copy;") is kept as-is, so text that was never escaped reads back unchanged.
+ *
+ * @param buffer Buffer to append to.
+ * @param text Text to decode (e.g., "Tom &amp; Jerry").
+ */
+void append_unescaped(std::string &buffer,
+                      const std::string_view text);
+
+/**
+ * @brief Decode the character references of HTML text.
+ *
+ * @param text Text to decode (e.g., "Tom &amp; Jerry &#x30CE;").
+ *
+ * @return Decoded text (e.g., "Tom & Jerry ノ"). See "append_unescaped" for the references that are decoded.
+ */
+[[nodiscard]] std::string unescape(const std::string_view text);
+
+/**
+ * @brief Check if text may contain character references, i.e., if "unescape" could change it.
+ *
+ * @param text Text to check (e.g., "Tom &amp; Jerry").
+ *
+ * @return True if the text contains "&", false otherwise.
+ */
+[[nodiscard]] inline bool is_escaped(const std::string_view text)
+{
+    // A single-byte search is "memchr", which the C library already vectorizes
+    return text.find('&') != std::string_view::npos;
+}
+
+}  // namespace core::escape
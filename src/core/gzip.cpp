@@ -0,0 +1,485 @@
+/**
+ * @file gzip.cpp
+ */
+
+#include <algorithm>    // for std::upper_bound
+#include <array>        // for std::array
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint8_t, std::uint16_t, std::uint32_t, std::uint64_t
+#include <cstring>      // for std::memcpy
+#include <iterator>     // for std::begin, std::end, std::size
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+#include <vector>       // for std::vector
+
+#include "gzip.hpp"
+
+namespace core::gzip {
+
+namespace {
+
+/**
+ * @brief Private helper variable that contains the CRC-32 polynomial, with its bits reversed.
+ */
+constexpr std::uint32_t polynomial = 0xEDB88320;
+
+/**
+ * @brief Private helper variable that contains how far back a match may start, in bytes.
+ */
+constexpr std::size_t window_size = 32768;
+
+/**
+ * @brief Private helper variable that contains the number of bits of the hash of three bytes, which index the table of match candidates.
+ */
+constexpr unsigned hash_bits = 15;
+
+/**
+ * @brief Private helper variable that contains how many earlier positions with the same hash are compared before giving up.
+ */
+constexpr std::size_t max_candidates = 16;
+
+/**
+ * @brief Private helper variable that contains the shortest and longest match that deflate can code.
+ */
+constexpr std::size_t min_match = 3;
+constexpr std::size_t max_match = 258;
+
+/**
+ * @brief Private helper variable that contains the largest text that is compressed with one table of positions; longer texts are split, so the positions fit in 32 bits.
+ */
+constexpr std::size_t max_piece_size = std::size_t{1} << 30;
+
+/**
+ * @brief Private helper variable that contains the shortest length, and the number of extra bits, of each length code from 257 to 285.
+ */
+constexpr std::uint16_t length_bases[] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+constexpr std::uint8_t length_extra_bits[] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+
+/**
+ * @brief Private helper variable that contains the shortest distance, and the number of extra bits, of each distance code from 0 to 29.
+ */
+constexpr std::uint16_t distance_bases[] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+constexpr std::uint8_t distance_extra_bits[] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+/**
+ * @brief Private helper function to reverse the bits of a Huffman code, which deflate writes from the most significant bit, into the least significant bit first order of the rest of the stream.
+ *
+ * @param code Code to reverse (e.g., "0b0011").
+ * @param length Number of bits of the code (e.g., "4").
+ *
+ * @return Reversed code (e.g., "0b1100").
+ */
+[[nodiscard]] constexpr std::uint16_t reverse_bits(const std::uint16_t code,
+                                                   const unsigned length)
+{
+    std::uint16_t reversed = 0;
+    for (unsigned bit = 0; bit < length; ++bit) {
+        reversed = static_cast<std::uint16_t>(reversed << 1 | ((code >> bit) & 1));
+    }
+    return reversed;
+}
+
+/**
+ * @brief Private helper struct that contains a Huffman code, ready to be written.
+ *
+ * @note This struct is marked as `final` to prevent inheritance.
+ */
+struct Code final {
+    /**
+     * @brief Bits of the code, reversed (see "reverse_bits").
+     */
+    std::uint16_t bits = 0;
+
+    /**
+     * @brief Number of bits of the code (e.g., "8").
+     */
+    std::uint8_t length = 0;
+};
+
+/**
+ * @brief Private helper function to build the fixed Huffman codes of the literal and length symbols (RFC 1951, section 3.2.6).
+ *
+ * @return Code of each symbol from 0 to 287.
+ */
+[[nodiscard]] constexpr std::array<Code, 288> make_fixed_codes()
+{
+    std::array<Code, 288> codes{};
+    for (unsigned symbol = 0; symbol < codes.size(); ++symbol) {
+        unsigned code = 0;
+        unsigned length = 0;
+        if (symbol < 144) {
+            code = 0x30 + symbol;
+            length = 8;
+        }
+        else if (symbol < 256) {
+            code = 0x190 + symbol - 144;
+            length = 9;
+        }
+        else if (symbol < 280) {
+            code = symbol - 256;
+            length = 7;
+        }
+        else {
+            code = 0xC0 + symbol - 280;
+            length = 8;
+        }
+        codes[symbol] = Code{reverse_bits(static_cast<std::uint16_t>(code), length), static_cast<std::uint8_t>(length)};
+    }
+    return codes;
+}
+
+/**
+ * @brief Private helper variable that contains the fixed Huffman code of each literal and length symbol.
+ */
+constexpr std::array<Code, 288> fixed_codes = make_fixed_codes();
+
+/**
+ * @brief Private helper function to build the length code of each match length.
+ *
+ * @return Index into "length_bases" of each length from 0 to "max_match"; lengths below "min_match" are unused.
+ */
+[[nodiscard]] constexpr std::array<std::uint8_t, max_match + 1> make_length_codes()
+{
+    std::array<std::uint8_t, max_match + 1> codes{};
+    std::uint8_t code = 0;
+    for (std::size_t length = min_match; length <= max_match; ++length) {
+        while (std::size_t{code} + 1 < std::size(length_bases) && length_bases[code + 1] <= length) {
+            ++code;
+        }
+        codes[length] = code;
+    }
+    return codes;
+}
+
+/**
+ * @brief Private helper variable that contains the length code of each match length.
+ */
+constexpr std::array<std::uint8_t, max_match + 1> length_codes = make_length_codes();
+
+/**
+ * @brief Private helper function to build the lookup tables of the CRC-32, eight bytes at a time ("slicing-by-8").
+ *
+ * @return Eight tables; the first one is the CRC-32 of each byte value, and each next one is the CRC-32 of each byte value followed by one more zero byte.
+ */
+[[nodiscard]] constexpr std::array<std::array<std::uint32_t, 256>, 8> make_crc_tables()
+{
+    std::array<std::array<std::uint32_t, 256>, 8> tables{};
+    for (std::uint32_t byte = 0; byte < 256; ++byte) {
+        std::uint32_t crc = byte;
+        for (unsigned bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) != 0 ? (crc >> 1) ^ polynomial : crc >> 1;
+        }
+        tables[0][byte] = crc;
+    }
+    for (std::size_t table = 1; table < tables.size(); ++table) {
+        for (std::size_t byte = 0; byte < 256; ++byte) {
+            tables[table][byte] = (tables[table - 1][byte] >> 8) ^ tables[0][tables[table - 1][byte] & 0xFF];
+        }
+    }
+    return tables;
+}
+
+/**
+ * @brief Private helper variable that contains the lookup tables of the CRC-32.
+ */
+constexpr std::array<std::array<std::uint32_t, 256>, 8> crc_tables = make_crc_tables();
+
+/**
+ * @brief Private helper function to multiply two polynomials modulo the CRC-32 polynomial, with their bits reversed.
+ *
+ * @param a First polynomial.
+ * @param b Second polynomial.
+ *
+ * @return Product modulo the CRC-32 polynomial.
+ */
+[[nodiscard]] std::uint32_t multiply(const std::uint32_t a,
+                                     std::uint32_t b)
+{
+    std::uint32_t product = 0;
+    for (std::uint32_t mask = std::uint32_t{1} << 31; mask != 0; mask >>= 1) {
+        if ((a & mask) != 0) {
+            product ^= b;
+        }
+        b = (b & 1) != 0 ? (b >> 1) ^ polynomial : b >> 1;
+    }
+    return product;
+}
+
+/**
+ * @brief Private helper class that writes a stream of bits, least significant bit first, as deflate expects.
+ *
+ * @note This class is marked as `final` to prevent inheritance.
+ */
+class BitWriter final {
+  public:
+    /**
+     * @brief Construct a new BitWriter object.
+     *
+     * @param buffer Buffer to append the bytes to.
+     */
+    explicit BitWriter(std::string &buffer)
+        : buffer_(buffer) {}
+
+    /**
+     * @brief Write bits.
+     *
+     * @param value Bits to write, from the least significant one.
+     * @param length Number of bits to write, at most 32 (e.g., "5").
+     */
+    void write(const std::uint32_t value,
+               const unsigned length)
+    {
+        this->bits_ |= std::uint64_t{value} << this->count_;
+        this->count_ += length;
+        while (this->count_ >= 8) {
+            this->buffer_.push_back(static_cast<char>(this->bits_ & 0xFF));
+            this->bits_ >>= 8;
+            this->count_ -= 8;
+        }
+    }
+
+    /**
+     * @brief Write a Huffman code.
+     *
+     * @param code Code to write.
+     */
+    void write(const Code code)
+    {
+        this->write(code.bits, code.length);
+    }
+
+    /**
+     * @brief Pad the last byte with zero bits, and write it.
+     */
+    void align()
+    {
+        if (this->count_ > 0) {
+            this->write(0, 8 - this->count_);
+        }
+    }
+
+  private:
+    /**
+     * @brief Buffer to append the bytes to.
+     */
+    std::string &buffer_;
+
+    /**
+     * @brief Bits that do not fill a byte yet.
+     */
+    std::uint64_t bits_ = 0;
+
+    /**
+     * @brief Number of bits in "bits_".
+     */
+    unsigned count_ = 0;
+};
+
+/**
+ * @brief Private helper function to hash the three bytes at a position, to find earlier positions that start with the same bytes.
+ *
+ * @param data Pointer to the first of the three bytes.
+ *
+ * @return Hash of "hash_bits" bits.
+ */
+[[nodiscard]] std::uint32_t hash_bytes(const char *data)
+{
+    const std::uint32_t bytes = static_cast<std::uint32_t>(static_cast<unsigned char>(data[0])) |
+                                static_cast<std::uint32_t>(static_cast<unsigned char>(data[1])) << 8 |
+                                static_cast<std::uint32_t>(static_cast<unsigned char>(data[2])) << 16;
+    return (bytes * 0x9E3779B1u) >> (32 - hash_bits);
+}
+
+/**
+ * @brief Private helper function to count the bytes that two positions of a text have in common, eight at a time.
+ *
+ * @param a Pointer to the earlier position.
+ * @param b Pointer to the later position.
+ * @param limit Largest length to return; both positions must have that many bytes.
+ *
+ * @return Number of equal bytes from the start, at most "limit".
+ */
+[[nodiscard]] std::size_t match_length(const char *a,
+                                       const char *b,
+                                       const std::size_t limit)
+{
+    std::size_t length = 0;
+    for (; length + sizeof(std::uint64_t) <= limit; length += sizeof(std::uint64_t)) {
+        std::uint64_t x = 0;
+        std::uint64_t y = 0;
+        std::memcpy(&x, a + length, sizeof(x));
+        std::memcpy(&y, b + length, sizeof(y));
+        if (x != y) {
+            break;
+        }
+    }
+    while (length < limit && a[length] == b[length]) {
+        ++length;
+    }
+    return length;
+}
+
+/**
+ * @brief Private helper function to write a text as a single fixed Huffman block (RFC 1951, section 3.2.6), without ending the stream.
+ *
+ * @param writer Writer to write the block to.
+ * @param text Text to compress, shorter than "max_piece_size".
+ */
+void write_fixed_block(BitWriter &writer,
+                       const std::string_view text)
+{
+    // BFINAL = 0, BTYPE = 01
+    writer.write(0b010, 3);
+
+    // Each hash maps to the last position that had it, plus one, and each position in the window to the previous one with the same hash
+    std::vector<std::uint32_t> head(std::size_t{1} << hash_bits, 0);
+    std::vector<std::uint32_t> previous(window_size, 0);
+    const char *data = text.data();
+    const std::size_t size = text.size();
+    const auto insert = [&](const std::size_t position) {
+        const std::uint32_t hash = hash_bytes(data + position);
+        previous[position % window_size] = head[hash];
+        head[hash] = static_cast<std::uint32_t>(position + 1);
+    };
+
+    std::size_t position = 0;
+    while (position < size) {
+        // Find the longest earlier match among the most recent candidates
+        std::size_t best_length = 0;
+        std::size_t best_distance = 0;
+        if (position + min_match <= size) {
+            const std::size_t limit = size - position < max_match ? size - position : max_match;
+            std::uint32_t candidate = head[hash_bytes(data + position)];
+            for (std::size_t tries = 0; candidate != 0 && tries < max_candidates; ++tries) {
+                const std::size_t start = candidate - 1;
+                if (position - start > window_size) {
+                    break;
+                }
+                // A candidate that differs at the end of the best match so far cannot beat it
+                if (best_length > 0 && data[start + best_length] != data[position + best_length]) {
+                    candidate = previous[start % window_size];
+                    continue;
+                }
+                const std::size_t length = match_length(data + start, data + position, limit);
+                if (length > best_length) {
+                    best_length = length;
+                    best_distance = position - start;
+                    if (length == limit) {
+                        break;
+                    }
+                }
+                candidate = previous[start % window_size];
+            }
+            insert(position);
+        }
+
+        if (best_length < min_match) {
+            writer.write(fixed_codes[static_cast<unsigned char>(data[position])]);
+            ++position;
+            continue;
+        }
+
+        // Write the length, then the distance, each as a code and its extra bits
+        const std::uint8_t length_code = length_codes[best_length];
+        writer.write(fixed_codes[257 + std::size_t{length_code}]);
+        writer.write(static_cast<std::uint32_t>(best_length - length_bases[length_code]), length_extra_bits[length_code]);
+        const auto distance_code = static_cast<std::size_t>(std::upper_bound(std::begin(distance_bases), std::end(distance_bases), best_distance) - std::begin(distance_bases) - 1);
+        writer.write(reverse_bits(static_cast<std::uint16_t>(distance_code), 5), 5);
+        writer.write(static_cast<std::uint32_t>(best_distance - distance_bases[distance_code]), distance_extra_bits[distance_code]);
+
+        // Remember the positions inside the match too, so later repeats can refer to them
+        const std::size_t end = position + best_length;
+        for (++position; position < end; ++position) {
+            if (position + min_match <= size) {
+                insert(position);
+            }
+        }
+    }
+
+    // End of block
+    writer.write(fixed_codes[256]);
+}
+
+}  // namespace
+
+std::uint32_t crc32(const std::string_view text,
+                    const std::uint32_t crc)
+{
+    // Eight bytes per step, with one lookup per byte, so the lookups do not wait on each other
+    std::uint32_t value = ~crc;
+    const auto byte = [&text](const std::size_t offset) {
+        return static_cast<std::uint32_t>(static_cast<unsigned char>(text[offset]));
+    };
+    std::size_t offset = 0;
+    for (; offset + 8 <= text.size(); offset += 8) {
+        value ^= byte(offset) | byte(offset + 1) << 8 | byte(offset + 2) << 16 | byte(offset + 3) << 24;
+        value = crc_tables[7][value & 0xFF] ^ crc_tables[6][(value >> 8) & 0xFF] ^ crc_tables[5][(value >> 16) & 0xFF] ^ crc_tables[4][value >> 24] ^
+                crc_tables[3][byte(offset + 4)] ^ crc_tables[2][byte(offset + 5)] ^ crc_tables[1][byte(offset + 6)] ^ crc_tables[0][byte(offset + 7)];
+    }
+    for (; offset < text.size(); ++offset) {
+        value = crc_tables[0][(value ^ byte(offset)) & 0xFF] ^ (value >> 8);
+    }
+    return ~value;
+}
+
+std::uint32_t crc32_combine(const std::uint32_t first,
+                            const std::uint32_t second,
+                            const std::uint64_t second_size)
+{
+    // Appending n bytes to a text multiplies its CRC by x^(8n) modulo the polynomial, so square x^8 once per bit of the size
+    std::uint32_t shift = std::uint32_t{1} << 31;
+    std::uint32_t power = std::uint32_t{1} << 23;
+    for (std::uint64_t bits = second_size; bits != 0; bits >>= 1) {
+        if ((bits & 1) != 0) {
+            shift = multiply(shift, power);
+        }
+        power = multiply(power, power);
+    }
+    return multiply(shift, first) ^ second;
+}
+
+void deflate(std::string &buffer,
+             const std::string_view text)
+{
+    BitWriter writer(buffer);
+    for (std::size_t begin = 0; begin < text.size(); begin += max_piece_size) {
+        write_fixed_block(writer, text.substr(begin, max_piece_size));
+    }
+    if (text.empty()) {
+        return;
+    }
+
+    // An empty stored block ends on a byte boundary (BFINAL = 0, BTYPE = 00, LEN = 0, NLEN = 0xFFFF)
+    writer.write(0b000, 3);
+    writer.align();
+    buffer.append("\x00\x00\xff\xff", 4);
+}
+
+void append_trailer(std::string &buffer,
+                    const std::uint32_t crc,
+                    const std::uint64_t size)
+{
+    // An empty fixed Huffman block that ends the stream (BFINAL = 1, BTYPE = 01, end of block), padded to a byte boundary
+    BitWriter writer(buffer);
+    writer.write(0b011, 3);
+    writer.write(fixed_codes[256]);
+    writer.align();
+
+    // CRC-32 and size modulo 2^32, both little-endian
+    for (unsigned shift = 0; shift < 32; shift += 8) {
+        buffer.push_back(static_cast<char>((crc >> shift) & 0xFF));
+    }
+    for (unsigned shift = 0; shift < 32; shift += 8) {
+        buffer.push_back(static_cast<char>((size >> shift) & 0xFF));
+    }
+}
+
+std::string compress(const std::string_view text)
+{
+    std::string buffer(header);
+    deflate(buffer, text);
+    append_trailer(buffer, crc32(text), text.size());
+    return buffer;
+}
+
+}  // namespace core::gzip
@@ -0,0 +1,77 @@
+/**
+ * @file gzip.hpp
+ *
+ * @brief Compress documents in the gzip format (RFC 1951, RFC 1952), in pieces that can be compressed separately and joined.
+ */
+
+#pragma once
+
+#include <cstdint>      // for std::uint32_t, std::uint64_t
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+
+namespace core::gzip {
+
+/**
+ * @brief Header of a gzip member: deflate method, no name or time, unknown operating system.
+ */
+inline constexpr std::string_view header{"\x1f\x8b\x08\x00\x00\x00\x00\x00\x00\xff", 10};
+
+/**
+ * @brief Update the CRC-32 of a text, as stored in the gzip trailer.
+ *
+ * @param text Text to add (e.g., "123456789").
+ * @param crc CRC-32 of the text before it (default: "0", for the start of the text).
+ *
+ * @return CRC-32 of both texts (e.g., "0xCBF43926").
+ */
+[[nodiscard]] std::uint32_t crc32(const std::string_view text,
+                                  const std::uint32_t crc = 0);
+
+/**
+ * @brief Combine the CRC-32 of two texts into the CRC-32 of the first text followed by the second one, without reading either text.
+ *
+ * @param first CRC-32 of the first text.
+ * @param second CRC-32 of the second text.
+ * @param second_size Size of the second text in bytes (e.g., "65536").
+ *
+ * @return CRC-32 of both texts, in O(log second_size).
+ */
+[[nodiscard]] std::uint32_t crc32_combine(const std::uint32_t first,
+                                          const std::uint32_t second,
+                                          const std::uint64_t second_size);
+
+/**
+ * @brief Compress a text into deflate blocks, and append them to a buffer.
+ *
+ * Matches never refer to bytes before the text, and the blocks end on a byte boundary without ending the stream (like zlib's "Z_SYNC_FLUSH"), so pieces of a document can be compressed separately, cached, and joined in order between "header" and "append_trailer".
+ *
+ * Repeats are found with a hash table of the last 32 KiB and a short search, and coded with the fixed Huffman codes. This is fast and compresses repetitive markup well (e.g., the rows of a table), though less tightly than zlib.
+ *
+ * @param buffer Buffer to append to.
+ * @param text Text to compress.
+ */
+void deflate(std::string &buffer,
+             const std::string_view text);
+
+/**
+ * @brief End a gzip member: append the final deflate block, the CRC-32 and the size of the uncompressed text.
+ *
+ * @param buffer Buffer to append to.
+ * @param crc CRC-32 of the uncompressed text (see "crc32" and "crc32_combine").
+ * @param size Size of the uncompressed text in bytes (e.g., "150000").
+ */
+void append_trailer(std::string &buffer,
+                    const std::uint32_t crc,
+                    const std::uint64_t size);
+
+/**
+ * @brief Compress a text into a complete gzip member.
+ *
+ * @param text Text to compress (e.g., "<!DOCTYPE html>...").
+ *
+ * @return Compressed text, which any gzip decoder reads back (e.g., a web browser, or "gzip -d").
+ */
+[[nodiscard]] std::string compress(const std::string_view text);
+
+}  // namespace core::gzip
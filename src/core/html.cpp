@@ -0,0 +1,245 @@
+/**
+ * @file html.cpp
+ */
+
+#include <algorithm>    // for std::count
+#include <cstddef>      // for std::size_t
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+#include <vector>       // for std::vector
+
+#include <fmt/core.h>
+
+#include "html.hpp"
+#include "simd.hpp"
+
+namespace core::html {
+
+namespace {
+
+/**
+ * @brief Private helper variable that contains the bytes that end an attribute name: whitespace (see "simd::is_whitespace"), "=", ">" and "/".
+ */
+constexpr std::string_view attribute_name_end = " \t\n\v\f\r=>/";
+
+/**
+ * @brief Private helper variable that contains the bytes that end an unquoted attribute value: whitespace and ">".
+ */
+constexpr std::string_view unquoted_value_end = " \t\n\v\f\r>";
+
+}  // namespace
+
+ParseError::ParseError(const std::string &message,
+                       const std::size_t line,
+                       const std::size_t column)
+    : std::runtime_error(fmt::format("line {}, column {}: {}", line, column, message)),
+      line_(line),
+      column_(column) {}
+
+std::size_t ParseError::get_line() const
+{
+    return this->line_;
+}
+
+std::size_t ParseError::get_column() const
+{
+    return this->column_;
+}
+
+RowScanner::RowScanner(const std::string_view text,
+                       const std::size_t begin,
+                       const std::size_t end)
+    : text_(text),
+      pos_(begin < text.size() ? begin : text.size()),
+      end_(end < text.size() ? end : text.size()) {}
+
+bool RowScanner::next(Row &row)
+{
+    while (true) {
+        // Jump to the next tag, leaving tags after the end of the range to another scanner
+        const std::size_t open = this->text_.find('<', this->pos_);
+        if (open == std::string_view::npos || open >= this->end_) {
+            this->pos_ = this->end_;
+            return false;
+        }
+        this->pos_ = open + 1;
+
+        // Only "<tr>" can start a row
+        if (!simd::starts_with_icase(this->text_, open, "<tr>")) {
+            continue;
+        }
+
+        // Only "<tr>" followed by "<td>" is a channel row, anything else (e.g., the "<th>" header) is skipped
+        const std::size_t cell = simd::skip_whitespace(this->text_, open + 4);
+        if (!simd::starts_with_icase(this->text_, cell, "<td>")) {
+            continue;
+        }
+
+        // Like the regex this scanner replaces, skip rows that are not channel rows (e.g., a note without a link), and look for the next row right after this one's "<tr>"
+        this->pos_ = cell + 4;
+        Row parsed;
+        parsed.begin = open;
+        if (!this->parse_row(parsed)) {
+            this->pos_ = open + 1;
+            continue;
+        }
+        parsed.end = this->pos_;
+        row = parsed;
+        return true;
+    }
+}
+
+bool RowScanner::parse_row(Row &row)
+{
+    // <a ...>name</a></td>, where a cell without a link, a link without an "href" and an empty name all mean that the row is not a channel row
+    this->pos_ = simd::skip_whitespace(this->text_, this->pos_);
+    if (!simd::starts_with_icase(this->text_, this->pos_, "<a") ||
+        this->pos_ + 2 >= this->text_.size() ||
+        !simd::is_whitespace(this->text_[this->pos_ + 2])) {
+        return false;
+    }
+    this->pos_ += 2;
+    row.link = this->parse_anchor_attributes();
+    row.name = this->text_until_tag("channel name");
+    if (row.link.empty() || row.name.empty()) {
+        return false;
+    }
+    this->expect("</a>");
+    this->expect("</td>");
+
+    // <td>description</td>, where an empty description also means that the row is not a channel row
+    this->expect("<td>");
+    row.description = this->text_until_tag("channel description");
+    if (row.description.empty()) {
+        return false;
+    }
+    this->expect("</td>");
+
+    // </tr>
+    this->expect("</tr>");
+    return true;
+}
+
+std::string_view RowScanner::parse_anchor_attributes()
+{
+    std::string_view href;
+
+    while (true) {
+        this->pos_ = simd::skip_whitespace(this->text_, this->pos_);
+        if (this->pos_ >= this->text_.size()) {
+            throw this->error_at("unterminated '<a>' tag", this->pos_);
+        }
+        const char c = this->text_[this->pos_];
+        if (c == '>') {
+            ++this->pos_;
+            break;
+        }
+        // Tolerate a stray "/" (e.g., "<a href="..." / >")
+        if (c == '/') {
+            ++this->pos_;
+            continue;
+        }
+
+        // Attribute name
+        const std::size_t name_begin = this->pos_;
+        this->pos_ = simd::find_any_of(this->text_, attribute_name_end, this->pos_);
+        const std::size_t name_end = this->pos_;
+
+        // Attribute value (optional)
+        std::string_view value;
+        this->pos_ = simd::skip_whitespace(this->text_, this->pos_);
+        if (this->pos_ < this->text_.size() && this->text_[this->pos_] == '=') {
+            this->pos_ = simd::skip_whitespace(this->text_, this->pos_ + 1);
+            if (this->pos_ >= this->text_.size()) {
+                throw this->error_at("unterminated '<a>' tag", this->pos_);
+            }
+            const char quote = this->text_[this->pos_];
+            if (quote == '"' || quote == '\'') {
+                const std::size_t value_begin = this->pos_ + 1;
+                const std::size_t value_end = this->text_.find(quote, value_begin);
+                if (value_end == std::string_view::npos) {
+                    throw this->error_at("unterminated attribute value", this->pos_);
+                }
+                value = this->text_.substr(value_begin, value_end - value_begin);
+                this->pos_ = value_end + 1;
+            }
+            else {
+                const std::size_t value_begin = this->pos_;
+                this->pos_ = simd::find_any_of(this->text_, unquoted_value_end, this->pos_);
+                value = this->text_.substr(value_begin, this->pos_ - value_begin);
+            }
+        }
+
+        // If there are multiple "href" attributes, the last one wins, like the regex it replaces
+        if (name_end - name_begin == 4 && simd::starts_with_icase(this->text_, name_begin, "href")) {
+            href = value;
+        }
+    }
+    return href;
+}
+
+void RowScanner::expect(const std::string_view tag)
+{
+    this->pos_ = simd::skip_whitespace(this->text_, this->pos_);
+    if (!simd::starts_with_icase(this->text_, this->pos_, tag)) {
+        throw this->error_at(fmt::format("expected '{}'", tag), this->pos_);
+    }
+    this->pos_ += tag.size();
+}
+
+std::string_view RowScanner::text_until_tag(const std::string_view what)
+{
+    const std::size_t begin = this->pos_;
+    const std::size_t end = this->text_.find('<', begin);
+    if (end == std::string_view::npos) {
+        throw this->error_at(fmt::format("unterminated {}", what), begin);
+    }
+    this->pos_ = end;
+    return this->text_.substr(begin, end - begin);
+}
+
+ParseError RowScanner::error_at(const std::string &message,
+                                const std::size_t offset) const
+{
+    // Errors are rare, so the line and column are only computed when needed
+    const std::string_view before = this->text_.substr(0, offset);
+    const auto line = static_cast<std::size_t>(std::count(before.cbegin(), before.cend(), '\n')) + 1;
+    const std::size_t line_start = before.rfind('\n');
+    const std::size_t column = (line_start == std::string_view::npos) ? offset + 1 : offset - line_start;
+    return ParseError(message, line, column);
+}
+
+std::vector<Row> scan_rows(const std::string_view text)
+{
+    std::vector<Row> rows;
+    RowScanner scanner(text);
+    Row row;
+    while (scanner.next(row)) {
+        rows.emplace_back(row);
+    }
+    return rows;
+}
+
+std::vector<std::size_t> split_rows(const std::string_view text,
+                                    const std::size_t parts)
+{
+    std::vector<std::size_t> bounds = {0};
+    for (std::size_t part = 1; part < parts; ++part) {
+        // Start the next range at the first "<tr>" after an even share of the document
+        std::size_t pos = text.size() / parts * part;
+        if (pos <= bounds.back()) {
+            pos = bounds.back() + 1;
+        }
+        while ((pos = text.find('<', pos)) != std::string_view::npos && !simd::starts_with_icase(text, pos, "<tr>")) {
+            ++pos;
+        }
+        if (pos == std::string_view::npos) {
+            break;
+        }
+        bounds.push_back(pos);
+    }
+    bounds.push_back(text.size());
+    return bounds;
+}
+
+}  // namespace core::html
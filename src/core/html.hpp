@@ -0,0 +1,222 @@
+/**
+ * @file html.hpp
+ *
+ * @brief Scan HTML tables.
+ */
+
+#pragma once
+
+#include <cstddef>      // for std::size_t
+#include <stdexcept>    // for std::runtime_error
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+#include <vector>       // for std::vector
+
+namespace core::html {
+
+/**
+ * @brief Exceptions raised by the row scanner when a channel row is cut short (e.g., a missing "</td>"). The message contains the 1-based line and column of the error.
+ *
+ * This class extends "std::runtime_error".
+ *
+ * @note This class is marked as `final` to prevent inheritance.
+ */
+class ParseError final : public std::runtime_error {
+  public:
+    /**
+     * @brief Construct a new ParseError object.
+     *
+     * @param message Description of the error (e.g., "expected '</td>'").
+     * @param line 1-based line number of the error (e.g., "12").
+     * @param column 1-based column number (in bytes) of the error (e.g., "5").
+     */
+    explicit ParseError(const std::string &message,
+                        const std::size_t line,
+                        const std::size_t column);
+
+    /**
+     * @brief Get the line of the error.
+     *
+     * @return 1-based line number (e.g., "12").
+     */
+    [[nodiscard]] std::size_t get_line() const;
+
+    /**
+     * @brief Get the column of the error.
+     *
+     * @return 1-based column number in bytes (e.g., "5").
+     */
+    [[nodiscard]] std::size_t get_column() const;
+
+  private:
+    /**
+     * @brief 1-based line number of the error.
+     */
+    std::size_t line_;
+
+    /**
+     * @brief 1-based column number (in bytes) of the error.
+     */
+    std::size_t column_;
+};
+
+/**
+ * @brief Struct that represents a single table row, as seen by the scanner.
+ *
+ * The fields are views into the scanned text, so the text must outlive the row.
+ *
+ * @note This struct is marked as `final` to prevent inheritance.
+ */
+struct Row final {
+    /**
+     * @brief Byte offset of the opening "<tr>" tag.
+     */
+    std::size_t begin = 0;
+
+    /**
+     * @brief Byte offset one past the closing "</tr>" tag.
+     */
+    std::size_t end = 0;
+
+    /**
+     * @brief Value of the "href" attribute (e.g., "https://www.youtube.com/@noriyaro/videos").
+     */
+    std::string_view link;
+
+    /**
+     * @brief Text of the link (e.g., "Noriyaro").
+     */
+    std::string_view name;
+
+    /**
+     * @brief Text of the second cell (e.g., "JP Drifting").
+     */
+    std::string_view description;
+};
+
+/**
+ * @brief Class that scans an HTML document for channel rows in a single forward pass.
+ *
+ * A channel row has the layout written by "core::io::save", i.e., "<tr><td><a href="...">name</a></td><td>description</td></tr>". Tags are matched case-insensitively, whitespace is allowed between tags, and the "<a>" tag may carry any other attributes in any order. Like the regex this scanner replaced, rows that are not channel rows are skipped: rows that do not start with "<tr>" followed by "<td>" (e.g., the "<th>" header row), and rows whose first cell has no "<a>" tag with a non-empty "href", or whose name or description is empty. Channel rows that are cut short (e.g., a missing "</td>" or a document that ends inside the row) are reported as errors. Whitespace, tags and the ends of attributes are found with the searches of "core::simd".
+ *
+ * @note This class is marked as `final` to prevent inheritance.
+ */
+class RowScanner final {
+  public:
+    /**
+     * @brief Construct a new RowScanner object.
+     *
+     * Several scanners can share one document by giving each a range of it (see "split_rows"). Rows are reported with offsets into the whole document, and a row that starts in the range is parsed to its end, even past the range.
+     *
+     * @param text HTML document to scan. It must outlive the scanner and every row it returns.
+     * @param begin Byte offset to start scanning at (default: "0"). It must not be inside a channel row.
+     * @param end Byte offset at which to stop looking for rows (default: the end of the document). Rows that start at or after it are left to another scanner.
+     */
+    explicit RowScanner(const std::string_view text,
+                        const std::size_t begin = 0,
+                        const std::size_t end = std::string_view::npos);
+
+    /**
+     * @brief Scan the next channel row.
+     *
+     * @param row Row to fill in. It is left untouched if there are no more rows.
+     *
+     * @return True if a row was found, false if the end of the document was reached.
+     *
+     * @throws ParseError If a channel row is cut short.
+     */
+    [[nodiscard]] bool next(Row &row);
+
+  private:
+    /**
+     * @brief HTML document being scanned.
+     */
+    std::string_view text_;
+
+    /**
+     * @brief Current byte offset into the document.
+     */
+    std::size_t pos_;
+
+    /**
+     * @brief Byte offset at which to stop looking for rows.
+     */
+    std::size_t end_;
+
+    /**
+     * @brief Parse a channel row, starting right after its "<td>" tag.
+     *
+     * @param row Row to fill in.
+     *
+     * @return True if the row is a channel row, false if it is not and must be skipped (e.g., its first cell has no link).
+     *
+     * @throws ParseError If the row is a channel row that is cut short.
+     */
+    [[nodiscard]] bool parse_row(Row &row);
+
+    /**
+     * @brief Parse the attributes of an "<a>" tag up to and including its closing ">".
+     *
+     * @return Value of the last "href" attribute, or an empty view if there is none.
+     *
+     * @throws ParseError If the tag is not terminated.
+     */
+    [[nodiscard]] std::string_view parse_anchor_attributes();
+
+    /**
+     * @brief Consume a tag at the current position, skipping any leading whitespace.
+     *
+     * @param tag Lowercase tag to consume (e.g., "</td>").
+     *
+     * @throws ParseError If the tag is not found.
+     */
+    void expect(const std::string_view tag);
+
+    /**
+     * @brief Consume the text up to the next "<".
+     *
+     * @param what Human-readable name of the text, used in error messages (e.g., "channel name").
+     *
+     * @return Text, which may be empty.
+     *
+     * @throws ParseError If the document ends.
+     */
+    [[nodiscard]] std::string_view text_until_tag(const std::string_view what);
+
+    /**
+     * @brief Build an error for the given byte offset.
+     *
+     * @param message Description of the error (e.g., "expected '</td>'").
+     * @param offset Byte offset of the error.
+     *
+     * @return Error with the line and column computed from the offset.
+     */
+    [[nodiscard]] ParseError error_at(const std::string &message,
+                                      const std::size_t offset) const;
+};
+
+/**
+ * @brief Scan an HTML document for all channel rows.
+ *
+ * @param text HTML document to scan. It must outlive the returned rows.
+ *
+ * @return Vector of rows in document order.
+ *
+ * @throws ParseError If a channel row is cut short.
+ */
+[[nodiscard]] std::vector<Row> scan_rows(const std::string_view text);
+
+/**
+ * @brief Split an HTML document into ranges of roughly equal size that start at "<tr>" tags, so that each range can be scanned by its own "RowScanner".
+ *
+ * A "<tr>" inside an attribute value (e.g., "<a href="?q=<tr>">") may be picked as a boundary. The scanner of the previous range then reports a row that ends past the boundary, and the caller must rescan the next range from the end of that row.
+ *
+ * @param text HTML document to split.
+ * @param parts Number of ranges to aim for (e.g., "8"). Fewer are returned if the document has fewer "<tr>" tags.
+ *
+ * @return Boundaries of the ranges, starting with "0" and ending with the size of the document (e.g., "{0, 5000, 10240}" for two ranges).
+ */
+[[nodiscard]] std::vector<std::size_t> split_rows(const std::string_view text,
+                                                  const std::size_t parts);
+
+}  // namespace core::html
@@ -0,0 +1,238 @@
+/**
+ * @file http.cpp
+ */
+
+#include <cstddef>      // for std::size_t
+#include <optional>     // for std::optional, std::nullopt
+#include <stdexcept>    // for std::invalid_argument
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+
+#include <fmt/core.h>
+
+#include "http.hpp"
+
+namespace core::http {
+
+namespace {
+
+/**
+ * @brief Private helper function to remove the spaces and tabs around a text.
+ *
+ * @param text Text to trim (e.g., " gzip ").
+ *
+ * @return Trimmed text (e.g., "gzip").
+ */
+[[nodiscard]] std::string_view trim(std::string_view text)
+{
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+/**
+ * @brief Private helper function to compare two ASCII texts, ignoring case.
+ *
+ * @param a First text (e.g., "Accept-Encoding").
+ * @param b Second text, in lowercase (e.g., "accept-encoding").
+ *
+ * @return True if the texts are equal, ignoring case, false otherwise.
+ */
+[[nodiscard]] bool equals_lowercase(const std::string_view a,
+                                    const std::string_view b)
+{
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        const char c = (a[i] >= 'A' && a[i] <= 'Z') ? static_cast<char>(a[i] - 'A' + 'a') : a[i];
+        if (c != b[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Private helper function to call a function for each item of a comma-separated header value.
+ *
+ * @tparam Function Type of "on_item".
+ *
+ * @param value Header value (e.g., "gzip;q=1.0, br").
+ * @param on_item Function to call with each trimmed, non-empty item (e.g., "gzip;q=1.0", then "br").
+ */
+template <typename Function>
+void for_each_item(const std::string_view value,
+                   const Function &on_item)
+{
+    std::size_t begin = 0;
+    while (begin <= value.size()) {
+        const std::size_t comma = value.find(',', begin);
+        const std::string_view item = trim(value.substr(begin, comma - begin));
+        if (!item.empty()) {
+            on_item(item);
+        }
+        if (comma == std::string_view::npos) {
+            break;
+        }
+        begin = comma + 1;
+    }
+}
+
+/**
+ * @brief Private helper function to check if an "Accept-Encoding" header allows gzip.
+ *
+ * @param value Header value (e.g., "gzip, deflate, br", or "gzip;q=0").
+ *
+ * @return True if "gzip", "x-gzip" or "*" is listed without a zero quality, false otherwise.
+ */
+[[nodiscard]] bool allows_gzip(const std::string_view value)
+{
+    bool allowed = false;
+    for_each_item(value, [&allowed](const std::string_view item) {
+        const std::size_t semicolon = item.find(';');
+        const std::string_view coding = trim(item.substr(0, semicolon));
+        if (!equals_lowercase(coding, "gzip") && !equals_lowercase(coding, "x-gzip") && coding != "*") {
+            return;
+        }
+        // A quality of zero (e.g., "q=0" or "q=0.000") means "not acceptable"
+        bool zero = false;
+        if (semicolon != std::string_view::npos) {
+            const std::string_view parameter = trim(item.substr(semicolon + 1));
+            if (parameter.size() > 2 && (parameter[0] == 'q' || parameter[0] == 'Q') && parameter[1] == '=') {
+                zero = parameter.find_first_not_of("0.", 2) == std::string_view::npos;
+            }
+        }
+        allowed = !zero;
+    });
+    return allowed;
+}
+
+}  // namespace
+
+std::optional<std::size_t> parse_request(const std::string_view buffer,
+                                         Request &request)
+{
+    const std::size_t head_end = buffer.find("\r\n\r\n");
+    if (head_end == std::string_view::npos) {
+        if (buffer.size() > max_request_size) {
+            throw std::invalid_argument("Request head is too large");
+        }
+        return std::nullopt;
+    }
+    if (head_end + 4 > max_request_size) {
+        throw std::invalid_argument("Request head is too large");
+    }
+    const std::string_view head = buffer.substr(0, head_end);
+    request = Request{};
+
+    // Request line (e.g., "GET /?x=1 HTTP/1.1")
+    const std::size_t line_end = head.find("\r\n");
+    const std::string_view line = head.substr(0, line_end);
+    const std::size_t first_space = line.find(' ');
+    const std::size_t second_space = first_space == std::string_view::npos ? std::string_view::npos : line.find(' ', first_space + 1);
+    if (first_space == 0 || second_space == std::string_view::npos || second_space == first_space + 1) {
+        throw std::invalid_argument(fmt::format("Malformed request line: {}", line));
+    }
+    request.method = line.substr(0, first_space);
+    const std::string_view target = line.substr(first_space + 1, second_space - first_space - 1);
+    const std::string_view version = line.substr(second_space + 1);
+    if (target.front() != '/') {
+        throw std::invalid_argument(fmt::format("Unsupported request target: {}", target));
+    }
+    request.path = target.substr(0, target.find_first_of("?#"));
+    if (version == "HTTP/1.0") {
+        request.keep_alive = false;
+    }
+    else if (version != "HTTP/1.1") {
+        throw std::invalid_argument(fmt::format("Unsupported HTTP version: {}", version));
+    }
+
+    // Headers (e.g., "Accept-Encoding: gzip"), one per line
+    std::size_t begin = line_end == std::string_view::npos ? head.size() : line_end + 2;
+    while (begin < head.size()) {
+        std::size_t end = head.find("\r\n", begin);
+        if (end == std::string_view::npos) {
+            end = head.size();
+        }
+        const std::string_view header = head.substr(begin, end - begin);
+        begin = end + 2;
+        const std::size_t colon = header.find(':');
+        if (colon == std::string_view::npos || colon == 0) {
+            throw std::invalid_argument(fmt::format("Malformed header: {}", header));
+        }
+        const std::string_view name = header.substr(0, colon);
+        const std::string_view value = trim(header.substr(colon + 1));
+        if (equals_lowercase(name, "if-none-match")) {
+            request.if_none_match = value;
+        }
+        else if (equals_lowercase(name, "accept-encoding")) {
+            request.accepts_gzip = allows_gzip(value);
+        }
+        else if (equals_lowercase(name, "connection")) {
+            for_each_item(value, [&request](const std::string_view option) {
+                if (equals_lowercase(option, "close")) {
+                    request.keep_alive = false;
+                }
+                else if (equals_lowercase(option, "keep-alive")) {
+                    request.keep_alive = true;
+                }
+            });
+        }
+        else if ((equals_lowercase(name, "content-length") && value != "0") || equals_lowercase(name, "transfer-encoding")) {
+            throw std::invalid_argument("Request bodies are not supported");
+        }
+    }
+    return head_end + 4;
+}
+
+bool matches_etag(const std::string_view if_none_match,
+                  const std::string_view etag)
+{
+    bool matches = false;
+    for_each_item(if_none_match, [&matches, &etag](std::string_view tag) {
+        // Weak comparison, as "If-None-Match" requires (RFC 9110, section 13.1.2)
+        if (tag.substr(0, 2) == "W/") {
+            tag.remove_prefix(2);
+        }
+        if (tag == "*" || tag == etag) {
+            matches = true;
+        }
+    });
+    return matches;
+}
+
+void append_status_line(std::string &buffer,
+                        const int status)
+{
+    std::string_view reason = "Error";
+    switch (status) {
+    case 200:
+        reason = "OK";
+        break;
+    case 304:
+        reason = "Not Modified";
+        break;
+    case 400:
+        reason = "Bad Request";
+        break;
+    case 404:
+        reason = "Not Found";
+        break;
+    case 405:
+        reason = "Method Not Allowed";
+        break;
+    case 503:
+        reason = "Service Unavailable";
+        break;
+    default:
+        break;
+    }
+    buffer.append(fmt::format("HTTP/1.1 {} {}\r\n", status, reason));
+}
+
+}  // namespace core::http
@@ -0,0 +1,88 @@
+/**
+ * @file http.hpp
+ *
+ * @brief Parse HTTP/1.1 requests and build the start of responses, for the loopback server.
+ */
+
+#pragma once
+
+#include <cstddef>      // for std::size_t
+#include <optional>     // for std::optional
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+
+namespace core::http {
+
+/**
+ * @brief Largest request head (request line and headers) that is accepted, in bytes (16 KiB).
+ */
+inline constexpr std::size_t max_request_size = 16 * 1024;
+
+/**
+ * @brief Struct that represents the parts of a request that the server uses.
+ *
+ * @note This struct is marked as `final` to prevent inheritance.
+ */
+struct Request final {
+    /**
+     * @brief Request method (e.g., "GET").
+     */
+    std::string method;
+
+    /**
+     * @brief Path of the request, without the query string (e.g., "/events").
+     */
+    std::string path;
+
+    /**
+     * @brief Value of the "If-None-Match" header (e.g., "\"5f2b...\""), or an empty string if not given.
+     */
+    std::string if_none_match;
+
+    /**
+     * @brief Whether the "Accept-Encoding" header allows gzip.
+     */
+    bool accepts_gzip = false;
+
+    /**
+     * @brief Whether the connection stays open after the response: by default for HTTP/1.1, and only on request for HTTP/1.0.
+     */
+    bool keep_alive = true;
+};
+
+/**
+ * @brief Parse the request at the start of a buffer.
+ *
+ * Header names are matched case-insensitively, and unknown headers are ignored. Requests with a body are rejected, because the server only answers "GET" and "HEAD".
+ *
+ * @param buffer Bytes received so far on a connection (e.g., "GET / HTTP/1.1\r\nHost: localhost\r\n\r\n").
+ * @param request Request to fill in.
+ *
+ * @return Size of the request in bytes, or std::nullopt if the buffer does not hold a complete request head yet.
+ *
+ * @throws std::invalid_argument If the request is malformed, has a body, or its head exceeds "max_request_size".
+ */
+[[nodiscard]] std::optional<std::size_t> parse_request(const std::string_view buffer,
+                                                       Request &request);
+
+/**
+ * @brief Check if an "If-None-Match" header matches an entity tag.
+ *
+ * @param if_none_match Value of the header (e.g., "\"a\", \"b\"", or "*").
+ * @param etag Entity tag of the current document, including the quotes (e.g., "\"b\"").
+ *
+ * @return True if any tag in the header matches (weak tags match too), false otherwise.
+ */
+[[nodiscard]] bool matches_etag(const std::string_view if_none_match,
+                                const std::string_view etag);
+
+/**
+ * @brief Append the status line of a response (e.g., "HTTP/1.1 304 Not Modified\r\n").
+ *
+ * @param buffer Buffer to append to.
+ * @param status Status code (e.g., "304"). Codes that the server does not send get the reason "Error".
+ */
+void append_status_line(std::string &buffer,
+                        const int status);
+
+}  // namespace core::http
@@ -0,0 +1,1021 @@
+/**
+ * @file import.cpp
+ */
+
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint32_t, std::uintmax_t
+#include <exception>    // for std::exception
+#include <filesystem>   // for std::filesystem
+#include <fstream>      // for std::ifstream
+#include <functional>   // for std::function
+#include <optional>     // for std::optional, std::nullopt
+#include <stdexcept>    // for std::runtime_error
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+#include <utility>      // for std::move
+#include <vector>       // for std::vector
+
+#include <fmt/core.h>
+
+#include "escape.hpp"
+#include "import.hpp"
+#include "io.hpp"
+#include "strings.hpp"
+
+namespace core::import {
+
+namespace {
+
+/**
+ * @brief Private helper function to convert an ASCII character to lowercase.
+ *
+ * @param c Character to convert (e.g., 'A').
+ *
+ * @return Lowercase character (e.g., 'a'). Non-ASCII characters are returned unchanged.
+ */
+[[nodiscard]] constexpr char to_lower(const char c)
+{
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+/**
+ * @brief Private helper function to lowercase an ASCII string.
+ *
+ * @param text Text to convert (e.g., "Channel Url").
+ *
+ * @return Lowercase text (e.g., "channel url").
+ */
+[[nodiscard]] std::string lowercase(const std::string_view text)
+{
+    std::string lower(text);
+    for (char &c : lower) {
+        c = to_lower(c);
+    }
+    return lower;
+}
+
+/**
+ * @brief Private helper function to parse hexadecimal or decimal digits.
+ *
+ * @param digits Digits to parse (e.g., "30C1").
+ * @param base Base of the digits ("10" or "16").
+ *
+ * @return Parsed value, or std::nullopt if the digits are empty, invalid or too large.
+ */
+[[nodiscard]] std::optional<std::uint32_t> parse_number(const std::string_view digits,
+                                                        const std::uint32_t base)
+{
+    if (digits.empty() || digits.size() > 8) {
+        return std::nullopt;
+    }
+    std::uint32_t value = 0;
+    for (const char c : digits) {
+        std::uint32_t digit;
+        if (c >= '0' && c <= '9') {
+            digit = static_cast<std::uint32_t>(c - '0');
+        }
+        else if (base == 16 && to_lower(c) >= 'a' && to_lower(c) <= 'f') {
+            digit = static_cast<std::uint32_t>(to_lower(c) - 'a' + 10);
+        }
+        else {
+            return std::nullopt;
+        }
+        value = value * base + digit;
+    }
+    return value;
+}
+
+/**
+ * @brief Private helper function to build a link from a YouTube channel ID.
+ *
+ * @param id Channel ID (e.g., "UCabc").
+ *
+ * @return Channel link (e.g., "https://www.youtube.com/channel/UCabc").
+ */
+[[nodiscard]] std::string link_from_channel_id(const std::string_view id)
+{
+    return fmt::format("https://www.youtube.com/channel/{}", id);
+}
+
+/**
+ * @brief Class that represents the shared part of every parser: validating records and passing them on.
+ *
+ * @note This class is marked as `final` to prevent inheritance.
+ */
+class Output final {
+  public:
+    /**
+     * @brief Construct a new Output object.
+     *
+     * @param on_record Function to call for each record.
+     */
+    explicit Output(const std::function<void(const Record &)> &on_record)
+        : on_record_(on_record),
+          records_(0) {}
+
+    /**
+     * @brief Trim and validate a record, then pass it on.
+     *
+     * @param record Record to emit. Its fields are trimmed in place.
+     */
+    void emit(Record &record)
+    {
+        record.channel.name = strings::trim_whitespace(record.channel.name);
+        record.channel.link = strings::trim_whitespace(record.channel.link);
+        record.channel.description = strings::trim_whitespace(record.channel.description);
+        if (record.error.empty() && record.channel.name.empty()) {
+            record.error = "missing name";
+        }
+        if (record.error.empty() && record.channel.link.empty()) {
+            record.error = "missing link";
+        }
+        ++this->records_;
+        this->on_record_(record);
+    }
+
+    /**
+     * @brief Report a record that could not be parsed at all.
+     *
+     * @param line 1-based line number of the record (e.g., "12").
+     * @param error Description of the problem (e.g., "unterminated string").
+     */
+    void fail(const std::size_t line,
+              const std::string &error)
+    {
+        Record record;
+        record.line = line;
+        record.error = error;
+        ++this->records_;
+        this->on_record_(record);
+    }
+
+    /**
+     * @brief Get the number of records passed on so far.
+     *
+     * @return Number of records (e.g., "1000").
+     */
+    [[nodiscard]] std::size_t get_records() const
+    {
+        return this->records_;
+    }
+
+  private:
+    /**
+     * @brief Function to call for each record.
+     */
+    const std::function<void(const Record &)> &on_record_;
+
+    /**
+     * @brief Number of records passed on so far.
+     */
+    std::size_t records_;
+};
+
+/**
+ * @brief Class that parses CSV (RFC 4180) incrementally, so that quoted fields may span lines and chunks.
+ *
+ * @note This class is marked as `final` to prevent inheritance.
+ */
+class CsvParser final {
+  public:
+    /**
+     * @brief Construct a new CsvParser object.
+     *
+     * @param output Output to pass records to.
+     */
+    explicit CsvParser(Output &output)
+        : output_(output) {}
+
+    /**
+     * @brief Parse the next chunk of the file.
+     *
+     * @param chunk Bytes of the file, following the previous chunk.
+     */
+    void feed(const std::string_view chunk)
+    {
+        for (const char c : chunk) {
+            if (this->in_quotes_) {
+                if (this->quote_pending_) {
+                    // A doubled quote is a literal quote, anything else ends the quoted part
+                    this->quote_pending_ = false;
+                    if (c == '"') {
+                        this->field_ += '"';
+                        continue;
+                    }
+                    this->in_quotes_ = false;
+                }
+                else {
+                    if (c == '"') {
+                        this->quote_pending_ = true;
+                    }
+                    else {
+                        if (c == '\n') {
+                            ++this->line_;
+                        }
+                        this->field_ += c;
+                    }
+                    continue;
+                }
+            }
+
+            switch (c) {
+            case '"':
+                // Quotes only start a quoted field at its beginning, stray quotes are kept as-is
+                if (this->field_.empty() && !this->quoted_) {
+                    this->in_quotes_ = true;
+                    this->quoted_ = true;
+                }
+                else {
+                    this->field_ += c;
+                }
+                break;
+            case ',':
+                this->end_field();
+                break;
+            case '\r':
+                break;
+            case '\n':
+                this->end_field();
+                this->end_record();
+                ++this->line_;
+                this->record_line_ = this->line_;
+                break;
+            default:
+                this->field_ += c;
+                break;
+            }
+        }
+    }
+
+    /**
+     * @brief Finish parsing at the end of the file.
+     */
+    void finish()
+    {
+        if (this->in_quotes_ && !this->quote_pending_) {
+            this->output_.fail(this->record_line_, "unterminated quoted field");
+            return;
+        }
+        this->in_quotes_ = false;
+        this->quote_pending_ = false;
+        this->end_field();
+        this->end_record();
+    }
+
+  private:
+    /**
+     * @brief Output to pass records to.
+     */
+    Output &output_;
+
+    /**
+     * @brief Fields of the current record.
+     */
+    std::vector<std::string> fields_;
+
+    /**
+     * @brief Current field.
+     */
+    std::string field_;
+
+    /**
+     * @brief Whether the parser is inside a quoted part of a field.
+     */
+    bool in_quotes_ = false;
+
+    /**
+     * @brief Whether the last character inside a quoted part was a quote, which is either the end of the quoted part or the first half of a doubled quote.
+     */
+    bool quote_pending_ = false;
+
+    /**
+     * @brief Whether the current field started with a quote.
+     */
+    bool quoted_ = false;
+
+    /**
+     * @brief 1-based number of the current line.
+     */
+    std::size_t line_ = 1;
+
+    /**
+     * @brief 1-based line number where the current record starts.
+     */
+    std::size_t record_line_ = 1;
+
+    /**
+     * @brief Whether the first row was looked at to find a header.
+     */
+    bool has_columns_ = false;
+
+    /**
+     * @brief Column of each field, or std::nullopt if the file does not have it.
+     */
+    std::optional<std::size_t> name_column_;
+    std::optional<std::size_t> link_column_;
+    std::optional<std::size_t> description_column_;
+    std::optional<std::size_t> id_column_;
+
+    /**
+     * @brief End the current field.
+     */
+    void end_field()
+    {
+        this->fields_.emplace_back(std::move(this->field_));
+        this->field_.clear();
+        this->quoted_ = false;
+    }
+
+    /**
+     * @brief End the current record, passing it on unless it is empty or the header.
+     */
+    void end_record()
+    {
+        // Skip empty lines
+        if (this->fields_.size() == 1 && this->fields_[0].empty()) {
+            this->fields_.clear();
+            return;
+        }
+
+        // Look for a header in the first row; without one, the columns are "name,link,description"
+        if (!this->has_columns_) {
+            this->has_columns_ = true;
+            if (this->find_columns()) {
+                this->fields_.clear();
+                return;
+            }
+            this->name_column_ = 0;
+            this->link_column_ = 1;
+            this->description_column_ = 2;
+        }
+
+        Record record;
+        record.line = this->record_line_;
+        const auto field = [this](const std::optional<std::size_t> &column) -> std::string {
+            return column && *column < this->fields_.size() ? this->fields_[*column] : std::string();
+        };
+        record.channel.name = field(this->name_column_);
+        record.channel.link = field(this->link_column_);
+        record.channel.description = field(this->description_column_);
+        const std::string id = strings::trim_whitespace(field(this->id_column_));
+        if (strings::trim_whitespace(record.channel.link).empty() && !id.empty()) {
+            record.channel.link = link_from_channel_id(id);
+        }
+        this->fields_.clear();
+        this->output_.emit(record);
+    }
+
+    /**
+     * @brief Check if the current record is a header, and if so, remember the column of each field.
+     *
+     * @return True if the record is a header, false otherwise.
+     */
+    [[nodiscard]] bool find_columns()
+    {
+        for (std::size_t i = 0; i < this->fields_.size(); ++i) {
+            const std::string header = lowercase(strings::trim_whitespace(this->fields_[i]));
+            if (header == "name" || header == "title" || header == "channel name" || header == "channel title") {
+                this->name_column_ = i;
+            }
+            else if (header == "link" || header == "url" || header == "channel link" || header == "channel url") {
+                this->link_column_ = i;
+            }
+            else if (header == "description" || header == "desc") {
+                this->description_column_ = i;
+            }
+            else if (header == "id" || header == "channel id" || header == "channel_id") {
+                this->id_column_ = i;
+            }
+        }
+        return this->name_column_ || this->link_column_ || this->id_column_;
+    }
+};
+
+/**
+ * @brief Class that parses a single JSON object with string values, skipping values of any other type.
+ *
+ * @note This class is marked as `final` to prevent inheritance.
+ */
+class JsonObjectParser final {
+  public:
+    /**
+     * @brief Construct a new JsonObjectParser object.
+     *
+     * @param text JSON text of a single object (e.g., "{"name": "Noriyaro"}").
+     */
+    explicit JsonObjectParser(const std::string_view text)
+        : text_(text),
+          pos_(0) {}
+
+    /**
+     * @brief Parse the object into a record.
+     *
+     * @param record Record to fill in.
+     *
+     * @throws std::runtime_error If the text is not a single JSON object.
+     */
+    void parse(Record &record)
+    {
+        std::string id;
+        this->expect('{');
+        if (!this->consume('}')) {
+            do {
+                const std::string key = lowercase(this->parse_string());
+                this->expect(':');
+                std::string *target = nullptr;
+                if (key == "name" || key == "title" || key == "channel_title") {
+                    target = &record.channel.name;
+                }
+                else if (key == "link" || key == "url" || key == "channel_url") {
+                    target = &record.channel.link;
+                }
+                else if (key == "description" || key == "desc") {
+                    target = &record.channel.description;
+                }
+                else if (key == "id" || key == "channel_id" || key == "channelid") {
+                    target = &id;
+                }
+                this->skip_space();
+                if (target != nullptr && this->peek() == '"') {
+                    *target = this->parse_string();
+                }
+                else {
+                    this->skip_value();
+                }
+            } while (this->consume(','));
+            this->expect('}');
+        }
+        this->skip_space();
+        if (this->pos_ != this->text_.size()) {
+            throw std::runtime_error("unexpected text after the object");
+        }
+        if (strings::trim_whitespace(record.channel.link).empty() && !id.empty()) {
+            record.channel.link = link_from_channel_id(id);
+        }
+    }
+
+  private:
+    /**
+     * @brief JSON text being parsed.
+     */
+    std::string_view text_;
+
+    /**
+     * @brief Current byte offset into the text.
+     */
+    std::size_t pos_;
+
+    /**
+     * @brief Skip JSON whitespace.
+     */
+    void skip_space()
+    {
+        while (this->pos_ < this->text_.size() && (this->text_[this->pos_] == ' ' || this->text_[this->pos_] == '\t' || this->text_[this->pos_] == '\r' || this->text_[this->pos_] == '\n')) {
+            ++this->pos_;
+        }
+    }
+
+    /**
+     * @brief Get the current character without consuming it.
+     *
+     * @return Current character, or '\0' at the end of the text.
+     */
+    [[nodiscard]] char peek() const
+    {
+        return this->pos_ < this->text_.size() ? this->text_[this->pos_] : '\0';
+    }
+
+    /**
+     * @brief Consume a character if it comes next, after any whitespace.
+     *
+     * @param c Character to consume (e.g., ',').
+     *
+     * @return True if the character was consumed, false otherwise.
+     */
+    [[nodiscard]] bool consume(const char c)
+    {
+        this->skip_space();
+        if (this->peek() == c) {
+            ++this->pos_;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Consume a character that must come next, after any whitespace.
+     *
+     * @param c Character to consume (e.g., ':').
+     *
+     * @throws std::runtime_error If the character does not come next.
+     */
+    void expect(const char c)
+    {
+        if (!this->consume(c)) {
+            throw std::runtime_error(fmt::format("expected '{}' at column {}", c, this->pos_ + 1));
+        }
+    }
+
+    /**
+     * @brief Parse the four hexadecimal digits of a "\u" escape.
+     *
+     * @return Value of the digits (e.g., "0x30C1").
+     *
+     * @throws std::runtime_error If the digits are missing or invalid.
+     */
+    [[nodiscard]] std::uint32_t parse_hex4()
+    {
+        const std::optional<std::uint32_t> value = this->pos_ + 4 <= this->text_.size() ? parse_number(this->text_.substr(this->pos_, 4), 16) : std::nullopt;
+        if (!value) {
+            throw std::runtime_error(fmt::format("invalid unicode escape at column {}", this->pos_ + 1));
+        }
+        this->pos_ += 4;
+        return *value;
+    }
+
+    /**
+     * @brief Parse a string, decoding its escapes to UTF-8.
+     *
+     * @return Decoded string.
+     *
+     * @throws std::runtime_error If the string is unterminated or has an invalid escape.
+     */
+    [[nodiscard]] std::string parse_string()
+    {
+        this->expect('"');
+        std::string value;
+        while (true) {
+            if (this->pos_ >= this->text_.size()) {
+                throw std::runtime_error("unterminated string");
+            }
+            const char c = this->text_[this->pos_++];
+            if (c == '"') {
+                return value;
+            }
+            if (c != '\\') {
+                value += c;
+                continue;
+            }
+            if (this->pos_ >= this->text_.size()) {
+                throw std::runtime_error("unterminated string");
+            }
+            const char escape = this->text_[this->pos_++];
+            switch (escape) {
+            case '"':
+            case '\\':
+            case '/':
+                value += escape;
+                break;
+            case 'b':
+                value += '\b';
+                break;
+            case 'f':
+                value += '\f';
+                break;
+            case 'n':
+                value += '\n';
+                break;
+            case 'r':
+                value += '\r';
+                break;
+            case 't':
+                value += '\t';
+                break;
+            case 'u': {
+                std::uint32_t code_point = this->parse_hex4();
+                // Combine a surrogate pair (e.g., "🚗") into a single code point
+                if (code_point >= 0xD800 && code_point <= 0xDBFF && this->text_.substr(this->pos_, 2) == "\\u") {
+                    this->pos_ += 2;
+                    const std::uint32_t low = this->parse_hex4();
+                    code_point = (low >= 0xDC00 && low <= 0xDFFF) ? 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00) : 0xFFFD;
+                }
+                strings::append_utf8(value, code_point);
+                break;
+            }
+            default:
+                throw std::runtime_error(fmt::format("invalid escape '\\{}'", escape));
+            }
+        }
+    }
+
+    /**
+     * @brief Skip a value of any type.
+     *
+     * @throws std::runtime_error If the value is missing or unterminated.
+     */
+    void skip_value()
+    {
+        this->skip_space();
+        const char c = this->peek();
+        if (c == '"') {
+            static_cast<void>(this->parse_string());
+            return;
+        }
+        if (c == '{' || c == '[') {
+            // Skip a nested object or array, minding brackets inside strings
+            std::size_t depth = 0;
+            do {
+                const char n = this->peek();
+                if (n == '\0') {
+                    throw std::runtime_error("unterminated object or array");
+                }
+                if (n == '"') {
+                    static_cast<void>(this->parse_string());
+                    continue;
+                }
+                if (n == '{' || n == '[') {
+                    ++depth;
+                }
+                else if (n == '}' || n == ']') {
+                    --depth;
+                }
+                ++this->pos_;
+            } while (depth > 0);
+            return;
+        }
+        // Number, true, false or null
+        const std::size_t begin = this->pos_;
+        while (this->pos_ < this->text_.size() && this->text_[this->pos_] != ',' && this->text_[this->pos_] != '}' && this->text_[this->pos_] != ']' && this->text_[this->pos_] != ' ') {
+            ++this->pos_;
+        }
+        if (this->pos_ == begin) {
+            throw std::runtime_error(fmt::format("expected a value at column {}", begin + 1));
+        }
+    }
+};
+
+/**
+ * @brief Class that parses JSON Lines incrementally, one object per line.
+ *
+ * @note This class is marked as `final` to prevent inheritance.
+ */
+class JsonLinesParser final {
+  public:
+    /**
+     * @brief Construct a new JsonLinesParser object.
+     *
+     * @param output Output to pass records to.
+     */
+    explicit JsonLinesParser(Output &output)
+        : output_(output) {}
+
+    /**
+     * @brief Parse the next chunk of the file.
+     *
+     * @param chunk Bytes of the file, following the previous chunk.
+     */
+    void feed(std::string_view chunk)
+    {
+        while (!chunk.empty()) {
+            const std::size_t end = chunk.find('\n');
+            this->line_text_.append(chunk.substr(0, end));
+            if (end == std::string_view::npos) {
+                return;
+            }
+            chunk.remove_prefix(end + 1);
+            this->end_line();
+        }
+    }
+
+    /**
+     * @brief Finish parsing at the end of the file.
+     */
+    void finish()
+    {
+        this->end_line();
+    }
+
+  private:
+    /**
+     * @brief Output to pass records to.
+     */
+    Output &output_;
+
+    /**
+     * @brief Text of the current line so far.
+     */
+    std::string line_text_;
+
+    /**
+     * @brief 1-based number of the current line.
+     */
+    std::size_t line_ = 1;
+
+    /**
+     * @brief Parse the current line, skipping blank lines.
+     */
+    void end_line()
+    {
+        std::string text = strings::trim_whitespace(this->line_text_);
+        this->line_text_.clear();
+        const std::size_t line = this->line_++;
+
+        // Also accept a JSON array with one object per line, as written by "export json"
+        if (!text.empty() && text.back() == ',') {
+            text.pop_back();
+        }
+        if (text.empty() || text == "[" || text == "]") {
+            return;
+        }
+        Record record;
+        record.line = line;
+        try {
+            JsonObjectParser(text).parse(record);
+        }
+        catch (const std::exception &e) {
+            this->output_.fail(line, e.what());
+            return;
+        }
+        this->output_.emit(record);
+    }
+};
+
+/**
+ * @brief Class that parses OPML incrementally, looking only at "<outline>" tags.
+ *
+ * Tags are collected across chunk boundaries, so only the current tag is held in memory. Text between tags is ignored.
+ *
+ * @note This class is marked as `final` to prevent inheritance.
+ */
+class OpmlParser final {
+  public:
+    /**
+     * @brief Construct a new OpmlParser object.
+     *
+     * @param output Output to pass records to.
+     */
+    explicit OpmlParser(Output &output)
+        : output_(output) {}
+
+    /**
+     * @brief Parse the next chunk of the file.
+     *
+     * @param chunk Bytes of the file, following the previous chunk.
+     */
+    void feed(const std::string_view chunk)
+    {
+        for (const char c : chunk) {
+            if (c == '\n') {
+                ++this->line_;
+            }
+            if (!this->in_tag_) {
+                if (c == '<') {
+                    this->in_tag_ = true;
+                    this->tag_.clear();
+                    this->tag_line_ = this->line_;
+                }
+                continue;
+            }
+            // Inside a tag, ">" only ends it outside of attribute values, and comments end with "-->"
+            if (this->quote_ != '\0') {
+                if (c == this->quote_) {
+                    this->quote_ = '\0';
+                }
+            }
+            else if ((c == '"' || c == '\'') && !this->is_comment()) {
+                this->quote_ = c;
+            }
+            else if (c == '>' && (!this->is_comment() || (this->tag_.size() >= 5 && this->tag_.compare(this->tag_.size() - 2, 2, "--") == 0))) {
+                this->in_tag_ = false;
+                this->end_tag();
+                continue;
+            }
+            this->tag_ += c;
+        }
+    }
+
+    /**
+     * @brief Finish parsing at the end of the file.
+     */
+    void finish()
+    {
+        if (this->in_tag_) {
+            this->output_.fail(this->tag_line_, "unterminated tag");
+        }
+    }
+
+  private:
+    /**
+     * @brief Output to pass records to.
+     */
+    Output &output_;
+
+    /**
+     * @brief Text of the current tag, without the angle brackets.
+     */
+    std::string tag_;
+
+    /**
+     * @brief Whether the parser is inside a tag.
+     */
+    bool in_tag_ = false;
+
+    /**
+     * @brief Quote of the attribute value the parser is inside, or '\0'.
+     */
+    char quote_ = '\0';
+
+    /**
+     * @brief 1-based number of the current line.
+     */
+    std::size_t line_ = 1;
+
+    /**
+     * @brief 1-based line number where the current tag starts.
+     */
+    std::size_t tag_line_ = 1;
+
+    /**
+     * @brief Check if the current tag is a comment.
+     *
+     * @return True if the tag starts with "!--", false otherwise.
+     */
+    [[nodiscard]] bool is_comment() const
+    {
+        return this->tag_.size() >= 3 && this->tag_.compare(0, 3, "!--") == 0;
+    }
+
+    /**
+     * @brief Handle a complete tag, passing on a record if it is an "<outline>" with a link.
+     */
+    void end_tag()
+    {
+        const std::string_view tag = this->tag_;
+        if (tag.size() < 8 || lowercase(tag.substr(0, 7)) != "outline" || (tag[7] != ' ' && tag[7] != '\t' && tag[7] != '\r' && tag[7] != '\n' && tag[7] != '/')) {
+            return;
+        }
+
+        // Parse the attributes (e.g., "text="Noriyaro" xmlUrl='...'")
+        std::string text;
+        std::string title;
+        std::string html_url;
+        std::string xml_url;
+        std::string description;
+        std::size_t pos = 7;
+        while (pos < tag.size()) {
+            const std::size_t name_begin = tag.find_first_not_of(" \t\r\n/", pos);
+            if (name_begin == std::string_view::npos) {
+                break;
+            }
+            const std::size_t equals = tag.find('=', name_begin);
+            if (equals == std::string_view::npos) {
+                break;
+            }
+            const std::string name = lowercase(strings::trim_whitespace(tag.substr(name_begin, equals - name_begin)));
+            const std::size_t quote = tag.find_first_not_of(" \t\r\n", equals + 1);
+            if (quote == std::string_view::npos || (tag[quote] != '"' && tag[quote] != '\'')) {
+                this->output_.fail(this->tag_line_, "unquoted attribute value in '<outline>'");
+                return;
+            }
+            const std::size_t value_end = tag.find(tag[quote], quote + 1);
+            if (value_end == std::string_view::npos) {
+                this->output_.fail(this->tag_line_, "unterminated attribute value in '<outline>'");
+                return;
+            }
+            std::string value = escape::unescape(tag.substr(quote + 1, value_end - quote - 1));
+            if (name == "text") {
+                text = std::move(value);
+            }
+            else if (name == "title") {
+                title = std::move(value);
+            }
+            else if (name == "htmlurl") {
+                html_url = std::move(value);
+            }
+            else if (name == "xmlurl") {
+                xml_url = std::move(value);
+            }
+            else if (name == "description") {
+                description = std::move(value);
+            }
+            pos = value_end + 1;
+        }
+
+        // Outlines without a URL are folders, not channels
+        if (html_url.empty() && xml_url.empty()) {
+            return;
+        }
+
+        // YouTube's feeds name the channel in the query (e.g., ".../feeds/videos.xml?channel_id=UC...")
+        Record record;
+        record.line = this->tag_line_;
+        record.channel.name = text.empty() ? title : text;
+        record.channel.description = description;
+        if (!html_url.empty()) {
+            record.channel.link = html_url;
+        }
+        else if (const std::size_t id = xml_url.find("channel_id="); id != std::string::npos) {
+            record.channel.link = link_from_channel_id(xml_url.substr(id + 11, xml_url.find('&', id) - (id + 11)));
+        }
+        else {
+            record.channel.link = xml_url;
+        }
+        this->output_.emit(record);
+    }
+};
+
+/**
+ * @brief Private helper function to feed a file to a parser in fixed-size chunks.
+ *
+ * @tparam Parser Parser with "feed(std::string_view)" and "finish()" members (e.g., "CsvParser").
+ *
+ * @param path Path to the file.
+ * @param parser Parser to feed.
+ * @param output Output of the parser, used to count records.
+ * @param on_progress Function to call after each chunk.
+ * @param chunk_size Number of bytes to read at a time.
+ */
+template <typename Parser>
+void stream(const std::filesystem::path &path,
+            Parser &parser,
+            const Output &output,
+            const std::function<void(const Progress &)> &on_progress,
+            const std::size_t chunk_size)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Failed to open file");
+    }
+    Progress progress;
+    progress.total_bytes = std::filesystem::file_size(path);
+
+    // Skip a UTF-8 byte order mark, which spreadsheet programs like to add
+    char bom[3] = {};
+    file.read(bom, 3);
+    if (file.gcount() == 3 && std::string_view(bom, 3) == "\xEF\xBB\xBF") {
+        progress.bytes_read = 3;
+    }
+    else {
+        file.clear();
+        file.seekg(0);
+    }
+
+    std::vector<char> buffer(chunk_size > 0 ? chunk_size : 1);
+    while (file) {
+        file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        const auto count = static_cast<std::size_t>(file.gcount());
+        if (count == 0) {
+            break;
+        }
+        parser.feed(std::string_view(buffer.data(), count));
+        progress.bytes_read += count;
+        progress.records = output.get_records();
+        if (on_progress) {
+            on_progress(progress);
+        }
+    }
+    if (file.bad()) {
+        throw std::runtime_error("Failed to read file");
+    }
+    parser.finish();
+}
+
+}  // namespace
+
+std::optional<Format> detect_format(const std::filesystem::path &path)
+{
+    const std::string extension = lowercase(path.extension().string());
+    if (extension == ".csv") {
+        return Format::Csv;
+    }
+    if (extension == ".jsonl" || extension == ".ndjson" || extension == ".json") {
+        return Format::JsonLines;
+    }
+    if (extension == ".opml" || extension == ".xml") {
+        return Format::Opml;
+    }
+    return std::nullopt;
+}
+
+void read(const std::filesystem::path &path,
+          const Format format,
+          const std::function<void(const Record &)> &on_record,
+          const std::function<void(const Progress &)> &on_progress,
+          const std::size_t chunk_size)
+{
+    try {
+        Output output(on_record);
+        switch (format) {
+        case Format::Csv: {
+            CsvParser parser(output);
+            stream(path, parser, output, on_progress, chunk_size);
+            break;
+        }
+        case Format::JsonLines: {
+            JsonLinesParser parser(output);
+            stream(path, parser, output, on_progress, chunk_size);
+            break;
+        }
+        case Format::Opml: {
+            OpmlParser parser(output);
+            stream(path, parser, output, on_progress, chunk_size);
+            break;
+        }
+        }
+    }
+    catch (const std::exception &e) {
+        throw std::runtime_error(fmt::format("Failed to import file '{}': {}", path.string(), e.what()));
+    }
+}
+
+}  // namespace core::import
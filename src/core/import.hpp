@@ -0,0 +1,112 @@
+/**
+ * @file import.hpp
+ *
+ * @brief Stream YouTube channels from subscription exports.
+ */
+
+#pragma once
+
+#include <cstddef>     // for std::size_t
+#include <cstdint>     // for std::uintmax_t
+#include <filesystem>  // for std::filesystem
+#include <functional>  // for std::function
+#include <optional>    // for std::optional
+#include <string>      // for std::string
+
+#include "io.hpp"
+
+namespace core::import {
+
+/**
+ * @brief File formats that can be imported.
+ */
+enum class Format {
+    /**
+     * @brief Comma-separated values, with an optional header row (e.g., "Channel Id,Channel Url,Channel Title" from Google Takeout). Without a header, the columns are "name,link,description".
+     */
+    Csv,
+
+    /**
+     * @brief One JSON object per line, with "name" (or "title"), "link" (or "url") and "description" keys. A JSON array with one object per line (e.g., from "export json") is also accepted.
+     */
+    JsonLines,
+
+    /**
+     * @brief OPML subscription list, with one "<outline>" element per channel (e.g., from a feed reader or YouTube's RSS export).
+     */
+    Opml,
+};
+
+/**
+ * @brief Struct that represents a single record read from the file.
+ *
+ * @note This struct is marked as `final` to prevent inheritance.
+ */
+struct Record final {
+    /**
+     * @brief Channel read from the record. The description may be empty, because most exports do not have one.
+     */
+    io::Channel channel{"", "", ""};
+
+    /**
+     * @brief 1-based line number where the record starts (e.g., "12").
+     */
+    std::size_t line = 0;
+
+    /**
+     * @brief Description of the problem if the record is invalid (e.g., "missing link"), or an empty string if it is valid.
+     */
+    std::string error;
+};
+
+/**
+ * @brief Struct that represents how far the import has progressed.
+ *
+ * @note This struct is marked as `final` to prevent inheritance.
+ */
+struct Progress final {
+    /**
+     * @brief Number of bytes read so far (e.g., "65536").
+     */
+    std::uintmax_t bytes_read = 0;
+
+    /**
+     * @brief Size of the file in bytes (e.g., "1048576").
+     */
+    std::uintmax_t total_bytes = 0;
+
+    /**
+     * @brief Number of records read so far, including invalid ones (e.g., "1000").
+     */
+    std::size_t records = 0;
+};
+
+/**
+ * @brief Guess the format of a file from its extension.
+ *
+ * @param path Path to the file (e.g., "~/subscriptions.csv").
+ *
+ * @return Format (".csv", ".jsonl", ".ndjson", ".json", ".opml" or ".xml"), or std::nullopt if the extension is unknown.
+ */
+[[nodiscard]] std::optional<Format> detect_format(const std::filesystem::path &path);
+
+/**
+ * @brief Read every record of a file, in fixed-size chunks.
+ *
+ * Only one chunk and the record being parsed are held in memory at a time, so memory use does not grow with the size of the file. A UTF-8 byte order mark is skipped. Invalid records (including a file that ends in the middle of one, e.g., an unterminated quote) are reported with an error instead of stopping the import.
+ *
+ * @param path Path to the file (e.g., "~/subscriptions.csv").
+ * @param format Format of the file (e.g., "Format::Csv").
+ * @param on_record Function to call for each record, in file order.
+ * @param on_progress Function to call after each chunk (default: none).
+ * @param chunk_size Number of bytes to read at a time (default: 64 KiB).
+ *
+ * @throws std::runtime_error If the file cannot be opened or read.
+ */
+void read(const std::filesystem::path &path,
+          const Format format,
+          const std::function<void(const Record &)> &on_record,
+          const std::function<void(const Progress &)> &on_progress = nullptr,
+          const std::size_t chunk_size = 64 * 1024);
+
+}  // namespace core::import
@@ -2,230 +2,909 @@
  * @file io.cpp
  */
 
-#include <algorithm>    // for std::sort
-#include <exception>    // for std::exception
-#include <filesystem>   // for std::filesystem
-#include <fstream>      // for std::ifstream, std::ofstream
-#include <regex>        // for std::regex, std::smatch, std::sregex_iterator
-#include <sstream>      // for std::ostringstream
-#include <stdexcept>    // for std::runtime_error
-#include <string>       // for std::string
-#include <string_view>  // for std::string_view
-#include <vector>       // for std::vector
+#include <algorithm>         // for std::stable_sort
+#include <cerrno>            // for errno, EINTR
+#include <cstddef>           // for std::size_t, std::ptrdiff_t
+#include <cstdio>            // for std::rename
+#include <exception>         // for std::exception, std::exception_ptr, std::current_exception, std::rethrow_exception
+#include <filesystem>        // for std::filesystem
+#include <fstream>           // for std::ofstream
+#include <functional>        // for std::ref
+#include <initializer_list>  // for std::initializer_list
+#include <ios>               // for std::ios, std::streamoff, std::streamsize
+#include <optional>          // for std::optional, std::nullopt
+#include <queue>             // for std::priority_queue
+#include <stdexcept>         // for std::runtime_error
+#include <string>            // for std::string
+#include <string_view>       // for std::string_view
+#include <system_error>      // for std::error_code, std::system_error
+#include <thread>            // for std::thread
+#include <utility>           // for std::exchange, std::move, std::pair
+#include <vector>            // for std::vector
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN  // Exclude rarely-used stuff from Windows headers
+#include <windows.h>         // for CreateFileW, CreateFileMappingW, MapViewOfFile, UnmapViewOfFile, WriteFile, FlushFileBuffers, MoveFileExW
+#else                        // Assume POSIX for macOS and GNU/Linux
+#include <fcntl.h>           // for open, fcntl, O_RDONLY, O_WRONLY, O_CREAT, O_TRUNC, O_CLOEXEC
+#include <sys/mman.h>        // for mmap, munmap, posix_madvise
+#include <sys/stat.h>        // for fstat, stat, fchmod, struct stat
+#include <sys/types.h>       // for ssize_t
+#include <sys/uio.h>         // for writev, struct iovec
+#include <unistd.h>          // for close, fsync, fdatasync, getpid
+#endif
 
 #include <fmt/core.h>
 
+#include "backup.hpp"
+#include "escape.hpp"
+#include "html.hpp"
 #include "io.hpp"
+#include "render.hpp"
 
 namespace core::io {
 
 namespace {
 
 /**
- * @brief Private helper variable that contains the start of the HTML file.
+ * @brief Private helper function to backup and map a file before loading it.
  *
- * @note This must be followed by rows.
- */
-constexpr std::string_view html_template_start = R"(<!DOCTYPE html>
-<html lang="en">
-
-  <head>
-    <meta charset="UTF-8">
-    <meta name="viewport" content="width=device-width, initial-scale=1.0">
-    <title>Subscriptions</title>
-    <style>
-      body {
-        background-color: black;
-        border: none;
-        color: #d3d3d3;
-        font-family: Arial, Helvetica, sans-serif;
-        height: 100%;
-        margin-top: 2rem;
-        margin-bottom: 2rem;
-        overflow-x: hidden;
-        overflow-y: scroll;
-        text-align: center;
-      }
-
-      * {
-        margin: 0;
-        padding: 0;
-      }
-
-      a {
-        color: #ff6961;
-        text-decoration: none;
-      }
-
-      a:hover {
-        color: #ff9eb5;
-      }
-
-      main {
-        display: block;
-        margin: auto;
-        max-width: 600px;
-      }
-
-      main>table {
-        background-color: #0d0d0d;
-        border-radius: 15px;
-        border-spacing: 2em;
-        border: 2px solid #262626;
-        table-layout: fixed;
-        width: 100%;
-      }
-
-      main>table tr>th {
-        color: #bfbfbf;
-        font-size: 130%;
-        font-weight: bold;
-      }
-
-      main>table tr>td {
-        color: #828282;
-        overflow-wrap: anywhere;
-      }
-    </style>
-  </head>
-
-  <body>
-    <main>
-      <table>
-        <tr>
-          <th>Name</th>
-          <th>Desc<wbr>ription</th>
-        </tr>
-)";
-
-/**
- * @brief Private helper variable that contains the end of the HTML file.
+ * @param input_path Path to the HTML file (e.g., "~/data.html").
+ * @param create_backup If true, create a backup of the original file before mapping it.
  *
- * @note This must be preceded by rows.
+ * @return Read-only mapping of the file.
+ *
+ * @throws std::runtime_error If the file does not exist, or if the backup or mapping fails.
  */
-constexpr std::string_view html_template_end = R"(      </table>
-    </main>
-  </body>
-
-</html>
-)";
-
-}  // namespace
-
-std::vector<Channel> load(const std::filesystem::path &input_path,
-                          const bool create_backup)
+[[nodiscard]] MappedFile open_for_loading(const std::filesystem::path &input_path,
+                                          const bool create_backup)
 {
     // Error: Doesn't exist
     if (!std::filesystem::exists(input_path)) {
         throw std::runtime_error(fmt::format("File does not exist: {}", input_path.string()));
     }
-    // Otherwise, load the file
+    // Otherwise, map the file
     try {
         // Backup to prevent data loss
         if (create_backup) {
-            // Create a backup path by appending ".bak" to the input path
-            auto backup_path = input_path;
-            backup_path += ".bak";
-
-            std::filesystem::copy_file(
-                input_path,                                        // Source (filepath.ext)
-                backup_path,                                       // Destination (filepath.ext.bak)
-                std::filesystem::copy_options::overwrite_existing  // Overwrite if exists
-            );
+            static_cast<void>(backup::create(input_path));
         }
+        return MappedFile(input_path);
+    }
+    catch (const std::exception &e) {
+        throw std::runtime_error(fmt::format("Failed to load file '{}': {}", input_path.string(), e.what()));
+    }
+}
 
-        // Initialize a string to store the file contents
-        std::string text;
+#if !defined(_WIN32)
+/**
+ * @brief Private helper function to sync an open file descriptor to stable storage.
+ *
+ * @param fd File descriptor (e.g., "3").
+ * @param durability How hard to try (Durability::None does nothing).
+ *
+ * @return True if succeeded, false otherwise.
+ */
+[[nodiscard]] bool sync_descriptor(const int fd,
+                                   const Durability durability)
+{
+    switch (durability) {
+    case Durability::None:
+        return true;
+    case Durability::Data:
+#if defined(__APPLE__)
+        // macOS does not declare fdatasync
+        return fsync(fd) == 0;
+#else
+        return fdatasync(fd) == 0;
+#endif
+    case Durability::Full:
+#if defined(__APPLE__)
+        // On macOS, fsync does not flush the drive's cache, F_FULLFSYNC does
+        return fcntl(fd, F_FULLFSYNC) == 0 || fsync(fd) == 0;
+#else
+        return fsync(fd) == 0;
+#endif
+    }
+    return false;
+}
+#endif  // !defined(_WIN32)
 
-        {
-            // Open the file in read mode
-            std::ifstream file(input_path);
+/**
+ * @brief Private helper function to sync a file that was written through a stream to stable storage.
+ *
+ * @param path Path to the file (e.g., "~/data.html").
+ * @param durability How hard to try (Durability::None does nothing).
+ *
+ * @throws std::runtime_error If the sync fails.
+ */
+void sync_file(const std::filesystem::path &path,
+               const Durability durability)
+{
+    if (durability == Durability::None) {
+        return;
+    }
+#if defined(_WIN32)
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    const bool synced = file != INVALID_HANDLE_VALUE && FlushFileBuffers(file);
+    if (file != INVALID_HANDLE_VALUE) {
+        CloseHandle(file);
+    }
+#else
+    // Syncing flushes the file itself, not just the writes made through this descriptor
+    const int fd = open(path.c_str(), O_RDONLY);
+    const bool synced = fd != -1 && sync_descriptor(fd, durability);
+    if (fd != -1) {
+        close(fd);
+    }
+#endif
+    if (!synced) {
+        throw std::runtime_error("Failed to sync file to disk");
+    }
+}
 
-            // Error: File cannot be opened
-            if (!file) {
-                throw std::runtime_error("Failed to open file for reading");
-            }
+#if !defined(_WIN32)
+/**
+ * @brief Private helper variable that contains the largest number of parts to gather into a single write, which is the smallest "IOV_MAX" of the supported systems.
+ */
+constexpr std::size_t max_write_parts = 1024;
+#endif  // !defined(_WIN32)
 
-            // Read the file contents into a string
-            std::ostringstream buffer;
-            buffer << file.rdbuf();
-            text = buffer.str();
-        }  // Close the file and deallocate buffer, keeping only the text in memory
-
-        // Initialize a vector of channels
-        std::vector<Channel> channels;
-
-        // Define a regex pattern to match the HTML structure
-        static const std::regex pattern(
-            R"(<tr>\s*<td><a\s+[^>]*href=\"([^\"]+)\"[^>]*>([^<]+)</a></td>\s*<td>([^<]+)</td>\s*</tr>)",
-            std::regex::icase | std::regex::optimize);
-
-        // Iterate over the matches
-        std::sregex_iterator it(text.cbegin(), text.cend(), pattern);
-        std::sregex_iterator end;
-        while (it != end) {
-            std::smatch match = *it;
-            // If the match size is 4, we have a valid match
-            if (match.size() == 4) {
-                // match[0] is the whole match, we need match[1], match[2], and match[3]
-                const std::string link = match[1].str();
-                const std::string name = match[2].str();
-                const std::string description = match[3].str();
-
-                channels.emplace_back(name, link, description);
+/**
+ * @brief Private helper function to atomically replace a file with new contents.
+ *
+ * The contents are written to a temporary file in the same directory (so the rename never crosses filesystems), synced according to the durability level, and renamed over the target. On failure, the temporary file is removed and the target is left untouched.
+ *
+ * @param path Path to the file to replace (e.g., "~/data.html").
+ * @param parts New contents of the file, as parts to write in order, so that a document need not be copied into one buffer first.
+ * @param durability How hard to try to get the file onto stable storage.
+ *
+ * @throws SyncError If the file was replaced, but the directory could not be synced.
+ * @throws std::runtime_error If any other step fails, in which case the file is left untouched.
+ */
+void write_atomically(const std::filesystem::path &path,
+                      const std::vector<std::string_view> &parts,
+                      const Durability durability)
+{
+    // Name the temporary file after the process, so that concurrent writers don't collide
+    std::filesystem::path temp_path = path;
+#if defined(_WIN32)
+    temp_path += fmt::format(".{}.tmp", GetCurrentProcessId());
+#else
+    temp_path += fmt::format(".{}.tmp", getpid());
+#endif
+
+    try {
+#if defined(_WIN32)
+        HANDLE file = CreateFileW(temp_path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("Failed to open file for writing");
+        }
+        // WriteFile takes a 32-bit size, so write each part in chunks
+        bool ok = true;
+        for (const std::string_view part : parts) {
+            std::size_t written = 0;
+            while (ok && written < part.size()) {
+                const std::size_t remaining = part.size() - written;
+                const auto chunk = static_cast<DWORD>(remaining < (std::size_t{1} << 30) ? remaining : (std::size_t{1} << 30));
+                DWORD done = 0;
+                ok = WriteFile(file, part.data() + written, chunk, &done, nullptr) && done > 0;
+                written += done;
+            }
+        }
+        ok = ok && (durability == Durability::None || FlushFileBuffers(file));
+        CloseHandle(file);
+        if (!ok) {
+            throw std::runtime_error("Failed to write file");
+        }
+        const DWORD flags = MOVEFILE_REPLACE_EXISTING | (durability == Durability::Full ? MOVEFILE_WRITE_THROUGH : 0);
+        if (!MoveFileExW(temp_path.c_str(), path.c_str(), flags)) {
+            throw std::runtime_error("Failed to replace file");
+        }
+#else
+        const int fd = open(temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+        if (fd == -1) {
+            throw std::runtime_error("Failed to open file for writing");
+        }
+        // Keep the permissions of the file being replaced
+        struct stat st;
+        if (stat(path.c_str(), &st) == 0) {
+            static_cast<void>(fchmod(fd, st.st_mode & 07777));
+        }
+        // Write everything in as few system calls as possible, gathering up to "max_write_parts" parts per call, and retrying on partial writes and signals
+        std::vector<struct iovec> vectors;
+        vectors.reserve(parts.size());
+        for (const std::string_view part : parts) {
+            if (!part.empty()) {
+                vectors.push_back(iovec{const_cast<char *>(part.data()), part.size()});
+            }
+        }
+        std::size_t first = 0;
+        bool ok = true;
+        while (ok && first < vectors.size()) {
+            const std::size_t count = vectors.size() - first < max_write_parts ? vectors.size() - first : max_write_parts;
+            const ssize_t done = writev(fd, vectors.data() + first, static_cast<int>(count));
+            if (done > 0) {
+                // Skip the parts that were written whole, then the written start of the next one
+                auto remaining = static_cast<std::size_t>(done);
+                while (first < vectors.size() && remaining >= vectors[first].iov_len) {
+                    remaining -= vectors[first].iov_len;
+                    ++first;
+                }
+                if (remaining > 0) {
+                    vectors[first].iov_base = static_cast<char *>(vectors[first].iov_base) + remaining;
+                    vectors[first].iov_len -= remaining;
+                }
+            }
+            else if (done == -1 && errno == EINTR) {
+                continue;
             }
             else {
-                // If the match size is not 4, throw an error
-                throw std::runtime_error(fmt::format("Unexpected match size '{}' (expected 4) in: {}", match.size(), match.str()));
+                ok = false;
             }
-            ++it;
         }
+        ok = ok && sync_descriptor(fd, durability);
+        ok = (close(fd) == 0) && ok;
+        if (!ok) {
+            throw std::runtime_error("Failed to write file");
+        }
+        if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+            throw std::runtime_error("Failed to replace file");
+        }
+#endif
+    }
+    catch (...) {
+        std::error_code ec;
+        std::filesystem::remove(temp_path, ec);
+        throw;
+    }
 
-        // Sort channels by name
-        std::sort(channels.begin(), channels.end(),
-                  [](const Channel &a, const Channel &b) {
-                      return a.name < b.name;
-                  });
+#if !defined(_WIN32)
+    // Sync the directory, so that the rename itself survives a power loss
+    if (durability == Durability::Full) {
+        const std::filesystem::path directory = path.has_parent_path() ? path.parent_path() : std::filesystem::path(".");
+        const int dir_fd = open(directory.c_str(), O_RDONLY);
+        const bool synced = dir_fd != -1 && fsync(dir_fd) == 0;
+        if (dir_fd != -1) {
+            close(dir_fd);
+        }
+        if (!synced) {
+            throw SyncError("Failed to sync directory to disk");
+        }
+    }
+#endif
+}
 
-        // Return shrunk vector (RVO)
-        channels.shrink_to_fit();
-        return channels;
+/**
+ * @brief Private helper function to write channels to an HTML file on disk.
+ *
+ * @tparam Channels Range of channels with "name", "link" and "description" members (e.g., "std::vector<Channel>").
+ *
+ * @param output_path Path to the HTML file (e.g., "~/data.html").
+ * @param channels Range of YouTube channels.
+ * @param durability How hard to try to get the file onto stable storage.
+ *
+ * @return Layout of the rows in the written file.
+ *
+ * @throws std::runtime_error If failed to save to disk.
+ */
+template <typename Channels>
+Layout write_table(const std::filesystem::path &output_path,
+                   const Channels &channels,
+                   const Durability durability)
+{
+    try {
+        // Render the whole document first, so the file is written with a single call
+        Layout layout;
+        std::string buffer;
+        if (channels.size() > virtual_threshold) {
+            render::render_into<render::VirtualHtml>(buffer, channels, &layout);
+        }
+        else {
+            render::render_into<render::Html>(buffer, channels, &layout);
+        }
+        write_atomically(output_path, {buffer}, durability);
+        return layout;
+    }
+    catch (const SyncError &e) {
+        throw SyncError(fmt::format("Failed to save file '{}': {}", output_path.string(), e.what()));
+    }
+    catch (const std::exception &e) {
+        throw std::runtime_error(fmt::format("Failed to save file '{}': {}", output_path.string(), e.what()));
+    }
+}
+
+/**
+ * @brief Private helper function to widen a row's byte range to its whole line(s), so that removing the range leaves no blank line behind.
+ *
+ * The range is only widened if nothing but spaces and tabs separate it from the surrounding line breaks.
+ *
+ * @param text Text of the file.
+ * @param range Byte range of the row, from "<tr>" to "</tr>".
+ *
+ * @return Widened byte range.
+ */
+[[nodiscard]] ByteRange widen_to_lines(const std::string_view text,
+                                       ByteRange range)
+{
+    std::size_t begin = range.begin;
+    while (begin > 0 && (text[begin - 1] == ' ' || text[begin - 1] == '\t')) {
+        --begin;
+    }
+    std::size_t end = range.end;
+    while (end < text.size() && (text[end] == ' ' || text[end] == '\t' || text[end] == '\r')) {
+        ++end;
+    }
+    if ((begin == 0 || text[begin - 1] == '\n') && end < text.size() && text[end] == '\n') {
+        range.begin = begin;
+        range.end = end + 1;
+    }
+    return range;
+}
+
+/**
+ * @brief Private helper variable that contains the smallest share of a document worth scanning on its own thread, in bytes.
+ */
+constexpr std::size_t min_chunk_size = 1 << 20;
+
+/**
+ * @brief Private helper function to choose how many chunks to split a document into for scanning.
+ *
+ * @param size Size of the document in bytes (e.g., "4096").
+ * @param threads Number of threads requested, or "0" to use one per hardware thread. Either way, each chunk gets at least "min_chunk_size" bytes, so a small document never starts more threads than it has work for.
+ *
+ * @return Number of chunks (e.g., "8"), at least one.
+ */
+[[nodiscard]] std::size_t get_chunk_count(const std::size_t size,
+                                          const std::size_t threads)
+{
+    const std::size_t requested = threads != 0 ? threads : std::thread::hardware_concurrency();
+    const std::size_t fitting = size / min_chunk_size;
+    const std::size_t count = requested < fitting ? requested : fitting;
+    return count == 0 ? 1 : count;
+}
+
+/**
+ * @brief Private helper function to scan the rows of a document on several threads, and sort them by name.
+ *
+ * The document is split at "<tr>" tags, each chunk is scanned and stably sorted on its own thread, and the sorted chunks are merged, preferring the earlier chunk on ties. The result is therefore identical to scanning the whole document in one pass and stably sorting it, and so is the first error, since errors are reported in document order.
+ *
+ * @tparam Entry Type of the entries, with a "name" member to sort by (e.g., "Channel").
+ * @tparam Function Type of "make_entry".
+ *
+ * @param text HTML document to scan.
+ * @param make_entry Function that turns a row into an entry. It is called concurrently, so it must not modify shared state.
+ * @param threads Number of threads to use, or "0" to choose automatically (see "get_chunk_count").
+ *
+ * @return Entries sorted alphabetically by name, keeping document order for equal names.
+ *
+ * @throws html::ParseError If a row is malformed.
+ */
+template <typename Entry, typename Function>
+[[nodiscard]] std::vector<Entry> scan_sorted(const std::string_view text,
+                                             const Function &make_entry,
+                                             const std::size_t threads)
+{
+    struct Chunk final {
+        std::size_t begin;
+        std::size_t end;
+        std::vector<Entry> entries;
+        std::size_t rows_end;
+        std::exception_ptr error;
+    };
+    const auto by_name = [](const Entry &a, const Entry &b) {
+        return a.name < b.name;
+    };
+    const auto scan = [&text, &make_entry, &by_name](Chunk &chunk) {
+        chunk.entries.clear();
+        chunk.rows_end = chunk.begin;
+        chunk.error = nullptr;
+        try {
+            html::RowScanner scanner(text, chunk.begin, chunk.end);
+            html::Row row;
+            while (scanner.next(row)) {
+                chunk.entries.push_back(make_entry(row));
+                chunk.rows_end = row.end;
+            }
+            std::stable_sort(chunk.entries.begin(), chunk.entries.end(), by_name);
+        }
+        catch (...) {
+            chunk.error = std::current_exception();
+        }
+    };
+
+    // Scan the first chunk on this thread and every other chunk on its own thread, or on this thread if no more threads can be started
+    const std::vector<std::size_t> bounds = html::split_rows(text, get_chunk_count(text.size(), threads));
+    std::vector<Chunk> chunks(bounds.size() - 1);
+    for (std::size_t i = 0; i < chunks.size(); ++i) {
+        chunks[i].begin = bounds[i];
+        chunks[i].end = bounds[i + 1];
+    }
+    std::vector<std::thread> workers;
+    workers.reserve(chunks.size() - 1);
+    for (std::size_t i = 1; i < chunks.size(); ++i) {
+        try {
+            workers.emplace_back(scan, std::ref(chunks[i]));
+        }
+        catch (const std::system_error &) {
+            scan(chunks[i]);
+        }
+    }
+    scan(chunks.front());
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+
+    // A row that runs past the start of the next chunk means the chunk started at a "<tr>" inside the row (e.g., in a link), so scan that chunk again from the end of the row
+    for (std::size_t i = 0; i < chunks.size(); ++i) {
+        if (i > 0 && chunks[i - 1].rows_end > chunks[i].begin) {
+            chunks[i].begin = chunks[i - 1].rows_end;
+            scan(chunks[i]);
+        }
+        if (chunks[i].error) {
+            std::rethrow_exception(chunks[i].error);
+        }
+    }
+    if (chunks.size() == 1) {
+        return std::move(chunks.front().entries);
+    }
+
+    // Merge the sorted chunks, taking the smallest name next, and the earliest chunk on ties
+    using Cursor = std::pair<std::size_t, std::size_t>;
+    const auto after = [&chunks](const Cursor &a, const Cursor &b) {
+        const std::string_view a_name = chunks[a.first].entries[a.second].name;
+        const std::string_view b_name = chunks[b.first].entries[b.second].name;
+        return b_name < a_name || (a_name == b_name && b.first < a.first);
+    };
+    std::priority_queue<Cursor, std::vector<Cursor>, decltype(after)> queue(after);
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < chunks.size(); ++i) {
+        total += chunks[i].entries.size();
+        if (!chunks[i].entries.empty()) {
+            queue.emplace(i, 0);
+        }
+    }
+    std::vector<Entry> merged;
+    merged.reserve(total);
+    while (!queue.empty()) {
+        const auto [chunk, index] = queue.top();
+        queue.pop();
+        merged.push_back(std::move(chunks[chunk].entries[index]));
+        if (index + 1 < chunks[chunk].entries.size()) {
+            queue.emplace(chunk, index + 1);
+        }
+    }
+    return merged;
+}
+
+}  // namespace
+
+void RowCache::erase(const std::uint32_t slot)
+{
+    // A slot past the end was never rendered
+    if (slot >= this->rows_.size()) {
+        return;
+    }
+    ByteRange &row = this->rows_[slot];
+    this->garbage_ += row.end - row.begin;
+    row = ByteRange{};
+}
+
+void RowCache::reset()
+{
+    this->arena_ = std::string();
+    this->rows_ = std::vector<ByteRange>();
+    this->garbage_ = 0;
+    this->rendered_rows_ = 0;
+}
+
+void RowCache::render(const store::ChannelStore &channels)
+{
+    // New channels may have taken slots past the end, which are not rendered yet; a cache with more slots than the store belongs to another store, so it is rendered from scratch
+    if (this->rows_.size() > channels.slot_count()) {
+        this->arena_.clear();
+        this->rows_.clear();
+        this->garbage_ = 0;
+    }
+    this->rows_.resize(channels.slot_count());
+
+    // Once more than half of the arena is wasted, copy the rows into a new arena in store order, which also joins them into a single run again
+    if (this->garbage_ > this->arena_.size() / 2) {
+        std::string arena;
+        arena.reserve(this->arena_.size() - this->garbage_);
+        for (std::size_t i = 0; i < channels.size(); ++i) {
+            ByteRange &row = this->rows_[channels.slot(i)];
+            const std::size_t begin = arena.size();
+            arena.append(this->arena_, row.begin, row.end - row.begin);
+            row = ByteRange{begin, arena.size()};
+        }
+        this->arena_ = std::move(arena);
+        this->garbage_ = 0;
+    }
+
+    // Render the missing rows at the end of the arena, in store order, which is grown once (a rendered row is never empty)
+    std::size_t missing = 0;
+    std::size_t bytes = 0;
+    for (std::size_t i = 0; i < channels.size(); ++i) {
+        const ByteRange &row = this->rows_[channels.slot(i)];
+        if (row.begin == row.end) {
+            ++missing;
+            bytes += render::Html::row_overhead + channels.name(i).size() + channels.link(i).size() + channels.description(i).size();
+        }
+    }
+    this->rendered_rows_ = missing;
+    if (missing == 0) {
+        return;
+    }
+    this->arena_.reserve(this->arena_.size() + bytes);
+    for (std::size_t i = 0; i < channels.size(); ++i) {
+        ByteRange &row = this->rows_[channels.slot(i)];
+        if (row.begin == row.end) {
+            const std::size_t begin = this->arena_.size();
+            render::Html::append_row(this->arena_, channels.name(i), channels.link(i), channels.description(i));
+            row = ByteRange{begin, this->arena_.size()};
+        }
+    }
+}
+
+std::string_view RowCache::row(const std::uint32_t slot) const
+{
+    const ByteRange &row = this->rows_[slot];
+    return std::string_view(this->arena_).substr(row.begin, row.end - row.begin);
+}
+
+std::size_t RowCache::get_rendered_rows() const
+{
+    return this->rendered_rows_;
+}
+
+MappedFile::MappedFile(const std::filesystem::path &path)
+    : data_(nullptr),
+      size_(0)
+{
+#if defined(_WIN32)
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Failed to open file for reading");
+    }
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size)) {
+        CloseHandle(file);
+        throw std::runtime_error("Failed to get file size");
+    }
+    this->size_ = static_cast<std::size_t>(file_size.QuadPart);
+    // Mapping an empty file is an error, so leave the view empty
+    if (this->size_ == 0) {
+        CloseHandle(file);
+        return;
+    }
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr) {
+        this->size_ = 0;
+        throw std::runtime_error("Failed to map file");
+    }
+    // The view keeps the mapping alive, so the handle can be closed right away
+    this->data_ = static_cast<const char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    CloseHandle(mapping);
+    if (this->data_ == nullptr) {
+        this->size_ = 0;
+        throw std::runtime_error("Failed to map file");
+    }
+#else
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        throw std::runtime_error("Failed to open file for reading");
+    }
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+        close(fd);
+        throw std::runtime_error("Failed to get file size");
+    }
+    this->size_ = static_cast<std::size_t>(st.st_size);
+    // Mapping an empty file is an error, so leave the view empty
+    if (this->size_ == 0) {
+        close(fd);
+        return;
+    }
+    // The mapping keeps the file alive, so the descriptor can be closed right away
+    void *address = mmap(nullptr, this->size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (address == MAP_FAILED) {
+        this->size_ = 0;
+        throw std::runtime_error("Failed to map file");
+    }
+    // The scanner reads the file front to back, so let the kernel read ahead aggressively
+    posix_madvise(address, this->size_, POSIX_MADV_SEQUENTIAL);
+    this->data_ = static_cast<const char *>(address);
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+    this->release();
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)) {}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+{
+    if (this != &other) {
+        this->release();
+        this->data_ = std::exchange(other.data_, nullptr);
+        this->size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+}
+
+std::string_view MappedFile::view() const
+{
+    return this->data_ ? std::string_view(this->data_, this->size_) : std::string_view();
+}
+
+void MappedFile::release() noexcept
+{
+    if (this->data_ == nullptr) {
+        return;
+    }
+#if defined(_WIN32)
+    UnmapViewOfFile(this->data_);
+#else
+    munmap(const_cast<char *>(this->data_), this->size_);
+#endif
+    this->data_ = nullptr;
+    this->size_ = 0;
+}
+
+MappedChannels::MappedChannels(const std::filesystem::path &input_path,
+                               const bool create_backup,
+                               const std::size_t threads)
+    : file_(open_for_loading(input_path, create_backup))
+{
+    try {
+        const std::string_view text = this->file_.view();
+
+        // Record the byte ranges of each row, decoding only the name, and sort entries by name
+        this->entries_ = scan_sorted<Entry>(
+            text,
+            [&text](const html::Row &row) {
+                return Entry{
+                    escape::unescape(row.name),
+                    Span{static_cast<std::size_t>(row.link.data() - text.data()), row.link.size()},
+                    Span{static_cast<std::size_t>(row.description.data() - text.data()), row.description.size()},
+                    widen_to_lines(text, ByteRange{row.begin, row.end}),
+                    escape::is_escaped(row.link) || escape::is_escaped(row.description)};
+            },
+            threads);
+        this->entries_.shrink_to_fit();
     }
     catch (const std::exception &e) {
         throw std::runtime_error(fmt::format("Failed to load file '{}': {}", input_path.string(), e.what()));
     }
 }
 
+std::size_t MappedChannels::size() const
+{
+    return this->entries_.size();
+}
+
+std::string_view MappedChannels::name(const std::size_t index) const
+{
+    return this->entries_[index].name;
+}
+
+std::string_view MappedChannels::link(const std::size_t index) const
+{
+    const Entry &entry = this->entries_[index];
+    return this->decode(entry, entry.link);
+}
+
+std::string_view MappedChannels::description(const std::size_t index) const
+{
+    const Entry &entry = this->entries_[index];
+    return this->decode(entry, entry.description);
+}
+
+Channel MappedChannels::channel(const std::size_t index) const
+{
+    return Channel(std::string(this->name(index)), std::string(this->link(index)), std::string(this->description(index)));
+}
+
+std::optional<Layout> MappedChannels::get_layout() const
+{
+    if (this->entries_.empty()) {
+        return std::nullopt;
+    }
+    Layout layout;
+    layout.rows.reserve(this->entries_.size());
+    for (const Entry &entry : this->entries_) {
+        // The rows must appear in the file in the same (sorted) order as the entries
+        if (!layout.rows.empty() && entry.row.begin < layout.rows.back().end) {
+            return std::nullopt;
+        }
+        layout.rows.push_back(entry.row);
+    }
+    layout.rows_end = layout.rows.back().end;
+    return layout;
+}
+
+std::string_view MappedChannels::decode(const Entry &entry,
+                                        const Span &span) const
+{
+    const std::string_view raw = this->file_.view().substr(span.offset, span.length);
+    if (!entry.escaped) {
+        return raw;
+    }
+    // The map is node-based, so views of earlier decoded fields stay valid when it grows
+    const auto it = this->unescaped_.find(span.offset);
+    if (it != this->unescaped_.end()) {
+        return it->second;
+    }
+    return this->unescaped_.try_emplace(span.offset, escape::unescape(raw)).first->second;
+}
+
+std::vector<Channel> load(const std::filesystem::path &input_path,
+                          const bool create_backup,
+                          const std::size_t threads)
+{
+    // Map the file instead of copying it into a string, so it is only held in memory once
+    const MappedFile file = open_for_loading(input_path, create_backup);
+
+    // Parse the mapped file
+    try {
+        // Scan the rows and sort the channels by name, splitting large files across threads
+        return scan_sorted<Channel>(
+            file.view(),
+            [](const html::Row &row) {
+                return Channel(escape::unescape(row.name), escape::unescape(row.link), escape::unescape(row.description));
+            },
+            threads);
+    }
+    catch (const std::exception &e) {
+        throw std::runtime_error(fmt::format("Failed to load file '{}': {}", input_path.string(), e.what()));
+    }
+}
+
+std::vector<Channel> scan_rows(const std::string_view text,
+                               const std::size_t begin,
+                               const std::size_t end,
+                               std::vector<ByteRange> &ranges)
+{
+    std::vector<Channel> channels;
+    ranges.clear();
+    html::RowScanner scanner(text, begin, end);
+    html::Row row;
+    while (scanner.next(row)) {
+        channels.emplace_back(escape::unescape(row.name), escape::unescape(row.link), escape::unescape(row.description));
+        ranges.push_back(widen_to_lines(text, ByteRange{row.begin, row.end}));
+    }
+    return channels;
+}
+
 void save(const std::filesystem::path &output_path,
-          const std::vector<Channel> &channels)
+          const std::vector<Channel> &channels,
+          const Durability durability)
+{
+    static_cast<void>(write_table(output_path, channels, durability));
+}
+
+Layout save(const std::filesystem::path &output_path,
+            const store::ChannelStore &channels,
+            const Durability durability)
+{
+    return write_table(output_path, channels, durability);
+}
+
+Layout save(const std::filesystem::path &output_path,
+            const std::vector<store::ChannelView> &channels,
+            const Durability durability)
+{
+    return write_table(output_path, channels, durability);
+}
+
+Layout save(const std::filesystem::path &output_path,
+            const store::ChannelStore &channels,
+            RowCache &cache,
+            const Durability durability)
 {
     try {
-        // Open the file in write mode
-        std::ofstream file(output_path);
+        cache.render(channels);
+
+        // Gather the document from the header, the cached rows and the footer, joining rows that follow each other in the arena into a single part
+        Layout layout;
+        layout.rows.reserve(channels.size());
+        const bool virtualized = channels.size() > virtual_threshold;
+        const std::string_view header = virtualized ? render::VirtualHtml::header : render::Html::header;
+        std::vector<std::string_view> parts;
+        parts.push_back(header);
+        std::size_t offset = header.size();
+        for (std::size_t i = 0; i < channels.size(); ++i) {
+            const std::string_view row = cache.row(channels.slot(i));
+            layout.rows.push_back(ByteRange{offset, offset + row.size()});
+            offset += row.size();
+            std::string_view &last = parts.back();
+            if (parts.size() > 1 && last.data() + last.size() == row.data()) {
+                last = std::string_view(last.data(), last.size() + row.size());
+            }
+            else {
+                parts.push_back(row);
+            }
+        }
+        layout.rows_end = offset;
+        parts.push_back(virtualized ? render::VirtualHtml::footer : render::Html::footer);
+        write_atomically(output_path, parts, durability);
+        return layout;
+    }
+    catch (const SyncError &e) {
+        throw SyncError(fmt::format("Failed to save file '{}': {}", output_path.string(), e.what()));
+    }
+    catch (const std::exception &e) {
+        throw std::runtime_error(fmt::format("Failed to save file '{}': {}", output_path.string(), e.what()));
+    }
+}
+
+void write_file(const std::filesystem::path &output_path,
+                const std::string_view contents,
+                const Durability durability)
+{
+    try {
+        write_atomically(output_path, {contents}, durability);
+    }
+    catch (const SyncError &e) {
+        throw SyncError(fmt::format("Failed to save file '{}': {}", output_path.string(), e.what()));
+    }
+    catch (const std::exception &e) {
+        throw std::runtime_error(fmt::format("Failed to save file '{}': {}", output_path.string(), e.what()));
+    }
+}
+
+std::string render(const store::ChannelStore &channels)
+{
+    std::string buffer;
+    if (channels.size() > virtual_threshold) {
+        render::render_into<render::VirtualHtml>(buffer, channels);
+    }
+    else {
+        render::render_into<render::Html>(buffer, channels);
+    }
+    return buffer;
+}
+
+std::string format_row(const std::string_view name,
+                       const std::string_view link,
+                       const std::string_view description)
+{
+    std::string row;
+    render::Html::append_row(row, name, link, description);
+    return row;
+}
+
+void append_file(const std::filesystem::path &path,
+                 const std::string_view contents,
+                 const Durability durability)
+{
+    try {
+        // Open the file in append mode, so every write goes to the end
+        std::ofstream file(path, std::ios::out | std::ios::app | std::ios::binary);
 
         // Error: File cannot be opened
         if (!file) {
             throw std::runtime_error("Failed to open file for writing");
         }
+        file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+        file.close();
 
-        // Write the start of the HTML template
-        file << html_template_start;
-
-        // Write each channel's HTML row
-        for (const auto &channel : channels) {
-            file << fmt::format(
-                "        <tr>\n"
-                "          <td><a target=\"_blank\" href=\"{}\">{}</a></td>\n"
-                "          <td>{}</td>\n"
-                "        </tr>\n",
-                channel.link, channel.name, channel.description);
+        // Error: Write failed (e.g., disk full)
+        if (!file) {
+            throw std::runtime_error("Failed to write file");
         }
 
-        // Write the end of the HTML template
-        file << html_template_end;
+        // Sync to stable storage
+        sync_file(path, durability);
     }
     catch (const std::exception &e) {
-        throw std::runtime_error(fmt::format("Failed to save file '{}': {}", output_path.string(), e.what()));
+        throw std::runtime_error(fmt::format("Failed to append to file '{}': {}", path.string(), e.what()));
     }
 }
 
@@ -6,12 +6,27 @@
 
 #pragma once
 
-#include <filesystem>  // for std::filesystem
-#include <string>      // for std::string
-#include <vector>      // for std::vector
+#include <cstddef>        // for std::size_t
+#include <cstdint>        // for std::uint32_t
+#include <filesystem>     // for std::filesystem
+#include <optional>       // for std::optional
+#include <stdexcept>      // for std::runtime_error
+#include <string>         // for std::string
+#include <string_view>    // for std::string_view
+#include <unordered_map>  // for std::unordered_map
+#include <vector>         // for std::vector
+
+#include "store.hpp"
 
 namespace core::io {
 
+/**
+ * @brief Number of channels above which "save" writes the table as a page that only lays out the rows in view (see "render::VirtualHtml"), rather than as a static table that the browser lays out in full before showing anything.
+ *
+ * The choice is made whenever the whole file is written.
+ */
+inline constexpr std::size_t virtual_threshold = 10000;
+
 /**
  * @brief Struct that represents a single YouTube channel.
  *
@@ -62,28 +77,468 @@ struct Channel final {
     std::string description;
 };
 
+/**
+ * @brief Exceptions raised by "save" and "write_file" when the file was already replaced, but the directory could not be synced, so the replacement may not survive a power loss (only at Durability::Full).
+ *
+ * Unlike other errors, the file holds the new contents when this is thrown. This class extends "std::runtime_error".
+ *
+ * @note This class is marked as `final` to prevent inheritance.
+ */
+class SyncError final : public std::runtime_error {
+  public:
+    using std::runtime_error::runtime_error;
+};
+
+/**
+ * @brief How hard "save" tries to get the written bytes onto stable storage before returning.
+ *
+ * Every level replaces the file atomically, so a crash never leaves a truncated file behind. The levels only differ in what survives a power loss.
+ */
+enum class Durability {
+    /**
+     * @brief Do not sync. The file survives a process crash, but a power loss may lose the latest write.
+     */
+    None,
+
+    /**
+     * @brief Sync the file's data (fdatasync) before replacing the original file.
+     */
+    Data,
+
+    /**
+     * @brief Sync the file's data and metadata (fsync), then sync the directory, so the rename itself is durable.
+     */
+    Full,
+};
+
+/**
+ * @brief Struct that represents a half-open range of bytes in a file.
+ *
+ * @note This struct is marked as `final` to prevent inheritance.
+ */
+struct ByteRange final {
+    /**
+     * @brief Offset of the first byte.
+     */
+    std::size_t begin = 0;
+
+    /**
+     * @brief Offset one past the last byte.
+     */
+    std::size_t end = 0;
+};
+
+/**
+ * @brief Struct that represents where the rows of a table live in its HTML file.
+ *
+ * @note This struct is marked as `final` to prevent inheritance.
+ */
+struct Layout final {
+    /**
+     * @brief Byte range of each row, in table order, including its indentation and trailing newline.
+     */
+    std::vector<ByteRange> rows;
+
+    /**
+     * @brief Offset right after the last row, where a row appended to the end of the table goes.
+     */
+    std::size_t rows_end = 0;
+};
+
+/**
+ * @brief Class that caches the rendered HTML row of each channel in a store, so that saving after a few changes only renders the rows that changed.
+ *
+ * Rows are kept by the store's slot (see "store::ChannelStore::slot"), which does not move when other channels are inserted or removed, so the cache is only told about removed channels: its owner calls "erase" with the slot of each channel it removes from the store, and "render" renders the rows of new channels and of the slots that were emptied. Rows are rendered into a single arena, one after the other, so after a full render the rows of the document form one run of bytes, which "save" writes straight from the arena.
+ *
+ * @note This class is marked as `final` to prevent inheritance.
+ */
+class RowCache final {
+  public:
+    /**
+     * @brief Forget the row of a channel that is removed from the store, in O(1).
+     *
+     * @param slot Slot of the channel (e.g., "7"), taken before the channel is removed, since its slot may be reused afterwards.
+     */
+    void erase(const std::uint32_t slot);
+
+    /**
+     * @brief Forget every rendered row, releasing the arena (e.g., after the store was replaced, and its slots were renumbered).
+     */
+    void reset();
+
+    /**
+     * @brief Render the rows of a store that are not cached yet, compacting the arena first if more than half of it is wasted.
+     *
+     * @param channels Store of YouTube channels that the cache mirrors.
+     */
+    void render(const store::ChannelStore &channels);
+
+    /**
+     * @brief Get a rendered row.
+     *
+     * @param slot Slot of the channel (e.g., "7"). The row must be rendered.
+     *
+     * @return HTML row, exactly as "format_row" renders it, valid until the cache is changed.
+     */
+    [[nodiscard]] std::string_view row(const std::uint32_t slot) const;
+
+    /**
+     * @brief Get the number of rows that the last "render" rendered, as opposed to reusing them.
+     *
+     * @return Number of rendered rows (e.g., "1" after adding a single channel).
+     */
+    [[nodiscard]] std::size_t get_rendered_rows() const;
+
+  private:
+    /**
+     * @brief Rendered rows, in the order they were rendered.
+     */
+    std::string arena_;
+
+    /**
+     * @brief Byte range of each row in the arena, by slot, or an empty range if the row is not rendered yet.
+     */
+    std::vector<ByteRange> rows_;
+
+    /**
+     * @brief Number of bytes in the arena that belong to removed rows.
+     */
+    std::size_t garbage_ = 0;
+
+    /**
+     * @brief Number of rows that the last "render" rendered.
+     */
+    std::size_t rendered_rows_ = 0;
+};
+
+/**
+ * @brief Class that represents a read-only memory mapping of a file as a RAII object.
+ *
+ * On construction, the whole file is mapped into memory. When the object goes out of scope, the mapping is released. Empty files are represented by an empty view without a mapping.
+ *
+ * @note This class is marked as `final` to prevent inheritance.
+ */
+class MappedFile final {
+  public:
+    /**
+     * @brief Construct a new MappedFile object.
+     *
+     * @param path Path to the file to map (e.g., "~/data.html").
+     *
+     * @throws std::runtime_error If the file cannot be opened or mapped.
+     */
+    explicit MappedFile(const std::filesystem::path &path);
+
+    /**
+     * @brief Destroy the MappedFile object, releasing the mapping.
+     */
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile &operator=(MappedFile &&other) noexcept;
+
+    /**
+     * @brief Get the contents of the file.
+     *
+     * @return View of the mapped bytes, valid for the lifetime of the object.
+     */
+    [[nodiscard]] std::string_view view() const;
+
+  private:
+    /**
+     * @brief Pointer to the first mapped byte, or nullptr if the file is empty.
+     */
+    const char *data_;
+
+    /**
+     * @brief Size of the mapping in bytes.
+     */
+    std::size_t size_;
+
+    /**
+     * @brief Release the mapping, if any.
+     */
+    void release() noexcept;
+};
+
+/**
+ * @brief Class that represents YouTube channels loaded lazily from a memory-mapped HTML file on disk.
+ *
+ * On construction, the file is mapped read-only and scanned once. Only the byte offsets of each row are recorded, except for the name, which is decoded eagerly because it is needed for sorting. Links and descriptions are views into the mapping, except for the few that have character references (e.g., "&amp;"), which are decoded on first access and kept until the object is destroyed. This keeps startup bound by page faults rather than by copying.
+ *
+ * @note This class is marked as `final` to prevent inheritance.
+ */
+class MappedChannels final {
+  public:
+    /**
+     * @brief Construct a new MappedChannels object.
+     *
+     * @param input_path Path to the HTML file (e.g., "~/data.html").
+     * @param create_backup If true, create a backup of the original file before loading (default: true).
+     * @param threads Number of threads to scan the file with, or "0" to use one per hardware thread (default: "0"). Either way, it is capped at one thread per MiB of the file. The result does not depend on it.
+     *
+     * @throws std::runtime_error If the file does not exist, a channel row is cut short (the message contains its line and column), or if any other error occurs.
+     */
+    explicit MappedChannels(const std::filesystem::path &input_path,
+                            const bool create_backup = true,
+                            const std::size_t threads = 0);
+
+    /**
+     * @brief Get the number of channels.
+     *
+     * @return Number of channels (e.g., "3").
+     */
+    [[nodiscard]] std::size_t size() const;
+
+    /**
+     * @brief Get the name of a channel. Channels are sorted alphabetically by name.
+     *
+     * @param index Index of the channel (e.g., "0"). Must be less than "size()".
+     *
+     * @return YouTube Channel's name (e.g., "Noriyaro").
+     */
+    [[nodiscard]] std::string_view name(const std::size_t index) const;
+
+    /**
+     * @brief Get the link of a channel, decoding it on first access.
+     *
+     * @param index Index of the channel (e.g., "0"). Must be less than "size()".
+     *
+     * @return YouTube Channel's link (e.g., "https://www.youtube.com/@noriyaro/videos"), valid for the lifetime of the object.
+     */
+    [[nodiscard]] std::string_view link(const std::size_t index) const;
+
+    /**
+     * @brief Get the description of a channel, decoding it on first access.
+     *
+     * @param index Index of the channel (e.g., "0"). Must be less than "size()".
+     *
+     * @return YouTube Channel's description (e.g., "JP Drifting"), valid for the lifetime of the object.
+     */
+    [[nodiscard]] std::string_view description(const std::size_t index) const;
+
+    /**
+     * @brief Decode every field of a channel into a standalone object.
+     *
+     * @param index Index of the channel (e.g., "0"). Must be less than "size()".
+     *
+     * @return YouTube channel (e.g., "{name: "Noriyaro", link: "https://www.youtube.com/@noriyaro/videos", description: "JP Drifting"}").
+     */
+    [[nodiscard]] Channel channel(const std::size_t index) const;
+
+    /**
+     * @brief Get the layout of the rows in the file, in the same order as the channels.
+     *
+     * @return Layout of the rows, or std::nullopt if the file has no rows or its rows are not sorted by name, in which case the layout cannot be reused for splicing edits.
+     */
+    [[nodiscard]] std::optional<Layout> get_layout() const;
+
+  private:
+    /**
+     * @brief Struct that represents the byte range of a field in the mapped file.
+     */
+    struct Span final {
+        std::size_t offset;
+        std::size_t length;
+    };
+
+    /**
+     * @brief Struct that represents a single row of the mapped file.
+     */
+    struct Entry final {
+        std::string name;
+        Span link;
+        Span description;
+        ByteRange row;
+        bool escaped;  // Whether the link or the description has character references, in which case both are decoded into "unescaped_" on first access
+    };
+
+    /**
+     * @brief Read-only mapping of the HTML file.
+     */
+    MappedFile file_;
+
+    /**
+     * @brief Rows of the HTML file, sorted alphabetically by name.
+     */
+    std::vector<Entry> entries_;
+
+    /**
+     * @brief Decoded links and descriptions of the entries that have character references, by the offset of the field in the mapped file.
+     *
+     * @note Filled on first access by "decode()", so the accessors must not be called from several threads at once.
+     */
+    mutable std::unordered_map<std::size_t, std::string> unescaped_;
+
+    /**
+     * @brief Decode a field of the mapped file.
+     *
+     * @param entry Entry that the field belongs to.
+     * @param span Byte range of the field.
+     *
+     * @return Decoded field.
+     *
+     * @note Most fields have no character references (e.g., "&amp;"), so decoding is usually a view into the mapping.
+     */
+    [[nodiscard]] std::string_view decode(const Entry &entry,
+                                          const Span &span) const;
+};
+
 /**
  * @brief Load a vector of YouTube channels from an HTML file on disk.
  *
  * @param input_path Path to the HTML file (e.g., "~/data.html").
  * @param create_backup If true, create a backup of the original file before saving (default: true).
+ * @param threads Number of threads to parse the file with, or "0" to use one per hardware thread (default: "0"). Either way, it is capped at one thread per MiB of the file. The result does not depend on it.
  *
- * @return Alphabetically sorted (by name) vector of YouTube channels (e.g., {name: "Noriyaro", link: "https://www.youtube.com/@noriyaro/videos", description: "JP Drifting"}).
+ * @return Alphabetically sorted (by name) vector of YouTube channels (e.g., {name: "Noriyaro", link: "https://www.youtube.com/@noriyaro/videos", description: "JP Drifting"}). Channels with the same name keep the order of the file.
  *
- * @throws std::runtime_error If the file does not exist or if any other error occurs.
+ * @throws std::runtime_error If the file does not exist, a channel row is cut short (the message contains its line and column), or if any other error occurs.
  */
 [[nodiscard]] std::vector<Channel> load(const std::filesystem::path &input_path,
-                                        const bool create_backup = true);
+                                        const bool create_backup = true,
+                                        const std::size_t threads = 0);
+
+/**
+ * @brief Scan the channel rows that start in part of an HTML document (e.g., the part of a file that changed since it was loaded).
+ *
+ * @param text HTML document (e.g., the view of a "MappedFile").
+ * @param begin Byte offset to start scanning at. It must not be inside a channel row (e.g., the end of an earlier row).
+ * @param end Byte offset at which to stop looking for rows, or std::string_view::npos to scan to the end of the document. A row that starts before it is parsed to its end, even past it.
+ * @param ranges Filled with the byte range of each row, widened to whole lines like the rows of "Layout".
+ *
+ * @return Channels in the order of the document, which is not necessarily sorted.
+ *
+ * @throws std::runtime_error If a channel row is cut short (the message contains its line and column).
+ */
+[[nodiscard]] std::vector<Channel> scan_rows(const std::string_view text,
+                                             const std::size_t begin,
+                                             const std::size_t end,
+                                             std::vector<ByteRange> &ranges);
 
 /**
  * @brief Save a vector of YouTube channels to an HTML file on disk.
  *
+ * The whole file is rendered into memory, written to a temporary file in the same directory, and renamed over the original file, so a crash or a full disk never leaves a truncated file behind. Above "virtual_threshold" channels, the rows are wrapped in a page that only lays out the rows in view.
+ *
  * @param output_path Path to the HTML file (e.g., "~/data.html").
  * @param channels Vector of YouTube channels (e.g., "{name: "Noriyaro", link: "https://www.youtube.com/@noriyaro/videos", description: "JP Drifting"}").
+ * @param durability How hard to try to get the file onto stable storage (default: Durability::Full).
  *
- * @throws std::runtime_error If failed to save to disk.
+ * @throws SyncError If the file was replaced, but the directory could not be synced.
+ * @throws std::runtime_error If failed to save to disk, in which case the file is left untouched.
  */
 void save(const std::filesystem::path &output_path,
-          const std::vector<Channel> &channels);
+          const std::vector<Channel> &channels,
+          const Durability durability = Durability::Full);
+
+/**
+ * @brief Save a store of YouTube channels to an HTML file on disk.
+ *
+ * The file is replaced atomically, like the vector overload.
+ *
+ * @param output_path Path to the HTML file (e.g., "~/data.html").
+ * @param channels Store of YouTube channels, written in store order.
+ * @param durability How hard to try to get the file onto stable storage (default: Durability::Full).
+ *
+ * @return Layout of the rows in the written file.
+ *
+ * @throws SyncError If the file was replaced, but the directory could not be synced.
+ * @throws std::runtime_error If failed to save to disk, in which case the file is left untouched.
+ */
+Layout save(const std::filesystem::path &output_path,
+            const store::ChannelStore &channels,
+            const Durability durability = Durability::Full);
+
+/**
+ * @brief Save views of YouTube channels to an HTML file on disk (e.g., the channels of a single shard, see "core::shard").
+ *
+ * The file is replaced atomically, like the other overloads.
+ *
+ * @param output_path Path to the HTML file (e.g., "~/subscriptions-n.html").
+ * @param channels Views of YouTube channels, in sorted order, which is written as is.
+ * @param durability How hard to try to get the file onto stable storage (default: Durability::Full).
+ *
+ * @return Layout of the rows in the written file.
+ *
+ * @throws SyncError If the file was replaced, but the directory could not be synced.
+ * @throws std::runtime_error If failed to save to disk, in which case the file is left untouched.
+ */
+Layout save(const std::filesystem::path &output_path,
+            const std::vector<store::ChannelView> &channels,
+            const Durability durability = Durability::Full);
+
+/**
+ * @brief Save a store of YouTube channels to an HTML file on disk, rendering only the rows that are not cached yet.
+ *
+ * The document is written straight from the cache with gather writes (e.g., "writev"), without being copied into a buffer first, so saving after a few changes costs the rendering of the changed rows plus the write itself. The file is replaced atomically, like the other overloads.
+ *
+ * @param output_path Path to the HTML file (e.g., "~/data.html").
+ * @param channels Store of YouTube channels, written in store order.
+ * @param cache Cache of the rendered rows of the store, which is brought up to date (see "RowCache::render").
+ * @param durability How hard to try to get the file onto stable storage (default: Durability::Full).
+ *
+ * @return Layout of the rows in the written file.
+ *
+ * @throws SyncError If the file was replaced, but the directory could not be synced.
+ * @throws std::runtime_error If failed to save to disk, in which case the file is left untouched.
+ */
+Layout save(const std::filesystem::path &output_path,
+            const store::ChannelStore &channels,
+            RowCache &cache,
+            const Durability durability = Durability::Full);
+
+/**
+ * @brief Write a document to a file on disk, replacing the file atomically like "save" does.
+ *
+ * @param output_path Path to the file (e.g., "~/subscriptions.md").
+ * @param contents Contents of the file (e.g., a document from "render::render").
+ * @param durability How hard to try to get the file onto stable storage (default: Durability::Full).
+ *
+ * @throws SyncError If the file was replaced, but the directory could not be synced.
+ * @throws std::runtime_error If failed to save to disk, in which case the file is left untouched.
+ */
+void write_file(const std::filesystem::path &output_path,
+                const std::string_view contents,
+                const Durability durability = Durability::Full);
+
+/**
+ * @brief Render a store of YouTube channels as a complete HTML document, exactly as "save" writes it (i.e., as a virtualized page above "virtual_threshold" channels).
+ *
+ * @param channels Store of YouTube channels, rendered in store order.
+ *
+ * @return HTML document.
+ */
+[[nodiscard]] std::string render(const store::ChannelStore &channels);
+
+/**
+ * @brief Render a single table row, exactly as "save" writes it.
+ *
+ * @param name YouTube Channel's name (e.g., "Noriyaro").
+ * @param link YouTube Channel's link (e.g., "https://www.youtube.com/@noriyaro/videos").
+ * @param description YouTube Channel's description (e.g., "JP Drifting").
+ *
+ * @return HTML row, including its indentation and trailing newline.
+ */
+[[nodiscard]] std::string format_row(const std::string_view name,
+                                     const std::string_view link,
+                                     const std::string_view description);
+
+/**
+ * @brief Append bytes to the end of a file on disk, creating the file if it doesn't exist.
+ *
+ * Unlike "save", the file is modified in place, so a crash in the middle of an append can leave a partial write at the end. Callers should be able to detect it (e.g., with a checksum).
+ *
+ * @param path Path to the file (e.g., "~/data.journal").
+ * @param contents Bytes to append.
+ * @param durability How hard to try to get the file onto stable storage (default: Durability::Full). The directory is never synced, because the file is not renamed.
+ *
+ * @throws std::runtime_error If failed to write to disk.
+ */
+void append_file(const std::filesystem::path &path,
+                 const std::string_view contents,
+                 const Durability durability = Durability::Full);
 
 }  // namespace core::io
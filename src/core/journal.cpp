@@ -0,0 +1,237 @@
+/**
+ * @file journal.cpp
+ */
+
+#include <cstddef>       // for std::size_t
+#include <cstdint>       // for std::uint64_t, std::uintmax_t
+#include <cstring>       // for std::memcpy
+#include <filesystem>    // for std::filesystem
+#include <functional>    // for std::function
+#include <stdexcept>     // for std::runtime_error
+#include <string>        // for std::string
+#include <string_view>   // for std::string_view
+#include <system_error>  // for std::error_code
+
+#include <fmt/core.h>
+
+#include "io.hpp"
+#include "journal.hpp"
+#include "snapshot.hpp"
+
+namespace core::journal {
+
+namespace {
+
+/**
+ * @brief Private helper variable that contains the first bytes of every journal.
+ */
+constexpr std::string_view magic = "ytt-jrnl";
+
+/**
+ * @brief Private helper variable that contains the version of the journal format.
+ */
+constexpr std::uint64_t format_version = 1;
+
+/**
+ * @brief Private helper variable that contains a value whose bytes tell the byte order of the machine that wrote the journal.
+ */
+constexpr std::uint64_t byte_order_mark = 0x0102030405060708;
+
+/**
+ * @brief Private helper enum that contains the index of each 64-bit word of the file header.
+ */
+enum Header : std::size_t {
+    Magic,
+    ByteOrder,
+    Version,
+    HeaderWords,
+};
+
+/**
+ * @brief Private helper enum that contains the index of each 64-bit word in front of an entry's fields.
+ */
+enum Record : std::size_t {
+    Checksum,
+    Kind,
+    NameLength,
+    LinkLength,
+    DescriptionLength,
+    RecordWords,
+};
+
+/**
+ * @brief Private helper variable that contains the size of the file header in bytes.
+ */
+constexpr std::size_t header_size = HeaderWords * sizeof(std::uint64_t);
+
+/**
+ * @brief Private helper variable that contains the size of an entry's fixed part in bytes.
+ */
+constexpr std::size_t record_size = RecordWords * sizeof(std::uint64_t);
+
+/**
+ * @brief Private helper function to read a 64-bit word from any offset.
+ *
+ * @param data Pointer to the first byte of the word.
+ *
+ * @return Word in native byte order.
+ */
+[[nodiscard]] std::uint64_t read_word(const char *data)
+{
+    std::uint64_t word;
+    std::memcpy(&word, data, sizeof(word));
+    return word;
+}
+
+/**
+ * @brief Private helper function to append a 64-bit word in native byte order.
+ *
+ * @param buffer Buffer to append to.
+ * @param word Word to append (e.g., "42").
+ */
+void append_word(std::string &buffer,
+                 const std::uint64_t word)
+{
+    char bytes[sizeof(word)];
+    std::memcpy(bytes, &word, sizeof(word));
+    buffer.append(bytes, sizeof(word));
+}
+
+}  // namespace
+
+std::filesystem::path get_path(const std::filesystem::path &html_path)
+{
+    std::filesystem::path path = html_path;
+    path.replace_extension(".journal");
+    return path;
+}
+
+std::size_t replay(const std::filesystem::path &html_path,
+                   const std::function<void(const Entry &)> &on_entry)
+{
+    const std::filesystem::path path = get_path(html_path);
+    if (!std::filesystem::exists(path)) {
+        return 0;
+    }
+    const io::MappedFile file = [&path]() {
+        try {
+            return io::MappedFile(path);
+        }
+        catch (const std::runtime_error &e) {
+            throw std::runtime_error(fmt::format("Failed to read journal '{}': {}", path.string(), e.what()));
+        }
+    }();
+    const std::string_view text = file.view();
+
+    // An empty journal (e.g., created right before a crash) has nothing to replay
+    if (text.size() < header_size) {
+        return 0;
+    }
+    if (text.substr(0, magic.size()) != magic || read_word(text.data() + ByteOrder * sizeof(std::uint64_t)) != byte_order_mark || read_word(text.data() + Version * sizeof(std::uint64_t)) != format_version) {
+        throw std::runtime_error(fmt::format("Failed to read journal '{}': Unknown format", path.string()));
+    }
+
+    // Stop at the first entry that was not completely written
+    std::size_t entries = 0;
+    std::size_t offset = header_size;
+    while (text.size() - offset >= record_size) {
+        const char *record = text.data() + offset;
+        const auto word = [record](const Record index) {
+            return read_word(record + index * sizeof(std::uint64_t));
+        };
+        const std::uint64_t available = text.size() - offset - record_size;
+        if (word(NameLength) > available || word(LinkLength) > available - word(NameLength) || word(DescriptionLength) > available - word(NameLength) - word(LinkLength)) {
+            break;
+        }
+        const auto length = static_cast<std::size_t>(word(NameLength) + word(LinkLength) + word(DescriptionLength));
+        const std::string_view checked = text.substr(offset + sizeof(std::uint64_t), record_size - sizeof(std::uint64_t) + length);
+        if (snapshot::hash_contents(checked) != word(Checksum) || word(Kind) < static_cast<std::uint64_t>(Operation::Add) || word(Kind) > static_cast<std::uint64_t>(Operation::Dedupe)) {
+            break;
+        }
+
+        const std::string_view fields = text.substr(offset + record_size, length);
+        const auto name_length = static_cast<std::size_t>(word(NameLength));
+        const auto link_length = static_cast<std::size_t>(word(LinkLength));
+        on_entry(Entry{static_cast<Operation>(word(Kind)), fields.substr(0, name_length), fields.substr(name_length, link_length), fields.substr(name_length + link_length)});
+        ++entries;
+        offset += record_size + length;
+    }
+    return entries;
+}
+
+Journal::Journal(const std::filesystem::path &html_path,
+                 const io::Durability durability)
+    : path_(get_path(html_path)),
+      durability_(durability)
+{
+    std::error_code ec;
+    const std::uintmax_t size = std::filesystem::file_size(this->path_, ec);
+    this->synced_size_ = ec ? 0 : size;
+}
+
+void Journal::append(const Operation operation,
+                     const std::string_view name,
+                     const std::string_view link,
+                     const std::string_view description)
+{
+    // A new journal starts with the header, so it is written along with the first entries
+    if (this->synced_size_ == 0 && this->pending_.empty()) {
+        this->pending_.append(magic);
+        append_word(this->pending_, byte_order_mark);
+        append_word(this->pending_, format_version);
+    }
+
+    // Encode the entry with a placeholder checksum, then checksum everything after it
+    const std::size_t start = this->pending_.size();
+    append_word(this->pending_, 0);
+    append_word(this->pending_, static_cast<std::uint64_t>(operation));
+    append_word(this->pending_, name.size());
+    append_word(this->pending_, link.size());
+    append_word(this->pending_, description.size());
+    this->pending_.append(name);
+    this->pending_.append(link);
+    this->pending_.append(description);
+    const std::uint64_t checksum = snapshot::hash_contents(std::string_view(this->pending_).substr(start + sizeof(std::uint64_t)));
+    std::memcpy(this->pending_.data() + start, &checksum, sizeof(checksum));
+}
+
+void Journal::sync()
+{
+    if (this->pending_.empty()) {
+        return;
+    }
+    try {
+        io::append_file(this->path_, this->pending_, this->durability_);
+    }
+    catch (...) {
+        // Cut off a partial write, so the retried entries are not appended after a torn one, where "replay" would never reach them
+        std::error_code ec;
+        std::filesystem::resize_file(this->path_, this->synced_size_, ec);
+        throw;
+    }
+    this->synced_size_ += this->pending_.size();
+    this->pending_.clear();
+}
+
+void Journal::clear()
+{
+    this->pending_.clear();
+    std::error_code ec;
+    std::filesystem::remove(this->path_, ec);
+    if (ec) {
+        throw std::runtime_error(fmt::format("Failed to remove journal '{}': {}", this->path_.string(), ec.message()));
+    }
+    this->synced_size_ = 0;
+}
+
+std::uintmax_t Journal::size() const
+{
+    return this->synced_size_ + this->pending_.size();
+}
+
+bool Journal::empty() const
+{
+    return this->size() == 0;
+}
+
+}  // namespace core::journal
@@ -0,0 +1,170 @@
+/**
+ * @file journal.hpp
+ *
+ * @brief Append-only journal of changes to an HTML table, for crash safety.
+ */
+
+#pragma once
+
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint64_t, std::uintmax_t
+#include <filesystem>   // for std::filesystem
+#include <functional>   // for std::function
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+
+#include "io.hpp"
+
+namespace core::journal {
+
+/**
+ * @brief Kind of change recorded in the journal.
+ */
+enum class Operation : std::uint64_t {
+    /**
+     * @brief A channel was added.
+     */
+    Add = 1,
+
+    /**
+     * @brief A channel was removed by name.
+     */
+    Remove = 2,
+
+    /**
+     * @brief Channels whose links point to the same channel as an earlier one were removed.
+     */
+    Dedupe = 3,
+};
+
+/**
+ * @brief Struct that represents a change read back from the journal.
+ */
+struct Entry final {
+    /**
+     * @brief Kind of change (e.g., "Operation::Add").
+     */
+    Operation operation;
+
+    /**
+     * @brief YouTube Channel's name (e.g., "Noriyaro"), or empty for "Operation::Dedupe".
+     */
+    std::string_view name;
+
+    /**
+     * @brief YouTube Channel's link, or empty unless the operation is "Operation::Add".
+     */
+    std::string_view link;
+
+    /**
+     * @brief YouTube Channel's description, or empty unless the operation is "Operation::Add".
+     */
+    std::string_view description;
+};
+
+/**
+ * @brief Get the path of the journal that belongs to an HTML table.
+ *
+ * @param html_path Path to the HTML table (e.g., "~/subscriptions.html").
+ *
+ * @return Path to the journal, next to the table (e.g., "~/subscriptions.journal").
+ */
+[[nodiscard]] std::filesystem::path get_path(const std::filesystem::path &html_path);
+
+/**
+ * @brief Read every complete entry of a journal, in the order they were appended.
+ *
+ * Reading stops at the first entry that is truncated or fails its checksum (e.g., the process crashed in the middle of an append). Such an entry was never synced, so it was never acknowledged.
+ *
+ * @param html_path Path to the HTML table (e.g., "~/subscriptions.html"), whose journal to read.
+ * @param on_entry Function to call for each entry. The views in the entry are only valid during the call.
+ *
+ * @return Number of entries read (e.g., "3"), or "0" if the journal does not exist.
+ *
+ * @throws std::runtime_error If the journal cannot be read, or was written in an unknown format.
+ */
+std::size_t replay(const std::filesystem::path &html_path,
+                   const std::function<void(const Entry &)> &on_entry);
+
+/**
+ * @brief Class that represents the journal of an HTML table, open for appending.
+ *
+ * Entries are collected in memory by "append" and written to the end of the file by "sync", so that a burst of changes costs a single write and a single sync. Each entry carries a checksum, so a torn write at the end of the file is detected by "replay".
+ *
+ * @note This class is marked as `final` to prevent inheritance.
+ */
+class Journal final {
+  public:
+    /**
+     * @brief Construct a new Journal object. Nothing is written until the first "sync".
+     *
+     * @param html_path Path to the HTML table (e.g., "~/subscriptions.html"), whose journal to append to.
+     * @param durability How hard "sync" tries to get the entries onto stable storage (default: core::io::Durability::Full).
+     */
+    explicit Journal(const std::filesystem::path &html_path,
+                     const io::Durability durability = io::Durability::Full);
+
+    /**
+     * @brief Record a change in memory. Call "sync" to write it to disk.
+     *
+     * @param operation Kind of change (e.g., "Operation::Add").
+     * @param name YouTube Channel's name (e.g., "Noriyaro"), or empty for "Operation::Dedupe".
+     * @param link YouTube Channel's link (default: empty).
+     * @param description YouTube Channel's description (default: empty).
+     */
+    void append(const Operation operation,
+                const std::string_view name,
+                const std::string_view link = {},
+                const std::string_view description = {});
+
+    /**
+     * @brief Write the changes recorded since the last sync to the end of the journal, and sync it.
+     *
+     * @throws std::runtime_error If failed to write to disk. A partial write is cut off and the changes are kept, so a later sync will retry.
+     */
+    void sync();
+
+    /**
+     * @brief Forget every change, on disk and in memory, once the HTML table holds them.
+     *
+     * @throws std::runtime_error If the journal cannot be removed.
+     */
+    void clear();
+
+    /**
+     * @brief Get the size of the journal, including changes that are not synced yet.
+     *
+     * @return Size in bytes (e.g., "4096").
+     */
+    [[nodiscard]] std::uintmax_t size() const;
+
+    /**
+     * @brief Check if the journal has no changes, on disk or in memory.
+     *
+     * @return True if the journal is empty, false otherwise.
+     */
+    [[nodiscard]] bool empty() const;
+
+  private:
+    /**
+     * @brief Path to the journal.
+     */
+    const std::filesystem::path path_;
+
+    /**
+     * @brief How hard "sync" tries to get the entries onto stable storage.
+     */
+    const io::Durability durability_;
+
+    /**
+     * @brief Encoded entries that are not written to disk yet.
+     */
+    std::string pending_;
+
+    /**
+     * @brief Size of the journal on disk.
+     */
+    std::uintmax_t synced_size_ = 0;
+};
+
+}  // namespace core::journal
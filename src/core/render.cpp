@@ -0,0 +1,466 @@
+/**
+ * @file render.cpp
+ */
+
+#include <cstddef>      // for std::size_t
+#include <optional>     // for std::optional, std::nullopt
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+
+#include "render.hpp"
+#include "store.hpp"
+
+namespace core::render {
+
+const std::string_view Html::header = R"(<!DOCTYPE html>
+<html lang="en">
+
+  <head>
+    <meta charset="UTF-8">
+    <meta name="viewport" content="width=device-width, initial-scale=1.0">
+    <title>Subscriptions</title>
+    <style>
+      body {
+        background-color: black;
+        border: none;
+        color: #d3d3d3;
+        font-family: Arial, Helvetica, sans-serif;
+        height: 100%;
+        margin-top: 2rem;
+        margin-bottom: 2rem;
+        overflow-x: hidden;
+        overflow-y: scroll;
+        text-align: center;
+      }
+
+      * {
+        margin: 0;
+        padding: 0;
+      }
+
+      a {
+        color: #ff6961;
+        text-decoration: none;
+      }
+
+      a:hover {
+        color: #ff9eb5;
+      }
+
+      main {
+        display: block;
+        margin: auto;
+        max-width: 600px;
+      }
+
+      main>table {
+        background-color: #0d0d0d;
+        border-radius: 15px;
+        border-spacing: 2em;
+        border: 2px solid #262626;
+        table-layout: fixed;
+        width: 100%;
+      }
+
+      main>table tr>th {
+        color: #bfbfbf;
+        font-size: 130%;
+        font-weight: bold;
+      }
+
+      main>table tr>td {
+        color: #828282;
+        overflow-wrap: anywhere;
+      }
+    </style>
+  </head>
+
+  <body>
+    <main>
+      <table>
+        <tr>
+          <th>Name</th>
+          <th>Desc<wbr>ription</th>
+        </tr>
+)";
+
+const std::string_view Html::footer = R"(      </table>
+    </main>
+  </body>
+
+</html>
+)";
+
+const std::string_view VirtualHtml::header = R"(<!DOCTYPE html>
+<html lang="en">
+
+  <head>
+    <meta charset="UTF-8">
+    <meta name="viewport" content="width=device-width, initial-scale=1.0">
+    <title>Subscriptions</title>
+    <style>
+      body {
+        background-color: black;
+        border: none;
+        color: #d3d3d3;
+        font-family: Arial, Helvetica, sans-serif;
+        margin-top: 2rem;
+        margin-bottom: 2rem;
+        overflow-x: hidden;
+        overflow-y: scroll;
+        text-align: center;
+      }
+
+      * {
+        margin: 0;
+        padding: 0;
+      }
+
+      a {
+        color: #ff6961;
+        text-decoration: none;
+      }
+
+      a:hover {
+        color: #ff9eb5;
+      }
+
+      main {
+        display: block;
+        margin: auto;
+        max-width: 600px;
+      }
+
+      main>input {
+        background-color: #0d0d0d;
+        border-radius: 15px;
+        border: 2px solid #262626;
+        box-sizing: border-box;
+        color: #d3d3d3;
+        font-size: 100%;
+        padding: 0.75em 1em;
+        width: 100%;
+      }
+
+      main>p {
+        color: #828282;
+        margin: 1em 0;
+      }
+
+      main>div {
+        background-color: #0d0d0d;
+        border-radius: 15px;
+        border: 2px solid #262626;
+        position: relative;
+      }
+
+      main>div>table {
+        border-spacing: 2em 0;
+        position: absolute;
+        table-layout: fixed;
+        width: 100%;
+      }
+
+      main>div>table td {
+        color: #828282;
+        height: 40px;
+        overflow: hidden;
+        text-overflow: ellipsis;
+        white-space: nowrap;
+      }
+    </style>
+  </head>
+
+  <body>
+    <main>
+      <input type="search" placeholder="Filter by name or description" aria-label="Filter">
+      <p>Loading...</p>
+      <div>
+        <table></table>
+      </div>
+      <noscript>This table is too large to show without JavaScript; open the file in a text editor instead.</noscript>
+    </main>
+    <script type="text/plain" id="channels">
+)";
+
+const std::string_view VirtualHtml::footer = R"js(    </script>
+    <script>
+      "use strict";
+      (() => {
+        // Height of a row in pixels, which must match the height of the cells in the style sheet
+        const row_height = 40;
+        // Number of rows rendered above and below the viewport, so fast scrolling does not show blank space
+        const overscan = 10;
+        // Number of rows indexed between two frames
+        const slice_rows = 50000;
+
+        const text = document.getElementById("channels").textContent;
+        const filter = document.querySelector("main>input");
+        const status = document.querySelector("main>p");
+        const viewport = document.querySelector("main>div");
+        const table = viewport.firstElementChild;
+
+        // Offsets of the fields of each row in the text, five per row: start and end of the link, end of the name (which starts two bytes after the link), start and end of the description
+        const bounds = [];
+        let scanned = 0;
+        let done = false;
+        const index_rows = (count) => {
+          for (let i = 0; i < count; ++i) {
+            const link_begin = text.indexOf('href="', scanned);
+            const link_end = link_begin === -1 ? -1 : text.indexOf('">', link_begin + 6);
+            const name_end = link_end === -1 ? -1 : text.indexOf("</a>", link_end + 2);
+            const description_begin = name_end === -1 ? -1 : text.indexOf("<td>", name_end);
+            const description_end = description_begin === -1 ? -1 : text.indexOf("</td>", description_begin + 4);
+            if (description_end === -1) {
+              done = true;
+              return;
+            }
+            bounds.push(link_begin + 6, link_end, name_end, description_begin + 4, description_end);
+            scanned = description_end;
+          }
+        };
+
+        // Rows that match the filter, or null to show every row
+        let query = null;
+        let matches = null;
+        let searched = 0;
+        const search_rows = () => {
+          // Search the text of the rows indexed since the last search in one go, and keep the rows whose name or description holds a match
+          const rows = bounds.length / 5;
+          const end = rows > 0 ? bounds[rows * 5 - 1] : 0;
+          let row = searched;
+          let position = row < rows ? bounds[row * 5] : end;
+          while (row < rows) {
+            query.lastIndex = position;
+            const match = query.exec(text);
+            if (match === null || match.index >= end) {
+              break;
+            }
+            while (row + 1 < rows && bounds[(row + 1) * 5] <= match.index) {
+              ++row;
+            }
+            const b = row * 5;
+            const match_end = match.index + match[0].length;
+            if ((match.index >= bounds[b + 1] + 2 && match_end <= bounds[b + 2]) || (match.index >= bounds[b + 3] && match_end <= bounds[b + 4])) {
+              matches.push(row);
+              ++row;
+              position = row < rows ? bounds[row * 5] : end;
+            }
+            else {
+              position = match.index + 1;
+            }
+          }
+          searched = rows;
+        };
+
+        // Render the rows around the viewport, at most once per frame
+        let frame = 0;
+        const render = () => {
+          frame = 0;
+          const rows = bounds.length / 5;
+          const shown = matches === null ? rows : matches.length;
+          status.textContent = `${matches === null ? rows : `${shown} of ${rows}`} channels${done ? "" : " so far"}`;
+          viewport.style.height = `${shown * row_height}px`;
+          const top = Math.max(0, -viewport.getBoundingClientRect().top);
+          const first = Math.max(0, Math.floor(top / row_height) - overscan);
+          const last = Math.min(shown, Math.ceil((top + innerHeight) / row_height) + overscan);
+          const body = document.createElement("tbody");
+          for (let i = first; i < last; ++i) {
+            const b = (matches === null ? i : matches[i]) * 5;
+            const row = body.insertRow();
+            row.innerHTML = `<td><a target="_blank" href="${text.slice(bounds[b], bounds[b + 1])}">${text.slice(bounds[b + 1] + 2, bounds[b + 2])}</a></td><td>${text.slice(bounds[b + 3], bounds[b + 4])}</td>`;
+            for (const cell of row.cells) {
+              cell.title = cell.textContent;
+            }
+          }
+          table.style.top = `${first * row_height}px`;
+          table.replaceChildren(body);
+        };
+        const schedule = () => {
+          if (frame === 0) {
+            frame = requestAnimationFrame(render);
+          }
+        };
+
+        filter.addEventListener("input", () => {
+          // The rows are searched as they are stored, so escape the query the way the fields are escaped
+          const value = filter.value.trim().replace(/[&<>"']/g, (c) => ({"&": "&amp;", "<": "&lt;", ">": "&gt;", '"': "&quot;", "'": "&#39;"})[c]);
+          query = value === "" ? null : new RegExp(value.replace(/[.*+?^${}()|[\]\\]/g, "\\$&"), "gi");
+          matches = query === null ? null : [];
+          searched = 0;
+          if (query !== null) {
+            search_rows();
+          }
+          scrollTo(0, 0);
+          schedule();
+        });
+        addEventListener("scroll", schedule, {passive: true});
+        addEventListener("resize", schedule);
+
+        // Index the first screen right away, then the rest in slices, so the page responds while a large table is indexed
+        let count = Math.ceil(innerHeight / row_height) + overscan;
+        const index_slice = () => {
+          index_rows(count);
+          count = slice_rows;
+          if (query !== null) {
+            search_rows();
+          }
+          schedule();
+          if (!done) {
+            setTimeout(index_slice, 0);
+          }
+        };
+        index_slice();
+      })();
+    </script>
+  </body>
+
+</html>
+)js";
+
+void Markdown::append_escaped_text(std::string &buffer,
+                                   const std::string_view text,
+                                   std::size_t special)
+{
+    // Copy the runs between special bytes in one go
+    std::size_t begin = 0;
+    while (special < text.size()) {
+        buffer.append(text, begin, special - begin);
+        const char c = text[special];
+        if (c == '\n') {
+            buffer += ' ';
+        }
+        else if (c != '\r') {
+            buffer += '\\';
+            buffer += c;
+        }
+        begin = special + 1;
+        special = find_first_in(text, text_special, begin);
+    }
+    buffer.append(text, begin);
+}
+
+void Markdown::append_escaped_link(std::string &buffer,
+                                   const std::string_view link,
+                                   std::size_t special)
+{
+    constexpr std::string_view hex_digits = "0123456789ABCDEF";
+    std::size_t begin = 0;
+    while (special < link.size()) {
+        buffer.append(link, begin, special - begin);
+        const auto c = static_cast<unsigned char>(link[special]);
+        if (c != '\r' && c != '\n') {
+            buffer += '%';
+            buffer += hex_digits[c >> 4];
+            buffer += hex_digits[c & 0xF];
+        }
+        begin = special + 1;
+        special = find_first_in(link, link_special, begin);
+    }
+    buffer.append(link, begin);
+}
+
+void Csv::append_quoted(std::string &buffer,
+                        const std::string_view field)
+{
+    // Only quotes need escaping inside a quoted field, by doubling them
+    buffer += '"';
+    std::size_t begin = 0;
+    for (std::size_t quote = field.find('"'); quote != std::string_view::npos; quote = field.find('"', begin)) {
+        buffer.append(field, begin, quote + 1 - begin);
+        buffer += '"';
+        begin = quote + 1;
+    }
+    buffer.append(field, begin);
+    buffer += '"';
+}
+
+void Json::append_escaped_string(std::string &buffer,
+                                 const std::string_view text,
+                                 std::size_t first)
+{
+    constexpr std::string_view hex_digits = "0123456789abcdef";
+    std::size_t begin = 0;
+    while (first < text.size()) {
+        buffer.append(text, begin, first - begin);
+        const char c = text[first];
+        switch (c) {
+        case '"':
+            buffer.append("\\\"");
+            break;
+        case '\\':
+            buffer.append("\\\\");
+            break;
+        case '\b':
+            buffer.append("\\b");
+            break;
+        case '\f':
+            buffer.append("\\f");
+            break;
+        case '\n':
+            buffer.append("\\n");
+            break;
+        case '\r':
+            buffer.append("\\r");
+            break;
+        case '\t':
+            buffer.append("\\t");
+            break;
+        default:
+            buffer.append("\\u00");
+            buffer += hex_digits[static_cast<unsigned char>(c) >> 4];
+            buffer += hex_digits[static_cast<unsigned char>(c) & 0xF];
+            break;
+        }
+        begin = first + 1;
+        first = find_first_in(text, special, begin);
+    }
+    buffer.append(text, begin);
+}
+
+std::optional<Format> parse_format(const std::string_view name)
+{
+    if (name == "html") {
+        return Format::Html;
+    }
+    if (name == "virtual") {
+        return Format::VirtualHtml;
+    }
+    if (name == "markdown" || name == "md") {
+        return Format::Markdown;
+    }
+    if (name == "csv") {
+        return Format::Csv;
+    }
+    if (name == "json") {
+        return Format::Json;
+    }
+    return std::nullopt;
+}
+
+std::string render(const store::ChannelStore &channels,
+                   const Format format)
+{
+    // Dispatch once per document; every row below is a direct call
+    std::string buffer;
+    switch (format) {
+    case Format::Html:
+        render_into<Html>(buffer, channels);
+        break;
+    case Format::VirtualHtml:
+        render_into<VirtualHtml>(buffer, channels);
+        break;
+    case Format::Markdown:
+        render_into<Markdown>(buffer, channels);
+        break;
+    case Format::Csv:
+        render_into<Csv>(buffer, channels);
+        break;
+    case Format::Json:
+        render_into<Json>(buffer, channels);
+        break;
+    }
+    return buffer;
+}
+
+}  // namespace core::render
@@ -0,0 +1,467 @@
+/**
+ * @file render.hpp
+ *
+ * @brief Render YouTube channels as HTML, Markdown, CSV or JSON documents.
+ */
+
+#pragma once
+
+#include <array>        // for std::array
+#include <cstddef>      // for std::size_t
+#include <optional>     // for std::optional
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+
+#include "escape.hpp"
+#include "io.hpp"
+#include "store.hpp"
+
+namespace core::render {
+
+/**
+ * @brief Document formats that channels can be rendered as.
+ */
+enum class Format {
+    /**
+     * @brief HTML document with a static table, as the table is saved on disk up to "io::virtual_threshold" channels.
+     */
+    Html,
+
+    /**
+     * @brief HTML document that only lays out the rows in view, as the table is saved on disk above "io::virtual_threshold" channels.
+     */
+    VirtualHtml,
+
+    /**
+     * @brief Markdown table, with each name linking to its channel.
+     */
+    Markdown,
+
+    /**
+     * @brief Comma-separated values with a "name,link,description" header, as read back by "import".
+     */
+    Csv,
+
+    /**
+     * @brief JSON array of objects with "name", "link" and "description" keys, one object per line.
+     */
+    Json,
+};
+
+/**
+ * @brief Lookup table of the bytes that a format must escape, indexed by unsigned byte value.
+ */
+using ByteSet = std::array<bool, 256>;
+
+/**
+ * @brief Build a ByteSet at compile time.
+ *
+ * @param bytes Bytes to include (e.g., ",\"\r\n").
+ * @param controls If true, also include the control characters below 0x20 (default: false).
+ *
+ * @return Set of the bytes.
+ */
+[[nodiscard]] constexpr ByteSet make_byte_set(const std::string_view bytes,
+                                              const bool controls = false)
+{
+    ByteSet set{};
+    for (std::size_t i = 0; controls && i < 0x20; ++i) {
+        set[i] = true;
+    }
+    for (const char c : bytes) {
+        set[static_cast<unsigned char>(c)] = true;
+    }
+    return set;
+}
+
+/**
+ * @brief Find the first byte of a text that is in a set.
+ *
+ * A table lookup per byte is much faster than "std::string_view::find_first_of", which compares each byte against every character of its argument.
+ *
+ * @param text Text to search (e.g., "Tom, Jerry").
+ * @param set Bytes to look for.
+ * @param pos Offset to start at (default: 0).
+ *
+ * @return Offset of the first byte in the set (e.g., "3"), or the size of the text if there is none.
+ */
+[[nodiscard]] inline std::size_t find_first_in(const std::string_view text,
+                                               const ByteSet &set,
+                                               std::size_t pos = 0)
+{
+    while (pos < text.size() && !set[static_cast<unsigned char>(text[pos])]) {
+        ++pos;
+    }
+    return pos;
+}
+
+/**
+ * @brief Policy that renders channels as the HTML document that the table is saved as.
+ *
+ * Fields are escaped (see "core::escape"), so any text can be stored and the loader decodes it back unchanged.
+ *
+ * @note This struct is marked as `final` to prevent inheritance.
+ */
+struct Html final {
+    /**
+     * @brief Start of the document, followed by the rows.
+     */
+    static const std::string_view header;
+
+    /**
+     * @brief End of the document, after the last row.
+     */
+    static const std::string_view footer;
+
+    /**
+     * @brief Text between two rows.
+     */
+    static constexpr std::string_view separator = "";
+
+    /**
+     * @brief Text of a row before the link, between the link and the name, between the name and the description, and after the description.
+     */
+    static constexpr std::string_view row_start = "        <tr>\n"
+                                                  "          <td><a target=\"_blank\" href=\"";
+    static constexpr std::string_view row_link_end = "\">";
+    static constexpr std::string_view row_name_end = "</a></td>\n"
+                                                     "          <td>";
+    static constexpr std::string_view row_end = "</td>\n"
+                                                "        </tr>\n";
+
+    /**
+     * @brief Number of bytes that a row adds besides its fields, used to size the buffer up front.
+     */
+    static constexpr std::size_t row_overhead = row_start.size() + row_link_end.size() + row_name_end.size() + row_end.size();
+
+    /**
+     * @brief Append a single row.
+     *
+     * @param buffer Buffer to append to.
+     * @param name YouTube Channel's name (e.g., "Noriyaro").
+     * @param link YouTube Channel's link (e.g., "https://www.youtube.com/@noriyaro/videos").
+     * @param description YouTube Channel's description (e.g., "JP Drifting").
+     */
+    static void append_row(std::string &buffer,
+                           const std::string_view name,
+                           const std::string_view link,
+                           const std::string_view description)
+    {
+        buffer.append(row_start);
+        escape::append_escaped(buffer, link);
+        buffer.append(row_link_end);
+        escape::append_escaped(buffer, name);
+        buffer.append(row_name_end);
+        escape::append_escaped(buffer, description);
+        buffer.append(row_end);
+    }
+};
+
+/**
+ * @brief Policy that renders channels as an HTML document that only lays out the rows in view, for tables too large to open as a static table.
+ *
+ * The rows are those of "Html", but they sit in an inert "<script type="text/plain">" block instead of a table, so the browser keeps them as a single text node rather than building and laying out an element per row. An inline script indexes the rows in slices (the first screen shows up at once, however large the table), renders the rows around the viewport as the page scrolls, and filters them by name and description as the user types. The page needs no network connection, and the loader reads its rows back exactly like those of "Html", so edits made by hand are picked up like any other.
+ *
+ * @note This struct is marked as `final` to prevent inheritance.
+ */
+struct VirtualHtml final {
+    // See "Html" for the meaning of each member
+    static const std::string_view header;
+    static const std::string_view footer;
+    static constexpr std::string_view separator = Html::separator;
+    static constexpr std::size_t row_overhead = Html::row_overhead;
+
+    static void append_row(std::string &buffer,
+                           const std::string_view name,
+                           const std::string_view link,
+                           const std::string_view description)
+    {
+        Html::append_row(buffer, name, link, description);
+    }
+};
+
+/**
+ * @brief Policy that renders channels as a Markdown table.
+ *
+ * Characters that would break the table or the link syntax are escaped, and line breaks become spaces.
+ *
+ * @note This struct is marked as `final` to prevent inheritance.
+ */
+struct Markdown final {
+    // See "Html" for the meaning of each member
+    static constexpr std::string_view header = "| Channel | Description |\n"
+                                               "| --- | --- |\n";
+    static constexpr std::string_view footer = "";
+    static constexpr std::string_view separator = "";
+    static constexpr std::size_t row_overhead = 12;
+
+    /**
+     * @brief Append a single row (e.g., "| [Noriyaro](https://www.youtube.com/@noriyaro/videos) | JP Drifting |").
+     *
+     * @param buffer Buffer to append to.
+     * @param name YouTube Channel's name (e.g., "Noriyaro").
+     * @param link YouTube Channel's link (e.g., "https://www.youtube.com/@noriyaro/videos").
+     * @param description YouTube Channel's description (e.g., "JP Drifting").
+     */
+    static void append_row(std::string &buffer,
+                           const std::string_view name,
+                           const std::string_view link,
+                           const std::string_view description)
+    {
+        buffer.append("| [");
+        append_text(buffer, name);
+        buffer.append("](");
+        append_link(buffer, link);
+        buffer.append(") | ");
+        append_text(buffer, description);
+        buffer.append(" |\n");
+    }
+
+  private:
+    /**
+     * @brief Bytes of names and descriptions that are escaped with a backslash, or replaced (line breaks).
+     */
+    static constexpr ByteSet text_special = make_byte_set("\\|[]*_`\r\n");
+
+    /**
+     * @brief Bytes of links that are percent-encoded, or dropped (line breaks).
+     */
+    static constexpr ByteSet link_special = make_byte_set(" ()|<>\r\n");
+
+    /**
+     * @brief Append text, escaping "\", "|", "[", "]", "*", "_" and "`" if needed.
+     *
+     * @param buffer Buffer to append to.
+     * @param text Text to append (e.g., "Tom | Jerry").
+     */
+    static void append_text(std::string &buffer,
+                            const std::string_view text)
+    {
+        const std::size_t special = find_first_in(text, text_special);
+        if (special == text.size()) {
+            buffer.append(text);
+            return;
+        }
+        append_escaped_text(buffer, text, special);
+    }
+
+    /**
+     * @brief Append a link, percent-encoding spaces, parentheses, "|", "<" and ">" if needed.
+     *
+     * @param buffer Buffer to append to.
+     * @param link Link to append (e.g., "https://example.com/a (b)").
+     */
+    static void append_link(std::string &buffer,
+                            const std::string_view link)
+    {
+        const std::size_t special = find_first_in(link, link_special);
+        if (special == link.size()) {
+            buffer.append(link);
+            return;
+        }
+        append_escaped_link(buffer, link, special);
+    }
+
+    static void append_escaped_text(std::string &buffer,
+                                    const std::string_view text,
+                                    std::size_t special);
+    static void append_escaped_link(std::string &buffer,
+                                    const std::string_view link,
+                                    std::size_t special);
+};
+
+/**
+ * @brief Policy that renders channels as comma-separated values (RFC 4180).
+ *
+ * Fields that contain a comma, a quote or a line break, or that start or end with whitespace, are quoted.
+ *
+ * @note This struct is marked as `final` to prevent inheritance.
+ */
+struct Csv final {
+    // See "Html" for the meaning of each member
+    static constexpr std::string_view header = "name,link,description\n";
+    static constexpr std::string_view footer = "";
+    static constexpr std::string_view separator = "";
+    static constexpr std::size_t row_overhead = 3;
+
+    /**
+     * @brief Append a single row (e.g., "Noriyaro,https://www.youtube.com/@noriyaro/videos,JP Drifting").
+     *
+     * @param buffer Buffer to append to.
+     * @param name YouTube Channel's name (e.g., "Noriyaro").
+     * @param link YouTube Channel's link (e.g., "https://www.youtube.com/@noriyaro/videos").
+     * @param description YouTube Channel's description (e.g., "JP Drifting").
+     */
+    static void append_row(std::string &buffer,
+                           const std::string_view name,
+                           const std::string_view link,
+                           const std::string_view description)
+    {
+        append_field(buffer, name);
+        buffer += ',';
+        append_field(buffer, link);
+        buffer += ',';
+        append_field(buffer, description);
+        buffer += '\n';
+    }
+
+  private:
+    /**
+     * @brief Bytes that make a field quoted.
+     */
+    static constexpr ByteSet special = make_byte_set(",\"\r\n");
+
+    /**
+     * @brief Append a field, quoting it if needed.
+     *
+     * @param buffer Buffer to append to.
+     * @param field Field to append (e.g., "Tom, Jerry").
+     */
+    static void append_field(std::string &buffer,
+                             const std::string_view field)
+    {
+        if (find_first_in(field, special) == field.size() && (field.empty() || (field.front() != ' ' && field.back() != ' '))) {
+            buffer.append(field);
+            return;
+        }
+        append_quoted(buffer, field);
+    }
+
+    static void append_quoted(std::string &buffer,
+                              const std::string_view field);
+};
+
+/**
+ * @brief Policy that renders channels as a JSON array, with one object per line.
+ *
+ * Quotes, backslashes and control characters are escaped; all other bytes, including UTF-8, are written verbatim.
+ *
+ * @note This struct is marked as `final` to prevent inheritance.
+ */
+struct Json final {
+    // See "Html" for the meaning of each member
+    static constexpr std::string_view header = "[";
+    static constexpr std::string_view footer = "\n]\n";
+    static constexpr std::string_view separator = ",";
+    static constexpr std::size_t row_overhead = 48;
+
+    /**
+     * @brief Append a single row (e.g., "{"name": "Noriyaro", "link": "...", "description": "JP Drifting"}"), on its own line.
+     *
+     * @param buffer Buffer to append to.
+     * @param name YouTube Channel's name (e.g., "Noriyaro").
+     * @param link YouTube Channel's link (e.g., "https://www.youtube.com/@noriyaro/videos").
+     * @param description YouTube Channel's description (e.g., "JP Drifting").
+     */
+    static void append_row(std::string &buffer,
+                           const std::string_view name,
+                           const std::string_view link,
+                           const std::string_view description)
+    {
+        buffer.append("\n  {\"name\": \"");
+        append_string(buffer, name);
+        buffer.append("\", \"link\": \"");
+        append_string(buffer, link);
+        buffer.append("\", \"description\": \"");
+        append_string(buffer, description);
+        buffer.append("\"}");
+    }
+
+  private:
+    /**
+     * @brief Bytes that are escaped.
+     */
+    static constexpr ByteSet special = make_byte_set("\"\\", true);
+
+    /**
+     * @brief Append the contents of a JSON string, escaping it if needed.
+     *
+     * @param buffer Buffer to append to.
+     * @param text Text to append (e.g., "Tom \"Jerry\"").
+     */
+    static void append_string(std::string &buffer,
+                              const std::string_view text)
+    {
+        const std::size_t first = find_first_in(text, special);
+        if (first == text.size()) {
+            buffer.append(text);
+            return;
+        }
+        append_escaped_string(buffer, text, first);
+    }
+
+    static void append_escaped_string(std::string &buffer,
+                                      const std::string_view text,
+                                      std::size_t first);
+};
+
+/**
+ * @brief Render channels into a buffer with a format policy.
+ *
+ * Every format shares this loop; the policy is a template parameter, so each row is a direct (usually inlined) call rather than a virtual one. The buffer is sized once from the field lengths, and fields are appended as plain byte copies unless they need escaping.
+ *
+ * @tparam Policy Format policy with "header", "footer", "separator", "row_overhead" and "append_row" members (e.g., "Html").
+ * @tparam Channels Range of channels with "name", "link" and "description" members (e.g., "store::ChannelStore").
+ *
+ * @param buffer Buffer to append the document to.
+ * @param channels Range of YouTube channels, rendered in range order.
+ * @param layout Layout to fill in with the byte range of each row, relative to the start of the buffer (default: none).
+ */
+template <typename Policy, typename Channels>
+void render_into(std::string &buffer,
+                 const Channels &channels,
+                 io::Layout *layout = nullptr)
+{
+    // Guess the final size up front, so the buffer is allocated about once
+    std::size_t estimate = buffer.size() + Policy::header.size() + Policy::footer.size();
+    std::size_t count = 0;
+    for (const auto &channel : channels) {
+        estimate += Policy::row_overhead + Policy::separator.size() + channel.name.size() + channel.link.size() + channel.description.size();
+        ++count;
+    }
+    buffer.reserve(estimate);
+    if (layout != nullptr) {
+        layout->rows.clear();
+        layout->rows.reserve(count);
+    }
+
+    buffer.append(Policy::header);
+    bool first = true;
+    for (const auto &channel : channels) {
+        if (!first) {
+            buffer.append(Policy::separator);
+        }
+        first = false;
+        const std::size_t begin = buffer.size();
+        Policy::append_row(buffer, channel.name, channel.link, channel.description);
+        if (layout != nullptr) {
+            layout->rows.push_back(io::ByteRange{begin, buffer.size()});
+        }
+    }
+    if (layout != nullptr) {
+        layout->rows_end = buffer.size();
+    }
+    buffer.append(Policy::footer);
+}
+
+/**
+ * @brief Parse the name of a format.
+ *
+ * @param name Name of the format (e.g., "md"), case-sensitive: "html", "virtual", "markdown" (or "md"), "csv" or "json".
+ *
+ * @return Format, or std::nullopt if the name is unknown.
+ */
+[[nodiscard]] std::optional<Format> parse_format(const std::string_view name);
+
+/**
+ * @brief Render a store of YouTube channels as a complete document.
+ *
+ * @param channels Store of YouTube channels, rendered in store order.
+ * @param format Format of the document (e.g., "Format::Csv").
+ *
+ * @return Document. For Format::Html (or Format::VirtualHtml above "io::virtual_threshold" channels), this is exactly what "io::save" writes.
+ */
+[[nodiscard]] std::string render(const store::ChannelStore &channels,
+                                 const Format format);
+
+}  // namespace core::render
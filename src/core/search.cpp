@@ -0,0 +1,314 @@
+/**
+ * @file search.cpp
+ */
+
+#include <algorithm>      // for std::pop_heap, std::push_heap, std::sort, std::sort_heap, std::unique
+#include <cstddef>        // for std::size_t
+#include <cstdint>        // for std::uint8_t, std::uint32_t
+#include <limits>         // for std::numeric_limits
+#include <stdexcept>      // for std::length_error
+#include <string>         // for std::string
+#include <string_view>    // for std::string_view
+#include <unordered_map>  // for std::unordered_map
+#include <utility>        // for std::move
+#include <vector>         // for std::vector
+
+#include "search.hpp"
+
+namespace core::search {
+
+namespace {
+
+/**
+ * @brief Private helper variable that contains the flag bit of trigrams that come from a description.
+ */
+constexpr std::uint32_t description_flag = 1u << 24;
+
+/**
+ * @brief Private helper variable that marks a removed channel when renumbering.
+ */
+constexpr std::uint32_t removed_number = std::numeric_limits<std::uint32_t>::max();
+
+/**
+ * @brief Private helper function to convert an ASCII character to lowercase.
+ *
+ * @param c Character to convert (e.g., 'A').
+ *
+ * @return Lowercase character (e.g., 'a'). Non-ASCII characters are returned unchanged.
+ */
+[[nodiscard]] constexpr char to_lower(const char c)
+{
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+/**
+ * @brief Private helper function to call a function for each trigram of a text, in order, including repeats.
+ *
+ * ASCII letters are lowercased, and every run of other ASCII characters (e.g., spaces and punctuation) becomes a single space. The text is padded with a space on both sides, so that the start and end of each word get trigrams of their own. Non-ASCII bytes are kept as they are, so UTF-8 text is split into byte trigrams.
+ *
+ * @tparam Function Type of "on_trigram".
+ *
+ * @param text Text to split (e.g., "Noriyaro").
+ * @param flag Bits to add to every trigram (e.g., "description_flag").
+ * @param on_trigram Function to call with each trigram (e.g., " no", "nor", "ori", ...), packed into the lower 24 bits.
+ */
+template <typename Function>
+void for_each_trigram(const std::string_view text,
+                      const std::uint32_t flag,
+                      const Function &on_trigram)
+{
+    // Slide a window of the last three normalized bytes over the text, without building the normalized text
+    std::uint32_t window = ' ';
+    std::size_t length = 1;
+    const auto push = [&](const char c) {
+        window = (window << 8 | static_cast<unsigned char>(c)) & 0xFFFFFF;
+        if (++length >= 3) {
+            on_trigram(flag | window);
+        }
+    };
+    for (const char c : text) {
+        if ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || static_cast<unsigned char>(c) >= 0x80) {
+            push(c);
+        }
+        else if (c >= 'A' && c <= 'Z') {
+            push(to_lower(c));
+        }
+        else if ((window & 0xFF) != ' ') {
+            push(' ');
+        }
+    }
+    // Pad the end of the last word; a text without letters or digits has no trigrams at all
+    if ((window & 0xFF) != ' ') {
+        push(' ');
+    }
+}
+
+/**
+ * @brief Private helper function to split a text into its distinct trigrams (see "for_each_trigram").
+ *
+ * @param text Text to split (e.g., "Noriyaro").
+ *
+ * @return Sorted, distinct trigrams (e.g., " no", "nor", "ori", ...).
+ */
+[[nodiscard]] std::vector<std::uint32_t> get_trigrams(const std::string_view text)
+{
+    std::vector<std::uint32_t> trigrams;
+    for_each_trigram(text, 0, [&trigrams](const std::uint32_t trigram) {
+        trigrams.push_back(trigram);
+    });
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    return trigrams;
+}
+
+}  // namespace
+
+std::size_t TrigramIndex::size() const
+{
+    return this->names_.size() - this->removed_;
+}
+
+void TrigramIndex::reserve(const std::size_t channels)
+{
+    this->names_.reserve(channels);
+    this->links_.reserve(channels);
+    this->name_trigrams_.reserve(channels);
+}
+
+void TrigramIndex::insert(const std::string_view name,
+                          const std::string_view link,
+                          const std::string_view description)
+{
+    if (this->names_.size() >= removed_number) {
+        throw std::length_error("Search index cannot hold more channels");
+    }
+    const auto number = static_cast<std::uint32_t>(this->names_.size());
+
+    // Numbers only grow, so appending keeps every posting list sorted, and a repeated trigram finds the channel at the back of its list already
+    this->names_.emplace_back(name);
+    this->links_.emplace_back(link);
+    std::uint32_t &name_trigrams = this->name_trigrams_.emplace_back(0);
+    const auto add_posting = [this, number](const std::uint32_t trigram) {
+        std::vector<std::uint32_t> &list = this->postings_[trigram];
+        if (!list.empty() && list.back() == number) {
+            return false;
+        }
+        list.push_back(number);
+        return true;
+    };
+    for_each_trigram(name, 0, [&add_posting, &name_trigrams](const std::uint32_t trigram) {
+        name_trigrams += add_posting(trigram) ? 1u : 0u;
+    });
+    for_each_trigram(description, description_flag, [&add_posting](const std::uint32_t trigram) {
+        static_cast<void>(add_posting(trigram));
+    });
+}
+
+bool TrigramIndex::erase(const std::string_view name,
+                         const std::string_view link)
+{
+    // Every channel with the name is in the posting list of each of its trigrams, so only the shortest one has to be searched
+    const std::vector<std::uint32_t> trigrams = get_trigrams(name);
+    const std::vector<std::uint32_t> *candidates = nullptr;
+    for (const std::uint32_t trigram : trigrams) {
+        const auto it = this->postings_.find(trigram);
+        if (it == this->postings_.end()) {
+            return false;
+        }
+        if (candidates == nullptr || it->second.size() < candidates->size()) {
+            candidates = &it->second;
+        }
+    }
+    const auto is_match = [this, &name, &link](const std::uint32_t number) {
+        return this->name_trigrams_[number] != removed_number && this->names_[number] == name && this->links_[number] == link;
+    };
+    std::uint32_t found = removed_number;
+    if (candidates != nullptr) {
+        for (const std::uint32_t number : *candidates) {
+            if (is_match(number)) {
+                found = number;
+                break;
+            }
+        }
+    }
+    // Names without letters or digits have no trigrams, so they are searched for one by one
+    else {
+        for (std::uint32_t number = 0; number < this->names_.size(); ++number) {
+            if (is_match(number)) {
+                found = number;
+                break;
+            }
+        }
+    }
+    if (found == removed_number) {
+        return false;
+    }
+
+    // Leave the channel in the posting lists until removed channels outnumber the live ones
+    this->name_trigrams_[found] = removed_number;
+    std::string().swap(this->names_[found]);
+    std::string().swap(this->links_[found]);
+    ++this->removed_;
+    if (this->removed_ > this->names_.size() - this->removed_) {
+        this->compact();
+    }
+    return true;
+}
+
+void TrigramIndex::clear()
+{
+    this->names_.clear();
+    this->links_.clear();
+    this->name_trigrams_.clear();
+    this->postings_.clear();
+    this->removed_ = 0;
+}
+
+std::vector<Match> TrigramIndex::find(const std::string_view query,
+                                      const std::size_t limit) const
+{
+    std::vector<std::uint32_t> trigrams = get_trigrams(query);
+    if (trigrams.empty() || limit == 0 || this->size() == 0) {
+        return {};
+    }
+    // The counters below are 8 bits wide, which is plenty for any sensible query
+    if (trigrams.size() > std::numeric_limits<std::uint8_t>::max()) {
+        trigrams.resize(std::numeric_limits<std::uint8_t>::max());
+    }
+
+    // Count the trigrams each channel shares with the query, in its name and in its description; the posting lists are sorted, so the counters are walked in order
+    std::vector<std::uint8_t> name_hits(this->names_.size(), 0);
+    std::vector<std::uint8_t> description_hits(this->names_.size(), 0);
+    for (const std::uint32_t trigram : trigrams) {
+        if (const auto it = this->postings_.find(trigram); it != this->postings_.end()) {
+            for (const std::uint32_t number : it->second) {
+                ++name_hits[number];
+            }
+        }
+        if (const auto it = this->postings_.find(trigram | description_flag); it != this->postings_.end()) {
+            for (const std::uint32_t number : it->second) {
+                ++description_hits[number];
+            }
+        }
+    }
+
+    // Score names by their Dice coefficient, and descriptions by the share of the query they contain, at half weight, keeping the best matches in a heap whose top is the worst of them
+    const auto is_better = [](const Match &a, const Match &b) {
+        if (a.score != b.score) {
+            return a.score > b.score;
+        }
+        return a.name < b.name;
+    };
+    const auto query_trigrams = static_cast<double>(trigrams.size());
+    std::vector<Match> matches;
+    matches.reserve(limit < this->names_.size() ? limit : this->names_.size());
+    // Channels with fewer hits cannot be similar enough, even with a one-trigram name, so they are skipped without touching them
+    const double min_name_hits = min_similarity * (query_trigrams + 1) / 2.0;
+    const double min_description_hits = min_similarity * query_trigrams / 0.5;
+    for (std::size_t number = 0; number < this->names_.size(); ++number) {
+        if (name_hits[number] < min_name_hits && description_hits[number] < min_description_hits) {
+            continue;
+        }
+        if (this->name_trigrams_[number] == removed_number) {
+            continue;
+        }
+        const double name_score = 2.0 * name_hits[number] / (query_trigrams + this->name_trigrams_[number]);
+        const double description_score = 0.5 * description_hits[number] / query_trigrams;
+        const double score = name_score > description_score ? name_score : description_score;
+        // Names are only compared to break ties with the worst of the best matches
+        if (score < min_similarity || (matches.size() == limit && score < matches.front().score)) {
+            continue;
+        }
+        const Match match{this->names_[number], this->links_[number], score};
+        if (matches.size() < limit) {
+            matches.push_back(match);
+            std::push_heap(matches.begin(), matches.end(), is_better);
+        }
+        else if (is_better(match, matches.front())) {
+            std::pop_heap(matches.begin(), matches.end(), is_better);
+            matches.back() = match;
+            std::push_heap(matches.begin(), matches.end(), is_better);
+        }
+    }
+    std::sort_heap(matches.begin(), matches.end(), is_better);
+    return matches;
+}
+
+void TrigramIndex::compact()
+{
+    // Renumber the live channels in order, so the posting lists stay sorted
+    std::vector<std::uint32_t> numbers(this->names_.size(), removed_number);
+    std::size_t live = 0;
+    for (std::size_t i = 0; i < this->names_.size(); ++i) {
+        if (this->name_trigrams_[i] != removed_number) {
+            numbers[i] = static_cast<std::uint32_t>(live);
+            this->names_[live] = std::move(this->names_[i]);
+            this->links_[live] = std::move(this->links_[i]);
+            this->name_trigrams_[live] = this->name_trigrams_[i];
+            ++live;
+        }
+    }
+    this->names_.resize(live);
+    this->links_.resize(live);
+    this->name_trigrams_.resize(live);
+
+    // Drop the removed channels from every posting list, and the lists that end up empty
+    for (auto it = this->postings_.begin(); it != this->postings_.end();) {
+        std::vector<std::uint32_t> &list = it->second;
+        std::size_t kept = 0;
+        for (const std::uint32_t number : list) {
+            if (numbers[number] != removed_number) {
+                list[kept++] = numbers[number];
+            }
+        }
+        if (kept == 0) {
+            it = this->postings_.erase(it);
+            continue;
+        }
+        list.resize(kept);
+        ++it;
+    }
+    this->removed_ = 0;
+}
+
+}  // namespace core::search
@@ -0,0 +1,142 @@
+/**
+ * @file search.hpp
+ *
+ * @brief Fuzzy search over YouTube channels.
+ */
+
+#pragma once
+
+#include <cstddef>        // for std::size_t
+#include <cstdint>        // for std::uint32_t
+#include <string>         // for std::string
+#include <string_view>    // for std::string_view
+#include <unordered_map>  // for std::unordered_map
+#include <vector>         // for std::vector
+
+namespace core::search {
+
+/**
+ * @brief Lowest similarity (from 0 to 1) of a channel that "TrigramIndex::find" returns.
+ */
+inline constexpr double min_similarity = 0.3;
+
+/**
+ * @brief Struct that represents a channel found by a search.
+ *
+ * @note This struct is marked as `final` to prevent inheritance.
+ */
+struct Match final {
+    /**
+     * @brief YouTube Channel's name (e.g., "Noriyaro"). It is a view into the index, so it is invalidated by any change to the index.
+     */
+    std::string_view name;
+
+    /**
+     * @brief YouTube Channel's link (e.g., "https://www.youtube.com/@noriyaro/videos"), which tells apart channels that share a name. It is a view into the index, like "name".
+     */
+    std::string_view link;
+
+    /**
+     * @brief Similarity to the query, from "min_similarity" to 1 (e.g., "0.625").
+     */
+    double score;
+};
+
+/**
+ * @brief Class that finds channels by name and description, tolerating typos.
+ *
+ * Every channel is split into trigrams (e.g., " no", "nor", "ori" for "Noriyaro"), ignoring ASCII case and punctuation, and an inverted index maps each trigram to the channels that contain it. A query is split the same way, and each channel is scored by the trigrams it shares with the query: names by their Dice coefficient, so an exact name scores 1, and descriptions by the share of the query they contain, at half weight. A typo only changes up to three trigrams of a query, so the intended channel still shares most of them.
+ *
+ * Adding a channel appends it to the posting list of each of its trigrams, in O(row length). Removing a channel only marks it as removed, and the posting lists are compacted once removed channels outnumber the live ones.
+ *
+ * @note This class is marked as `final` to prevent inheritance.
+ */
+class TrigramIndex final {
+  public:
+    /**
+     * @brief Get the number of channels in the index.
+     *
+     * @return Number of channels (e.g., "3").
+     */
+    [[nodiscard]] std::size_t size() const;
+
+    /**
+     * @brief Reserve space for channels up front.
+     *
+     * @param channels Number of channels (e.g., "1000").
+     */
+    void reserve(const std::size_t channels);
+
+    /**
+     * @brief Add a channel to the index.
+     *
+     * @param name YouTube Channel's name (e.g., "Noriyaro").
+     * @param link YouTube Channel's link (e.g., "https://www.youtube.com/@noriyaro/videos"). It is not searched, but returned with each match.
+     * @param description YouTube Channel's description (e.g., "JP Drifting").
+     *
+     * @throws std::length_error If the index would hold more than 4 billion channels.
+     */
+    void insert(const std::string_view name,
+                const std::string_view link,
+                const std::string_view description);
+
+    /**
+     * @brief Remove a channel from the index by name and link. If several channels have both, one of them is removed.
+     *
+     * @param name YouTube Channel's name (e.g., "Noriyaro").
+     * @param link YouTube Channel's link (e.g., "https://www.youtube.com/@noriyaro/videos").
+     *
+     * @return True if a channel was removed, false if no channel has the name and link.
+     */
+    bool erase(const std::string_view name,
+               const std::string_view link);
+
+    /**
+     * @brief Remove all channels.
+     */
+    void clear();
+
+    /**
+     * @brief Find the channels that are most similar to a query.
+     *
+     * @param query Text to search for, in any case (e.g., "noriyoro").
+     * @param limit Largest number of channels to return (e.g., "10").
+     *
+     * @return Channels whose similarity is at least "min_similarity", most similar first, then by name.
+     */
+    [[nodiscard]] std::vector<Match> find(const std::string_view query,
+                                          const std::size_t limit) const;
+
+  private:
+    /**
+     * @brief Names of the channels, indexed by the numbers used in the posting lists. Removed channels have an empty name.
+     */
+    std::vector<std::string> names_;
+
+    /**
+     * @brief Links of the channels, indexed like "names_". Removed channels have an empty link.
+     */
+    std::vector<std::string> links_;
+
+    /**
+     * @brief Number of distinct trigrams in the name of each channel, or the largest 32-bit value for removed channels. Removed channels stay in the posting lists until the next compaction.
+     */
+    std::vector<std::uint32_t> name_trigrams_;
+
+    /**
+     * @brief Numbers of the channels that contain each trigram, in increasing order. Trigrams of descriptions are kept apart from trigrams of names by a flag bit.
+     */
+    std::unordered_map<std::uint32_t, std::vector<std::uint32_t>> postings_;
+
+    /**
+     * @brief Number of removed channels that are still in the posting lists.
+     */
+    std::size_t removed_ = 0;
+
+    /**
+     * @brief Drop the removed channels from the posting lists, and renumber the live ones.
+     */
+    void compact();
+};
+
+}  // namespace core::search
@@ -0,0 +1,250 @@
+/**
+ * @file shard.cpp
+ */
+
+#include <algorithm>     // for std::sort, std::unique
+#include <cstddef>       // for std::size_t
+#include <exception>     // for std::exception_ptr, std::current_exception, std::rethrow_exception
+#include <filesystem>    // for std::filesystem
+#include <memory>        // for std::unique_ptr, std::make_unique
+#include <optional>      // for std::optional, std::nullopt
+#include <stdexcept>     // for std::runtime_error
+#include <string>        // for std::string
+#include <string_view>   // for std::string_view
+#include <system_error>  // for std::system_error
+#include <thread>        // for std::thread
+#include <vector>        // for std::vector
+
+#include <fmt/core.h>
+
+#include "backup.hpp"
+#include "io.hpp"
+#include "shard.hpp"
+
+namespace core::shard {
+
+namespace {
+
+/**
+ * @brief Private helper variable that contains the key of each letter shard, one byte per key.
+ */
+constexpr std::string_view letters = "abcdefghijklmnopqrstuvwxyz";
+
+/**
+ * @brief Private helper variable that contains the key of the last shard, which holds every name that does not start with an ASCII letter.
+ */
+constexpr std::string_view other_key = "other";
+
+/**
+ * @brief Private helper variable that contains the attribute that names the shard of a link on the index page.
+ */
+constexpr std::string_view shard_attribute = "data-shard=\"";
+
+/**
+ * @brief Private helper function to percent-encode a file name for use in a link.
+ *
+ * @param name File name, in UTF-8 (e.g., "my subscriptions-a.html").
+ *
+ * @return Encoded file name (e.g., "my%20subscriptions-a.html").
+ */
+[[nodiscard]] std::string encode_file_name(const std::string_view name)
+{
+    constexpr std::string_view hex_digits = "0123456789ABCDEF";
+    std::string encoded;
+    encoded.reserve(name.size());
+    for (const char c : name) {
+        const bool unreserved = (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '-' || c == '.' || c == '_' || c == '~';
+        if (unreserved) {
+            encoded += c;
+        }
+        else {
+            encoded += '%';
+            encoded += hex_digits[static_cast<unsigned char>(c) >> 4];
+            encoded += hex_digits[static_cast<unsigned char>(c) & 0xF];
+        }
+    }
+    return encoded;
+}
+
+}  // namespace
+
+std::size_t get_shard(const std::string_view name)
+{
+    const char first = name.empty() ? '\0' : name.front();
+    if (first >= 'a' && first <= 'z') {
+        return static_cast<std::size_t>(first - 'a');
+    }
+    if (first >= 'A' && first <= 'Z') {
+        return static_cast<std::size_t>(first - 'A');
+    }
+    return count - 1;
+}
+
+std::string_view get_key(const std::size_t shard)
+{
+    return shard < letters.size() ? letters.substr(shard, 1) : other_key;
+}
+
+std::optional<std::size_t> parse_key(const std::string_view key)
+{
+    if (key == other_key) {
+        return count - 1;
+    }
+    if (key.size() == 1 && key.front() >= 'a' && key.front() <= 'z') {
+        return static_cast<std::size_t>(key.front() - 'a');
+    }
+    return std::nullopt;
+}
+
+std::filesystem::path get_path(const std::filesystem::path &index_path,
+                               const std::size_t shard)
+{
+    // "subscriptions.html" becomes "subscriptions-n.html"
+    std::filesystem::path name = index_path.stem();
+    name += "-";
+    name += std::string(get_key(shard));
+    name += index_path.extension();
+    return index_path.parent_path() / name;
+}
+
+bool is_index(const std::string_view text)
+{
+    // The marker is on the second line of every index page, so a large table is never searched in full
+    constexpr std::size_t search_limit = 256;
+    return text.substr(0, search_limit).find(index_marker) != std::string_view::npos;
+}
+
+std::string render_index(const std::filesystem::path &index_path,
+                         const std::vector<std::size_t> &shards)
+{
+    std::string page = fmt::format(R"(<!DOCTYPE html>
+{}
+<html lang="en">
+
+  <head>
+    <meta charset="UTF-8">
+    <meta name="viewport" content="width=device-width, initial-scale=1.0">
+    <title>Subscriptions</title>
+    <style>
+      body {{
+        background-color: black;
+        color: #d3d3d3;
+        font-family: Arial, Helvetica, sans-serif;
+        margin-top: 2rem;
+        text-align: center;
+      }}
+
+      a {{
+        color: #ff6961;
+        display: inline-block;
+        font-size: 130%;
+        padding: 0.5em;
+        text-decoration: none;
+      }}
+
+      a:hover {{
+        color: #ff9eb5;
+      }}
+
+      main {{
+        background-color: #0d0d0d;
+        border-radius: 15px;
+        border: 2px solid #262626;
+        margin: auto;
+        max-width: 600px;
+        padding: 1em;
+      }}
+    </style>
+  </head>
+
+  <body>
+    <main>
+)",
+                                   index_marker);
+    for (const std::size_t shard : shards) {
+        const std::string_view key = get_key(shard);
+        const std::string label = shard < letters.size() ? std::string(1, static_cast<char>(key.front() - 'a' + 'A')) : std::string("#");
+        page.append(fmt::format("      <a href=\"{}\" {}{}\">{}</a>\n", encode_file_name(get_path(index_path, shard).filename().u8string()), shard_attribute, key, label));
+    }
+    page.append(R"(    </main>
+  </body>
+
+</html>
+)");
+    return page;
+}
+
+std::vector<std::size_t> read_index(const std::string_view text)
+{
+    std::vector<std::size_t> shards;
+    for (std::size_t begin = text.find(shard_attribute); begin != std::string_view::npos; begin = text.find(shard_attribute, begin)) {
+        begin += shard_attribute.size();
+        const std::size_t end = text.find('"', begin);
+        const std::string_view key = text.substr(begin, end - begin);
+        const std::optional<std::size_t> shard = parse_key(key);
+        if (!shard || end == std::string_view::npos) {
+            throw std::runtime_error(fmt::format("Unknown shard in index page: {}", key));
+        }
+        shards.push_back(*shard);
+        begin = end;
+    }
+    std::sort(shards.begin(), shards.end());
+    shards.erase(std::unique(shards.begin(), shards.end()), shards.end());
+    return shards;
+}
+
+std::vector<std::unique_ptr<io::MappedChannels>> load(const std::filesystem::path &index_path,
+                                                      const std::vector<std::size_t> &shards,
+                                                      const bool create_backup)
+{
+    std::vector<std::filesystem::path> paths;
+    paths.reserve(shards.size());
+    for (const std::size_t shard : shards) {
+        paths.push_back(get_path(index_path, shard));
+    }
+
+    // Back up one file at a time, because backups share a directory
+    if (create_backup) {
+        for (const std::filesystem::path &path : paths) {
+            if (std::filesystem::exists(path)) {
+                static_cast<void>(backup::create(path));
+            }
+        }
+    }
+
+    // Load the first shard on this thread and every other shard on its own thread, or on this thread if no more threads can be started; each shard is scanned on a single thread, since the shards already keep the cores busy
+    std::vector<std::unique_ptr<io::MappedChannels>> loaded(paths.size());
+    std::vector<std::exception_ptr> errors(paths.size());
+    const auto load_shard = [&paths, &loaded, &errors](const std::size_t i) {
+        try {
+            loaded[i] = std::make_unique<io::MappedChannels>(paths[i], false, 1);
+        }
+        catch (...) {
+            errors[i] = std::current_exception();
+        }
+    };
+    std::vector<std::thread> workers;
+    workers.reserve(paths.size());
+    for (std::size_t i = 1; i < paths.size(); ++i) {
+        try {
+            workers.emplace_back(load_shard, i);
+        }
+        catch (const std::system_error &) {
+            load_shard(i);
+        }
+    }
+    if (!paths.empty()) {
+        load_shard(0);
+    }
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+    for (const std::exception_ptr &error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+    return loaded;
+}
+
+}  // namespace core::shard
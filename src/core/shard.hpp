@@ -0,0 +1,121 @@
+/**
+ * @file shard.hpp
+ *
+ * @brief Split HTML tables into one file per leading letter, with an index page that links to them.
+ */
+
+#pragma once
+
+#include <cstddef>      // for std::size_t
+#include <filesystem>   // for std::filesystem
+#include <memory>       // for std::unique_ptr
+#include <optional>     // for std::optional
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+#include <vector>       // for std::vector
+
+#include "io.hpp"
+
+namespace core::shard {
+
+/**
+ * @brief Number of shards: one per ASCII letter, plus one for every other name.
+ */
+inline constexpr std::size_t count = 27;
+
+/**
+ * @brief Comment that marks a file as an index page, as opposed to a table with rows.
+ */
+inline constexpr std::string_view index_marker = "<!-- yt-table shard index -->";
+
+/**
+ * @brief Get the shard that a channel belongs to.
+ *
+ * Names are sharded by their first byte, ignoring case, so a channel never moves to another shard when others are added or removed.
+ *
+ * @param name YouTube Channel's name (e.g., "Noriyaro").
+ *
+ * @return Shard, from "0" to "count - 1" (e.g., "13" for "Noriyaro", and "26" for names that do not start with an ASCII letter, such as "チャンネル").
+ */
+[[nodiscard]] std::size_t get_shard(const std::string_view name);
+
+/**
+ * @brief Get the key of a shard, as used in its file name.
+ *
+ * @param shard Shard (e.g., "13"). Must be less than "count".
+ *
+ * @return Key (e.g., "n", or "other" for the last shard).
+ */
+[[nodiscard]] std::string_view get_key(const std::size_t shard);
+
+/**
+ * @brief Parse the key of a shard.
+ *
+ * @param key Key (e.g., "n").
+ *
+ * @return Shard (e.g., "13"), or std::nullopt if the key is unknown.
+ */
+[[nodiscard]] std::optional<std::size_t> parse_key(const std::string_view key);
+
+/**
+ * @brief Get the path of a shard file, next to its index page.
+ *
+ * @param index_path Path to the index page (e.g., "~/subscriptions.html").
+ * @param shard Shard (e.g., "13"). Must be less than "count".
+ *
+ * @return Path to the shard file (e.g., "~/subscriptions-n.html").
+ */
+[[nodiscard]] std::filesystem::path get_path(const std::filesystem::path &index_path,
+                                             const std::size_t shard);
+
+/**
+ * @brief Check if a document is an index page.
+ *
+ * @param text Contents of the file (e.g., the view of a "MappedFile").
+ *
+ * @return True if "index_marker" is near the start of the document, false otherwise.
+ */
+[[nodiscard]] bool is_index(const std::string_view text);
+
+/**
+ * @brief Render the index page of a sharded table.
+ *
+ * The page contains no rows, so it only changes when a shard is created or emptied.
+ *
+ * @param index_path Path to the index page (e.g., "~/subscriptions.html"), whose name the links are derived from.
+ * @param shards Shards that have channels, in ascending order (e.g., "{0, 13}").
+ *
+ * @return HTML document that links to each shard file by its file name, and names the shard in a "data-shard" attribute.
+ */
+[[nodiscard]] std::string render_index(const std::filesystem::path &index_path,
+                                       const std::vector<std::size_t> &shards);
+
+/**
+ * @brief Read the shards that an index page links to, from the "data-shard" attribute of each link.
+ *
+ * @param text Contents of the index page.
+ *
+ * @return Shards in ascending order, without repeats (e.g., "{0, 13}").
+ *
+ * @throws std::runtime_error If a link names an unknown shard (e.g., it was edited by hand).
+ */
+[[nodiscard]] std::vector<std::size_t> read_index(const std::string_view text);
+
+/**
+ * @brief Load the channels of shard files, one thread per file.
+ *
+ * The files are backed up first, one after the other, then each is loaded on its own thread (see "io::MappedChannels"), so loading a sharded table costs about as much as loading its largest shard.
+ *
+ * @param index_path Path to the index page (e.g., "~/subscriptions.html").
+ * @param shards Shards to load (e.g., "{0, 13}").
+ * @param create_backup If true, create a backup of each shard file before loading it.
+ *
+ * @return Loaded channels of each shard, in the order of "shards".
+ *
+ * @throws std::runtime_error If a shard file does not exist or cannot be loaded (the first such error, in the order of "shards").
+ */
+[[nodiscard]] std::vector<std::unique_ptr<io::MappedChannels>> load(const std::filesystem::path &index_path,
+                                                                    const std::vector<std::size_t> &shards,
+                                                                    const bool create_backup);
+
+}  // namespace core::shard
@@ -0,0 +1,322 @@
+/**
+ * @file simd.cpp
+ */
+
+#include <array>             // for std::array
+#include <cstddef>           // for std::size_t
+#include <initializer_list>  // for std::initializer_list
+#include <string_view>       // for std::string_view
+
+// The vector kernels need x86-64, where SSE2 is always available; AVX2 is checked at runtime, which needs GCC or Clang
+#if defined(__x86_64__) || defined(_M_X64)
+#define SIMD_HAS_SSE2
+#include <emmintrin.h>  // for _mm_loadu_si128, _mm_cmpeq_epi8, _mm_movemask_epi8
+#endif
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SIMD_HAS_AVX2
+#include <immintrin.h>  // for _mm256_loadu_si256, _mm256_cmpeq_epi8, _mm256_movemask_epi8
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>  // for _BitScanForward
+#endif
+
+#include "simd.hpp"
+
+namespace core::simd {
+
+namespace {
+
+/**
+ * @brief Private helper type of a kernel's "find_any_of", which works on the text from the offset to search at, and returns offsets relative to it.
+ */
+using FindAnyOf = std::size_t (*)(const char *data, std::size_t size, const char *set, std::size_t set_size);
+
+/**
+ * @brief Private helper function to find the first byte that is one of a set, one byte at a time.
+ *
+ * @param data Start of the text.
+ * @param size Size of the text, in bytes.
+ * @param set Start of the set.
+ * @param set_size Number of bytes in the set.
+ *
+ * @return Offset of the first byte in the set, or "size" if there is none.
+ */
+[[nodiscard]] std::size_t find_any_of_scalar(const char *data,
+                                             const std::size_t size,
+                                             const char *set,
+                                             const std::size_t set_size)
+{
+    // Short texts are checked against each byte of the set; long ones against a table, which costs a pass over 256 bytes to fill but makes each byte a single lookup
+    constexpr std::size_t min_table_size = 256;
+    if (size < min_table_size) {
+        for (std::size_t pos = 0; pos < size; ++pos) {
+            for (std::size_t i = 0; i < set_size; ++i) {
+                if (data[pos] == set[i]) {
+                    return pos;
+                }
+            }
+        }
+        return size;
+    }
+    std::array<bool, 256> in_set = {};
+    for (std::size_t i = 0; i < set_size; ++i) {
+        in_set[static_cast<unsigned char>(set[i])] = true;
+    }
+    for (std::size_t pos = 0; pos < size; ++pos) {
+        if (in_set[static_cast<unsigned char>(data[pos])]) {
+            return pos;
+        }
+    }
+    return size;
+}
+
+#if defined(SIMD_HAS_SSE2)
+
+/**
+ * @brief Private helper function to get the index of the lowest set bit.
+ *
+ * @param mask Non-zero mask (e.g., "0b100").
+ *
+ * @return Index of the lowest set bit (e.g., "2").
+ */
+[[nodiscard]] std::size_t lowest_bit(const unsigned mask)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    return static_cast<std::size_t>(__builtin_ctz(mask));
+#endif
+}
+
+/**
+ * @brief Private helper function to get a mask of the bytes of a block that are one of a set.
+ *
+ * @param data Start of the 16 bytes, which need not be aligned.
+ * @param needles Each byte of the set, repeated across a vector.
+ * @param set_size Number of bytes in the set.
+ *
+ * @return Mask with bit "i" set if byte "i" is in the set.
+ */
+[[nodiscard]] unsigned any_of_mask_sse2(const char *data,
+                                        const __m128i *needles,
+                                        const std::size_t set_size)
+{
+    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+    __m128i found = _mm_setzero_si128();
+    for (std::size_t i = 0; i < set_size; ++i) {
+        found = _mm_or_si128(found, _mm_cmpeq_epi8(block, needles[i]));
+    }
+    return static_cast<unsigned>(_mm_movemask_epi8(found));
+}
+
+/**
+ * @brief Private helper function to find the first byte that is one of a set, 16 bytes at a time.
+ *
+ * @param data Start of the text.
+ * @param size Size of the text, in bytes.
+ * @param set Start of the set.
+ * @param set_size Number of bytes in the set.
+ *
+ * @return Offset of the first byte in the set, or "size" if there is none.
+ */
+[[nodiscard]] std::size_t find_any_of_sse2(const char *data,
+                                           const std::size_t size,
+                                           const char *set,
+                                           const std::size_t set_size)
+{
+    constexpr std::size_t width = 16;
+    if (size < width || set_size > max_set_size) {
+        return find_any_of_scalar(data, size, set, set_size);
+    }
+    __m128i needles[max_set_size];
+    for (std::size_t i = 0; i < set_size; ++i) {
+        needles[i] = _mm_set1_epi8(set[i]);
+    }
+    std::size_t pos = 0;
+    for (; pos + width <= size; pos += width) {
+        const unsigned mask = any_of_mask_sse2(data + pos, needles, set_size);
+        if (mask != 0) {
+            return pos + lowest_bit(mask);
+        }
+    }
+    // Check the last, partial block by loading the 16 bytes that end the text, which overlap bytes already known not to match
+    if (pos < size) {
+        const unsigned mask = any_of_mask_sse2(data + size - width, needles, set_size);
+        if (mask != 0) {
+            return size - width + lowest_bit(mask);
+        }
+    }
+    return size;
+}
+
+#endif
+
+#if defined(SIMD_HAS_AVX2)
+
+/**
+ * @brief Private helper function to get a mask of the bytes of a block that are one of a set.
+ *
+ * Like every AVX2 function here, it is compiled for AVX2 regardless of the build flags, so it must only be called if the CPU supports AVX2.
+ *
+ * @param data Start of the 32 bytes, which need not be aligned.
+ * @param needles Each byte of the set, repeated across a vector.
+ * @param set_size Number of bytes in the set.
+ *
+ * @return Mask with bit "i" set if byte "i" is in the set.
+ */
+[[nodiscard]] __attribute__((target("avx2"))) unsigned any_of_mask_avx2(const char *data,
+                                                                       const __m256i *needles,
+                                                                       const std::size_t set_size)
+{
+    const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+    __m256i found = _mm256_setzero_si256();
+    for (std::size_t i = 0; i < set_size; ++i) {
+        found = _mm256_or_si256(found, _mm256_cmpeq_epi8(block, needles[i]));
+    }
+    return static_cast<unsigned>(_mm256_movemask_epi8(found));
+}
+
+/**
+ * @brief Private helper function to find the first byte that is one of a set, 32 bytes at a time.
+ *
+ * @param data Start of the text.
+ * @param size Size of the text, in bytes.
+ * @param set Start of the set.
+ * @param set_size Number of bytes in the set.
+ *
+ * @return Offset of the first byte in the set, or "size" if there is none.
+ */
+[[nodiscard]] __attribute__((target("avx2"))) std::size_t find_any_of_avx2(const char *data,
+                                                                          const std::size_t size,
+                                                                          const char *set,
+                                                                          const std::size_t set_size)
+{
+    constexpr std::size_t width = 32;
+    if (size < width || set_size > max_set_size) {
+        return find_any_of_sse2(data, size, set, set_size);
+    }
+    __m256i needles[max_set_size];
+    for (std::size_t i = 0; i < set_size; ++i) {
+        needles[i] = _mm256_set1_epi8(set[i]);
+    }
+    std::size_t pos = 0;
+    for (; pos + width <= size; pos += width) {
+        const unsigned mask = any_of_mask_avx2(data + pos, needles, set_size);
+        if (mask != 0) {
+            return pos + lowest_bit(mask);
+        }
+    }
+    // Like the SSE2 kernel, finish with an overlapping load
+    if (pos < size) {
+        const unsigned mask = any_of_mask_avx2(data + size - width, needles, set_size);
+        if (mask != 0) {
+            return size - width + lowest_bit(mask);
+        }
+    }
+    return size;
+}
+
+#endif
+
+/**
+ * @brief Private helper function to get the "find_any_of" of a kernel.
+ *
+ * @param kernel Kernel (e.g., "Kernel::Avx2").
+ *
+ * @return Function of the kernel, or of "Kernel::Scalar" if the kernel is not supported.
+ */
+[[nodiscard]] FindAnyOf get_find_any_of(const Kernel kernel)
+{
+    if (!is_supported(kernel)) {
+        return find_any_of_scalar;
+    }
+    switch (kernel) {
+#if defined(SIMD_HAS_AVX2)
+    case Kernel::Avx2:
+        return find_any_of_avx2;
+#endif
+#if defined(SIMD_HAS_SSE2)
+    case Kernel::Sse2:
+        return find_any_of_sse2;
+#endif
+    default:
+        return find_any_of_scalar;
+    }
+}
+
+/**
+ * @brief Private helper function to get the "find_any_of" of the fastest supported kernel.
+ *
+ * @return Function of "get_best_kernel()".
+ */
+[[nodiscard]] FindAnyOf get_best_find_any_of()
+{
+    static const FindAnyOf best = get_find_any_of(get_best_kernel());
+    return best;
+}
+
+}  // namespace
+
+bool is_supported(const Kernel kernel)
+{
+    switch (kernel) {
+    case Kernel::Scalar:
+        return true;
+    case Kernel::Sse2:
+#if defined(SIMD_HAS_SSE2)
+        return true;
+#else
+        return false;
+#endif
+    case Kernel::Avx2:
+#if defined(SIMD_HAS_AVX2)
+        return __builtin_cpu_supports("avx2") != 0;
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+Kernel get_best_kernel()
+{
+    static const Kernel best = []() {
+        for (const Kernel kernel : {Kernel::Avx2, Kernel::Sse2}) {
+            if (is_supported(kernel)) {
+                return kernel;
+            }
+        }
+        return Kernel::Scalar;
+    }();
+    return best;
+}
+
+std::size_t find_any_of(const std::string_view text,
+                        const std::string_view set,
+                        const std::size_t pos)
+{
+    if (pos >= text.size()) {
+        return text.size();
+    }
+    // Text shorter than a vector is checked without the indirect call
+    constexpr std::size_t min_vector_size = 16;
+    if (text.size() - pos < min_vector_size) {
+        return pos + find_any_of_scalar(text.data() + pos, text.size() - pos, set.data(), set.size());
+    }
+    return pos + get_best_find_any_of()(text.data() + pos, text.size() - pos, set.data(), set.size());
+}
+
+std::size_t find_any_of(const std::string_view text,
+                        const std::string_view set,
+                        const std::size_t pos,
+                        const Kernel kernel)
+{
+    if (pos >= text.size()) {
+        return text.size();
+    }
+    return pos + get_find_any_of(kernel)(text.data() + pos, text.size() - pos, set.data(), set.size());
+}
+
+}  // namespace core::simd
@@ -0,0 +1,144 @@
+/**
+ * @file simd.hpp
+ *
+ * @brief Search bytes of text, with SIMD instructions chosen at runtime for the CPU where they pay off.
+ */
+
+#pragma once
+
+#include <cstddef>      // for std::size_t
+#include <string_view>  // for std::string_view
+
+namespace core::simd {
+
+/**
+ * @brief Implementations of "find_any_of", from slowest to fastest.
+ */
+enum class Kernel {
+    /**
+     * @brief Check one byte at a time, on every platform.
+     */
+    Scalar,
+
+    /**
+     * @brief Check 16 bytes at a time with SSE2, on every x86-64 CPU.
+     */
+    Sse2,
+
+    /**
+     * @brief Check 32 bytes at a time with AVX2, on x86-64 CPUs that support it.
+     */
+    Avx2
+};
+
+/**
+ * @brief Largest number of bytes that "find_any_of" looks for with vector instructions.
+ */
+inline constexpr std::size_t max_set_size = 16;
+
+/**
+ * @brief Check if a kernel can run on this CPU.
+ *
+ * @param kernel Kernel to check (e.g., "Kernel::Avx2").
+ *
+ * @return True if the kernel was compiled in and the CPU supports its instructions, false otherwise.
+ */
+[[nodiscard]] bool is_supported(const Kernel kernel);
+
+/**
+ * @brief Get the fastest kernel that can run on this CPU, which "find_any_of" uses unless told otherwise.
+ *
+ * The CPU is only checked on the first call.
+ *
+ * @return Fastest supported kernel (e.g., "Kernel::Avx2").
+ */
+[[nodiscard]] Kernel get_best_kernel();
+
+/**
+ * @brief Check if a byte is whitespace, using the same set as "\s" in regex.
+ *
+ * @param c Byte to check (e.g., ' ').
+ *
+ * @return True if the byte is a space, a tab, a line feed, a vertical tab, a form feed or a carriage return, false otherwise.
+ */
+[[nodiscard]] constexpr bool is_whitespace(const char c)
+{
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+/**
+ * @brief Find the first byte of a text that is one of a set of bytes.
+ *
+ * @param text Text to search (e.g., "Tom & Jerry").
+ * @param set Bytes to look for (e.g., "&<"). Sets of more than "max_set_size" bytes are searched one byte at a time.
+ * @param pos Offset to start at (default: 0).
+ *
+ * @return Offset of the first byte in the set (e.g., "4"), or the size of the text if there is none.
+ */
+[[nodiscard]] std::size_t find_any_of(const std::string_view text,
+                                      const std::string_view set,
+                                      const std::size_t pos = 0);
+
+/**
+ * @brief Find the first byte of a text that is one of a set of bytes, with a given kernel (e.g., to compare kernels).
+ *
+ * @param text Text to search (e.g., "Tom & Jerry").
+ * @param set Bytes to look for (e.g., "&<"). Sets of more than "max_set_size" bytes are searched one byte at a time.
+ * @param pos Offset to start at.
+ * @param kernel Kernel to search with. If it is not supported, "Kernel::Scalar" is used instead.
+ *
+ * @return Offset of the first byte in the set (e.g., "4"), or the size of the text if there is none.
+ */
+[[nodiscard]] std::size_t find_any_of(const std::string_view text,
+                                      const std::string_view set,
+                                      const std::size_t pos,
+                                      const Kernel kernel);
+
+/**
+ * @brief Skip whitespace (see "is_whitespace"), one byte at a time.
+ *
+ * Runs of whitespace in a table are short (e.g., a line break and an indent), so vector instructions would not pay for their setup.
+ *
+ * @param text Text to scan (e.g., "  <td>").
+ * @param pos Offset to start at (default: 0).
+ *
+ * @return Offset of the first byte that is not whitespace (e.g., "2"), or the size of the text if there is none.
+ */
+[[nodiscard]] inline std::size_t skip_whitespace(const std::string_view text,
+                                                 const std::size_t pos = 0)
+{
+    std::size_t end = pos;
+    while (end < text.size() && is_whitespace(text[end])) {
+        ++end;
+    }
+    return end < text.size() ? end : text.size();
+}
+
+/**
+ * @brief Check if the text at an offset starts with a tag, ignoring the case of ASCII letters, one byte at a time.
+ *
+ * Tags are short and usually differ from the text in their first bytes, so checking one byte at a time stops sooner than a vector comparison would.
+ *
+ * @param text Text to check (e.g., "<TD>hello").
+ * @param pos Offset into the text (e.g., "0"). It may be past the end of the text.
+ * @param tag Lowercase tag (e.g., "<td>").
+ *
+ * @return True if the tag was found at the offset, false otherwise.
+ */
+[[nodiscard]] inline bool starts_with_icase(const std::string_view text,
+                                            const std::size_t pos,
+                                            const std::string_view tag)
+{
+    if (pos > text.size() || text.size() - pos < tag.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < tag.size(); ++i) {
+        const char c = text[pos + i];
+        if ((c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c) != tag[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace core::simd
@@ -0,0 +1,331 @@
+/**
+ * @file snapshot.cpp
+ */
+
+#include <cstddef>       // for std::size_t
+#include <cstdint>       // for std::uint64_t
+#include <cstring>       // for std::memcpy
+#include <exception>     // for std::exception
+#include <filesystem>    // for std::filesystem
+#include <stdexcept>     // for std::runtime_error
+#include <string>        // for std::string
+#include <string_view>   // for std::string_view
+#include <system_error>  // for std::error_code
+#include <vector>        // for std::vector
+
+#include <fmt/core.h>
+
+#include "io.hpp"
+#include "snapshot.hpp"
+#include "store.hpp"
+#include "url.hpp"
+
+namespace core::snapshot {
+
+namespace {
+
+/**
+ * @brief Private helper variable that contains the first bytes of every snapshot.
+ */
+constexpr std::string_view magic = "ytt-snap";
+
+/**
+ * @brief Private helper variable that contains the version of the snapshot format. Snapshots of other versions are rebuilt.
+ */
+constexpr std::uint64_t format_version = 1;
+
+/**
+ * @brief Private helper variable that contains a value whose bytes tell the byte order of the machine that wrote the snapshot.
+ */
+constexpr std::uint64_t byte_order_mark = 0x0102030405060708;
+
+/**
+ * @brief Private helper enum that contains the index of each 64-bit word of the header.
+ */
+enum Header : std::size_t {
+    Magic,
+    ByteOrder,
+    Version,
+    HtmlSize,
+    HtmlTime,
+    HtmlHash,
+    Count,
+    RowsEnd,
+    StringsSize,
+    Checksum,
+    HeaderWords,
+};
+
+/**
+ * @brief Private helper enum that contains the index of each 64-bit word of a channel's record.
+ */
+enum Record : std::size_t {
+    RowBegin,
+    RowEnd,
+    Offset,
+    NameLength,
+    LinkLength,
+    DescriptionLength,
+    KeyLength,
+    RecordWords,
+};
+
+/**
+ * @brief Private helper variable that contains the size of the header in bytes.
+ */
+constexpr std::size_t header_size = HeaderWords * sizeof(std::uint64_t);
+
+/**
+ * @brief Private helper variable that contains the size of a record in bytes.
+ */
+constexpr std::size_t record_size = RecordWords * sizeof(std::uint64_t);
+
+/**
+ * @brief Private helper function to read a 64-bit word from any offset.
+ *
+ * @param data Pointer to the first byte of the word.
+ *
+ * @return Word in native byte order.
+ */
+[[nodiscard]] std::uint64_t read_word(const char *data)
+{
+    std::uint64_t word;
+    std::memcpy(&word, data, sizeof(word));
+    return word;
+}
+
+/**
+ * @brief Private helper function to append a 64-bit word in native byte order.
+ *
+ * @param buffer Buffer to append to.
+ * @param word Word to append (e.g., "42").
+ */
+void append_word(std::string &buffer,
+                 const std::uint64_t word)
+{
+    char bytes[sizeof(word)];
+    std::memcpy(bytes, &word, sizeof(word));
+    buffer.append(bytes, sizeof(word));
+}
+
+/**
+ * @brief Private helper function to get the modification time of a file as a number.
+ *
+ * @param path Path to the file (e.g., "~/subscriptions.html").
+ *
+ * @return Modification time in the clock's native ticks.
+ *
+ * @throws std::filesystem::filesystem_error If the file does not exist.
+ */
+[[nodiscard]] std::uint64_t get_file_time(const std::filesystem::path &path)
+{
+    return static_cast<std::uint64_t>(std::filesystem::last_write_time(path).time_since_epoch().count());
+}
+
+}  // namespace
+
+std::filesystem::path get_path(const std::filesystem::path &html_path)
+{
+    std::filesystem::path path = html_path;
+    path.replace_extension(".ytt");
+    return path;
+}
+
+std::uint64_t hash_contents(const std::string_view contents)
+{
+    // Four independent lanes keep the multiplier busy, so the hash runs at close to memory speed
+    constexpr std::uint64_t multiplier = 0x9E3779B97F4A7C15;
+    std::uint64_t lanes[4] = {0x243F6A8885A308D3, 0x13198A2E03707344, 0xA4093822299F31D0, 0x082EFA98EC4E6C89};
+    const char *data = contents.data();
+    std::size_t offset = 0;
+    for (; offset + sizeof(lanes) <= contents.size(); offset += sizeof(lanes)) {
+        for (std::size_t lane = 0; lane < 4; ++lane) {
+            lanes[lane] = (lanes[lane] ^ read_word(data + offset + lane * sizeof(std::uint64_t))) * multiplier;
+            lanes[lane] ^= lanes[lane] >> 32;
+        }
+    }
+
+    // Combine the lanes, then the remaining bytes and the size
+    std::uint64_t hash = contents.size();
+    for (const std::uint64_t lane : lanes) {
+        hash = (hash ^ lane) * multiplier;
+        hash ^= hash >> 29;
+    }
+    for (; offset < contents.size(); ++offset) {
+        hash = (hash ^ static_cast<unsigned char>(data[offset])) * multiplier;
+    }
+    hash ^= hash >> 32;
+    return hash;
+}
+
+void save(const std::filesystem::path &html_path,
+          const store::ChannelStore &channels,
+          const io::Layout &layout)
+{
+    const std::filesystem::path path = get_path(html_path);
+    try {
+        if (layout.rows.size() != channels.size()) {
+            throw std::runtime_error("Layout does not match the channels");
+        }
+
+        // Identify the HTML table by its size, modification time and contents
+        const io::MappedFile html(html_path);
+        const std::string_view contents = html.view();
+        const std::uint64_t html_time = get_file_time(html_path);
+
+        // Canonicalizing links is the slowest part of loading, so the keys are stored along with the fields
+        std::vector<std::string> keys;
+        keys.reserve(channels.size());
+        std::size_t strings_size = 0;
+        for (const store::ChannelView channel : channels) {
+            keys.push_back(url::get_channel_key(channel.link));
+            strings_size += channel.name.size() + channel.link.size() + channel.description.size() + keys.back().size();
+        }
+
+        // Lay out the records, then the fields they point to
+        std::string buffer;
+        buffer.reserve(header_size + channels.size() * record_size + strings_size);
+        buffer.resize(header_size);
+        std::uint64_t offset = 0;
+        for (std::size_t i = 0; i < channels.size(); ++i) {
+            append_word(buffer, layout.rows[i].begin);
+            append_word(buffer, layout.rows[i].end);
+            append_word(buffer, offset);
+            append_word(buffer, channels.name(i).size());
+            append_word(buffer, channels.link(i).size());
+            append_word(buffer, channels.description(i).size());
+            append_word(buffer, keys[i].size());
+            offset += channels.name(i).size() + channels.link(i).size() + channels.description(i).size() + keys[i].size();
+        }
+        for (std::size_t i = 0; i < channels.size(); ++i) {
+            buffer.append(channels.name(i));
+            buffer.append(channels.link(i));
+            buffer.append(channels.description(i));
+            buffer.append(keys[i]);
+        }
+
+        // Fill in the header, with a checksum over everything after it
+        std::string header;
+        header.reserve(header_size);
+        header.append(magic);
+        append_word(header, byte_order_mark);
+        append_word(header, format_version);
+        append_word(header, contents.size());
+        append_word(header, html_time);
+        append_word(header, hash_contents(contents));
+        append_word(header, channels.size());
+        append_word(header, layout.rows_end);
+        append_word(header, strings_size);
+        append_word(header, hash_contents(std::string_view(buffer).substr(header_size)));
+        buffer.replace(0, header_size, header);
+
+        // The snapshot is only a cache, so there is no need to wait for the disk
+        io::write_file(path, buffer, io::Durability::None);
+    }
+    catch (const std::exception &e) {
+        throw std::runtime_error(fmt::format("Failed to save snapshot '{}': {}", path.string(), e.what()));
+    }
+}
+
+MappedSnapshot::MappedSnapshot(const std::filesystem::path &html_path)
+    : file_(get_path(html_path))
+{
+    const std::string_view text = this->file_.view();
+    const auto header = [&text](const Header word) {
+        return read_word(text.data() + word * sizeof(std::uint64_t));
+    };
+
+    // Reject snapshots of another format or machine
+    if (text.size() < header_size || text.substr(0, magic.size()) != magic || header(ByteOrder) != byte_order_mark || header(Version) != format_version) {
+        throw std::runtime_error("Snapshot has an unknown format");
+    }
+    this->count_ = static_cast<std::size_t>(header(Count));
+    this->rows_end_ = static_cast<std::size_t>(header(RowsEnd));
+    const std::uint64_t strings_size = header(StringsSize);
+    if (this->count_ > (text.size() - header_size) / record_size || header_size + this->count_ * record_size + strings_size != text.size()) {
+        throw std::runtime_error("Snapshot is truncated");
+    }
+
+    // Reject snapshots of another version of the HTML table, checking the cheap properties first
+    std::error_code ec;
+    const std::uintmax_t html_size = std::filesystem::file_size(html_path, ec);
+    if (ec || html_size != header(HtmlSize) || get_file_time(html_path) != header(HtmlTime)) {
+        throw std::runtime_error("Snapshot is out of date");
+    }
+    if (hash_contents(text.substr(header_size)) != header(Checksum)) {
+        throw std::runtime_error("Snapshot is corrupt");
+    }
+    {
+        const io::MappedFile html(html_path);
+        if (hash_contents(html.view()) != header(HtmlHash)) {
+            throw std::runtime_error("Snapshot is out of date");
+        }
+    }
+
+    // Check that every record points inside the snapshot and the HTML table, so the accessors need no checks
+    for (std::size_t i = 0; i < this->count_; ++i) {
+        const char *record = text.data() + header_size + i * record_size;
+        const auto word = [record](const Record index) {
+            return read_word(record + index * sizeof(std::uint64_t));
+        };
+        const std::uint64_t length = word(NameLength) + word(LinkLength) + word(DescriptionLength) + word(KeyLength);
+        if (word(Offset) > strings_size || length > strings_size - word(Offset) || word(RowBegin) > word(RowEnd) || word(RowEnd) > this->rows_end_ || this->rows_end_ > html_size) {
+            throw std::runtime_error("Snapshot is corrupt");
+        }
+    }
+}
+
+std::size_t MappedSnapshot::size() const
+{
+    return this->count_;
+}
+
+std::string_view MappedSnapshot::name(const std::size_t index) const
+{
+    return this->field(index, 0);
+}
+
+std::string_view MappedSnapshot::link(const std::size_t index) const
+{
+    return this->field(index, 1);
+}
+
+std::string_view MappedSnapshot::description(const std::size_t index) const
+{
+    return this->field(index, 2);
+}
+
+std::string_view MappedSnapshot::key(const std::size_t index) const
+{
+    return this->field(index, 3);
+}
+
+io::Layout MappedSnapshot::get_layout() const
+{
+    const char *records = this->file_.view().data() + header_size;
+    io::Layout layout;
+    layout.rows.reserve(this->count_);
+    for (std::size_t i = 0; i < this->count_; ++i) {
+        const char *record = records + i * record_size;
+        layout.rows.push_back(io::ByteRange{static_cast<std::size_t>(read_word(record + RowBegin * sizeof(std::uint64_t))),
+                                            static_cast<std::size_t>(read_word(record + RowEnd * sizeof(std::uint64_t)))});
+    }
+    layout.rows_end = this->rows_end_;
+    return layout;
+}
+
+std::string_view MappedSnapshot::field(const std::size_t index,
+                                       const std::size_t which) const
+{
+    const char *data = this->file_.view().data();
+    const char *record = data + header_size + index * record_size;
+    std::uint64_t offset = read_word(record + Offset * sizeof(std::uint64_t));
+    for (std::size_t i = 0; i < which; ++i) {
+        offset += read_word(record + (NameLength + i) * sizeof(std::uint64_t));
+    }
+    const std::uint64_t length = read_word(record + (NameLength + which) * sizeof(std::uint64_t));
+    const char *strings = data + header_size + this->count_ * record_size;
+    return std::string_view(strings + offset, static_cast<std::size_t>(length));
+}
+
+}  // namespace core::snapshot
@@ -0,0 +1,150 @@
+/**
+ * @file snapshot.hpp
+ *
+ * @brief Binary snapshots of HTML tables, for fast startup.
+ */
+
+#pragma once
+
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint64_t
+#include <filesystem>   // for std::filesystem
+#include <string_view>  // for std::string_view
+
+#include "io.hpp"
+#include "store.hpp"
+
+namespace core::snapshot {
+
+/**
+ * @brief Get the path of the snapshot that belongs to an HTML table.
+ *
+ * @param html_path Path to the HTML table (e.g., "~/subscriptions.html").
+ *
+ * @return Path to the snapshot, next to the table (e.g., "~/subscriptions.ytt").
+ */
+[[nodiscard]] std::filesystem::path get_path(const std::filesystem::path &html_path);
+
+/**
+ * @brief Hash the contents of a file, to tell whether it changed.
+ *
+ * The hash is not cryptographic; it reads 32 bytes per step, so hashing a large table costs about as much as reading it.
+ *
+ * @param contents Contents of the file.
+ *
+ * @return 64-bit hash (e.g., "0x1F2E3D4C5B6A7988").
+ */
+[[nodiscard]] std::uint64_t hash_contents(const std::string_view contents);
+
+/**
+ * @brief Write the snapshot of an HTML table, next to the table.
+ *
+ * The snapshot holds every channel in store order, as a fixed-size record (the byte range of its row in the HTML file, and the offset and length of each field) followed by the fields themselves and the canonical key of each link, along with the size, modification time and content hash of the HTML file it was taken from. It is written atomically without syncing, because a lost or torn snapshot is detected and rebuilt from the HTML file.
+ *
+ * @param html_path Path to the HTML table (e.g., "~/subscriptions.html"). The table must already be on disk.
+ * @param channels Store of YouTube channels, exactly as the HTML table holds them.
+ * @param layout Layout of the rows in the HTML table, in the same order as the channels.
+ *
+ * @throws std::runtime_error If the HTML table cannot be read, or the snapshot cannot be written.
+ */
+void save(const std::filesystem::path &html_path,
+          const store::ChannelStore &channels,
+          const io::Layout &layout);
+
+/**
+ * @brief Class that represents a snapshot of an HTML table, memory-mapped from disk.
+ *
+ * On construction, the snapshot is mapped read-only and checked against the HTML table: its size, modification time and content hash must match, and the snapshot's own checksum must be intact. Fields are views into the mapping, so nothing is parsed or copied until the caller does so.
+ *
+ * @note This class is marked as `final` to prevent inheritance.
+ */
+class MappedSnapshot final {
+  public:
+    /**
+     * @brief Construct a new MappedSnapshot object.
+     *
+     * @param html_path Path to the HTML table (e.g., "~/subscriptions.html"), whose snapshot to map.
+     *
+     * @throws std::runtime_error If the snapshot does not exist, is corrupt, or was taken from a different version of the HTML table (e.g., the table was edited by hand).
+     */
+    explicit MappedSnapshot(const std::filesystem::path &html_path);
+
+    /**
+     * @brief Get the number of channels.
+     *
+     * @return Number of channels (e.g., "1000").
+     */
+    [[nodiscard]] std::size_t size() const;
+
+    /**
+     * @brief Get the name of a channel. Channels are in store order.
+     *
+     * @param index Index of the channel (e.g., "0").
+     *
+     * @return View of the name, valid for the lifetime of the object.
+     */
+    [[nodiscard]] std::string_view name(const std::size_t index) const;
+
+    /**
+     * @brief Get the link of a channel.
+     *
+     * @param index Index of the channel (e.g., "0").
+     *
+     * @return View of the link, valid for the lifetime of the object.
+     */
+    [[nodiscard]] std::string_view link(const std::size_t index) const;
+
+    /**
+     * @brief Get the description of a channel.
+     *
+     * @param index Index of the channel (e.g., "0").
+     *
+     * @return View of the description, valid for the lifetime of the object.
+     */
+    [[nodiscard]] std::string_view description(const std::size_t index) const;
+
+    /**
+     * @brief Get the canonical key of a channel's link (see "core::url::get_channel_key").
+     *
+     * @param index Index of the channel (e.g., "0").
+     *
+     * @return View of the key (e.g., "youtube.com/@noriyaro"), or an empty view if the link has no host.
+     */
+    [[nodiscard]] std::string_view key(const std::size_t index) const;
+
+    /**
+     * @brief Get the layout of the rows in the HTML table, in the same order as the channels.
+     *
+     * @return Layout of the rows.
+     */
+    [[nodiscard]] io::Layout get_layout() const;
+
+  private:
+    /**
+     * @brief Read-only mapping of the snapshot.
+     */
+    io::MappedFile file_;
+
+    /**
+     * @brief Number of channels.
+     */
+    std::size_t count_ = 0;
+
+    /**
+     * @brief Offset after the last row in the HTML table.
+     */
+    std::size_t rows_end_ = 0;
+
+    /**
+     * @brief Read a field of a channel's record.
+     *
+     * @param index Index of the channel (e.g., "0").
+     * @param which Index of the field ("0" for the name, "1" for the link, "2" for the description, "3" for the key).
+     *
+     * @return View of the field.
+     */
+    [[nodiscard]] std::string_view field(const std::size_t index,
+                                         const std::size_t which) const;
+};
+
+}  // namespace core::snapshot
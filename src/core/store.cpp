@@ -0,0 +1,413 @@
+/**
+ * @file store.cpp
+ */
+
+#include <algorithm>         // for std::stable_sort, std::upper_bound
+#include <cstddef>           // for std::size_t, std::ptrdiff_t
+#include <cstdint>           // for std::uint32_t, std::uint64_t
+#include <functional>        // for std::hash
+#include <initializer_list>  // for std::initializer_list
+#include <limits>            // for std::numeric_limits
+#include <optional>          // for std::optional, std::nullopt
+#include <stdexcept>         // for std::length_error
+#include <string>            // for std::string
+#include <string_view>       // for std::string_view
+#include <utility>           // for std::move
+#include <vector>            // for std::vector
+
+#include "store.hpp"
+
+namespace core::store {
+
+ChannelStore::Iterator::Iterator(const ChannelStore &store,
+                                 const std::size_t index)
+    : store_(&store),
+      index_(index) {}
+
+ChannelView ChannelStore::Iterator::operator*() const
+{
+    return (*this->store_)[this->index_];
+}
+
+ChannelStore::Iterator &ChannelStore::Iterator::operator++()
+{
+    ++this->index_;
+    return *this;
+}
+
+ChannelStore::Iterator ChannelStore::Iterator::operator++(int)
+{
+    Iterator previous = *this;
+    ++this->index_;
+    return previous;
+}
+
+bool ChannelStore::Iterator::operator==(const Iterator &other) const
+{
+    return this->store_ == other.store_ && this->index_ == other.index_;
+}
+
+bool ChannelStore::Iterator::operator!=(const Iterator &other) const
+{
+    return !(*this == other);
+}
+
+std::size_t ChannelStore::size() const
+{
+    return this->order_.size();
+}
+
+bool ChannelStore::empty() const
+{
+    return this->order_.empty();
+}
+
+std::string_view ChannelStore::name(const std::size_t index) const
+{
+    return this->names_.get(this->order_[index]);
+}
+
+std::string_view ChannelStore::link(const std::size_t index) const
+{
+    return this->links_.get(this->order_[index]);
+}
+
+std::string_view ChannelStore::description(const std::size_t index) const
+{
+    return this->descriptions_.get(this->order_[index]);
+}
+
+ChannelView ChannelStore::operator[](const std::size_t index) const
+{
+    const std::uint32_t slot = this->order_[index];
+    return ChannelView{this->names_.get(slot), this->links_.get(slot), this->descriptions_.get(slot)};
+}
+
+std::uint32_t ChannelStore::slot(const std::size_t index) const
+{
+    return this->order_[index];
+}
+
+std::size_t ChannelStore::slot_count() const
+{
+    return this->names_.spans.size();
+}
+
+ChannelStore::Iterator ChannelStore::begin() const
+{
+    return Iterator(*this, 0);
+}
+
+ChannelStore::Iterator ChannelStore::end() const
+{
+    return Iterator(*this, this->size());
+}
+
+bool ChannelStore::contains(const std::string_view name) const
+{
+    return this->find_slot(name) != empty_bucket;
+}
+
+std::optional<std::size_t> ChannelStore::find(const std::string_view name) const
+{
+    // Reject unknown names without a binary search
+    if (!this->contains(name)) {
+        return std::nullopt;
+    }
+    return this->lower_bound(name);
+}
+
+std::optional<std::size_t> ChannelStore::find(const std::string_view name,
+                                              const std::string_view link) const
+{
+    const std::optional<std::size_t> first = this->find(name);
+    if (!first) {
+        return std::nullopt;
+    }
+    // Channels with equal names are next to each other in sorted order
+    for (std::size_t index = *first; index < this->order_.size() && this->name(index) == name; ++index) {
+        if (this->link(index) == link) {
+            return index;
+        }
+    }
+    return std::nullopt;
+}
+
+std::size_t ChannelStore::lower_bound(const std::string_view name) const
+{
+    std::size_t low = 0;
+    std::size_t high = this->order_.size();
+    while (low < high) {
+        const std::size_t middle = low + (high - low) / 2;
+        if (this->names_.get(this->order_[middle]) < name) {
+            low = middle + 1;
+        }
+        else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+void ChannelStore::reserve(const std::size_t channels,
+                           const std::size_t bytes_per_channel)
+{
+    this->order_.reserve(channels);
+    for (Column *column : {&this->names_, &this->links_, &this->descriptions_}) {
+        column->spans.reserve(channels);
+        column->arena.reserve(channels * bytes_per_channel);
+    }
+    if (this->buckets_.size() * 3 < channels * 4) {
+        this->index_rehash(channels * 2);
+    }
+}
+
+std::size_t ChannelStore::insert(const std::string_view name,
+                                 const std::string_view link,
+                                 const std::string_view description)
+{
+    // Find the position after any equal names, appending directly if the input is already sorted
+    std::size_t position = this->order_.size();
+    if (!this->order_.empty() && name < this->names_.get(this->order_.back())) {
+        std::size_t low = 0;
+        std::size_t high = this->order_.size();
+        while (low < high) {
+            const std::size_t middle = low + (high - low) / 2;
+            if (name < this->names_.get(this->order_[middle])) {
+                high = middle;
+            }
+            else {
+                low = middle + 1;
+            }
+        }
+        position = low;
+    }
+
+    const std::uint32_t slot = this->store(name, link, description, {});
+    this->order_.insert(this->order_.begin() + static_cast<std::ptrdiff_t>(position), slot);
+    return position;
+}
+
+std::vector<std::size_t> ChannelStore::insert(const std::vector<ChannelView> &channels)
+{
+    // Store every channel in a slot, without touching the order yet
+    std::vector<std::uint32_t> slots;
+    slots.reserve(channels.size());
+    for (const ChannelView &channel : channels) {
+        slots.push_back(this->store(channel.name, channel.link, channel.description, slots));
+    }
+
+    // Sort the new slots by name, keeping equal names in the given order, then merge them behind equal existing names
+    const auto by_name = [this](const std::uint32_t a,
+                                const std::uint32_t b) {
+        return this->names_.get(a) < this->names_.get(b);
+    };
+    std::stable_sort(slots.begin(), slots.end(), by_name);
+    std::vector<std::uint32_t> merged;
+    merged.reserve(this->order_.size() + slots.size());
+    std::vector<std::size_t> positions;
+    positions.reserve(slots.size());
+    auto existing = this->order_.cbegin();
+    for (const std::uint32_t slot : slots) {
+        const auto end = std::upper_bound(existing, this->order_.cend(), slot, by_name);
+        merged.insert(merged.end(), existing, end);
+        existing = end;
+        positions.push_back(merged.size());
+        merged.push_back(slot);
+    }
+    merged.insert(merged.end(), existing, this->order_.cend());
+    this->order_ = std::move(merged);
+    return positions;
+}
+
+void ChannelStore::erase(const std::size_t index)
+{
+    const std::uint32_t slot = this->order_[index];
+    this->index_erase(slot, hash_name(this->names_.get(slot)));
+    this->order_.erase(this->order_.begin() + static_cast<std::ptrdiff_t>(index));
+    this->free_slots_.push_back(slot);
+
+    // Compact an arena once more than half of it is wasted
+    for (Column *column : {&this->names_, &this->links_, &this->descriptions_}) {
+        column->release(slot);
+        if (column->garbage > column->arena.size() / 2) {
+            column->compact(this->order_);
+        }
+    }
+}
+
+void ChannelStore::clear()
+{
+    for (Column *column : {&this->names_, &this->links_, &this->descriptions_}) {
+        column->arena.clear();
+        column->spans.clear();
+        column->garbage = 0;
+    }
+    this->order_.clear();
+    this->free_slots_.clear();
+    this->buckets_.clear();
+    this->buckets_used_ = 0;
+}
+
+std::uint32_t ChannelStore::store(const std::string_view name,
+                                  const std::string_view link,
+                                  const std::string_view description,
+                                  const std::vector<std::uint32_t> &pending)
+{
+    // Offsets are 32-bit to keep the columns dense, so reclaim wasted space before an arena overflows
+    // Slots that are stored but not ordered yet are live too, so they must survive the compaction
+    constexpr std::size_t max_size = std::numeric_limits<std::uint32_t>::max();
+    const std::string_view values[] = {name, link, description};
+    Column *columns[] = {&this->names_, &this->links_, &this->descriptions_};
+    for (std::size_t i = 0; i < 3; ++i) {
+        if (columns[i]->arena.size() + values[i].size() > max_size) {
+            std::vector<std::uint32_t> live = this->order_;
+            live.insert(live.end(), pending.cbegin(), pending.cend());
+            columns[i]->compact(live);
+            if (columns[i]->arena.size() + values[i].size() > max_size) {
+                throw std::length_error("Channel store arena exceeds 4 GiB");
+            }
+        }
+    }
+
+    // Reuse a free slot if there is one
+    std::uint32_t slot;
+    if (!this->free_slots_.empty()) {
+        slot = this->free_slots_.back();
+        this->free_slots_.pop_back();
+    }
+    else {
+        slot = static_cast<std::uint32_t>(this->names_.spans.size());
+    }
+    for (std::size_t i = 0; i < 3; ++i) {
+        columns[i]->set(slot, values[i]);
+    }
+    this->index_insert(slot, hash_name(name));
+    return slot;
+}
+
+std::string_view ChannelStore::Column::get(const std::uint32_t slot) const
+{
+    const Span &span = this->spans[slot];
+    return std::string_view(this->arena.data() + span.offset, span.length);
+}
+
+void ChannelStore::Column::set(const std::uint32_t slot,
+                               const std::string_view value)
+{
+    const Span span{static_cast<std::uint32_t>(this->arena.size()), static_cast<std::uint32_t>(value.size())};
+    this->arena.append(value);
+    if (slot == this->spans.size()) {
+        this->spans.push_back(span);
+    }
+    else {
+        this->spans[slot] = span;
+    }
+}
+
+void ChannelStore::Column::release(const std::uint32_t slot)
+{
+    this->garbage += this->spans[slot].length;
+    this->spans[slot] = Span{0, 0};
+}
+
+void ChannelStore::Column::compact(const std::vector<std::uint32_t> &live_slots)
+{
+    std::string compacted;
+    compacted.reserve(this->arena.size() - this->garbage);
+    for (const std::uint32_t slot : live_slots) {
+        Span &span = this->spans[slot];
+        const auto offset = static_cast<std::uint32_t>(compacted.size());
+        compacted.append(this->arena, span.offset, span.length);
+        span.offset = offset;
+    }
+    this->arena = std::move(compacted);
+    this->garbage = 0;
+}
+
+std::uint32_t ChannelStore::hash_name(const std::string_view name)
+{
+    // Fold the hash to 32 bits, which is plenty to filter out mismatches
+    const auto hash = static_cast<std::uint64_t>(std::hash<std::string_view>{}(name));
+    return static_cast<std::uint32_t>(hash ^ (hash >> 32));
+}
+
+std::uint32_t ChannelStore::find_slot(const std::string_view name) const
+{
+    if (this->buckets_.empty()) {
+        return empty_bucket;
+    }
+    const std::uint32_t hash = hash_name(name);
+    const std::size_t mask = this->buckets_.size() - 1;
+    for (std::size_t i = hash & mask;; i = (i + 1) & mask) {
+        const Bucket &bucket = this->buckets_[i];
+        if (bucket.slot == empty_bucket) {
+            return empty_bucket;
+        }
+        if (bucket.slot != deleted_bucket && bucket.hash == hash && this->names_.get(bucket.slot) == name) {
+            return bucket.slot;
+        }
+    }
+}
+
+void ChannelStore::index_insert(const std::uint32_t slot,
+                                const std::uint32_t hash)
+{
+    // Keep the load factor (including deleted buckets) below 3/4, so probe sequences stay short
+    // The live slots include the ones stored by a bulk insert that are not ordered yet, so the index grows with them
+    if ((this->buckets_used_ + 1) * 4 > this->buckets_.size() * 3) {
+        this->index_rehash((this->names_.spans.size() - this->free_slots_.size() + 1) * 2);
+    }
+    const std::size_t mask = this->buckets_.size() - 1;
+    for (std::size_t i = hash & mask;; i = (i + 1) & mask) {
+        Bucket &bucket = this->buckets_[i];
+        if (bucket.slot == empty_bucket || bucket.slot == deleted_bucket) {
+            if (bucket.slot == empty_bucket) {
+                ++this->buckets_used_;
+            }
+            bucket = Bucket{slot, hash};
+            return;
+        }
+    }
+}
+
+void ChannelStore::index_erase(const std::uint32_t slot,
+                               const std::uint32_t hash)
+{
+    // Leave a marker instead of emptying the bucket, so that probe sequences passing through it stay intact
+    const std::size_t mask = this->buckets_.size() - 1;
+    for (std::size_t i = hash & mask;; i = (i + 1) & mask) {
+        Bucket &bucket = this->buckets_[i];
+        if (bucket.slot == slot) {
+            bucket.slot = deleted_bucket;
+            return;
+        }
+    }
+}
+
+void ChannelStore::index_rehash(const std::size_t capacity)
+{
+    std::size_t size = 16;
+    while (size < capacity) {
+        size *= 2;
+    }
+    std::vector<Bucket> old_buckets(size, Bucket{empty_bucket, 0});
+    old_buckets.swap(this->buckets_);
+    this->buckets_used_ = 0;
+
+    // Reinsert the live buckets using their stored hashes, without touching the names
+    const std::size_t mask = this->buckets_.size() - 1;
+    for (const Bucket &old_bucket : old_buckets) {
+        if (old_bucket.slot == empty_bucket || old_bucket.slot == deleted_bucket) {
+            continue;
+        }
+        std::size_t i = old_bucket.hash & mask;
+        while (this->buckets_[i].slot != empty_bucket) {
+            i = (i + 1) & mask;
+        }
+        this->buckets_[i] = old_bucket;
+        ++this->buckets_used_;
+    }
+}
+
+}  // namespace core::store
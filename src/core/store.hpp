@@ -0,0 +1,359 @@
+/**
+ * @file store.hpp
+ *
+ * @brief Store YouTube channels contiguously in memory.
+ */
+
+#pragma once
+
+#include <cstddef>      // for std::size_t, std::ptrdiff_t
+#include <cstdint>      // for std::uint32_t
+#include <iterator>     // for std::forward_iterator_tag
+#include <optional>     // for std::optional
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+#include <vector>       // for std::vector
+
+namespace core::store {
+
+/**
+ * @brief Struct that represents a read-only view of a single YouTube channel inside a store.
+ *
+ * The fields are views into the store, so they are invalidated by any mutation of the store.
+ *
+ * @note This struct is marked as `final` to prevent inheritance.
+ */
+struct ChannelView final {
+    /**
+     * @brief YouTube Channel's name (e.g., "Noriyaro").
+     */
+    std::string_view name;
+
+    /**
+     * @brief YouTube Channel's link (e.g., "https://www.youtube.com/@noriyaro/videos").
+     */
+    std::string_view link;
+
+    /**
+     * @brief YouTube Channel's description (e.g., "JP Drifting").
+     */
+    std::string_view description;
+};
+
+/**
+ * @brief Class that stores YouTube channels as a struct of arrays, sorted by name.
+ *
+ * Names, links and descriptions live in three separate arenas (one contiguous byte buffer each), with an offset/length column per field. Adding a channel appends to the arenas instead of allocating three strings, and scanning a single field (e.g., names) only touches that field's memory.
+ *
+ * Each channel occupies a stable slot in the columns. The sorted order is a separate vector of slot numbers, so inserting or removing a channel only shifts 4 bytes per following channel. A hash index maps names to slots, so checking whether a name exists is O(1), and finding its position is O(log n).
+ *
+ * Removed channels leave their bytes behind in the arenas until the wasted space outgrows the live data, at which point the arenas are compacted.
+ *
+ * @note This class is marked as `final` to prevent inheritance.
+ */
+class ChannelStore final {
+  public:
+    /**
+     * @brief Class that iterates over the channels of a store in sorted order.
+     *
+     * @note This class is marked as `final` to prevent inheritance.
+     */
+    class Iterator final {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = ChannelView;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = ChannelView;
+
+        /**
+         * @brief Construct a new Iterator object.
+         *
+         * @param store Store to iterate over.
+         * @param index Index of the current channel (e.g., "0").
+         */
+        explicit Iterator(const ChannelStore &store,
+                          const std::size_t index);
+
+        [[nodiscard]] ChannelView operator*() const;
+        Iterator &operator++();
+        Iterator operator++(int);
+        [[nodiscard]] bool operator==(const Iterator &other) const;
+        [[nodiscard]] bool operator!=(const Iterator &other) const;
+
+      private:
+        /**
+         * @brief Store to iterate over.
+         */
+        const ChannelStore *store_;
+
+        /**
+         * @brief Index of the current channel.
+         */
+        std::size_t index_;
+    };
+
+    /**
+     * @brief Get the number of channels.
+     *
+     * @return Number of channels (e.g., "3").
+     */
+    [[nodiscard]] std::size_t size() const;
+
+    /**
+     * @brief Check if the store is empty.
+     *
+     * @return True if there are no channels, false otherwise.
+     */
+    [[nodiscard]] bool empty() const;
+
+    /**
+     * @brief Get the name of a channel.
+     *
+     * @param index Index of the channel in sorted order (e.g., "0"). Must be less than "size()".
+     *
+     * @return YouTube Channel's name (e.g., "Noriyaro").
+     */
+    [[nodiscard]] std::string_view name(const std::size_t index) const;
+
+    /**
+     * @brief Get the link of a channel.
+     *
+     * @param index Index of the channel in sorted order (e.g., "0"). Must be less than "size()".
+     *
+     * @return YouTube Channel's link (e.g., "https://www.youtube.com/@noriyaro/videos").
+     */
+    [[nodiscard]] std::string_view link(const std::size_t index) const;
+
+    /**
+     * @brief Get the description of a channel.
+     *
+     * @param index Index of the channel in sorted order (e.g., "0"). Must be less than "size()".
+     *
+     * @return YouTube Channel's description (e.g., "JP Drifting").
+     */
+    [[nodiscard]] std::string_view description(const std::size_t index) const;
+
+    /**
+     * @brief Get a view of a channel.
+     *
+     * @param index Index of the channel in sorted order (e.g., "0"). Must be less than "size()".
+     *
+     * @return View of the channel's name, link and description.
+     */
+    [[nodiscard]] ChannelView operator[](const std::size_t index) const;
+
+    /**
+     * @brief Get the slot of a channel, which stays the same while the channel is in the store, however many channels are inserted or removed around it.
+     *
+     * @param index Index of the channel in sorted order (e.g., "0"). Must be less than "size()".
+     *
+     * @return Slot of the channel (e.g., "7"), less than "slot_count()". Once the channel is removed, its slot may be reused by a later one.
+     */
+    [[nodiscard]] std::uint32_t slot(const std::size_t index) const;
+
+    /**
+     * @brief Get the number of slots, including the free slots of removed channels.
+     *
+     * @return Number of slots (e.g., "3").
+     */
+    [[nodiscard]] std::size_t slot_count() const;
+
+    [[nodiscard]] Iterator begin() const;
+    [[nodiscard]] Iterator end() const;
+
+    /**
+     * @brief Check if a channel with the given name exists, using the hash index.
+     *
+     * @param name YouTube Channel's name (e.g., "Noriyaro").
+     *
+     * @return True if the channel exists, false otherwise.
+     */
+    [[nodiscard]] bool contains(const std::string_view name) const;
+
+    /**
+     * @brief Find the position of a channel by name.
+     *
+     * Unknown names are rejected in O(1) by the hash index, known names are located in O(log n) by binary search.
+     *
+     * @param name YouTube Channel's name (e.g., "Noriyaro").
+     *
+     * @return Index of the first channel with that name in sorted order, or std::nullopt if not found.
+     */
+    [[nodiscard]] std::optional<std::size_t> find(const std::string_view name) const;
+
+    /**
+     * @brief Find the position of a channel by name and link, which tells apart channels that share a name.
+     *
+     * The name is located like in the single-argument overload, then the channels with that name are checked in order.
+     *
+     * @param name YouTube Channel's name (e.g., "Noriyaro").
+     * @param link YouTube Channel's link, spelled exactly as stored (e.g., "https://www.youtube.com/@noriyaro/videos").
+     *
+     * @return Index of the first channel with that name and link in sorted order, or std::nullopt if not found.
+     */
+    [[nodiscard]] std::optional<std::size_t> find(const std::string_view name,
+                                                  const std::string_view link) const;
+
+    /**
+     * @brief Find the sorted position of a name using binary search.
+     *
+     * @param name YouTube Channel's name (e.g., "Noriyaro").
+     *
+     * @return Index of the first channel whose name is not less than the given name.
+     */
+    [[nodiscard]] std::size_t lower_bound(const std::string_view name) const;
+
+    /**
+     * @brief Reserve space for channels up front.
+     *
+     * @param channels Number of channels (e.g., "1000").
+     * @param bytes_per_channel Expected number of bytes per field (e.g., "32").
+     */
+    void reserve(const std::size_t channels,
+                 const std::size_t bytes_per_channel = 0);
+
+    /**
+     * @brief Insert a channel at its sorted position. Channels with equal names keep their insertion order.
+     *
+     * Inserting in sorted order (e.g., when loading a sorted file) appends in amortized O(1).
+     *
+     * @param name YouTube Channel's name (e.g., "Noriyaro").
+     * @param link YouTube Channel's link (e.g., "https://www.youtube.com/@noriyaro/videos").
+     * @param description YouTube Channel's description (e.g., "JP Drifting").
+     *
+     * @return Index of the inserted channel in sorted order.
+     *
+     * @throws std::length_error If an arena would exceed 4 GiB.
+     */
+    std::size_t insert(const std::string_view name,
+                       const std::string_view link,
+                       const std::string_view description);
+
+    /**
+     * @brief Insert many channels at once, merging them into the sorted order in a single pass.
+     *
+     * Inserting k channels one by one in random order shifts the order vector k times, i.e., O(k·n). This sorts the new channels and merges them in, i.e., O(n + k log k).
+     *
+     * @param channels Channels to insert, in any order. Among equal names, existing channels come first, then new ones in the given order. The viewed bytes are copied, so they only need to outlive the call, but they must not point into this store.
+     *
+     * @return Indices of the inserted channels in sorted order, ascending (e.g., "{0, 5}").
+     *
+     * @throws std::length_error If an arena would exceed 4 GiB.
+     */
+    std::vector<std::size_t> insert(const std::vector<ChannelView> &channels);
+
+    /**
+     * @brief Remove a channel, shifting the following channels down by one.
+     *
+     * @param index Index of the channel in sorted order (e.g., "0"). Must be less than "size()".
+     */
+    void erase(const std::size_t index);
+
+    /**
+     * @brief Remove all channels and release the wasted arena space.
+     */
+    void clear();
+
+  private:
+    /**
+     * @brief Struct that represents the byte range of a field inside its arena.
+     */
+    struct Span final {
+        std::uint32_t offset;
+        std::uint32_t length;
+    };
+
+    /**
+     * @brief Struct that represents one field (e.g., names) of every channel, indexed by slot.
+     */
+    struct Column final {
+        /**
+         * @brief Contiguous bytes of every value, in insertion order.
+         */
+        std::string arena;
+
+        /**
+         * @brief Byte range of the value in each slot.
+         */
+        std::vector<Span> spans;
+
+        /**
+         * @brief Number of arena bytes that belong to removed values.
+         */
+        std::size_t garbage = 0;
+
+        [[nodiscard]] std::string_view get(const std::uint32_t slot) const;
+        void set(const std::uint32_t slot,
+                 const std::string_view value);
+        void release(const std::uint32_t slot);
+        void compact(const std::vector<std::uint32_t> &live_slots);
+    };
+
+    /**
+     * @brief Struct that represents a bucket of the open-addressing hash index.
+     */
+    struct Bucket final {
+        /**
+         * @brief Slot of the channel, or "empty_bucket" / "deleted_bucket".
+         */
+        std::uint32_t slot;
+
+        /**
+         * @brief Hash of the channel's name, so that most mismatches are rejected without touching the name arena.
+         */
+        std::uint32_t hash;
+    };
+
+    static constexpr std::uint32_t empty_bucket = 0xFFFFFFFFu;
+    static constexpr std::uint32_t deleted_bucket = 0xFFFFFFFEu;
+
+    /**
+     * @brief Names of the channels.
+     */
+    Column names_;
+
+    /**
+     * @brief Links of the channels.
+     */
+    Column links_;
+
+    /**
+     * @brief Descriptions of the channels.
+     */
+    Column descriptions_;
+
+    /**
+     * @brief Slots of the channels, sorted by name.
+     */
+    std::vector<std::uint32_t> order_;
+
+    /**
+     * @brief Slots that were freed by removed channels and can be reused.
+     */
+    std::vector<std::uint32_t> free_slots_;
+
+    /**
+     * @brief Buckets of the hash index from name to slot. The size is zero or a power of two.
+     */
+    std::vector<Bucket> buckets_;
+
+    /**
+     * @brief Number of buckets that are not empty (i.e., live or deleted).
+     */
+    std::size_t buckets_used_ = 0;
+
+    [[nodiscard]] std::uint32_t store(const std::string_view name,
+                                      const std::string_view link,
+                                      const std::string_view description,
+                                      const std::vector<std::uint32_t> &pending);
+    [[nodiscard]] static std::uint32_t hash_name(const std::string_view name);
+    [[nodiscard]] std::uint32_t find_slot(const std::string_view name) const;
+    void index_insert(const std::uint32_t slot,
+                      const std::uint32_t hash);
+    void index_erase(const std::uint32_t slot,
+                     const std::uint32_t hash);
+    void index_rehash(const std::size_t capacity);
+};
+
+}  // namespace core::store
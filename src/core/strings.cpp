@@ -2,27 +2,65 @@
  * @file strings.cpp
  */
 
-#include <string>  // for std::string
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint32_t
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
 
+#include "simd.hpp"
 #include "strings.hpp"
 
 namespace core::strings {
 
 std::string trim_whitespace(const std::string &str)
+{
+    return std::string(trim_whitespace(std::string_view(str)));
+}
+
+std::string_view trim_whitespace(const std::string_view str)
 {
     // Find the first non-whitespace character
-    const auto first = str.find_first_not_of(" \t\n\r");
+    const std::size_t first = simd::skip_whitespace(str);
 
     // If the string is empty, return an empty string
-    if (first == std::string::npos) {
-        return "";
+    if (first == str.size()) {
+        return {};
     }
 
-    // Find the last non-whitespace character
-    const auto last = str.find_last_not_of(" \t\n\r");
+    // Find the last non-whitespace character, which is close to the end, so the search runs backward one byte at a time
+    std::size_t last = str.size() - 1;
+    while (simd::is_whitespace(str[last])) {
+        --last;
+    }
 
     // Return the trimmed string
     return str.substr(first, last - first + 1);
 }
 
+void append_utf8(std::string &out,
+                 std::uint32_t code_point)
+{
+    if (code_point > 0x10FFFF || (code_point >= 0xD800 && code_point <= 0xDFFF)) {
+        code_point = 0xFFFD;
+    }
+    if (code_point < 0x80) {
+        out += static_cast<char>(code_point);
+    }
+    else if (code_point < 0x800) {
+        out += static_cast<char>(0xC0 | (code_point >> 6));
+        out += static_cast<char>(0x80 | (code_point & 0x3F));
+    }
+    else if (code_point < 0x10000) {
+        out += static_cast<char>(0xE0 | (code_point >> 12));
+        out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code_point & 0x3F));
+    }
+    else {
+        out += static_cast<char>(0xF0 | (code_point >> 18));
+        out += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code_point & 0x3F));
+    }
+}
+
 }  // namespace core::strings
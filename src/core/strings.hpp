@@ -6,12 +6,14 @@
 
 #pragma once
 
-#include <string>  // for std::string
+#include <cstdint>      // for std::uint32_t
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
 
 namespace core::strings {
 
 /**
- * @brief Trim leading and trailing whitespace from a string.
+ * @brief Trim leading and trailing whitespace (see "simd::is_whitespace") from a string.
  *
  * @param str String to trim (e.g., "  hello  ").
  *
@@ -19,4 +21,22 @@ namespace core::strings {
  */
 [[nodiscard]] std::string trim_whitespace(const std::string &str);
 
+/**
+ * @brief Trim leading and trailing whitespace (see "simd::is_whitespace") from a string, without copying it.
+ *
+ * @param str String to trim (e.g., "  hello  ").
+ *
+ * @return View of the trimmed part of "str" (e.g., "hello").
+ */
+[[nodiscard]] std::string_view trim_whitespace(const std::string_view str);
+
+/**
+ * @brief Append a Unicode code point as UTF-8.
+ *
+ * @param out String to append to.
+ * @param code_point Code point (e.g., "0x30C1"). Invalid code points are replaced with U+FFFD.
+ */
+void append_utf8(std::string &out,
+                 std::uint32_t code_point);
+
 }  // namespace core::strings
@@ -0,0 +1,195 @@
+/**
+ * @file url.cpp
+ */
+
+#include <cstddef>      // for std::size_t
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+
+#include "url.hpp"
+
+namespace core::url {
+
+namespace {
+
+/**
+ * @brief Private helper function to convert an ASCII character to lowercase.
+ *
+ * @param c Character to convert (e.g., 'A').
+ *
+ * @return Lowercase character (e.g., 'a'). Non-ASCII characters are returned unchanged.
+ */
+[[nodiscard]] constexpr char to_lower(const char c)
+{
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+/**
+ * @brief Private helper function to get the value of a hexadecimal digit.
+ *
+ * @param c Character to convert (e.g., 'F').
+ *
+ * @return Value of the digit (e.g., "15"), or -1 if the character is not a hexadecimal digit.
+ */
+[[nodiscard]] constexpr int hex_value(const char c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+/**
+ * @brief Private helper function to check if two strings are equal, ignoring ASCII case.
+ *
+ * @param text Text to check (e.g., "Channel").
+ * @param lower Lowercase text to compare against (e.g., "channel").
+ *
+ * @return True if the strings are equal, false otherwise.
+ */
+[[nodiscard]] bool equals_icase(const std::string_view text,
+                                const std::string_view lower)
+{
+    if (text.size() != lower.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        if (to_lower(text[i]) != lower[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Private helper function to append a path segment, decoding percent-escapes and optionally lowercasing it.
+ *
+ * Handles with non-ASCII characters are often shared percent-encoded (e.g., "@%E3%83%8E"), so decoding makes them match their raw UTF-8 spelling.
+ *
+ * @param out String to append to.
+ * @param segment Path segment (e.g., "@Noriyaro").
+ * @param lowercase If true, lowercase ASCII characters.
+ */
+void append_segment(std::string &out,
+                    const std::string_view segment,
+                    const bool lowercase)
+{
+    for (std::size_t i = 0; i < segment.size(); ++i) {
+        char c = segment[i];
+        if (c == '%' && i + 2 < segment.size()) {
+            const int high = hex_value(segment[i + 1]);
+            const int low = hex_value(segment[i + 2]);
+            if (high >= 0 && low >= 0) {
+                c = static_cast<char>(high * 16 + low);
+                i += 2;
+            }
+        }
+        out += lowercase ? to_lower(c) : c;
+    }
+}
+
+/**
+ * @brief Private helper function to get the next non-empty path segment.
+ *
+ * @param path Path to consume, without the leading slash (e.g., "@noriyaro//videos/"). The segment and its slashes are removed from the front.
+ *
+ * @return Next segment (e.g., "@noriyaro"), or an empty string if there are no more segments.
+ */
+[[nodiscard]] std::string_view next_segment(std::string_view &path)
+{
+    while (!path.empty() && path.front() == '/') {
+        path.remove_prefix(1);
+    }
+    const std::size_t end = path.find('/');
+    const std::string_view segment = path.substr(0, end);
+    path.remove_prefix(segment.size());
+    return segment;
+}
+
+}  // namespace
+
+std::string get_channel_key(const std::string_view link)
+{
+    // Trim surrounding whitespace
+    const std::size_t first = link.find_first_not_of(" \t\n\r");
+    if (first == std::string_view::npos) {
+        return "";
+    }
+    std::string_view rest = link.substr(first, link.find_last_not_of(" \t\n\r") - first + 1);
+
+    // Drop the query string and the fragment (e.g., "?view=0", "#about")
+    rest = rest.substr(0, rest.find_first_of("?#"));
+
+    // Drop the scheme (e.g., "https://"), if it comes before the first slash
+    const std::size_t scheme = rest.find("://");
+    if (scheme != std::string_view::npos && scheme < rest.find('/')) {
+        rest.remove_prefix(scheme + 3);
+    }
+    while (!rest.empty() && rest.front() == '/') {
+        rest.remove_prefix(1);
+    }
+
+    // Split off the host, dropping the port and a trailing dot (e.g., "www.youtube.com.:443")
+    std::string_view host = rest.substr(0, rest.find('/'));
+    std::string_view path = rest.substr(host.size());
+    host = host.substr(0, host.find(':'));
+    while (!host.empty() && host.back() == '.') {
+        host.remove_suffix(1);
+    }
+    if (host.empty()) {
+        return "";
+    }
+
+    // Lowercase the host, and drop the subdomains that serve the same channel pages
+    std::string key;
+    key.reserve(rest.size());
+    append_segment(key, host, true);
+    if (key.size() > 4 && key.compare(0, 4, "www.") == 0) {
+        key.erase(0, 4);
+    }
+    if (key == "m.youtube.com" || key == "music.youtube.com") {
+        key = "youtube.com";
+    }
+
+    // On YouTube, only the segments that name the channel matter; anything after them is a tab (e.g., "/videos")
+    if (key == "youtube.com") {
+        std::string_view remaining = path;
+        const std::string_view kind = next_segment(remaining);
+        const std::string_view name = next_segment(remaining);
+        // "/@handle"
+        if (kind.size() > 1 && kind.front() == '@') {
+            key += '/';
+            append_segment(key, kind, true);
+            return key;
+        }
+        // "/channel/UC..."
+        if (equals_icase(kind, "channel") && !name.empty()) {
+            key += "/channel/";
+            append_segment(key, name, false);
+            return key;
+        }
+        // "/c/name" and "/user/name"
+        if ((equals_icase(kind, "c") || equals_icase(kind, "user")) && !name.empty()) {
+            key += '/';
+            append_segment(key, kind, true);
+            key += '/';
+            append_segment(key, name, true);
+            return key;
+        }
+    }
+
+    // Elsewhere, keep the whole path, minus duplicate and trailing slashes
+    for (std::string_view segment = next_segment(path); !segment.empty(); segment = next_segment(path)) {
+        key += '/';
+        append_segment(key, segment, false);
+    }
+    return key;
+}
+
+}  // namespace core::url
@@ -0,0 +1,25 @@
+/**
+ * @file url.hpp
+ *
+ * @brief Canonicalize YouTube channel links.
+ */
+
+#pragma once
+
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+
+namespace core::url {
+
+/**
+ * @brief Get a stable key that identifies the channel a link points to, regardless of how the link is spelled.
+ *
+ * This runs offline, so links are only normalized, never resolved (e.g., a handle and the channel ID it belongs to produce different keys). For YouTube links, the scheme, the "www.", "m." and "music." subdomains, the query string, the fragment, duplicate and trailing slashes, and any tab after the channel (e.g., "/videos") are dropped, and handles and custom names are lowercased, because YouTube treats them case-insensitively. Channel IDs are kept as-is, because they are case-sensitive. Other links are reduced to their lowercased host and path.
+ *
+ * @param link YouTube Channel's link (e.g., "https://m.youtube.com/@Noriyaro/videos?view=0").
+ *
+ * @return Canonical key (e.g., "youtube.com/@noriyaro"), or an empty string if the link has no host.
+ */
+[[nodiscard]] std::string get_channel_key(const std::string_view link);
+
+}  // namespace core::url
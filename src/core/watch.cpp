@@ -0,0 +1,158 @@
+/**
+ * @file watch.cpp
+ */
+
+#include <cstddef>           // for std::size_t
+#include <cstdint>           // for std::uintmax_t
+#include <filesystem>        // for std::filesystem
+#include <initializer_list>  // for std::initializer_list
+#include <limits>            // for std::numeric_limits
+#include <optional>          // for std::optional, std::nullopt
+#include <string_view>       // for std::string_view
+#include <system_error>      // for std::error_code
+#if defined(__linux__)
+#include <cerrno>            // for errno, EINTR
+#include <cstring>           // for std::memcpy
+#include <sys/inotify.h>     // for inotify_init1, inotify_add_watch, struct inotify_event, IN_*
+#include <sys/types.h>       // for ssize_t
+#include <unistd.h>          // for read, close
+#endif
+
+#include "snapshot.hpp"
+#include "watch.hpp"
+
+namespace core::watch {
+
+void hash_chunks(ChunkHashes &hashes,
+                 const std::string_view text,
+                 const std::size_t offset)
+{
+    // Keep the full chunks before the one that contains the offset; a short last chunk may have grown, so it is always hashed again
+    std::size_t first = offset / chunk_size;
+    for (const std::size_t limit : {hashes.size / chunk_size, text.size() / chunk_size, hashes.chunks.size()}) {
+        first = first < limit ? first : limit;
+    }
+    hashes.chunks.resize(first);
+    for (std::size_t begin = hashes.chunks.size() * chunk_size; begin < text.size(); begin += chunk_size) {
+        hashes.chunks.push_back(snapshot::hash_contents(text.substr(begin, chunk_size)));
+    }
+    hashes.size = text.size();
+}
+
+std::optional<Change> find_change(const ChunkHashes &hashes,
+                                  const std::string_view text)
+{
+    const std::size_t old_size = hashes.size;
+    const std::size_t new_size = text.size();
+
+    // Skip the chunks that are unchanged from the start
+    std::size_t begin = 0;
+    std::size_t chunk = 0;
+    for (; chunk < hashes.chunks.size(); ++chunk) {
+        const std::size_t length = old_size - begin < chunk_size ? old_size - begin : chunk_size;
+        if (length > new_size - begin || snapshot::hash_contents(text.substr(begin, length)) != hashes.chunks[chunk]) {
+            break;
+        }
+        begin += length;
+    }
+    if (begin == old_size && old_size == new_size) {
+        return std::nullopt;
+    }
+
+    // Skip the chunks that are unchanged from the end; bytes after an insertion or deletion moved by the change in size, so each old chunk is compared with the new bytes at the same distance from the end
+    std::size_t old_end = old_size;
+    std::size_t new_end = new_size;
+    for (std::size_t next = hashes.chunks.size(); next > chunk; --next) {
+        const std::size_t length = old_end - (next - 1) * chunk_size;
+        if (new_end - begin < length || snapshot::hash_contents(text.substr(new_end - length, length)) != hashes.chunks[next - 1]) {
+            break;
+        }
+        old_end -= length;
+        new_end -= length;
+    }
+    return Change{begin, old_end, new_end};
+}
+
+FileWatcher::FileWatcher(const std::filesystem::path &path)
+    : path_(path),
+      filename_(path.filename().string())
+{
+    static_cast<void>(this->update_state());
+#if defined(__linux__)
+    // Watch the directory rather than the file, because a file that is replaced by a rename is a different file
+    const int descriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (descriptor == -1) {
+        return;
+    }
+    const std::filesystem::path directory = path.has_parent_path() ? path.parent_path() : std::filesystem::path(".");
+    if (inotify_add_watch(descriptor, directory.c_str(), IN_MODIFY | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO) == -1) {
+        close(descriptor);
+        return;
+    }
+    this->descriptor_ = descriptor;
+#endif
+}
+
+FileWatcher::~FileWatcher()
+{
+#if defined(__linux__)
+    if (this->descriptor_ != -1) {
+        close(this->descriptor_);
+    }
+#endif
+}
+
+bool FileWatcher::poll()
+{
+#if defined(__linux__)
+    if (this->descriptor_ != -1) {
+        // Drain every queued event, looking for the ones about the file
+        bool changed = false;
+        alignas(struct inotify_event) char buffer[4096];
+        while (true) {
+            const ssize_t length = read(this->descriptor_, buffer, sizeof(buffer));
+            if (length == -1 && errno == EINTR) {
+                continue;
+            }
+            if (length <= 0) {
+                break;
+            }
+            for (std::size_t offset = 0; offset + sizeof(struct inotify_event) <= static_cast<std::size_t>(length);) {
+                struct inotify_event event;
+                std::memcpy(&event, buffer + offset, sizeof(event));
+                // If the queue overflowed, events were lost, so assume the worst
+                if ((event.mask & IN_Q_OVERFLOW) != 0 || (event.len > 0 && this->filename_ == buffer + offset + sizeof(event))) {
+                    changed = true;
+                }
+                offset += sizeof(event) + event.len;
+            }
+        }
+        return changed;
+    }
+#endif
+    return this->update_state();
+}
+
+bool FileWatcher::is_notified() const
+{
+    return this->descriptor_ != -1;
+}
+
+bool FileWatcher::update_state()
+{
+    std::error_code ec;
+    std::uintmax_t size = std::filesystem::file_size(this->path_, ec);
+    if (ec) {
+        size = std::numeric_limits<std::uintmax_t>::max();
+    }
+    std::filesystem::file_time_type time = std::filesystem::last_write_time(this->path_, ec);
+    if (ec) {
+        time = std::filesystem::file_time_type();
+    }
+    const bool changed = size != this->size_ || time != this->time_;
+    this->size_ = size;
+    this->time_ = time;
+    return changed;
+}
+
+}  // namespace core::watch
@@ -0,0 +1,163 @@
+/**
+ * @file watch.hpp
+ *
+ * @brief Watch files for changes made by other programs, and find which part of a file changed.
+ */
+
+#pragma once
+
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint64_t, std::uintmax_t
+#include <filesystem>   // for std::filesystem
+#include <optional>     // for std::optional
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+#include <vector>       // for std::vector
+
+namespace core::watch {
+
+/**
+ * @brief Size of the chunks that files are hashed in, in bytes (64 KiB).
+ */
+inline constexpr std::size_t chunk_size = 64 * 1024;
+
+/**
+ * @brief Struct that represents the contents of a file as the hashes of its fixed-size chunks.
+ *
+ * @note This struct is marked as `final` to prevent inheritance.
+ */
+struct ChunkHashes final {
+    /**
+     * @brief Size of the file in bytes (e.g., "150000").
+     */
+    std::size_t size = 0;
+
+    /**
+     * @brief Hash of each chunk of "chunk_size" bytes, from the start of the file; the last chunk may be shorter.
+     */
+    std::vector<std::uint64_t> chunks;
+};
+
+/**
+ * @brief Struct that represents the single range of bytes that differs between two versions of a file. The bytes before it are identical, and so are the bytes after it.
+ *
+ * @note This struct is marked as `final` to prevent inheritance.
+ */
+struct Change final {
+    /**
+     * @brief Offset of the first byte that may differ, the same in both versions (e.g., "65536").
+     */
+    std::size_t begin = 0;
+
+    /**
+     * @brief Offset one past the last byte that may differ, in the old version (e.g., "131072").
+     */
+    std::size_t old_end = 0;
+
+    /**
+     * @brief Offset one past the last byte that may differ, in the new version (e.g., "131100").
+     */
+    std::size_t new_end = 0;
+};
+
+/**
+ * @brief Hash the chunks of a file, from the chunk that contains an offset to the end, keeping the hashes of the earlier chunks.
+ *
+ * After a write that only changed a file from some offset onwards (e.g., a few rows patched in by another program), only the chunks from that offset need to be hashed again.
+ *
+ * @param hashes Hashes to update, whose "size" is set to the size of the text.
+ * @param text Contents of the file.
+ * @param offset Offset of the first byte that changed since the hashes were taken (default: "0", to hash everything).
+ */
+void hash_chunks(ChunkHashes &hashes,
+                 const std::string_view text,
+                 const std::size_t offset = 0);
+
+/**
+ * @brief Find the range of bytes in which a file differs from an older version of it.
+ *
+ * Chunks are compared from the start of the file to find the bytes that did not change before the edit, and the old chunks are compared with the new bytes shifted by the change in size to find the bytes that did not change after it. Several edits far apart are reported as one range that spans all of them.
+ *
+ * @param hashes Hashes of the older version (see "hash_chunks").
+ * @param text Contents of the new version.
+ *
+ * @return Range that differs, or std::nullopt if the contents are unchanged.
+ */
+[[nodiscard]] std::optional<Change> find_change(const ChunkHashes &hashes,
+                                                const std::string_view text);
+
+/**
+ * @brief Class that tells whether a file was changed since it was last checked.
+ *
+ * On GNU/Linux, the directory of the file is watched with inotify, so that checking costs a single non-blocking read, and a file that is replaced by renaming another one over it (as editors and "core::io::save" do) is still noticed. Elsewhere, or if inotify is unavailable, the size and modification time of the file are compared instead, which may miss an edit that keeps the size within the resolution of the file system's clock.
+ *
+ * Changes made by this program are reported too. Call "poll" right after writing the file to forget them.
+ *
+ * @note This class is marked as `final` to prevent inheritance.
+ */
+class FileWatcher final {
+  public:
+    /**
+     * @brief Construct a new FileWatcher object, and start watching.
+     *
+     * @param path Path to the file to watch (e.g., "~/subscriptions.html"). The file does not need to exist.
+     */
+    explicit FileWatcher(const std::filesystem::path &path);
+
+    /**
+     * @brief Destroy the FileWatcher object, and stop watching.
+     */
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher &) = delete;
+    FileWatcher &operator=(const FileWatcher &) = delete;
+
+    /**
+     * @brief Check if the file was changed (e.g., written, replaced, or deleted) since the watcher was created or last polled.
+     *
+     * @return True if the file may have changed, false otherwise.
+     */
+    [[nodiscard]] bool poll();
+
+    /**
+     * @brief Check if the watcher is notified by the operating system, rather than by comparing the size and modification time.
+     *
+     * @return True if inotify is used, false otherwise.
+     */
+    [[nodiscard]] bool is_notified() const;
+
+  private:
+    /**
+     * @brief Path to the watched file.
+     */
+    const std::filesystem::path path_;
+
+    /**
+     * @brief Name of the watched file in its directory, which inotify reports with each event.
+     */
+    const std::string filename_;
+
+    /**
+     * @brief Inotify instance, or "-1" if the size and modification time are compared instead.
+     */
+    int descriptor_ = -1;
+
+    /**
+     * @brief Size of the file when it was last polled, or the largest value if it did not exist.
+     */
+    std::uintmax_t size_ = 0;
+
+    /**
+     * @brief Modification time of the file when it was last polled.
+     */
+    std::filesystem::file_time_type time_;
+
+    /**
+     * @brief Remember the size and modification time of the file.
+     *
+     * @return True if they differ from the ones remembered before, false otherwise.
+     */
+    bool update_state();
+};
+
+}  // namespace core::watch
@@ -20,7 +20,7 @@
  * @param argc Number of command-line arguments (e.g., "2").
  * @param argv Array of command-line arguments (e.g., {"./bin", "-h"}).
  *
- * @return EXIT_SUCCESS if the application ran successfully, EXIT_FAILURE otherwise.
+ * @return EXIT_SUCCESS if the application ran successfully, otherwise one of the non-zero "app::ExitCode" values (e.g., EXIT_FAILURE on errors).
  */
 int main(int argc,
          char **argv)
@@ -30,17 +30,22 @@ int main(int argc,
     SetConsoleOutputCP(CP_UTF8);
 #endif
     try {
-        // Parse command-line arguments, but do not pass them, as this class only checks for "--help" or "--version"
-        core::args::Args(argc, argv);
+        // Parse command-line arguments
+        const core::args::Args args(argc, argv);
 
-        // Run the application
-        app::run();
+        // Run the application, which selects the exit code (e.g., if a channel was not found)
+        return static_cast<int>(app::run(args));
     }
     catch (const core::args::ArgsMessage &e) {
         // User requested help or version
         fmt::print("{}\n", e.what());
         return EXIT_SUCCESS;
     }
+    catch (const core::args::ArgsError &e) {
+        // Invalid arguments get their own exit code, so that scripts can tell them apart from runtime errors
+        fmt::print(stderr, "{}\n", e.what());
+        return static_cast<int>(app::ExitCode::Usage);
+    }
     catch (const std::exception &e) {
         fmt::print(stderr, "{}\n", e.what());
         return EXIT_FAILURE;
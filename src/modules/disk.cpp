@@ -2,55 +2,406 @@
  * @file disk.cpp
  */
 
-#include <algorithm>   // for std::find_if
-#include <filesystem>  // for std::filesystem
-#include <stdexcept>   // for std::runtime_error
-#include <string>      // for std::string
-#include <vector>      // for std::vector
+#include <algorithm>      // for std::all_of, std::any_of, std::partition_point
+#include <array>          // for std::array
+#include <cstddef>        // for std::size_t, std::ptrdiff_t
+#include <filesystem>     // for std::filesystem
+#include <memory>         // for std::unique_ptr
+#include <optional>       // for std::optional
+#include <stdexcept>      // for std::runtime_error
+#include <string>         // for std::string
+#include <string_view>    // for std::string_view
+#include <system_error>   // for std::error_code
+#include <unordered_map>  // for std::unordered_map
+#include <utility>        // for std::move
+#include <vector>         // for std::vector
 
+#include <fmt/core.h>
+
+#include "core/backup.hpp"
 #include "core/io.hpp"
+#include "core/journal.hpp"
+#include "core/search.hpp"
+#include "core/shard.hpp"
+#include "core/snapshot.hpp"
+#include "core/store.hpp"
+#include "core/url.hpp"
+#include "core/watch.hpp"
 #include "disk.hpp"
 
 namespace modules::disk {
 
-Table::Table(const std::filesystem::path &filepath)
-    : filepath_(filepath)
+Table::Batch::Batch(Table &table)
+    : table_(table),
+      committed_(false)
+{
+    this->table_.begin_batch();
+}
+
+Table::Batch::~Batch()
 {
+    if (this->committed_) {
+        return;
+    }
     try {
+        this->commit();
+    }
+    catch (...) {
+        // The table stays dirty, so the next flush will retry
+    }
+}
 
-        // Load the HTML table from disk
-        // This will backup the file before loading, so we can safely overwrite if we want to
-        this->channels_ = core::io::load(this->filepath_);
+void Table::Batch::commit()
+{
+    if (this->committed_) {
+        return;
     }
-    catch (const std::runtime_error &) {
-        // If file doesn't exist or other error occurred, write an empty table to disk
-        core::io::save(this->filepath_, this->channels_);
+    // Mark as committed first, so a failed write is not retried by the destructor
+    this->committed_ = true;
+    this->table_.commit();
+}
+
+Table::Table(const std::filesystem::path &filepath,
+             const core::io::Durability durability)
+    : filepath_(filepath),
+      durability_(durability),
+      journal_(filepath, durability)
+{
+    this->load(true);
+}
+
+Table::~Table()
+{
+    // Only a file that matches the channels and the layout can be snapshotted
+    if (!this->snapshot_stale_ || this->dirty_ || !this->is_layout_current()) {
+        return;
+    }
+    try {
+        core::snapshot::save(this->filepath_, this->channels_, *this->layout_);
+    }
+    catch (...) {
+        // The next load falls back to the HTML file
     }
 }
 
-void Table::add(const core::io::Channel &channel)
+bool Table::add(const core::io::Channel &channel)
 {
-    this->channels_.emplace_back(channel);
-    // Save to disk
-    this->save();
+    // Start from the file as it is now, so that changes made by other programs are not overwritten
+    this->refresh();
+
+    // Reject the same channel under a different spelling of its link
+    if (this->contains_link(channel.link)) {
+        return false;
+    }
+
+    // The store inserts at the sorted position, so the table never needs to be re-sorted
+    static_cast<void>(this->channels_.insert(channel.name, channel.link, channel.description));
+    this->mark_shard_stale(channel.name);
+    this->track_link(channel.link);
+    if (this->index_) {
+        this->index_->insert(channel.name, channel.link, channel.description);
+    }
+
+    // Only journal the change and remember that the file is stale; the file is rewritten by the next compaction
+    this->journal_.append(core::journal::Operation::Add, channel.name, channel.link, channel.description);
+    this->mark_dirty();
+    this->end_edit();
+    return true;
+}
+
+std::vector<bool> Table::add(const std::vector<core::io::Channel> &channels)
+{
+    this->refresh();
+
+    // Reject known links and repeats within the input, computing each canonical link only once
+    std::vector<bool> added(channels.size(), false);
+    std::vector<core::store::ChannelView> views;
+    views.reserve(channels.size());
+    for (std::size_t i = 0; i < channels.size(); ++i) {
+        const core::io::Channel &channel = channels[i];
+        std::string key = core::url::get_channel_key(channel.link);
+        if (!key.empty() && !this->keys_.emplace(std::move(key), 1).second) {
+            continue;
+        }
+        views.push_back(core::store::ChannelView{channel.name, channel.link, channel.description});
+        added[i] = true;
+    }
+    if (views.empty()) {
+        return added;
+    }
+
+    // Merge all channels into the sorted order at once
+    static_cast<void>(this->channels_.insert(views));
+    for (const core::store::ChannelView &channel : views) {
+        this->mark_shard_stale(channel.name);
+        if (this->index_) {
+            this->index_->insert(channel.name, channel.link, channel.description);
+        }
+    }
+
+    // Many rows may be new, so rewrite the whole file once instead of splicing each one
+    if (this->batch_depth_ > 0) {
+        for (const core::store::ChannelView &channel : views) {
+            this->journal_.append(core::journal::Operation::Add, channel.name, channel.link, channel.description);
+        }
+        this->mark_dirty();
+    }
+    else {
+        this->save();
+    }
+    return added;
 }
 
 bool Table::remove(const std::string &name)
 {
-    // Find the channel by name
-    const auto it = std::find_if(this->channels_.cbegin(), this->channels_.cend(),
-                                 [&name](const core::io::Channel &channel) {
-                                     return channel.name == name;
-                                 });
+    this->refresh();
+
+    // Find the channel by name; unknown names are rejected by the hash index without a search
+    const std::optional<std::size_t> found = this->channels_.find(name);
+    if (!found) {
+        return false;
+    }
+    const std::size_t index = *found;
+    this->untrack_link(this->channels_.link(index));
+    // Remove the same channel from the search index before its link goes away with it
+    if (this->index_) {
+        static_cast<void>(this->index_->erase(name, this->channels_.link(index)));
+    }
+    this->row_cache_.erase(this->channels_.slot(index));
+    this->channels_.erase(index);
+    this->mark_shard_stale(name);
+
+    // Only journal the change and remember that the file is stale; the file is rewritten by the next compaction
+    this->journal_.append(core::journal::Operation::Remove, name);
+    this->mark_dirty();
+    this->end_edit();
+    return true;
+}
+
+bool Table::contains(const std::string &name) const
+{
+    return this->channels_.contains(name);
+}
+
+bool Table::contains_link(const std::string &link) const
+{
+    const std::string key = core::url::get_channel_key(link);
+    // Links without a host have no identity, so they never count as duplicates
+    return !key.empty() && this->keys_.find(key) != this->keys_.end();
+}
+
+std::size_t Table::dedupe()
+{
+    this->refresh();
+
+    // Duplicates only exist if some canonical link is counted more than once
+    if (this->keys_.empty() || std::all_of(this->keys_.cbegin(), this->keys_.cend(), [](const auto &entry) { return entry.second == 1; })) {
+        return 0;
+    }
+
+    // Copy the first channel of each canonical link into a new store, which appends in O(1) because the input is sorted
+    core::store::ChannelStore unique;
+    unique.reserve(this->channels_.size());
+    std::unordered_map<std::string, std::size_t> keys;
+    keys.reserve(this->keys_.size());
+    for (const core::store::ChannelView channel : this->channels_) {
+        std::string key = core::url::get_channel_key(channel.link);
+        if (!key.empty() && !keys.emplace(std::move(key), 1).second) {
+            continue;
+        }
+        unique.insert(channel.name, channel.link, channel.description);
+    }
+    const std::size_t removed = this->channels_.size() - unique.size();
+    this->channels_ = std::move(unique);
+    this->keys_ = std::move(keys);
+    // Many channels may be gone, so the search index is rebuilt by the next search, and every row is rendered again by the next save
+    this->index_.reset();
+    this->row_cache_.reset();
+    for (ShardFile &file : this->shards_) {
+        file.stale = true;
+    }
+
+    // Many rows may be gone, so rewrite the whole file once instead of splicing each one
+    if (this->batch_depth_ > 0) {
+        this->journal_.append(core::journal::Operation::Dedupe, "");
+        this->mark_dirty();
+    }
+    else {
+        this->save();
+    }
+    return removed;
+}
+
+std::vector<core::search::Match> Table::find(const std::string_view query,
+                                             const std::size_t limit)
+{
+    // Build the index on the first search, so that tables that are never searched don't pay for it
+    if (!this->index_) {
+        core::search::TrigramIndex index;
+        index.reserve(this->channels_.size());
+        for (const core::store::ChannelView channel : this->channels_) {
+            index.insert(channel.name, channel.link, channel.description);
+        }
+        this->index_ = std::move(index);
+    }
+    return this->index_->find(query, limit);
+}
 
-    // If the channel is found, remove it, and save to disk
-    if (it != this->channels_.cend()) {
-        this->channels_.erase(it);
+void Table::watch()
+{
+    if (this->watcher_) {
+        return;
+    }
+    this->watcher_.emplace(this->filepath_);
+    this->remember_file_state();
+}
+
+bool Table::refresh()
+{
+    // Without a watcher, the table assumes that it is the only writer; while reloading, the file is read already
+    if (!this->watcher_ || this->refreshing_) {
+        return false;
+    }
+    // Remember the change until it is picked up, so that a malformed file keeps failing instead of being overwritten
+    if (this->watcher_->poll()) {
+        this->file_changed_ = true;
+    }
+    // Only the index page is watched, so the shard files are checked by their size and modification time
+    if (this->sharded_ && this->is_shard_changed()) {
+        this->file_changed_ = true;
+    }
+    // A deleted file has nothing to pick up; the next write creates it again
+    if (!this->file_changed_ || !std::filesystem::exists(this->filepath_)) {
+        return false;
+    }
+
+    this->refreshing_ = true;
+    bool changed = true;
+    try {
+        // The mapping is released before reloading, which may write the file; shard files are never patched, because any of them may have changed
+        bool must_reload = this->sharded_;
+        if (!must_reload) {
+            const core::io::MappedFile file(this->filepath_);
+            const std::string_view text = file.view();
+            const std::optional<core::watch::Change> change = core::watch::find_change(this->hashes_, text);
+            // Only the metadata changed (e.g., the file was touched), so there is nothing to parse
+            if (!change) {
+                this->remember_file_state(text.size());
+                changed = false;
+            }
+            // Pending changes are not in the layout, so only a clean table can be patched
+            else {
+                must_reload = this->dirty_ || !this->layout_ || !this->patch(text, *change);
+            }
+        }
+        if (must_reload) {
+            this->reload();
+        }
+    }
+    catch (...) {
+        this->refreshing_ = false;
+        throw;
+    }
+    this->refreshing_ = false;
+    this->file_changed_ = false;
+    return changed;
+}
+
+void Table::begin_batch()
+{
+    ++this->batch_depth_;
+}
+
+void Table::commit()
+{
+    if (this->batch_depth_ > 0) {
+        --this->batch_depth_;
+    }
+    // Rewrite the file when the outermost batch ends, or when replaying the journal would take too long
+    if (this->batch_depth_ == 0 || this->journal_.size() > journal_compaction_threshold) {
+        this->flush();
+        return;
+    }
+
+    // Otherwise, make the changes durable with a single append to the journal
+    this->journal_.sync();
+}
+
+void Table::flush()
+{
+    // Changes made by other programs are merged before the file is rewritten
+    this->refresh();
+
+    // Pending changes only reached the journal, so the whole file has to be rewritten
+    if (this->dirty_) {
         this->save();
-        return true;
     }
+}
 
-    return false;
+core::backup::Generation Table::restore(const std::size_t number)
+{
+    // Each shard file has its own backups, taken at different times, so there is no single backup of the whole table to restore
+    if (this->sharded_) {
+        throw std::runtime_error(fmt::format("Failed to restore file '{}': backups of a sharded table are kept per shard file", this->filepath_.string()));
+    }
+
+    // Pending changes are written first, so that they are backed up along with the rest of the file
+    this->flush();
+    const core::backup::Generation generation = core::backup::restore(this->filepath_, number, this->durability_);
+
+    // Reload the restored file; it is a backup already, so it is not backed up again
+    this->channels_.clear();
+    this->keys_.clear();
+    this->index_.reset();
+    this->row_cache_.reset();
+    this->layout_.reset();
+    this->dirty_ = false;
+    this->snapshot_stale_ = false;
+    this->load(false);
+    return generation;
+}
+
+bool Table::is_dirty() const
+{
+    return this->dirty_;
+}
+
+void Table::set_sharded(const bool sharded)
+{
+    // Pending changes are written in the current layout first, so the switch starts from a clean table
+    this->flush();
+    if (sharded == this->sharded_) {
+        return;
+    }
+
+    if (sharded) {
+        // Write every shard file first, then replace the table with the index page
+        this->sharded_ = true;
+        this->shards_.fill(ShardFile{false, true, 0, {}});
+        this->layout_.reset();
+        this->save_shards(true);
+
+        // The snapshot belongs to the single file, which is gone
+        std::error_code ec;
+        std::filesystem::remove(core::snapshot::get_path(this->filepath_), ec);
+        return;
+    }
+
+    // Write the whole table first, then delete the shard files, which the file no longer links to
+    this->sharded_ = false;
+    this->save();
+    for (std::size_t shard = 0; shard < this->shards_.size(); ++shard) {
+        if (this->shards_[shard].exists) {
+            std::error_code ec;
+            std::filesystem::remove(core::shard::get_path(this->filepath_, shard), ec);
+        }
+    }
+    this->shards_.fill(ShardFile{});
+}
+
+bool Table::is_sharded() const
+{
+    return this->sharded_;
 }
 
 const std::filesystem::path &Table::get_filepath() const
@@ -58,7 +409,7 @@ const std::filesystem::path &Table::get_filepath() const
     return this->filepath_;
 }
 
-const std::vector<core::io::Channel> &Table::get_channels() const
+const core::store::ChannelStore &Table::get_channels() const
 {
     return this->channels_;
 }
@@ -66,7 +417,426 @@ const std::vector<core::io::Channel> &Table::get_channels() const
 void Table::save()
 {
     // Write current state to disk
-    core::io::save(this->filepath_, this->channels_);
+    if (this->sharded_) {
+        this->save_shards(false);
+    }
+    else {
+        try {
+            this->layout_ = core::io::save(this->filepath_, this->channels_, this->row_cache_, this->durability_);
+        }
+        catch (const core::io::SyncError &) {
+            // The file holds the channels, but its replacement may not survive a power loss, so the journal is synced and kept for the next load to replay
+            this->layout_.reset();
+            this->remember_file_state();
+            this->dirty_ = false;
+            this->journal_.sync();
+            return;
+        }
+        this->remember_file_state();
+        this->snapshot_stale_ = true;
+    }
+    this->dirty_ = false;
+
+    // The file holds every journaled change now
+    this->journal_.clear();
+}
+
+void Table::save_shards(const bool write_index)
+{
+    // Gather the channels of the stale shards in a single pass; the files of the other shards are left alone
+    std::array<std::vector<core::store::ChannelView>, core::shard::count> channels;
+    if (std::any_of(this->shards_.cbegin(), this->shards_.cend(), [](const ShardFile &file) { return file.stale; })) {
+        for (const core::store::ChannelView channel : this->channels_) {
+            const std::size_t shard = core::shard::get_shard(channel.name);
+            if (this->shards_[shard].stale) {
+                channels[shard].push_back(channel);
+            }
+        }
+    }
+
+    // Write the shards that have channels before the index page links to them
+    bool listed_changed = write_index;
+    std::vector<std::size_t> emptied;
+    for (std::size_t shard = 0; shard < this->shards_.size(); ++shard) {
+        ShardFile &file = this->shards_[shard];
+        if (!file.stale) {
+            continue;
+        }
+        const std::filesystem::path path = core::shard::get_path(this->filepath_, shard);
+        if (channels[shard].empty()) {
+            if (file.exists) {
+                emptied.push_back(shard);
+                listed_changed = true;
+            }
+            file = ShardFile{};
+            continue;
+        }
+        static_cast<void>(core::io::save(path, channels[shard], this->durability_));
+        listed_changed = listed_changed || !file.exists;
+        file = ShardFile{true, false, std::filesystem::file_size(path), std::filesystem::last_write_time(path)};
+    }
+
+    // The index page only changes when a shard file is created or emptied, and emptied files are deleted once it no longer links to them
+    if (listed_changed) {
+        std::vector<std::size_t> listed;
+        for (std::size_t shard = 0; shard < this->shards_.size(); ++shard) {
+            if (this->shards_[shard].exists) {
+                listed.push_back(shard);
+            }
+        }
+        core::io::write_file(this->filepath_, core::shard::render_index(this->filepath_, listed), this->durability_);
+        for (const std::size_t shard : emptied) {
+            std::error_code ec;
+            std::filesystem::remove(core::shard::get_path(this->filepath_, shard), ec);
+        }
+    }
+    this->remember_file_state();
+}
+
+void Table::load(const bool create_backup)
+{
+    // If the file doesn't exist, write an empty table to disk, with any changes journaled against a table that was deleted since
+    if (!std::filesystem::exists(this->filepath_)) {
+        this->replay_journal();
+        if (!this->layout_) {
+            this->save();
+        }
+        return;
+    }
+
+    // An index page holds no channels itself, so load the shard files it links to instead
+    std::optional<std::vector<std::size_t>> shards;
+    {
+        const core::io::MappedFile file(this->filepath_);
+        if (core::shard::is_index(file.view())) {
+            try {
+                shards = core::shard::read_index(file.view());
+            }
+            catch (const std::runtime_error &e) {
+                throw std::runtime_error(fmt::format("Failed to load file '{}': {}", this->filepath_.string(), e.what()));
+            }
+        }
+    }
+    if (shards) {
+        this->load_shards(*shards, create_backup);
+        return;
+    }
+
+    // Prefer the snapshot, which is already sorted and needs no parsing; any problem with it (e.g., missing or stale) falls back to the HTML
+    std::optional<core::snapshot::MappedSnapshot> snapshot;
+    try {
+        snapshot.emplace(this->filepath_);
+    }
+    catch (const std::runtime_error &) {
+    }
+    if (snapshot) {
+        // Backup like the HTML loader does, so we can safely overwrite if we want to
+        if (create_backup) {
+            static_cast<void>(core::backup::create(this->filepath_));
+        }
+        this->channels_.reserve(snapshot->size());
+        this->keys_.reserve(snapshot->size());
+        for (std::size_t i = 0; i < snapshot->size(); ++i) {
+            this->channels_.insert(snapshot->name(i), snapshot->link(i), snapshot->description(i));
+            // The canonical keys are stored in the snapshot, so the links need not be parsed again
+            if (const std::string_view key = snapshot->key(i); !key.empty()) {
+                ++this->keys_[std::string(key)];
+            }
+        }
+        this->row_cache_.reset();
+        this->layout_ = snapshot->get_layout();
+        this->remember_file_state();
+        this->replay_journal();
+        return;
+    }
+
+    // Load the HTML table from disk
+    // This will backup the file before loading, so we can safely overwrite if we want to
+    // Errors (e.g., a malformed row) are not swallowed, because writing an empty table would destroy the user's data
+    // The mapped loader hands out views, so each field is copied exactly once, straight into the store
+    const core::io::MappedChannels mapped(this->filepath_, create_backup);
+    this->channels_.reserve(mapped.size());
+    this->keys_.reserve(mapped.size());
+    for (std::size_t i = 0; i < mapped.size(); ++i) {
+        this->channels_.insert(mapped.name(i), mapped.link(i), mapped.description(i));
+        this->track_link(mapped.link(i));
+    }
+
+    // Remember where the rows are, so that edits made by other programs can be patched in; the rows are rendered by the first rewrite
+    this->row_cache_.reset();
+    this->layout_ = mapped.get_layout();
+    this->remember_file_state();
+    this->snapshot_stale_ = true;
+    this->replay_journal();
+}
+
+void Table::load_shards(const std::vector<std::size_t> &shards,
+                        const bool create_backup)
+{
+    // Each shard is sorted on its own, but shards interleave in sorted order (e.g., "Zed" sorts before "apple"), so the channels are merged into the store at once
+    const std::vector<std::unique_ptr<core::io::MappedChannels>> loaded = core::shard::load(this->filepath_, shards, create_backup);
+    std::size_t count = 0;
+    for (const std::unique_ptr<core::io::MappedChannels> &mapped : loaded) {
+        count += mapped->size();
+    }
+    std::vector<core::store::ChannelView> views;
+    views.reserve(count);
+    for (const std::unique_ptr<core::io::MappedChannels> &mapped : loaded) {
+        for (std::size_t i = 0; i < mapped->size(); ++i) {
+            views.push_back(core::store::ChannelView{mapped->name(i), mapped->link(i), mapped->description(i)});
+        }
+    }
+    this->channels_.reserve(count);
+    static_cast<void>(this->channels_.insert(views));
+    this->keys_.reserve(count);
+    for (const core::store::ChannelView &channel : views) {
+        this->track_link(channel.link);
+    }
+
+    // Remember the state of each shard file, so that changes made by other programs are noticed
+    this->sharded_ = true;
+    this->shards_.fill(ShardFile{});
+    for (const std::size_t shard : shards) {
+        const std::filesystem::path path = core::shard::get_path(this->filepath_, shard);
+        this->shards_[shard] = ShardFile{true, false, std::filesystem::file_size(path), std::filesystem::last_write_time(path)};
+    }
+    this->row_cache_.reset();
+    this->remember_file_state();
+    this->replay_journal();
+}
+
+void Table::replay_journal()
+{
+    // Apply the changes as a batch, so the file is rewritten once at the end
+    ++this->batch_depth_;
+    const std::size_t replayed = core::journal::replay(this->filepath_, [this](const core::journal::Entry &entry) {
+        switch (entry.operation) {
+        case core::journal::Operation::Add:
+            static_cast<void>(this->add(core::io::Channel(std::string(entry.name), std::string(entry.link), std::string(entry.description))));
+            break;
+        case core::journal::Operation::Remove:
+            static_cast<void>(this->remove(std::string(entry.name)));
+            break;
+        case core::journal::Operation::Dedupe:
+            static_cast<void>(this->dedupe());
+            break;
+        }
+    });
+    --this->batch_depth_;
+
+    // Rewriting the file clears the journal; an empty or torn journal is simply removed
+    if (replayed > 0) {
+        this->save();
+    }
+    else {
+        this->journal_.clear();
+    }
+}
+
+bool Table::patch(const std::string_view text,
+                  const core::watch::Change &change)
+{
+    // Patching swaps rows one at a time, so a change to most of the file is cheaper to load from scratch
+    if (change.old_end - change.begin > text.size() / 2) {
+        return false;
+    }
+
+    // Rows that end before the change or start after it are unchanged; the ones in between are parsed again, from the end of the last unchanged row to the start of the next one
+    std::vector<core::io::ByteRange> &rows = this->layout_->rows;
+    const auto first = std::partition_point(rows.begin(), rows.end(), [&change](const core::io::ByteRange &row) {
+        return row.end <= change.begin;
+    });
+    const auto last = std::partition_point(first, rows.end(), [&change](const core::io::ByteRange &row) {
+        return row.begin < change.old_end;
+    });
+    const std::size_t begin = first == rows.begin() ? 0 : (first - 1)->end;
+    const std::size_t end = last == rows.end() ? std::string_view::npos : last->begin - change.old_end + change.new_end;
+    std::vector<core::io::ByteRange> ranges;
+    std::vector<core::io::Channel> channels;
+    try {
+        channels = core::io::scan_rows(text, begin, end, ranges);
+    }
+    catch (const std::runtime_error &e) {
+        throw std::runtime_error(fmt::format("Failed to reload file '{}': {}", this->filepath_.string(), e.what()));
+    }
+    // A new row that runs into the unchanged rows cannot be swapped in
+    if (!ranges.empty() && end != std::string_view::npos && ranges.back().end > end) {
+        return false;
+    }
+
+    // Swap the channels of the old rows for the channels of the new ones
+    const auto index_first = static_cast<std::size_t>(first - rows.begin());
+    const auto index_last = static_cast<std::size_t>(last - rows.begin());
+    for (std::size_t index = index_last; index > index_first; --index) {
+        this->untrack_link(this->channels_.link(index - 1));
+        if (this->index_) {
+            static_cast<void>(this->index_->erase(this->channels_.name(index - 1), this->channels_.link(index - 1)));
+        }
+        this->row_cache_.erase(this->channels_.slot(index - 1));
+        this->channels_.erase(index - 1);
+    }
+    bool in_order = true;
+    for (std::size_t i = 0; i < channels.size(); ++i) {
+        const core::io::Channel &channel = channels[i];
+        const std::size_t index = this->channels_.insert(channel.name, channel.link, channel.description);
+        in_order = index == index_first + i && in_order;
+        this->track_link(channel.link);
+        if (this->index_) {
+            this->index_->insert(channel.name, channel.link, channel.description);
+        }
+    }
+
+    // The layout stays valid if the new rows landed where they are in the file; otherwise, the next write rewrites the whole file in sorted order
+    if (in_order) {
+        rows.erase(first, last);
+        for (auto it = rows.begin() + static_cast<std::ptrdiff_t>(index_first); it != rows.end(); ++it) {
+            it->begin = it->begin - change.old_end + change.new_end;
+            it->end = it->end - change.old_end + change.new_end;
+        }
+        rows.insert(rows.begin() + static_cast<std::ptrdiff_t>(index_first), ranges.begin(), ranges.end());
+    }
+    if (!in_order || rows.empty()) {
+        this->layout_.reset();
+    }
+    else {
+        this->layout_->rows_end = rows.back().end;
+    }
+    this->remember_file_state(change.begin);
+    this->snapshot_stale_ = true;
+    return true;
+}
+
+void Table::reload()
+{
+    // The pending changes are replayed from the journal, so they must be on disk first
+    this->journal_.sync();
+
+    // Keep the current state, so that a file that fails to load changes nothing
+    core::store::ChannelStore channels = std::move(this->channels_);
+    std::unordered_map<std::string, std::size_t> keys = std::move(this->keys_);
+    std::optional<core::search::TrigramIndex> index = std::move(this->index_);
+    core::io::RowCache row_cache = std::move(this->row_cache_);
+    std::optional<core::io::Layout> layout = std::move(this->layout_);
+    const bool dirty = this->dirty_;
+    const bool snapshot_stale = this->snapshot_stale_;
+    const bool sharded = this->sharded_;
+    const std::array<ShardFile, core::shard::count> shards = this->shards_;
+    try {
+        this->channels_.clear();
+        this->keys_.clear();
+        this->index_.reset();
+        this->row_cache_.reset();
+        this->layout_.reset();
+        this->dirty_ = false;
+        this->snapshot_stale_ = false;
+        this->sharded_ = false;
+        this->shards_.fill(ShardFile{});
+        this->load(false);
+    }
+    catch (...) {
+        this->channels_ = std::move(channels);
+        this->keys_ = std::move(keys);
+        this->index_ = std::move(index);
+        this->row_cache_ = std::move(row_cache);
+        this->layout_ = std::move(layout);
+        this->dirty_ = dirty;
+        this->snapshot_stale_ = snapshot_stale;
+        this->sharded_ = sharded;
+        this->shards_ = shards;
+        throw;
+    }
+}
+
+bool Table::is_layout_current() const
+{
+    if (!this->layout_) {
+        return false;
+    }
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(this->filepath_, ec);
+    if (ec || size != this->file_size_) {
+        return false;
+    }
+    const auto time = std::filesystem::last_write_time(this->filepath_, ec);
+    return !ec && time == this->file_time_;
+}
+
+bool Table::is_shard_changed() const
+{
+    std::error_code ec;
+    for (std::size_t shard = 0; shard < this->shards_.size(); ++shard) {
+        const ShardFile &file = this->shards_[shard];
+        if (!file.exists) {
+            continue;
+        }
+        const std::filesystem::path path = core::shard::get_path(this->filepath_, shard);
+        const auto size = std::filesystem::file_size(path, ec);
+        if (ec || size != file.size) {
+            return true;
+        }
+        const auto time = std::filesystem::last_write_time(path, ec);
+        if (ec || time != file.time) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Table::mark_shard_stale(const std::string_view name)
+{
+    if (this->sharded_) {
+        this->shards_[core::shard::get_shard(name)].stale = true;
+    }
+}
+
+void Table::remember_file_state(const std::size_t changed_from)
+{
+    this->file_size_ = std::filesystem::file_size(this->filepath_);
+    this->file_time_ = std::filesystem::last_write_time(this->filepath_);
+    if (!this->watcher_) {
+        return;
+    }
+    // The watcher reports this program's own writes too, so forget them before hashing what is on disk now
+    static_cast<void>(this->watcher_->poll());
+    const core::io::MappedFile file(this->filepath_);
+    core::watch::hash_chunks(this->hashes_, file.view(), changed_from);
+}
+
+void Table::track_link(const std::string_view link)
+{
+    std::string key = core::url::get_channel_key(link);
+    if (!key.empty()) {
+        ++this->keys_[std::move(key)];
+    }
+}
+
+void Table::untrack_link(const std::string_view link)
+{
+    const auto it = this->keys_.find(core::url::get_channel_key(link));
+    if (it != this->keys_.end() && --it->second == 0) {
+        this->keys_.erase(it);
+    }
+}
+
+void Table::end_edit()
+{
+    // A batch syncs the journal once, when it is committed
+    if (this->batch_depth_ > 0) {
+        return;
+    }
+    // Otherwise, the edit is a batch of its own, except that the file is only rewritten once replaying the journal would take too long
+    if (this->journal_.size() > journal_compaction_threshold) {
+        this->flush();
+        return;
+    }
+    this->journal_.sync();
+}
+
+void Table::mark_dirty()
+{
+    // The file no longer matches the channels, so the layout must not be used even if the batch fails to commit
+    this->dirty_ = true;
+    this->layout_.reset();
 }
 
 }  // namespace modules::disk
@@ -6,45 +6,150 @@
 
 #pragma once
 
-#include <filesystem>  // for std::filesystem
-#include <string>      // for std::string
-#include <vector>      // for std::vector
+#include <array>          // for std::array
+#include <cstddef>        // for std::size_t
+#include <cstdint>        // for std::uintmax_t
+#include <filesystem>     // for std::filesystem
+#include <optional>       // for std::optional
+#include <string>         // for std::string
+#include <string_view>    // for std::string_view
+#include <unordered_map>  // for std::unordered_map
+#include <vector>         // for std::vector
 
+#include "core/backup.hpp"
 #include "core/io.hpp"
+#include "core/journal.hpp"
+#include "core/search.hpp"
+#include "core/shard.hpp"
+#include "core/store.hpp"
+#include "core/watch.hpp"
 
 namespace modules::disk {
 
 /**
  * @brief Class that represents an HTML table.
  *
- * On construction, the class loads an HTML table from disk.
+ * On construction, the class loads an HTML table from disk. The channels are kept sorted by name.
+ *
+ * Adding or removing a channel appends a small record to a checksummed journal next to the file (see "core::journal") and syncs it, so an edit costs O(row) in I/O however large the table is. The file itself is rewritten (compacted) in one go when the journal grows past "journal_compaction_threshold", or when "flush" is called (e.g., before the file is opened in a browser). The journal is replayed on the next load, so an edit survives a crash even if the file was never rewritten. Until then, programs that read the file directly see the table as of the last compaction.
+ *
+ * Once "watch" is called, changes made to the file by other programs (e.g., a text editor, or a sync tool) are picked up before every change to the table, and by "refresh". Only the rows in the part of the file that changed are parsed again (see "core::watch::find_change"), and changes that were not written yet are replayed on top of the file, so neither side's edits are lost.
+ *
+ * Changes made during a batch are journaled too, but the journal is only synced when a batch (even a nested one) is committed, and the file is also rewritten when the outermost batch ends.
+ *
+ * The table can also be split into one file per leading letter (see "set_sharded" and "core::shard"), in which case the file is an index page that links to the shard files. Every write then rewrites only the shard files whose channels changed, and the shard files are loaded in parallel. Changes made to them by other programs are picked up by reloading the whole table.
  *
  * @note This class is marked as `final` to prevent inheritance.
  */
 class Table final {
   public:
+    /**
+     * @brief Size of the journal in bytes (1 MiB) above which an edit outside a batch, or committing a batch, rewrites the file, even in the middle of an outer batch.
+     */
+    static constexpr std::uintmax_t journal_compaction_threshold = 1024 * 1024;
+
+    /**
+     * @brief Class that represents a batch of changes to a table as a RAII object.
+     *
+     * On construction, a batch is started on the table, so that adding and removing channels only changes the table in memory and the journal. When the object goes out of scope, the batch is committed, writing the table to disk once. Batches can be nested; committing a nested batch only syncs the journal, and only the outermost one rewrites the file.
+     *
+     * @note This class is marked as `final` to prevent inheritance.
+     */
+    class Batch final {
+      public:
+        /**
+         * @brief Construct a new Batch object, starting a batch on the table.
+         *
+         * @param table Table to change (e.g., "Table("~/data.html")").
+         */
+        explicit Batch(Table &table);
+
+        /**
+         * @brief Destroy the Batch object, committing the batch if it was not committed yet.
+         *
+         * Errors are swallowed, because destructors must not throw. The table stays dirty, so a later flush will retry. Call "commit" to see errors.
+         */
+        ~Batch();
+
+        Batch(const Batch &) = delete;
+        Batch &operator=(const Batch &) = delete;
+
+        /**
+         * @brief Commit the batch, syncing the journal, and writing the table to disk if this is the outermost batch.
+         *
+         * @throws std::runtime_error If failed to write to disk.
+         */
+        void commit();
+
+      private:
+        /**
+         * @brief Table being changed.
+         */
+        Table &table_;
+
+        /**
+         * @brief Whether the batch was already committed.
+         */
+        bool committed_;
+    };
+
     /**
      * @brief Construct a new Table object.
      *
-     * The underlying parser will backup the file before loading. If the file doesn't exist, an empty table will be written to disk.
+     * The file is backed up before loading (see "core::backup::create"), unless the newest backup already has the same contents. If the file doesn't exist, an empty table will be written to disk.
+     *
+     * If the binary snapshot next to the file (see "core::snapshot") matches the file, the channels are copied from it without parsing the HTML. Otherwise (e.g., the file was edited by hand), the HTML is parsed, and the snapshot is rebuilt when the table is destroyed.
+     *
+     * If a journal was left behind (e.g., the program crashed before the file was rewritten), its changes are replayed on top of the loaded channels, and the file is rewritten. Replaying is idempotent (e.g., adding a channel that is already there does nothing), so a journal whose changes already reached the file is harmless.
      *
      * @param filepath Path to the HTML table that contains YouTube subscriptions which shall be loaded (e.g., "~/data.html").
+     * @param durability How hard to try to get every write onto stable storage (default: core::io::Durability::Full).
+     *
+     * @throws std::runtime_error If the file exists but cannot be loaded (e.g., a row is malformed), if the journal cannot be replayed, or if the empty table cannot be written.
+     */
+    explicit Table(const std::filesystem::path &filepath,
+                   const core::io::Durability durability = core::io::Durability::Full);
+
+    /**
+     * @brief Destroy the Table object, writing the snapshot of the file if it is out of date.
+     *
+     * The snapshot is refreshed once here rather than after every write, so edits only pay for the HTML file. Errors are ignored, because a missing or stale snapshot is rebuilt on the next load.
      */
-    explicit Table(const std::filesystem::path &filepath);
+    ~Table();
+
+    Table(const Table &) = delete;
+    Table &operator=(const Table &) = delete;
 
     /**
-     * @brief Add a YouTube to the table. The full channel object must be provided.
+     * @brief Add a YouTube channel to the table at its sorted position. The full channel object must be provided.
      *
-     * After adding, the table is immediately saved to disk.
+     * A channel is rejected in O(1) if the table already has a channel whose link points to the same channel, however it is spelled (see "core::url::get_channel_key").
+     *
+     * After adding, the change is synced to the journal, unless a batch is active. The file is rewritten by the next compaction.
      *
      * @param channel Channel to add (e.g., "{name: "Noriyaro", link: "https://www.youtube.com/@noriyaro/videos", description: "JP Drifting"}").
+     *
+     * @return True if succeeded, false if the channel is already in the table.
+     */
+    [[nodiscard]] bool add(const core::io::Channel &channel);
+
+    /**
+     * @brief Add many YouTube channels at once, merging them into the sorted order in a single pass.
+     *
+     * Channels are rejected like in the single-channel overload, including repeats within the given channels (the first one wins). This is much faster than adding unsorted channels one by one, because the sorted order is only rebuilt once.
+     *
+     * After adding, the whole file is rewritten once, unless a batch is active.
+     *
+     * @param channels Channels to add, in any order.
+     *
+     * @return For each channel, true if it was added, false if it was already in the table.
      */
-    void add(const core::io::Channel &channel);
+    [[nodiscard]] std::vector<bool> add(const std::vector<core::io::Channel> &channels);
 
     /**
      * @brief Remove a YouTube channel from the table by name.
      *
-     * After removing, the table is immediately saved to disk.
+     * After removing, the change is synced to the journal, unless a batch is active. The file is rewritten by the next compaction.
      *
      * @param name Name of the YouTube channel to remove (e.g., "Noriyaro").
      *
@@ -52,6 +157,129 @@ class Table final {
      */
     [[nodiscard]] bool remove(const std::string &name);
 
+    /**
+     * @brief Check if a YouTube channel with the given name is in the table. This is O(1), using the store's hash index.
+     *
+     * @param name Name of the YouTube channel (e.g., "Noriyaro").
+     *
+     * @return True if the channel exists, false otherwise.
+     */
+    [[nodiscard]] bool contains(const std::string &name) const;
+
+    /**
+     * @brief Check if the table has a channel whose link points to the same channel as the given link. This is O(1), using a hash set of canonical links.
+     *
+     * @param link YouTube Channel's link, in any spelling (e.g., "https://m.youtube.com/@Noriyaro").
+     *
+     * @return True if the channel exists, false otherwise.
+     */
+    [[nodiscard]] bool contains_link(const std::string &link) const;
+
+    /**
+     * @brief Remove every channel whose link points to the same channel as an earlier one, in a single pass over the table.
+     *
+     * The first channel (in sorted order) of each group of duplicates is kept. If anything was removed, the whole file is rewritten, unless a batch is active.
+     *
+     * @return Number of removed channels (e.g., "3").
+     */
+    std::size_t dedupe();
+
+    /**
+     * @brief Find the channels whose name or description is most similar to a query, tolerating typos (see "core::search::TrigramIndex").
+     *
+     * The search index is built on the first call, and kept up to date by every later change, so only the first search pays for it.
+     *
+     * @param query Text to search for, in any case (e.g., "noriyoro").
+     * @param limit Largest number of channels to return (e.g., "10").
+     *
+     * @return Channels that are similar enough, most similar first. The names and links are views into the index, so they are invalidated by any change to the table; together, they locate each channel in "get_channels()" (see "core::store::ChannelStore::find").
+     */
+    [[nodiscard]] std::vector<core::search::Match> find(const std::string_view query,
+                                                        const std::size_t limit);
+
+    /**
+     * @brief Start watching the file for changes made by other programs (see "core::watch::FileWatcher"). Until then, the table assumes that it is the only writer.
+     *
+     * The file is hashed in chunks, so that a later change can be narrowed down to the rows it touched.
+     *
+     * @throws std::runtime_error If the file cannot be read.
+     */
+    void watch();
+
+    /**
+     * @brief Pick up the changes made to the file by other programs since the table last read or wrote it, if the table is watching the file.
+     *
+     * If the table has no pending changes, only the rows that overlap the changed bytes are parsed again and patched into the table, the search index and the layout. Otherwise, the file is loaded again, and the pending changes are replayed from the journal on top of it, then written.
+     *
+     * This is called before every change to the table and before every write, so it only needs to be called directly to show the latest channels.
+     *
+     * @return True if the channels changed, false otherwise (e.g., the file was only touched, or nothing changed).
+     *
+     * @throws std::runtime_error If the changed file cannot be loaded (e.g., it is malformed). The table and the file are left alone, and every later change and write fails the same way until the file is fixed, so that the file is never overwritten with stale channels.
+     */
+    bool refresh();
+
+    /**
+     * @brief Start a batch. Until the matching "commit", adding and removing channels only changes the table in memory.
+     *
+     * @note Prefer the "Batch" guard, which commits automatically.
+     */
+    void begin_batch();
+
+    /**
+     * @brief End a batch started by "begin_batch", syncing the journal. When the outermost batch ends, or when the journal is larger than "journal_compaction_threshold", the table is written to disk if it changed.
+     *
+     * @throws std::runtime_error If failed to write to disk.
+     */
+    void commit();
+
+    /**
+     * @brief Write the table to disk if it has changes that are not on disk yet, even in the middle of a batch.
+     *
+     * All pending changes are written with a single full rewrite, after which the journal is cleared.
+     *
+     * @throws std::runtime_error If failed to write to disk.
+     */
+    void flush();
+
+    /**
+     * @brief Replace the file with one of its backups (see "core::backup::list"), and reload the table from it.
+     *
+     * Pending changes are written first, and the file is backed up before it is replaced, so restoring can be undone with another restore.
+     *
+     * @param number Number of the backup, starting at 1 for the newest (e.g., "2").
+     *
+     * @return Backup that was restored.
+     *
+     * @throws std::runtime_error If the table is sharded (backups are kept per shard file), there is no such backup, the backup is corrupt, or the file cannot be written or reloaded.
+     */
+    core::backup::Generation restore(const std::size_t number);
+
+    /**
+     * @brief Switch between a single file and one file per leading letter (see "core::shard").
+     *
+     * Pending changes are written first. Switching to shards writes every shard file, then replaces the file with the index page; switching back writes the whole table to the file, then deletes the shard files. Either way, a crash leaves a complete table behind.
+     *
+     * @param sharded If true, split the table into shard files, otherwise keep it in a single file.
+     *
+     * @throws std::runtime_error If failed to write to disk.
+     */
+    void set_sharded(const bool sharded);
+
+    /**
+     * @brief Check if the table is split into shard files.
+     *
+     * @return True if the file is an index page that links to shard files, false if it holds the whole table.
+     */
+    [[nodiscard]] bool is_sharded() const;
+
+    /**
+     * @brief Check if the table has changes that are not on disk yet.
+     *
+     * @return True if there are pending changes, false otherwise.
+     */
+    [[nodiscard]] bool is_dirty() const;
+
     /**
      * @brief Get the file path.
      *
@@ -62,25 +290,250 @@ class Table final {
     /**
      * @brief Get the channels.
      *
-     * @return Vector of YouTube channels.
+     * @return Store of YouTube channels, which can be iterated as views of name, link and description.
      */
-    [[nodiscard]] const std::vector<core::io::Channel> &get_channels() const;
+    [[nodiscard]] const core::store::ChannelStore &get_channels() const;
 
   private:
+    /**
+     * @brief Struct that represents the file of a shard.
+     *
+     * @note This struct is marked as `final` to prevent inheritance.
+     */
+    struct ShardFile final {
+        /**
+         * @brief Whether the file exists (i.e., the shard had channels when the table was last loaded or saved).
+         */
+        bool exists = false;
+
+        /**
+         * @brief Whether the file no longer matches the channels of the shard, so the next save must rewrite it.
+         */
+        bool stale = false;
+
+        /**
+         * @brief Size of the file after the last load or save.
+         */
+        std::uintmax_t size = 0;
+
+        /**
+         * @brief Modification time of the file after the last load or save.
+         */
+        std::filesystem::file_time_type time;
+    };
+
     /**
      * @brief Path to the HTML table that contains YouTube subscriptions.
      */
     const std::filesystem::path filepath_;
 
     /**
-     * @brief Vector of YouTube channels.
+     * @brief How hard to try to get every write onto stable storage.
+     */
+    const core::io::Durability durability_;
+
+    /**
+     * @brief Store of YouTube channels.
      */
-    std::vector<core::io::Channel> channels_;
+    core::store::ChannelStore channels_;
 
     /**
-     * @brief Save the YouTube channels to an HTML file on disk.
+     * @brief Number of channels for each canonical link. Tables written before duplicates were rejected may have counts above one.
+     */
+    std::unordered_map<std::string, std::size_t> keys_;
+
+    /**
+     * @brief Search index over names and descriptions, or std::nullopt until the first search.
+     */
+    std::optional<core::search::TrigramIndex> index_;
+
+    /**
+     * @brief Rendered rows of the channels, in store order, so that rewriting the file only renders the rows that changed since it was last written.
+     */
+    core::io::RowCache row_cache_;
+
+    /**
+     * @brief Layout of the rows in the file on disk, or std::nullopt if unknown.
+     */
+    std::optional<core::io::Layout> layout_;
+
+    /**
+     * @brief Number of active (nested) batches.
+     */
+    std::size_t batch_depth_ = 0;
+
+    /**
+     * @brief Whether the table has changes that are not on disk yet.
+     */
+    bool dirty_ = false;
+
+    /**
+     * @brief Size of the file on disk after the last load or save.
+     */
+    std::uintmax_t file_size_ = 0;
+
+    /**
+     * @brief Modification time of the file on disk after the last load or save.
+     */
+    std::filesystem::file_time_type file_time_;
+
+    /**
+     * @brief Whether the snapshot of the file is missing or older than the file.
+     */
+    bool snapshot_stale_ = false;
+
+    /**
+     * @brief Journal of the changes that are not in the file on disk yet.
+     */
+    core::journal::Journal journal_;
+
+    /**
+     * @brief Watcher of the file, or std::nullopt until "watch" is called.
+     */
+    std::optional<core::watch::FileWatcher> watcher_;
+
+    /**
+     * @brief Hashes of the chunks of the file after the last load or write, kept up to date only while watching.
+     */
+    core::watch::ChunkHashes hashes_;
+
+    /**
+     * @brief Whether the watcher reported a change to the file that was not picked up yet (e.g., because the changed file was malformed).
+     */
+    bool file_changed_ = false;
+
+    /**
+     * @brief Whether "refresh" is running, so that reloading the table does not refresh it again.
+     */
+    bool refreshing_ = false;
+
+    /**
+     * @brief Whether the table is split into shard files, with the file as their index page.
+     */
+    bool sharded_ = false;
+
+    /**
+     * @brief File of each shard, used while the table is sharded.
+     */
+    std::array<ShardFile, core::shard::count> shards_;
+
+    /**
+     * @brief Save the YouTube channels to an HTML file on disk, rewriting the whole file from the row cache, then clear the journal.
+     *
+     * If the file was replaced but the directory could not be synced (see "core::io::SyncError"), the save counts as done, but the journal is synced and kept instead, so the changes still survive a power loss.
      */
     void save();
+
+    /**
+     * @brief Rewrite the stale shard files, deleting the ones that became empty, and rewrite the index page if the set of shard files changed.
+     *
+     * @param write_index If true, rewrite the index page even if the set of shard files did not change (e.g., the file still holds the whole table).
+     */
+    void save_shards(const bool write_index);
+
+    /**
+     * @brief Load the channels from the snapshot or the file on disk, writing an empty table if the file doesn't exist, then replay the journal.
+     *
+     * @param create_backup If true, back up the file before loading it.
+     *
+     * @throws std::runtime_error If the file exists but cannot be loaded, or if the journal cannot be replayed.
+     */
+    void load(const bool create_backup);
+
+    /**
+     * @brief Load the channels from the shard files that the index page links to, in parallel, then replay the journal.
+     *
+     * @param shards Shards listed by the index page (see "core::shard::read_index").
+     * @param create_backup If true, back up each shard file before loading it.
+     *
+     * @throws std::runtime_error If a shard file cannot be loaded, or if the journal cannot be replayed.
+     */
+    void load_shards(const std::vector<std::size_t> &shards,
+                     const bool create_backup);
+
+    /**
+     * @brief Apply the changes of a journal left behind by an earlier run, then rewrite the file if there were any.
+     *
+     * @throws std::runtime_error If the journal cannot be read, or the file cannot be written.
+     */
+    void replay_journal();
+
+    /**
+     * @brief Parse the rows in a changed part of the file again, and swap them for the rows that were there before, without reloading the rest.
+     *
+     * The table must have no pending changes, and a layout that matches the file as it was before the change.
+     *
+     * @param text Contents of the changed file.
+     * @param change Range of bytes that changed (see "core::watch::find_change").
+     *
+     * @return True if the table was patched, false if the change is too large or its rows cannot be patched in, in which case nothing was changed.
+     *
+     * @throws std::runtime_error If a row in the changed part is malformed.
+     */
+    [[nodiscard]] bool patch(const std::string_view text,
+                             const core::watch::Change &change);
+
+    /**
+     * @brief Load the table from the file again, then replay the pending changes on top of it. If loading fails, the table is left as it was.
+     *
+     * @throws std::runtime_error If the file cannot be loaded, or the merged table cannot be written.
+     */
+    void reload();
+
+
+    /**
+     * @brief Check if the file on disk still matches the remembered layout.
+     *
+     * @return True if the layout is known and the file's size and modification time are unchanged, false otherwise.
+     */
+    [[nodiscard]] bool is_layout_current() const;
+
+    /**
+     * @brief Check if a shard file was changed, created or deleted since the table last read or wrote it.
+     *
+     * @return True if any shard file's existence, size or modification time differs, false otherwise.
+     */
+    [[nodiscard]] bool is_shard_changed() const;
+
+    /**
+     * @brief Mark the shard of a channel as stale, so that the next save rewrites its file, if the table is sharded.
+     *
+     * @param name YouTube Channel's name (e.g., "Noriyaro").
+     */
+    void mark_shard_stale(const std::string_view name);
+
+    /**
+     * @brief Remember the file's size and modification time after reading or writing it. While watching, also forget the watcher's events about this write, and hash the chunks that changed.
+     *
+     * @param changed_from Offset of the first byte that may have changed since the state was last remembered (default: "0", for the whole file).
+     */
+    void remember_file_state(const std::size_t changed_from = 0);
+
+    /**
+     * @brief Count a channel's link in the set of canonical links.
+     *
+     * @param link YouTube Channel's link (e.g., "https://www.youtube.com/@noriyaro/videos").
+     */
+    void track_link(const std::string_view link);
+
+    /**
+     * @brief Uncount a channel's link from the set of canonical links.
+     *
+     * @param link YouTube Channel's link (e.g., "https://www.youtube.com/@noriyaro/videos").
+     */
+    void untrack_link(const std::string_view link);
+
+    /**
+     * @brief Make a journaled edit durable, unless a batch is active. The file is rewritten instead if the journal is larger than "journal_compaction_threshold".
+     *
+     * @throws std::runtime_error If failed to sync the journal or to write to disk.
+     */
+    void end_edit();
+
+    /**
+     * @brief Mark the table as having changes that are not on disk yet, and forget the layout.
+     */
+    void mark_dirty();
 };
 
 }  // namespace modules::disk
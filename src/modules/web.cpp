@@ -0,0 +1,718 @@
+/**
+ * @file web.cpp
+ */
+
+#include <algorithm>      // for std::remove_if
+#include <chrono>         // for std::chrono
+#include <cstddef>        // for std::size_t
+#include <cstdint>        // for std::uint16_t, std::uint32_t, std::uint64_t, std::uintptr_t
+#include <memory>         // for std::make_shared, std::make_unique, std::shared_ptr
+#include <optional>       // for std::optional
+#include <stdexcept>      // for std::runtime_error, std::invalid_argument
+#include <string>         // for std::string
+#include <string_view>    // for std::string_view
+#include <system_error>   // for std::system_category
+#include <unordered_map>  // for std::unordered_map
+#include <utility>        // for std::move
+#include <vector>         // for std::vector
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN  // Exclude rarely-used stuff from Windows headers
+#include <winsock2.h>        // for SOCKET, WSAStartup, WSACleanup, WSAPoll, WSASend, WSAGetLastError, closesocket, ioctlsocket
+#include <ws2tcpip.h>        // for socklen_t
+#else                        // Assume POSIX for macOS and GNU/Linux
+#include <arpa/inet.h>       // for htonl, htons, ntohs
+#include <cerrno>            // for errno, EAGAIN, EWOULDBLOCK, EINTR
+#include <fcntl.h>           // for fcntl, F_GETFL, F_SETFL, O_NONBLOCK
+#include <netinet/in.h>      // for struct sockaddr_in, IPPROTO_TCP
+#include <netinet/tcp.h>     // for TCP_NODELAY
+#include <poll.h>            // for poll, struct pollfd, POLLIN, POLLOUT, POLLHUP, POLLERR
+#include <sys/socket.h>      // for socket, bind, listen, accept, recv, sendmsg, setsockopt, getsockname, struct msghdr
+#include <sys/types.h>       // for ssize_t
+#include <sys/uio.h>         // for struct iovec
+#include <unistd.h>          // for close
+#endif
+
+#include <fmt/core.h>
+
+#include "core/gzip.hpp"
+#include "core/http.hpp"
+#include "core/render.hpp"
+#include "core/snapshot.hpp"
+#include "core/store.hpp"
+#include "web.hpp"
+
+namespace modules::web {
+
+namespace {
+
+#if defined(_WIN32)
+/**
+ * @brief Private helper type of the native socket handle.
+ */
+using NativeSocket = SOCKET;
+
+/**
+ * @brief Private helper variable that contains the handle of no socket.
+ */
+constexpr NativeSocket invalid_socket = INVALID_SOCKET;
+#else
+using NativeSocket = int;
+constexpr NativeSocket invalid_socket = -1;
+#endif
+
+/**
+ * @brief Private helper variable that contains the largest number of rows in a segment, so that a run of channels whose names never end a segment still gets split.
+ */
+constexpr std::size_t max_segment_rows = Document::segment_rows * 8;
+
+/**
+ * @brief Private helper variable that contains the largest number of parts written by a single vectored write.
+ */
+constexpr std::size_t max_parts_per_write = 64;
+
+/**
+ * @brief Private helper variable that contains the size of the buffer that requests are received into, in bytes.
+ */
+constexpr std::size_t receive_buffer_size = 16 * 1024;
+
+/**
+ * @brief Private helper function to mix a value into a running hash.
+ *
+ * @param hash Hash so far.
+ * @param value Value to mix in (e.g., the hash of a field).
+ *
+ * @return Updated hash, which depends on the order of the values.
+ */
+[[nodiscard]] std::uint64_t mix(std::uint64_t hash,
+                                const std::uint64_t value)
+{
+    hash = (hash ^ value) * 0x9E3779B97F4A7C15;
+    return hash ^ (hash >> 32);
+}
+
+/**
+ * @brief Private helper function to get the native handle of a socket.
+ *
+ * @param handle Handle as stored in the server (e.g., "Server::listener_").
+ *
+ * @return Native handle.
+ */
+[[nodiscard]] NativeSocket to_native(const std::uintptr_t handle)
+{
+    return static_cast<NativeSocket>(handle);
+}
+
+/**
+ * @brief Private helper function to get the error of the last socket call.
+ *
+ * @return Error code (e.g., "EAGAIN").
+ */
+[[nodiscard]] int get_last_error()
+{
+#if defined(_WIN32)
+    return WSAGetLastError();
+#else
+    return errno;
+#endif
+}
+
+/**
+ * @brief Private helper function to check if a socket call failed only because it would have blocked.
+ *
+ * @param error Error code (see "get_last_error").
+ *
+ * @return True if the call would have blocked, false if it failed.
+ */
+[[nodiscard]] bool would_block(const int error)
+{
+#if defined(_WIN32)
+    return error == WSAEWOULDBLOCK;
+#else
+    return error == EAGAIN || error == EWOULDBLOCK;
+#endif
+}
+
+/**
+ * @brief Private helper function to close a native socket.
+ *
+ * @param socket Native handle (e.g., "3").
+ */
+void close_socket(const NativeSocket socket)
+{
+#if defined(_WIN32)
+    closesocket(socket);
+#else
+    ::close(socket);
+#endif
+}
+
+/**
+ * @brief Private helper function to make a socket non-blocking, and turn off the delay of small writes.
+ *
+ * @param socket Native handle (e.g., "3").
+ * @param is_connection If true, the socket is a connection rather than the listening socket.
+ *
+ * @return True if succeeded, false otherwise.
+ */
+[[nodiscard]] bool configure_socket(const NativeSocket socket,
+                                    const bool is_connection)
+{
+    const int one = 1;
+    // Responses are written whole, so there is nothing to gain from waiting for more data
+    if (is_connection) {
+        setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char *>(&one), sizeof(one));
+#if defined(SO_NOSIGPIPE)
+        // macOS has no MSG_NOSIGNAL, so a write to a closed connection must not raise SIGPIPE either way
+        setsockopt(socket, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+    }
+#if defined(_WIN32)
+    u_long mode = 1;
+    return ioctlsocket(socket, FIONBIO, &mode) == 0;
+#else
+    const int flags = fcntl(socket, F_GETFL, 0);
+    return flags != -1 && fcntl(socket, F_SETFL, flags | O_NONBLOCK) != -1;
+#endif
+}
+
+/**
+ * @brief Private helper function to build the head of a "200 OK" response for the document.
+ *
+ * @param etag Quoted entity tag of the document (e.g., "\"5f2b9c1e0a4d7e3b\"").
+ * @param size Size of the body in bytes (e.g., "150000").
+ * @param gzip If true, the body is compressed with gzip.
+ * @param closing If true, the connection is closed after the response.
+ *
+ * @return Head, including the empty line that ends it.
+ */
+[[nodiscard]] std::string make_document_head(const std::string &etag,
+                                             const std::size_t size,
+                                             const bool gzip,
+                                             const bool closing)
+{
+    std::string head;
+    core::http::append_status_line(head, 200);
+    head.append(fmt::format("Content-Type: text/html; charset=utf-8\r\n"
+                            "Content-Length: {}\r\n"
+                            "ETag: {}\r\n"
+                            "Cache-Control: no-cache\r\n"
+                            "Vary: Accept-Encoding\r\n",
+                            size, etag));
+    if (gzip) {
+        head.append("Content-Encoding: gzip\r\n");
+    }
+    if (closing) {
+        head.append("Connection: close\r\n");
+    }
+    head.append("\r\n");
+    return head;
+}
+
+/**
+ * @brief Private helper function to queue a part of a response.
+ *
+ * @param output Queue of the connection.
+ * @param part Part to send, which is skipped if empty.
+ */
+void queue(std::deque<std::shared_ptr<const std::string>> &output,
+           std::shared_ptr<const std::string> part)
+{
+    if (!part->empty()) {
+        output.push_back(std::move(part));
+    }
+}
+
+}  // namespace
+
+Document::Document()
+{
+    // The live reload script goes right before the end of the body
+    const std::string_view footer = core::render::Html::footer;
+    const std::size_t body_end = footer.find("  </body>");
+    std::string served_footer(footer.substr(0, body_end));
+    served_footer.append(live_reload_script);
+    served_footer.append(footer.substr(body_end));
+
+    const std::string_view header = core::render::Html::header;
+    this->segments_.push_back(Segment{core::snapshot::hash_contents(header), std::make_shared<const std::string>(header), nullptr, 0});
+    this->segments_.push_back(Segment{core::snapshot::hash_contents(served_footer), std::make_shared<const std::string>(std::move(served_footer)), nullptr, 0});
+    static_cast<void>(this->update(core::store::ChannelStore()));
+}
+
+bool Document::update(const core::store::ChannelStore &channels)
+{
+    // Find the segments of the previous version by their hash, wherever their rows moved
+    std::unordered_map<std::uint64_t, const Segment *> previous;
+    previous.reserve(this->segments_.size());
+    for (const Segment &segment : this->segments_) {
+        previous.emplace(segment.hash, &segment);
+    }
+
+    std::vector<Segment> segments;
+    segments.reserve(this->segments_.size());
+    segments.push_back(this->segments_.front());
+    this->rendered_segments_ = 0;
+    constexpr std::uint64_t seed = 0x243F6A8885A308D3;
+    std::size_t first = 0;
+    std::uint64_t hash = seed;
+    const auto end_segment = [&](const std::size_t end) {
+        if (const auto it = previous.find(hash); it != previous.end()) {
+            segments.push_back(*it->second);
+        }
+        else {
+            std::string html;
+            for (std::size_t index = first; index < end; ++index) {
+                core::render::Html::append_row(html, channels.name(index), channels.link(index), channels.description(index));
+            }
+            segments.push_back(Segment{hash, std::make_shared<const std::string>(std::move(html)), nullptr, 0});
+            ++this->rendered_segments_;
+        }
+        first = end;
+        hash = seed;
+    };
+    for (std::size_t index = 0; index < channels.size(); ++index) {
+        const std::uint64_t name_hash = core::snapshot::hash_contents(channels.name(index));
+        hash = mix(hash, name_hash);
+        hash = mix(hash, core::snapshot::hash_contents(channels.link(index)));
+        hash = mix(hash, core::snapshot::hash_contents(channels.description(index)));
+        if (name_hash % segment_rows == 0 || index + 1 - first == max_segment_rows) {
+            end_segment(index + 1);
+        }
+    }
+    if (first < channels.size()) {
+        end_segment(channels.size());
+    }
+    segments.push_back(this->segments_.back());
+    this->segments_ = std::move(segments);
+
+    std::uint64_t document_hash = seed;
+    for (const Segment &segment : this->segments_) {
+        document_hash = mix(document_hash, segment.hash);
+    }
+    std::string etag = fmt::format("\"{:016x}\"", document_hash);
+    if (etag == this->etag_) {
+        return false;
+    }
+    this->etag_ = std::move(etag);
+    this->gzip_trailer_.reset();
+    return true;
+}
+
+const std::string &Document::get_etag() const
+{
+    return this->etag_;
+}
+
+std::size_t Document::get_rendered_segments() const
+{
+    return this->rendered_segments_;
+}
+
+std::vector<std::shared_ptr<const std::string>> Document::get_parts(const bool gzip)
+{
+    std::vector<std::shared_ptr<const std::string>> parts;
+    parts.reserve(this->segments_.size() + 2);
+    if (!gzip) {
+        for (const Segment &segment : this->segments_) {
+            parts.push_back(segment.html);
+        }
+        return parts;
+    }
+
+    static const std::shared_ptr<const std::string> gzip_header = std::make_shared<const std::string>(core::gzip::header);
+    parts.push_back(gzip_header);
+    std::uint32_t crc = 0;
+    std::uint64_t size = 0;
+    for (Segment &segment : this->segments_) {
+        if (!segment.deflated) {
+            std::string deflated;
+            core::gzip::deflate(deflated, *segment.html);
+            segment.deflated = std::make_shared<const std::string>(std::move(deflated));
+            segment.crc = core::gzip::crc32(*segment.html);
+        }
+        parts.push_back(segment.deflated);
+        // The CRC of the document is combined from the ones of the segments, without reading them again
+        crc = core::gzip::crc32_combine(crc, segment.crc, segment.html->size());
+        size += segment.html->size();
+    }
+    if (!this->gzip_trailer_) {
+        std::string trailer;
+        core::gzip::append_trailer(trailer, crc, size);
+        this->gzip_trailer_ = std::make_shared<const std::string>(std::move(trailer));
+    }
+    parts.push_back(this->gzip_trailer_);
+    return parts;
+}
+
+Server::Server(const core::store::ChannelStore &channels,
+               const std::uint16_t port)
+{
+#if defined(_WIN32)
+    WSADATA data;
+    if (WSAStartup(MAKEWORD(2, 2), &data) != 0) {
+        throw std::runtime_error(fmt::format("Failed to listen on port '{}': Windows Sockets are unavailable", port));
+    }
+#endif
+    static_cast<void>(this->document_.update(channels));
+
+    // Only listen on the loopback interface, so the table is not exposed to the network
+    const NativeSocket listener = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    bool listening = listener != invalid_socket;
+    if (listening) {
+#if !defined(_WIN32)
+        // Restarting the server must not wait for the connections of the previous one to time out
+        const int one = 1;
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+#endif
+        struct sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        address.sin_addr.s_addr = htonl(0x7F000001);  // 127.0.0.1
+        socklen_t length = sizeof(address);
+        listening = ::bind(listener, reinterpret_cast<const struct sockaddr *>(&address), sizeof(address)) == 0 &&
+                    ::listen(listener, SOMAXCONN) == 0 &&
+                    configure_socket(listener, false) &&
+                    ::getsockname(listener, reinterpret_cast<struct sockaddr *>(&address), &length) == 0;
+        this->port_ = ntohs(address.sin_port);
+    }
+    if (!listening) {
+        const int error = get_last_error();
+        if (listener != invalid_socket) {
+            close_socket(listener);
+        }
+#if defined(_WIN32)
+        WSACleanup();
+#endif
+        throw std::runtime_error(fmt::format("Failed to listen on port '{}': {}", port, std::system_category().message(error)));
+    }
+    this->listener_ = static_cast<std::uintptr_t>(listener);
+}
+
+Server::~Server()
+{
+    for (const std::unique_ptr<Connection> &connection : this->connections_) {
+        this->close(*connection);
+    }
+    close_socket(to_native(this->listener_));
+#if defined(_WIN32)
+    WSACleanup();
+#endif
+}
+
+std::uint16_t Server::get_port() const
+{
+    return this->port_;
+}
+
+std::size_t Server::get_connection_count() const
+{
+    return this->connections_.size();
+}
+
+bool Server::publish(const core::store::ChannelStore &channels)
+{
+    if (!this->document_.update(channels)) {
+        return false;
+    }
+    this->heads_ = {};
+
+    // Tell every event stream, so their pages reload
+    const std::shared_ptr<const std::string> message = std::make_shared<const std::string>(fmt::format("data: {}\n\n", this->document_.get_etag()));
+    for (const std::unique_ptr<Connection> &connection : this->connections_) {
+        if (connection->events && !connection->closed) {
+            queue(connection->output, message);
+            this->send(*connection);
+        }
+    }
+    return true;
+}
+
+void Server::poll(const std::chrono::milliseconds timeout)
+{
+    std::vector<struct pollfd> descriptors;
+    descriptors.reserve(this->connections_.size() + 1);
+    descriptors.push_back({to_native(this->listener_), POLLIN, 0});
+    for (const std::unique_ptr<Connection> &connection : this->connections_) {
+        const short events = connection->output.empty() ? POLLIN : static_cast<short>(POLLIN | POLLOUT);
+        descriptors.push_back({to_native(connection->socket), events, 0});
+    }
+#if defined(_WIN32)
+    const int ready = WSAPoll(descriptors.data(), static_cast<ULONG>(descriptors.size()), static_cast<INT>(timeout.count()));
+    if (ready == SOCKET_ERROR) {
+        throw std::runtime_error(fmt::format("Failed to wait for connections: {}", std::system_category().message(get_last_error())));
+    }
+#else
+    const int ready = ::poll(descriptors.data(), static_cast<nfds_t>(descriptors.size()), static_cast<int>(timeout.count()));
+    if (ready == -1) {
+        // A signal (e.g., a resized terminal) only ends the wait early
+        if (errno == EINTR) {
+            return;
+        }
+        throw std::runtime_error(fmt::format("Failed to wait for connections: {}", std::system_category().message(errno)));
+    }
+#endif
+    if (ready == 0) {
+        return;
+    }
+
+    // Serve the existing connections first, because accepting new ones changes the list
+    const std::size_t count = this->connections_.size();
+    for (std::size_t i = 0; i < count; ++i) {
+        Connection &connection = *this->connections_[i];
+        const short events = descriptors[i + 1].revents;
+        if ((events & (POLLIN | POLLHUP | POLLERR)) != 0) {
+            this->receive(connection);
+        }
+        if (!connection.closed && (events & POLLOUT) != 0) {
+            this->send(connection);
+        }
+    }
+    if ((descriptors.front().revents & POLLIN) != 0) {
+        this->accept();
+    }
+    this->connections_.erase(std::remove_if(this->connections_.begin(), this->connections_.end(), [](const std::unique_ptr<Connection> &connection) {
+                                 return connection->closed;
+                             }),
+                             this->connections_.end());
+}
+
+void Server::accept()
+{
+    while (true) {
+        const NativeSocket socket = ::accept(to_native(this->listener_), nullptr, nullptr);
+        if (socket == invalid_socket) {
+            return;
+        }
+        if (!configure_socket(socket, true)) {
+            close_socket(socket);
+            continue;
+        }
+        auto connection = std::make_unique<Connection>();
+        connection->socket = static_cast<std::uintptr_t>(socket);
+        this->connections_.push_back(std::move(connection));
+    }
+}
+
+void Server::receive(Connection &connection)
+{
+    char buffer[receive_buffer_size];
+    while (true) {
+#if defined(_WIN32)
+        const int received = ::recv(to_native(connection.socket), buffer, static_cast<int>(sizeof(buffer)), 0);
+#else
+        const ssize_t received = ::recv(to_native(connection.socket), buffer, sizeof(buffer), 0);
+#endif
+        if (received > 0) {
+            // Event streams only send, so anything they receive is dropped
+            if (!connection.events) {
+                connection.input.append(buffer, static_cast<std::size_t>(received));
+            }
+            // A short read means the socket is drained, which saves a call that would block
+            if (static_cast<std::size_t>(received) < sizeof(buffer)) {
+                break;
+            }
+            continue;
+        }
+        const int error = get_last_error();
+        if (received < 0 && would_block(error)) {
+            break;
+        }
+#if !defined(_WIN32)
+        if (received < 0 && error == EINTR) {
+            continue;
+        }
+#endif
+        // Closed by the client, or failed
+        this->close(connection);
+        return;
+    }
+
+    // Answer every complete request, in order
+    std::size_t consumed = 0;
+    while (!connection.closing && !connection.events) {
+        core::http::Request request;
+        std::optional<std::size_t> size;
+        try {
+            size = core::http::parse_request(std::string_view(connection.input).substr(consumed), request);
+        }
+        catch (const std::invalid_argument &e) {
+            connection.closing = true;
+            this->respond_text(connection, 400, e.what());
+            break;
+        }
+        if (!size) {
+            break;
+        }
+        consumed += *size;
+        this->respond(connection, request);
+    }
+    connection.input.erase(0, consumed);
+    this->send(connection);
+}
+
+void Server::respond(Connection &connection,
+                     const core::http::Request &request)
+{
+    const bool is_head = request.method == "HEAD";
+    if (!request.keep_alive) {
+        connection.closing = true;
+    }
+    if (!is_head && request.method != "GET") {
+        this->respond_text(connection, 405, "Method not allowed");
+        return;
+    }
+
+    if (request.path == "/" || request.path == "/index.html") {
+        const std::string &etag = this->document_.get_etag();
+        // The browser's copy is current, so only the head is sent
+        if (!request.if_none_match.empty() && core::http::matches_etag(request.if_none_match, etag)) {
+            std::string head;
+            core::http::append_status_line(head, 304);
+            head.append(fmt::format("ETag: {}\r\n"
+                                    "Cache-Control: no-cache\r\n"
+                                    "Vary: Accept-Encoding\r\n"
+                                    "{}\r\n",
+                                    etag, connection.closing ? "Connection: close\r\n" : ""));
+            queue(connection.output, std::make_shared<const std::string>(std::move(head)));
+            return;
+        }
+
+        const bool gzip = request.accepts_gzip;
+        std::vector<std::shared_ptr<const std::string>> parts = this->document_.get_parts(gzip);
+        std::size_t size = 0;
+        for (const std::shared_ptr<const std::string> &part : parts) {
+            size += part->size();
+        }
+        // The heads of kept-alive connections are the same for every request, until the document changes
+        std::shared_ptr<const std::string> &head = this->heads_[gzip ? 1 : 0];
+        if (connection.closing) {
+            queue(connection.output, std::make_shared<const std::string>(make_document_head(etag, size, gzip, true)));
+        }
+        else {
+            if (!head) {
+                head = std::make_shared<const std::string>(make_document_head(etag, size, gzip, false));
+            }
+            queue(connection.output, head);
+        }
+        if (!is_head) {
+            for (std::shared_ptr<const std::string> &part : parts) {
+                queue(connection.output, std::move(part));
+            }
+        }
+    }
+    else if (request.path == "/events" && !is_head) {
+        // Send the current tag right away; the browser reconnects by itself after a second if the stream drops
+        std::string head;
+        core::http::append_status_line(head, 200);
+        head.append(fmt::format("Content-Type: text/event-stream\r\n"
+                                "Cache-Control: no-cache\r\n"
+                                "\r\n"
+                                "retry: 1000\n"
+                                "data: {}\n\n",
+                                this->document_.get_etag()));
+        queue(connection.output, std::make_shared<const std::string>(std::move(head)));
+        connection.events = true;
+        connection.closing = false;
+        connection.input.clear();
+    }
+    else {
+        this->respond_text(connection, 404, "Not found", !is_head);
+    }
+}
+
+void Server::respond_text(Connection &connection,
+                          const int status,
+                          const std::string_view text,
+                          const bool with_body)
+{
+    std::string response;
+    core::http::append_status_line(response, status);
+    response.append(fmt::format("Content-Type: text/plain; charset=utf-8\r\n"
+                                "Content-Length: {}\r\n"
+                                "{}{}\r\n",
+                                text.size() + 1,
+                                status == 405 ? "Allow: GET, HEAD\r\n" : "",
+                                connection.closing ? "Connection: close\r\n" : ""));
+    if (with_body) {
+        response.append(text);
+        response.push_back('\n');
+    }
+    queue(connection.output, std::make_shared<const std::string>(std::move(response)));
+}
+
+void Server::send(Connection &connection)
+{
+    while (!connection.output.empty()) {
+        // Gather the queued parts, so a whole response usually takes a single call
+        const std::size_t count = connection.output.size() < max_parts_per_write ? connection.output.size() : max_parts_per_write;
+#if defined(_WIN32)
+        WSABUF buffers[max_parts_per_write];
+        for (std::size_t i = 0; i < count; ++i) {
+            const std::size_t offset = i == 0 ? connection.written : 0;
+            buffers[i].buf = const_cast<char *>(connection.output[i]->data() + offset);
+            buffers[i].len = static_cast<ULONG>(connection.output[i]->size() - offset);
+        }
+        DWORD sent = 0;
+        if (WSASend(to_native(connection.socket), buffers, static_cast<DWORD>(count), &sent, 0, nullptr, nullptr) == SOCKET_ERROR) {
+            if (!would_block(get_last_error())) {
+                this->close(connection);
+            }
+            return;
+        }
+#else
+        struct iovec buffers[max_parts_per_write];
+        for (std::size_t i = 0; i < count; ++i) {
+            const std::size_t offset = i == 0 ? connection.written : 0;
+            buffers[i].iov_base = const_cast<char *>(connection.output[i]->data() + offset);
+            buffers[i].iov_len = connection.output[i]->size() - offset;
+        }
+        struct msghdr message = {};
+        message.msg_iov = buffers;
+        message.msg_iovlen = static_cast<decltype(message.msg_iovlen)>(count);
+#if defined(MSG_NOSIGNAL)
+        // A client that went away must not kill the server with SIGPIPE
+        const ssize_t sent = ::sendmsg(to_native(connection.socket), &message, MSG_NOSIGNAL);
+#else
+        const ssize_t sent = ::sendmsg(to_native(connection.socket), &message, 0);
+#endif
+        if (sent == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (!would_block(errno)) {
+                this->close(connection);
+            }
+            return;
+        }
+#endif
+
+        // Drop the parts that were written, and remember how much of the next one was
+        auto remaining = static_cast<std::size_t>(sent);
+        while (remaining > 0) {
+            const std::size_t left = connection.output.front()->size() - connection.written;
+            if (remaining < left) {
+                connection.written += remaining;
+                break;
+            }
+            remaining -= left;
+            connection.output.pop_front();
+            connection.written = 0;
+        }
+    }
+    if (connection.closing) {
+        this->close(connection);
+    }
+}
+
+void Server::close(Connection &connection)
+{
+    if (connection.closed) {
+        return;
+    }
+    close_socket(to_native(connection.socket));
+    connection.closed = true;
+    connection.output.clear();
+    connection.written = 0;
+}
+
+}  // namespace modules::web
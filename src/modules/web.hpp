@@ -0,0 +1,326 @@
+/**
+ * @file web.hpp
+ *
+ * @brief Serve the HTML table to a web browser over a loopback HTTP connection.
+ */
+
+#pragma once
+
+#include <array>        // for std::array
+#include <chrono>       // for std::chrono
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint16_t, std::uint32_t, std::uint64_t, std::uintptr_t
+#include <deque>        // for std::deque
+#include <memory>       // for std::shared_ptr, std::unique_ptr
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+#include <vector>       // for std::vector
+
+#include "core/http.hpp"
+#include "core/store.hpp"
+
+namespace modules::web {
+
+/**
+ * @brief Script that the served document runs to reload itself when the table changes, inserted before the end of the body.
+ *
+ * The browser keeps a Server-Sent Events stream open on "/events", which sends the entity tag of the document on connect and after every change. The page reloads when the tag differs from the first one it got.
+ */
+inline constexpr std::string_view live_reload_script = "    <script>\n"
+                                                       "      let version;\n"
+                                                       "      new EventSource(\"/events\").onmessage = (event) => {\n"
+                                                       "        if (version !== undefined && event.data !== version) {\n"
+                                                       "          location.reload();\n"
+                                                       "        }\n"
+                                                       "        version = event.data;\n"
+                                                       "      };\n"
+                                                       "    </script>\n";
+
+/**
+ * @brief Class that represents the HTML document of a table, rendered once and kept in memory, as served to web browsers.
+ *
+ * The rows are grouped into segments whose boundaries depend on the channels themselves (a segment ends after a channel whose name hashes to a multiple of "segment_rows"), so adding or removing a channel only changes the segment around it, and later segments keep their boundaries. Each segment is identified by a hash of its rows, and "update" only renders the segments that were not in the previous version, so a change costs a pass of hashing over the fields plus the rendering of about "segment_rows" rows.
+ *
+ * Segments are also compressed once, on the first request that accepts gzip, into deflate blocks that are sent joined as they are (see "core::gzip::deflate"), so a changed segment is compressed again on its own.
+ *
+ * @note This class is marked as `final` to prevent inheritance.
+ */
+class Document final {
+  public:
+    /**
+     * @brief Average number of rows per segment; segments never exceed eight times this.
+     */
+    static constexpr std::size_t segment_rows = 512;
+
+    /**
+     * @brief Construct a new, empty Document object.
+     */
+    Document();
+
+    /**
+     * @brief Bring the document up to date with a store of channels.
+     *
+     * @param channels Store of YouTube channels, rendered in store order.
+     *
+     * @return True if the document changed (i.e., its entity tag differs), false otherwise.
+     */
+    bool update(const core::store::ChannelStore &channels);
+
+    /**
+     * @brief Get the entity tag of the document, which changes whenever its contents do.
+     *
+     * @return Quoted entity tag (e.g., "\"5f2b9c1e0a4d7e3b\"").
+     */
+    [[nodiscard]] const std::string &get_etag() const;
+
+    /**
+     * @brief Get the number of segments that the last "update" rendered, as opposed to reusing them.
+     *
+     * @return Number of rendered segments (e.g., "1" after changing a single channel).
+     */
+    [[nodiscard]] std::size_t get_rendered_segments() const;
+
+    /**
+     * @brief Get the body of the document, as parts to send in order.
+     *
+     * The parts are shared, not copied, and stay valid after later updates as long as they are held, so a response can be sent while the document changes.
+     *
+     * @param gzip If true, the parts are a gzip member, compressing the segments that were not compressed yet, otherwise the plain HTML.
+     *
+     * @return Parts of the body.
+     */
+    [[nodiscard]] std::vector<std::shared_ptr<const std::string>> get_parts(const bool gzip);
+
+  private:
+    /**
+     * @brief Struct that represents a run of consecutive rows of the document (or its start or end), rendered and compressed once.
+     *
+     * @note This struct is marked as `final` to prevent inheritance.
+     */
+    struct Segment final {
+        /**
+         * @brief Hash of the fields of the rows in the segment.
+         */
+        std::uint64_t hash = 0;
+
+        /**
+         * @brief Rendered HTML.
+         */
+        std::shared_ptr<const std::string> html;
+
+        /**
+         * @brief Deflate blocks of the rendered HTML, or nullptr until the first request that accepts gzip.
+         */
+        std::shared_ptr<const std::string> deflated;
+
+        /**
+         * @brief CRC-32 of the rendered HTML, valid once "deflated" is set.
+         */
+        std::uint32_t crc = 0;
+    };
+
+    /**
+     * @brief Segments of the document, in order: the start of the document, the rows, then the end of the document.
+     */
+    std::vector<Segment> segments_;
+
+    /**
+     * @brief Quoted entity tag of the document.
+     */
+    std::string etag_;
+
+    /**
+     * @brief Number of segments that the last "update" rendered.
+     */
+    std::size_t rendered_segments_ = 0;
+
+    /**
+     * @brief End of the gzip member for the current segments, or nullptr until the first request that accepts gzip after an update.
+     */
+    std::shared_ptr<const std::string> gzip_trailer_;
+};
+
+/**
+ * @brief Class that serves a document to web browsers over HTTP/1.1 on the loopback interface.
+ *
+ * The server runs on the calling thread: "poll" waits for sockets to be ready, reads requests and writes responses without blocking, and returns. Nothing is read from disk for a request; every response is built from the document in memory, whose parts are written with one vectored write each (e.g., "sendmsg").
+ *
+ * The following paths are served:
+ * - "/" (or "/index.html"): the document, with an entity tag. A request whose "If-None-Match" matches the tag gets "304 Not Modified" without a body, and a request that accepts gzip gets the compressed document.
+ * - "/events": a Server-Sent Events stream, which sends the entity tag of the document on connect and after every change (see "live_reload_script").
+ *
+ * Only "GET" and "HEAD" are answered. Connections are kept alive unless the client asks otherwise, and pipelined requests are answered in order.
+ *
+ * @note This class is marked as `final` to prevent inheritance.
+ */
+class Server final {
+  public:
+    /**
+     * @brief Construct a new Server object, and start listening on 127.0.0.1.
+     *
+     * @param channels Store of YouTube channels to serve.
+     * @param port TCP port to listen on (e.g., "8080"), or "0" for any free port (see "get_port").
+     *
+     * @throws std::runtime_error If the port cannot be listened on (e.g., it is in use).
+     */
+    explicit Server(const core::store::ChannelStore &channels,
+                    const std::uint16_t port);
+
+    /**
+     * @brief Destroy the Server object, closing every connection.
+     */
+    ~Server();
+
+    Server(const Server &) = delete;
+    Server &operator=(const Server &) = delete;
+
+    /**
+     * @brief Get the TCP port that the server listens on.
+     *
+     * @return Port (e.g., "8080").
+     */
+    [[nodiscard]] std::uint16_t get_port() const;
+
+    /**
+     * @brief Get the number of open connections, including event streams.
+     *
+     * @return Number of connections (e.g., "2").
+     */
+    [[nodiscard]] std::size_t get_connection_count() const;
+
+    /**
+     * @brief Bring the served document up to date with a store of channels, and notify the event streams if it changed.
+     *
+     * @param channels Store of YouTube channels to serve.
+     *
+     * @return True if the document changed, false otherwise.
+     */
+    bool publish(const core::store::ChannelStore &channels);
+
+    /**
+     * @brief Wait until a socket is ready or the timeout expires, then accept connections, answer the complete requests, and write what the sockets accept.
+     *
+     * @param timeout How long to wait for a socket to be ready (e.g., "250ms").
+     *
+     * @throws std::runtime_error If waiting for the sockets fails.
+     */
+    void poll(const std::chrono::milliseconds timeout);
+
+  private:
+    /**
+     * @brief Struct that represents an open connection.
+     *
+     * @note This struct is marked as `final` to prevent inheritance.
+     */
+    struct Connection final {
+        /**
+         * @brief Native socket handle.
+         */
+        std::uintptr_t socket = 0;
+
+        /**
+         * @brief Bytes received that do not form a complete request yet.
+         */
+        std::string input;
+
+        /**
+         * @brief Parts of the responses that were not written yet, in order.
+         */
+        std::deque<std::shared_ptr<const std::string>> output;
+
+        /**
+         * @brief Number of bytes of the first part of "output" that were already written.
+         */
+        std::size_t written = 0;
+
+        /**
+         * @brief Whether the connection is a Server-Sent Events stream.
+         */
+        bool events = false;
+
+        /**
+         * @brief Whether to close the connection once "output" is written.
+         */
+        bool closing = false;
+
+        /**
+         * @brief Whether the connection was closed, and must be removed.
+         */
+        bool closed = false;
+    };
+
+    /**
+     * @brief Native handle of the listening socket.
+     */
+    std::uintptr_t listener_ = 0;
+
+    /**
+     * @brief TCP port that the server listens on.
+     */
+    std::uint16_t port_ = 0;
+
+    /**
+     * @brief Served document.
+     */
+    Document document_;
+
+    /**
+     * @brief Heads of the "200 OK" responses for the current document, plain and gzip, or nullptr until first needed after an update.
+     */
+    std::array<std::shared_ptr<const std::string>, 2> heads_;
+
+    /**
+     * @brief Open connections.
+     */
+    std::vector<std::unique_ptr<Connection>> connections_;
+
+    /**
+     * @brief Accept every pending connection.
+     */
+    void accept();
+
+    /**
+     * @brief Read what a connection received, and answer its complete requests.
+     *
+     * @param connection Connection to read from.
+     */
+    void receive(Connection &connection);
+
+    /**
+     * @brief Queue the response to a request.
+     *
+     * @param connection Connection to answer on.
+     * @param request Parsed request.
+     */
+    void respond(Connection &connection,
+                 const core::http::Request &request);
+
+    /**
+     * @brief Queue a response without a body, or with a short text body.
+     *
+     * @param connection Connection to answer on.
+     * @param status Status code (e.g., "404").
+     * @param text Body of the response, as plain text (e.g., "Not found").
+     * @param with_body If false, only the head is sent (i.e., for a "HEAD" request).
+     */
+    void respond_text(Connection &connection,
+                      const int status,
+                      const std::string_view text,
+                      const bool with_body = true);
+
+    /**
+     * @brief Write as much of the queued output as the socket accepts.
+     *
+     * @param connection Connection to write to.
+     */
+    void send(Connection &connection);
+
+    /**
+     * @brief Close a connection, which is removed at the end of "poll".
+     *
+     * @param connection Connection to close.
+     */
+    void close(Connection &connection);
+};
+
+}  // namespace modules::web
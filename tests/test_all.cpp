@@ -2,28 +2,57 @@
  * @file test_all.cpp
  */
 
-#include <algorithm>      // for std::any_of
-#include <cstdlib>        // for EXIT_FAILURE, EXIT_SUCCESS
-#include <exception>      // for std::exception
-#include <filesystem>     // for std::filesystem
-#include <functional>     // for std::function
-#include <stdexcept>      // for std::runtime_error
-#include <string>         // for std::string
-#include <unordered_map>  // for std::unordered_map
-#include <vector>         // for std::vector
+#include <algorithm>         // for std::any_of, std::equal, std::sort
+#include <chrono>            // for std::chrono
+#include <cstddef>           // for std::size_t
+#include <cstdint>           // for std::uint32_t
+#include <cstdlib>           // for EXIT_FAILURE, EXIT_SUCCESS
+#include <exception>         // for std::exception
+#include <filesystem>        // for std::filesystem
+#include <fstream>           // for std::ifstream, std::ofstream
+#include <functional>        // for std::function
+#include <initializer_list>  // for std::initializer_list
+#include <iterator>          // for std::istreambuf_iterator
+#include <memory>            // for std::shared_ptr
+#include <optional>          // for std::optional
+#include <stdexcept>         // for std::runtime_error
+#include <string>            // for std::string
+#include <string_view>       // for std::string_view
+#include <unordered_map>     // for std::unordered_map
+#include <utility>           // for std::pair
+#include <vector>            // for std::vector
 
 #include <fmt/core.h>
 #if defined(_WIN32)
 #define WIN32_LEAN_AND_MEAN  // Exclude rarely-used stuff from Windows headers
 #include <windows.h>         // for SetConsoleCP, SetConsoleOutputCP, CP_UTF8
+#else
+#include <csignal>           // for std::signal, SIGXFSZ, SIG_IGN
+#include <sys/resource.h>    // for getrlimit, setrlimit, RLIMIT_FSIZE
 #endif
 
 #include "core/args.hpp"
+#include "core/backup.hpp"
+#include "core/escape.hpp"
+#include "core/gzip.hpp"
+#include "core/html.hpp"
+#include "core/http.hpp"
+#include "core/import.hpp"
 #include "core/io.hpp"
+#include "core/journal.hpp"
 #include "core/paths.hpp"
+#include "core/render.hpp"
+#include "core/search.hpp"
+#include "core/shard.hpp"
 #include "core/shell.hpp"
+#include "core/simd.hpp"
+#include "core/snapshot.hpp"
+#include "core/store.hpp"
 #include "core/strings.hpp"
+#include "core/url.hpp"
+#include "core/watch.hpp"
 #include "modules/disk.hpp"
+#include "modules/web.hpp"
 
 #include "helpers.hpp"
 
@@ -34,24 +63,89 @@ namespace test_args {
 [[nodiscard]] int help();
 [[nodiscard]] int version();
 [[nodiscard]] int invalid();
+[[nodiscard]] int subcommands();
 }  // namespace test_args
 
+namespace test_backup {
+[[nodiscard]] int rotate();
+}  // namespace test_backup
+
+namespace test_escape {
+[[nodiscard]] int round_trip();
+}  // namespace test_escape
+
+namespace test_gzip {
+[[nodiscard]] int compress();
+}  // namespace test_gzip
+
 namespace test_html {
 [[nodiscard]] int save_load();
+[[nodiscard]] int scan_rows();
+[[nodiscard]] int parse_error();
+[[nodiscard]] int mapped_load();
+[[nodiscard]] int atomic_save();
+[[nodiscard]] int parallel_load();
+[[nodiscard]] int row_cache();
+[[nodiscard]] int virtual_page();
 }  // namespace test_html
 
+namespace test_http {
+[[nodiscard]] int parse_request();
+}  // namespace test_http
+
+namespace test_import {
+[[nodiscard]] int read();
+}  // namespace test_import
+
+namespace test_render {
+[[nodiscard]] int formats();
+}  // namespace test_render
+
+namespace test_search {
+[[nodiscard]] int find();
+}  // namespace test_search
+
+namespace test_shard {
+[[nodiscard]] int index();
+}  // namespace test_shard
+
 namespace test_shell {
 [[nodiscard]] int build_command();
 }  // namespace test_shell
 
+namespace test_simd {
+[[nodiscard]] int search();
+}  // namespace test_simd
+
+namespace test_store {
+[[nodiscard]] int insert_erase();
+[[nodiscard]] int index();
+}  // namespace test_store
+
 namespace test_strings {
 [[nodiscard]] int trim_whitespace();
 }  // namespace test_strings
 
+namespace test_url {
+[[nodiscard]] int channel_key();
+}  // namespace test_url
+
 namespace test_disk {
 [[nodiscard]] int save_load();
+[[nodiscard]] int compaction();
+[[nodiscard]] int batch();
+[[nodiscard]] int dedupe();
+[[nodiscard]] int bulk_add();
+[[nodiscard]] int snapshot();
+[[nodiscard]] int journal();
+[[nodiscard]] int watch();
+[[nodiscard]] int sharded();
 }  // namespace test_disk
 
+namespace test_web {
+[[nodiscard]] int document();
+}  // namespace test_web
+
 /**
  * @brief Entry-point of the test application.
  *
@@ -90,10 +184,39 @@ int main(int argc,
         {"test_args::help", test_args::help},
         {"test_args::version", test_args::version},
         {"test_args::invalid", test_args::invalid},
+        {"test_args::subcommands", test_args::subcommands},
+        {"test_backup::rotate", test_backup::rotate},
+        {"test_escape::round_trip", test_escape::round_trip},
+        {"test_gzip::compress", test_gzip::compress},
         {"test_html::save_load", test_html::save_load},
+        {"test_html::scan_rows", test_html::scan_rows},
+        {"test_html::parse_error", test_html::parse_error},
+        {"test_html::mapped_load", test_html::mapped_load},
+        {"test_html::atomic_save", test_html::atomic_save},
+        {"test_html::parallel_load", test_html::parallel_load},
+        {"test_html::row_cache", test_html::row_cache},
+        {"test_html::virtual_page", test_html::virtual_page},
+        {"test_http::parse_request", test_http::parse_request},
+        {"test_import::read", test_import::read},
+        {"test_render::formats", test_render::formats},
+        {"test_search::find", test_search::find},
+        {"test_shard::index", test_shard::index},
         {"test_shell::build_command", test_shell::build_command},
+        {"test_simd::search", test_simd::search},
+        {"test_store::insert_erase", test_store::insert_erase},
+        {"test_store::index", test_store::index},
         {"test_strings::trim_whitespace", test_strings::trim_whitespace},
+        {"test_url::channel_key", test_url::channel_key},
         {"test_disk::save_load", test_disk::save_load},
+        {"test_disk::compaction", test_disk::compaction},
+        {"test_disk::batch", test_disk::batch},
+        {"test_disk::dedupe", test_disk::dedupe},
+        {"test_disk::bulk_add", test_disk::bulk_add},
+        {"test_disk::snapshot", test_disk::snapshot},
+        {"test_disk::journal", test_disk::journal},
+        {"test_disk::watch", test_disk::watch},
+        {"test_disk::sharded", test_disk::sharded},
+        {"test_web::document", test_web::document},
     };
 
     // Get the test name from the command-line arguments
@@ -204,6 +327,330 @@ int test_args::invalid()
     }
 }
 
+int test_args::subcommands()
+{
+    try {
+        char test_executable_name[] = TEST_EXECUTABLE_NAME;
+
+        // Options may be given as "--key value" or "--key=value", and values are trimmed
+        {
+            char arg_add[] = "add";
+            char arg_name[] = "--name";
+            char arg_name_value[] = " Noriyaro ";
+            char arg_link[] = "--link=https://www.youtube.com/@noriyaro/videos";
+            char arg_desc[] = "--desc";
+            char arg_desc_value[] = "JP Drifting";
+            char *fake_argv[] = {test_executable_name, arg_add, arg_name, arg_name_value, arg_link, arg_desc, arg_desc_value};
+            const core::args::Args args(7, fake_argv);
+            if (args.get_command() != core::args::Command::Add ||
+                args.get_name() != "Noriyaro" ||
+                args.get_link() != "https://www.youtube.com/@noriyaro/videos" ||
+                args.get_description() != "JP Drifting") {
+                throw std::runtime_error("'add' options were not parsed");
+            }
+        }
+        {
+            char arg_ls[] = "ls";
+            char arg_format[] = "--format=tsv";
+            char *fake_argv[] = {test_executable_name, arg_ls, arg_format};
+            const core::args::Args args(3, fake_argv);
+            if (args.get_command() != core::args::Command::List || args.get_format() != core::args::ListFormat::Tsv) {
+                throw std::runtime_error("'ls' options were not parsed");
+            }
+        }
+        {
+            char arg_ls[] = "ls";
+            char arg_range[] = "--range=11-30";
+            char arg_fields[] = "--fields";
+            char arg_fields_value[] = "link,name";
+            char arg_format[] = "--format=compact";
+            char *fake_argv[] = {test_executable_name, arg_ls, arg_range, arg_fields, arg_fields_value, arg_format};
+            const core::args::Args args(6, fake_argv);
+            const core::args::ListOptions &options = args.get_list_options();
+            if (options.offset != 10 || options.limit != std::optional<std::size_t>(20) || options.format != core::args::ListFormat::Compact ||
+                options.fields != std::vector<core::args::Field>{core::args::Field::Link, core::args::Field::Name}) {
+                throw std::runtime_error("'ls' slice options were not parsed");
+            }
+        }
+        {
+            char arg_render[] = "render";
+            char *fake_argv[] = {test_executable_name, arg_render};
+            const core::args::Args args(2, fake_argv);
+            if (args.get_command() != core::args::Command::Render || args.get_output() != "-") {
+                throw std::runtime_error("'render' does not default to stdout");
+            }
+        }
+        {
+            char arg_render[] = "render";
+            char arg_format[] = "--format";
+            char arg_format_value[] = "md";
+            char arg_output[] = "table.md";
+            char *fake_argv[] = {test_executable_name, arg_render, arg_format, arg_format_value, arg_output};
+            const core::args::Args args(5, fake_argv);
+            if (args.get_render_format() != core::render::Format::Markdown || args.get_output() != "table.md") {
+                throw std::runtime_error("'render' options were not parsed");
+            }
+        }
+        fmt::print("core::args::Args() passed: subcommands parsed.\n");
+
+        // Missing, unknown and misplaced options must be rejected
+        char arg_add[] = "add";
+        char arg_remove[] = "remove";
+        char arg_ls[] = "ls";
+        char arg_name[] = "--name";
+        char arg_name_value[] = "Noriyaro";
+        char arg_link[] = "--link=https://www.youtube.com/@noriyaro";
+        char arg_format[] = "--format=xml";
+        char *missing_desc[] = {test_executable_name, arg_add, arg_name, arg_name_value, arg_link};
+        char *missing_value[] = {test_executable_name, arg_remove, arg_name};
+        char *wrong_command[] = {test_executable_name, arg_ls, arg_name, arg_name_value};
+        char *wrong_format[] = {test_executable_name, arg_ls, arg_format};
+        char arg_render[] = "render";
+        char *wrong_render_format[] = {test_executable_name, arg_render, arg_format};
+        char arg_limit[] = "--limit=-1";
+        char arg_range[] = "--range=20-11";
+        char arg_fields[] = "--fields=name,views";
+        char *wrong_limit[] = {test_executable_name, arg_ls, arg_limit};
+        char *wrong_range[] = {test_executable_name, arg_ls, arg_range};
+        char *wrong_fields[] = {test_executable_name, arg_ls, arg_fields};
+        const std::initializer_list<std::pair<int, char **>> invalid = {{5, missing_desc}, {3, missing_value}, {4, wrong_command}, {3, wrong_format}, {3, wrong_render_format}, {3, wrong_limit}, {3, wrong_range}, {3, wrong_fields}};
+        for (const auto &[argc, argv] : invalid) {
+            try {
+                const core::args::Args args(argc, argv);
+                throw std::runtime_error(fmt::format("Invalid arguments for '{}' were accepted", argv[1]));
+            }
+            catch (const core::args::ArgsError &) {
+            }
+        }
+        fmt::print("core::args::Args() passed: invalid subcommand options caught.\n");
+        return EXIT_SUCCESS;
+    }
+    catch (const std::exception &e) {
+        fmt::print(stderr, "core::args::Args() failed: {}\n", e.what());
+        return EXIT_FAILURE;
+    }
+}
+
+int test_backup::rotate()
+{
+    try {
+        // Get path to the resources directory
+        const auto temp_file = (core::paths::get_resources_directory(TEST_EXECUTABLE_NAME) / "test_backup.html");
+
+        // get_resources_directory will create the directory if it doesn't exist, but we want to ensure that tests are isolated
+        // TempDir removes the directory before creating it again
+        const helpers::TempDir temp_dir(std::filesystem::path(temp_file).parent_path());
+
+        // Read a whole file into a string
+        const auto read_file = [](const std::filesystem::path &path) {
+            std::ifstream file(path, std::ios::binary);
+            return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        };
+
+        // An unchanged file is backed up only once
+        core::io::save(temp_file, std::vector<core::io::Channel>{core::io::Channel("First", "https://www.youtube.com/@first", "One")});
+        if (!core::backup::create(temp_file) || core::backup::create(temp_file) || core::backup::list(temp_file).size() != 1) {
+            throw std::runtime_error("Unchanged file was backed up twice");
+        }
+
+        // Each change is a new generation, and the oldest ones are deleted
+        core::io::save(temp_file, std::vector<core::io::Channel>{core::io::Channel("Second", "https://www.youtube.com/@second", "Two")});
+        const std::string second = read_file(temp_file);
+        static_cast<void>(core::backup::create(temp_file, 2));
+        core::io::save(temp_file, std::vector<core::io::Channel>{core::io::Channel("Third", "https://www.youtube.com/@third", "Three")});
+        static_cast<void>(core::backup::create(temp_file, 2));
+        const std::vector<core::backup::Generation> generations = core::backup::list(temp_file);
+        if (generations.size() != 2 || generations[0].time <= generations[1].time || read_file(generations[1].path) != second) {
+            throw std::runtime_error(fmt::format("Expected the 2 newest of 3 generations, got {}", generations.size()));
+        }
+        if (core::backup::format_time(1792154820123) != "2026-10-16 12:47:00 UTC") {
+            throw std::runtime_error(fmt::format("Wrong time: {}", core::backup::format_time(1792154820123)));
+        }
+        fmt::print("core::backup::create() passed: unchanged files are skipped and old generations are deleted.\n");
+
+        // Restoring through the table reloads it, and keeps the replaced contents as the newest backup
+        {
+            modules::disk::Table table(temp_file);
+            const core::backup::Generation restored = table.restore(2);
+            if (read_file(temp_file) != second || table.get_channels().size() != 1 || table.get_channels().name(0) != "Second" || restored.path != generations[1].path) {
+                throw std::runtime_error("Table was not restored from the backup");
+            }
+            static_cast<void>(table.add(core::io::Channel("Added", "https://www.youtube.com/@added", "After restoring")));
+            table.flush();
+            if (core::io::load(temp_file, false).size() != 2) {
+                throw std::runtime_error("Restored table was not written to");
+            }
+        }
+        if (core::backup::list(temp_file).front().path != generations.front().path) {
+            throw std::runtime_error("Replaced contents were not kept as the newest backup");
+        }
+
+        // Corrupt backups and unknown numbers are rejected, leaving the file alone
+        const std::string before = read_file(temp_file);
+        std::ofstream(core::backup::list(temp_file).back().path, std::ios::binary | std::ios::app) << "<!-- damaged -->";
+        for (const std::size_t number : {std::size_t{0}, core::backup::list(temp_file).size(), std::size_t{100}}) {
+            try {
+                static_cast<void>(core::backup::restore(temp_file, number));
+                throw std::logic_error(fmt::format("Backup {} was restored", number));
+            }
+            catch (const std::runtime_error &) {
+            }
+        }
+        if (read_file(temp_file) != before) {
+            throw std::runtime_error("File was changed by a failed restore");
+        }
+        fmt::print("core::backup::restore() passed: backups are verified before restoring.\n");
+
+        return EXIT_SUCCESS;
+    }
+    catch (const std::exception &e) {
+        fmt::print(stderr, "core::backup failed: {}\n", e.what());
+        return EXIT_FAILURE;
+    }
+}
+
+int test_escape::round_trip()
+{
+    try {
+        // The first special character must be found wherever it is relative to the vector width
+        for (std::size_t size = 0; size <= 100; ++size) {
+            for (std::size_t pos = 0; pos <= size; ++pos) {
+                for (const char special : core::escape::special_characters) {
+                    std::string text(size, 'a');
+                    if (pos < size) {
+                        text[pos] = special;
+                    }
+                    if (core::escape::find_special(text) != pos) {
+                        throw std::runtime_error(fmt::format("Found the special character of a {}-byte text at {}, expected {}", size, core::escape::find_special(text), pos));
+                    }
+                }
+            }
+        }
+        fmt::print("core::escape::find_special() passed: special characters found at every offset.\n");
+
+        // Special characters are replaced, everything else (including UTF-8) is copied
+        if (core::escape::escape("Tom & Jerry <3 \"x\" 'y' > チャンネル") != "Tom &amp; Jerry &lt;3 &quot;x&quot; &#39;y&#39; &gt; チャンネル" || core::escape::escape("") != "") {
+            throw std::runtime_error("Escaped text does not match");
+        }
+        fmt::print("core::escape::escape() passed: special characters are replaced.\n");
+
+        // Known references are decoded, anything else is kept as-is
+        const std::vector<std::pair<std::string, std::string>> cases = {
+            {"Tom &amp; Jerry", "Tom & Jerry"},
+            {"&lt;&gt;&quot;&apos;&#39;&nbsp;", "<>\"''\xC2\xA0"},
+            {"&#x30CE;&#X30ce;&#12494;", "ノノノ"},
+            {"&#0;&#xD800;&#x110000;", "\xEF\xBF\xBD\xEF\xBF\xBD\xEF\xBF\xBD"},
+            {"Tom & Jerry; &copy; &amp &#; &#x; &#12a; &#123456789;", "Tom & Jerry; &copy; &amp &#; &#x; &#12a; &#123456789;"},
+            {"&amp;amp; &&amp;", "&amp; &&"},
+            {"&", "&"},
+        };
+        for (const auto &[text, expected] : cases) {
+            if (core::escape::unescape(text) != expected) {
+                throw std::runtime_error(fmt::format("Unescaped '{}' into '{}', expected '{}'", text, core::escape::unescape(text), expected));
+            }
+        }
+        fmt::print("core::escape::unescape() passed: {} cases decoded.\n", cases.size());
+
+        // Escaping then unescaping gives back any text, including text that looks escaped already
+        std::uint32_t state = 1;
+        constexpr std::string_view alphabet = "&<>\"';#xamplt ノ";
+        for (std::size_t i = 0; i < 2000; ++i) {
+            std::string text;
+            for (std::size_t j = 0; j < i % 80; ++j) {
+                state = state * 1103515245 + 12345;
+                text += alphabet[(state >> 16) % alphabet.size()];
+            }
+            if (core::escape::unescape(core::escape::escape(text)) != text) {
+                throw std::runtime_error(fmt::format("Text did not round-trip: '{}'", text));
+            }
+        }
+        fmt::print("core::escape passed: random texts round-trip.\n");
+
+        // Fields with special characters must survive the file, with both loaders
+        const auto temp_file = (core::paths::get_resources_directory(TEST_EXECUTABLE_NAME) / "test_escape.html");
+        const helpers::TempDir temp_dir(std::filesystem::path(temp_file).parent_path());
+        const std::vector<core::io::Channel> channels = {
+            core::io::Channel("<b>Bold</b>", "https://www.youtube.com/@bold?a=1&b=2", "Tags <td> and </td>"),
+            core::io::Channel("Noriyaro", "https://www.youtube.com/@noriyaro/videos", "JP Drifting"),
+            core::io::Channel("Tom & Jerry", "https://www.youtube.com/@tom\"jerry'", "Cat &amp; mouse &#x30CE;"),
+        };
+        core::io::save(temp_file, channels);
+        if (core::io::load(temp_file, false) != channels) {
+            throw std::runtime_error("Loaded channels do not match the original");
+        }
+        const core::io::MappedChannels mapped_channels(temp_file, false);
+        for (std::size_t i = 0; i < channels.size(); ++i) {
+            if (!(mapped_channels.channel(i) == channels[i])) {
+                throw std::runtime_error(fmt::format("Mapped channel {} does not match: {}", i, mapped_channels.name(i)));
+            }
+        }
+        fmt::print("core::io::save/load() passed: escaped fields read back unchanged.\n");
+
+        return EXIT_SUCCESS;
+    }
+    catch (const std::exception &e) {
+        fmt::print(stderr, "core::escape failed: {}\n", e.what());
+        return EXIT_FAILURE;
+    }
+}
+
+int test_gzip::compress()
+{
+    try {
+        // Check values of the CRC-32, also when combined from two parts
+        if (core::gzip::crc32("123456789") != 0xCBF43926 || core::gzip::crc32("") != 0) {
+            throw std::runtime_error("Wrong CRC-32");
+        }
+        if (core::gzip::crc32_combine(core::gzip::crc32("12345"), core::gzip::crc32("6789"), 4) != 0xCBF43926 || core::gzip::crc32_combine(0xCBF43926, 0, 0) != 0xCBF43926) {
+            throw std::runtime_error("Wrong combined CRC-32");
+        }
+        fmt::print("core::gzip::crc32() passed: check values match.\n");
+
+        // Pieces compressed separately are joined into one member, whose second piece refers back within itself (the bytes were checked with zlib)
+        std::string joined(core::gzip::header);
+        core::gzip::deflate(joined, "yt-table, ");
+        core::gzip::deflate(joined, "yt-table, yt-table");
+        core::gzip::append_trailer(joined, core::gzip::crc32("yt-table, yt-table, yt-table"), 28);
+        const std::string expected("\x1f\x8b\x08\x00\x00\x00\x00\x00\x00\xff"
+                                   "\xaa\x2c\xd1\x2d\x49\x4c\xca\x49\xd5\x51\x00\x00\x00\x00\xff\xff"
+                                   "\xaa\x2c\xd1\x2d\x49\x4c\xca\x49\xd5\x51\x80\xb1\x00\x00\x00\x00\xff\xff"
+                                   "\x03\x00\xa4\xa0\x02\x77\x1c\x00\x00\x00",
+                                   54);
+        if (joined != expected) {
+            throw std::runtime_error("Joined pieces differ from the expected bytes");
+        }
+        const std::string empty = core::gzip::compress("");
+        if (empty != std::string(core::gzip::header) + std::string("\x03\x00\x00\x00\x00\x00\x00\x00\x00\x00", 10)) {
+            throw std::runtime_error("Empty text differs from the expected bytes");
+        }
+        fmt::print("core::gzip::deflate() passed: pieces are joined into one member.\n");
+
+        // Repetitive markup shrinks a lot, and the trailer holds the CRC-32 and the size
+        std::string rows;
+        for (std::size_t i = 0; i < 1000; ++i) {
+            core::render::Html::append_row(rows, fmt::format("Channel {}", i), fmt::format("https://www.youtube.com/@channel{}", i), "Description");
+        }
+        const std::string compressed = core::gzip::compress(rows);
+        const auto read_word = [&compressed](const std::size_t offset) {
+            std::uint32_t word = 0;
+            for (std::size_t i = 0; i < 4; ++i) {
+                word |= static_cast<std::uint32_t>(static_cast<unsigned char>(compressed[offset + i])) << (8 * i);
+            }
+            return word;
+        };
+        if (compressed.size() * 4 > rows.size() || read_word(compressed.size() - 8) != core::gzip::crc32(rows) || read_word(compressed.size() - 4) != rows.size()) {
+            throw std::runtime_error(fmt::format("Compressed {} bytes into {} bytes, with a wrong trailer", rows.size(), compressed.size()));
+        }
+        fmt::print("core::gzip::compress() passed: {} bytes of rows compressed into {} bytes.\n", rows.size(), compressed.size());
+
+        return EXIT_SUCCESS;
+    }
+    catch (const std::exception &e) {
+        fmt::print(stderr, "core::gzip failed: {}\n", e.what());
+        return EXIT_FAILURE;
+    }
+}
+
 int test_html::save_load()
 {
     try {
@@ -244,96 +691,1917 @@ int test_html::save_load()
     }
 }
 
-int test_shell::build_command()
+int test_html::scan_rows()
 {
     try {
-        const std::vector<std::string> test_paths = {
-            "~/data.html",
-            "/Users/USER/Library/Application Support/yt-table/Resources/subscriptions.html",
-            "C:\\Program Files",
-            "C:\\Program Files (x86)",
-            "C:\\Users\\USER\\AppData\\Local\\yt-table\\Resources\\subscriptions.html",
-            "~/ダタ.html",  // Japanese characters
-        };
-        // Define platform-specific commands
-        const std::vector<std::string> possible_beginnings = {"open", "xdg-open", "start"};
+        // Header row, uppercase tags, extra attributes in any order, and whitespace between tags must all be accepted
+        const std::string text =
+            "<table>\n"
+            "  <tr><th>Name</th><th>Description</th></tr>\n"
+            "  <TR>\n"
+            "    <TD><A class=\"x\" HREF=\"https://www.youtube.com/@noriyaro/videos\" target=\"_blank\">Noriyaro</A></TD>\n"
+            "    <td>JP Drifting</td>\n"
+            "  </tr>\n"
+            "  <tr><td>A note row without a link</td><td>x</td></tr>\n"
+            "  <tr><td><a href=\"https://www.youtube.com/@empty\">Empty description</a></td><td></td></tr>\n"
+            "  <tr><td><a class=\"x\">No href</a></td><td>x</td></tr>\n"
+            "  <tr><td><a href=\"https://www.youtube.com/@channel/videos\">チャンネル</a></td><td>日本語</td></tr>\n"
+            "</table>\n";
 
-        for (const auto &path : test_paths) {
-            const std::string command = core::shell::build_command(path);
+        // Rows that are not channel rows (no link, an empty description or no "href") are skipped, like the regex the scanner replaced did
+        const std::vector<core::html::Row> rows = core::html::scan_rows(text);
+        if (rows.size() != 2) {
+            throw std::runtime_error(fmt::format("Expected 2 rows, got {}", rows.size()));
+        }
+        if (rows[0].link != "https://www.youtube.com/@noriyaro/videos" || rows[0].name != "Noriyaro" || rows[0].description != "JP Drifting") {
+            throw std::runtime_error("First row does not match");
+        }
+        if (rows[1].link != "https://www.youtube.com/@channel/videos" || rows[1].name != "チャンネル" || rows[1].description != "日本語") {
+            throw std::runtime_error("Second row does not match");
+        }
 
-            // Check if the command begins with one of the possible commands
-            if (!std::any_of(possible_beginnings.cbegin(), possible_beginnings.cend(),
-                             [&command](const std::string &beginning) { return command.rfind(beginning, 0) == 0; })) {
-                throw std::runtime_error("Build command '" + command + "' does not begin with a valid platform-specific command");
-            }
+        // The byte range must cover the row from "<tr>" to "</tr>"
+        const std::string_view first(text.data() + rows[0].begin, rows[0].end - rows[0].begin);
+        if (first.substr(0, 4) != "<TR>" || first.substr(first.size() - 5) != "</tr>") {
+            throw std::runtime_error("Row byte range does not match");
+        }
 
-            // Extract the path from the command (assuming the path is after the first space)
-            const auto first_space_pos = command.find(' ');
-            if (first_space_pos == std::string::npos) {
-                throw std::runtime_error("No path found in command '" + command + "'");
+        fmt::print("core::html::scan_rows() passed: scanned {} rows.\n", rows.size());
+        return EXIT_SUCCESS;
+    }
+    catch (const std::exception &e) {
+        fmt::print(stderr, "core::html::scan_rows() failed: {}\n", e.what());
+        return EXIT_FAILURE;
+    }
+}
+
+int test_html::parse_error()
+{
+    try {
+        // The second row is missing its "</td>" on line 3, column 59
+        const std::string text =
+            "<tr><td><a href=\"https://www.youtube.com/@noriyaro/videos\">Noriyaro</a></td><td>JP Drifting</td></tr>\n"
+            "<tr>\n"
+            "<td><a href=\"https://www.youtube.com/@channel\">Channel</a><td>Description</td></tr>\n";
+
+        try {
+            static_cast<void>(core::html::scan_rows(text));
+        }
+        catch (const core::html::ParseError &e) {
+            if (e.get_line() != 3 || e.get_column() != 59) {
+                throw std::runtime_error(fmt::format("Unexpected error position: {}", e.what()));
             }
+            fmt::print("core::html::scan_rows() passed: malformed row reported: {}\n", e.what());
+            return EXIT_SUCCESS;
+        }
+        throw std::runtime_error("Malformed row was not reported");
+    }
+    catch (const std::exception &e) {
+        fmt::print(stderr, "core::html::scan_rows() failed: {}\n", e.what());
+        return EXIT_FAILURE;
+    }
+}
 
-            const std::string extracted_path = command.substr(first_space_pos + 1);
+int test_html::mapped_load()
+{
+    try {
+        // Get path to the resources directory
+        const auto temp_file = (core::paths::get_resources_directory(TEST_EXECUTABLE_NAME) / "test_mapped.html");
 
-            // Check if the extracted path is wrapped in quotes
-            if (extracted_path.front() != '"' || extracted_path.back() != '"') {
-                throw std::runtime_error("Path in built command '" + command + "' is not wrapped in quotes");
+        // get_resources_directory will create the directory if it doesn't exist, but we want to ensure that tests are isolated
+        // TempDir removes the directory before creating it again
+        const helpers::TempDir temp_dir(std::filesystem::path(temp_file).parent_path());
+
+        // Save the channels in reverse order, so the mapped loader has to sort them
+        const std::vector<core::io::Channel> channels = {
+            core::io::Channel("チャンネル", "https://www.youtube.com/@channel/videos", "日本語"),  // Japanese characters
+            core::io::Channel("Noriyaro", "https://www.youtube.com/@noriyaro/videos", "JP Drifting"),
+            core::io::Channel("Engineering Explained", "https://www.youtube.com/@EngineeringExplained", "Car Engineering"),
+        };
+        core::io::save(temp_file, channels);
+
+        // The mapped loader must return the same channels as the regular loader
+        const auto loaded_channels = core::io::load(temp_file, false);
+        const core::io::MappedChannels mapped_channels(temp_file, false);
+        if (mapped_channels.size() != loaded_channels.size()) {
+            throw std::runtime_error(fmt::format("Expected {} channels, got {}", loaded_channels.size(), mapped_channels.size()));
+        }
+        for (std::size_t i = 0; i < mapped_channels.size(); ++i) {
+            if (!(mapped_channels.channel(i) == loaded_channels[i])) {
+                throw std::runtime_error(fmt::format("Channel {} does not match: {}", i, mapped_channels.name(i)));
             }
         }
-        fmt::print("core::shell::impl::build_command() passed: built platform-specific command for paths.\n");
+        fmt::print("core::io::MappedChannels() passed: mapped channels match the loaded channels.\n");
+
+        // Fields with character references are decoded on first access, and later accesses must return the same view
+        core::io::save(temp_file, {core::io::Channel("Tom & Jerry", "https://www.youtube.com/@tom&jerry", "Cats & Mice")});
+        const core::io::MappedChannels escaped_channels(temp_file, false);
+        const std::string_view link = escaped_channels.link(0);
+        const std::string_view description = escaped_channels.description(0);
+        if (link != "https://www.youtube.com/@tom&jerry" || description != "Cats & Mice") {
+            throw std::runtime_error(fmt::format("Escaped fields were not decoded: '{}', '{}'", link, description));
+        }
+        if (escaped_channels.link(0).data() != link.data() || escaped_channels.description(0).data() != description.data()) {
+            throw std::runtime_error("Escaped fields were decoded again on a later access");
+        }
+        fmt::print("core::io::MappedChannels() passed: escaped fields decoded once on first access.\n");
+
+        // An empty file cannot be mapped, but must still load as an empty table
+        std::filesystem::resize_file(temp_file, 0);
+        if (core::io::MappedChannels(temp_file, false).size() != 0) {
+            throw std::runtime_error("Empty file loaded as a non-empty table");
+        }
+        fmt::print("core::io::MappedChannels() passed: empty file loaded as an empty table.\n");
+
         return EXIT_SUCCESS;
     }
     catch (const std::exception &e) {
-        fmt::print(stderr, "core::shell::impl::build_command() failed: {}\n", e.what());
+        fmt::print(stderr, "core::io::MappedChannels() failed: {}\n", e.what());
         return EXIT_FAILURE;
     }
 }
 
-int test_strings::trim_whitespace()
+int test_html::atomic_save()
 {
     try {
-        const std::string test_string = "  hello  ";
-        const std::string trimmed_string = core::strings::trim_whitespace(test_string);
-        if (trimmed_string != "hello") {
-            throw std::runtime_error("Trimmed string does not match expected value");
+        // Get path to the resources directory
+        const auto temp_file = (core::paths::get_resources_directory(TEST_EXECUTABLE_NAME) / "test_atomic.html");
+
+        // get_resources_directory will create the directory if it doesn't exist, but we want to ensure that tests are isolated
+        // TempDir removes the directory before creating it again
+        const helpers::TempDir temp_dir(std::filesystem::path(temp_file).parent_path());
+
+        const std::vector<core::io::Channel> channels = {
+            core::io::Channel("Noriyaro", "https://www.youtube.com/@noriyaro/videos", "JP Drifting"),
+        };
+
+        // Every durability level must produce the same, loadable file
+        for (const auto durability : {core::io::Durability::None, core::io::Durability::Data, core::io::Durability::Full}) {
+            core::io::save(temp_file, channels, durability);
+            if (core::io::load(temp_file, false) != channels) {
+                throw std::runtime_error("Loaded channels do not match the original");
+            }
         }
-        fmt::print("core::strings::trim_whitespace() passed: trimmed whitespace from '{}'.\n", test_string);
-        return EXIT_SUCCESS;
+
+        // The temporary file must be renamed over the target, so it must be the only file left behind
+        std::size_t files = 0;
+        for (const auto &entry : std::filesystem::directory_iterator(temp_dir.get())) {
+            if (entry.path() != temp_file) {
+                throw std::runtime_error(fmt::format("Unexpected file left behind: {}", entry.path().string()));
+            }
+            ++files;
+        }
+        if (files != 1) {
+            throw std::runtime_error("Saved file is missing");
+        }
+        fmt::print("core::io::save() passed: file replaced atomically at every durability level.\n");
+
+        // Saving into a directory that doesn't exist must fail without creating anything
+        try {
+            core::io::save(temp_dir.get() / "missing" / "test.html", channels);
+        }
+        catch (const std::runtime_error &e) {
+            fmt::print("core::io::save() passed: failed write reported: {}\n", e.what());
+            return EXIT_SUCCESS;
+        }
+        throw std::runtime_error("Write into a missing directory did not fail");
     }
     catch (const std::exception &e) {
-        fmt::print(stderr, "core::strings::trim_whitespace() failed: {}\n", e.what());
+        fmt::print(stderr, "core::io::save() failed: {}\n", e.what());
         return EXIT_FAILURE;
     }
 }
 
-int test_disk::save_load()
+int test_html::parallel_load()
 {
     try {
         // Get path to the resources directory
-        const auto temp_file = (core::paths::get_resources_directory(TEST_EXECUTABLE_NAME) / "test_table.html");
+        const auto temp_file = (core::paths::get_resources_directory(TEST_EXECUTABLE_NAME) / "test_parallel.html");
 
         // get_resources_directory will create the directory if it doesn't exist, but we want to ensure that tests are isolated
         // TempDir removes the directory before creating it again
         const helpers::TempDir temp_dir(std::filesystem::path(temp_file).parent_path());
 
-        // Create a table at the temporary file path
-        modules::disk::Table table(temp_file);
-        fmt::print("modules::disk::Table() passed: created table at {}.\n", temp_file.string());
+        // Write rows out of order, with repeated names (whose order must be kept) and "<tr><td>" inside links (which must not be taken for rows); the links are padded so the file is split into chunks of at least 1 MiB, most of which start inside a link
+        const std::string padding(48 << 10, 'q');
+        std::string text = "<table>\n<tr><th>Name</th><th>Description</th></tr>\n";
+        for (std::size_t i = 0; i < 500; ++i) {
+            const std::size_t id = (i * 7919) % 500;
+            const std::string link = (i % 3 == 0) ? fmt::format("https://www.youtube.com/@channel{}?q={}<tr><td><tr><td>", id, padding) : fmt::format("https://www.youtube.com/@channel{}", id);
+            text += fmt::format("<tr><td><a href=\"{}\">Channel {}</a></td><td>Row {}</td></tr>\n", link, id % 100, i);
+        }
+        text += "</table>\n";
+        std::ofstream(temp_file, std::ios::binary) << text;
 
-        // Add a channel to the table
-        table.add(core::io::Channel("Noriyaro", "https://www.youtube.com/@noriyaro/videos", "JP Drifting"));
-        fmt::print("modules::disk::Table::add() passed: added channel to the table.\n");
+        // Every thread count must produce the same channels and layout as a single thread
+        const std::vector<core::io::Channel> expected = core::io::load(temp_file, false, 1);
+        const core::io::MappedChannels expected_mapped(temp_file, false, 1);
+        if (expected.size() != 500 || expected_mapped.size() != 500) {
+            throw std::runtime_error(fmt::format("Expected 500 channels, got {} and {}", expected.size(), expected_mapped.size()));
+        }
+        for (const std::size_t threads : std::initializer_list<std::size_t>{2, 3, 7, 64}) {
+            if (core::io::load(temp_file, false, threads) != expected) {
+                throw std::runtime_error(fmt::format("Channels loaded with {} threads do not match", threads));
+            }
+            const core::io::MappedChannels mapped(temp_file, false, threads);
+            if (mapped.size() != expected_mapped.size()) {
+                throw std::runtime_error(fmt::format("Expected {} mapped channels with {} threads, got {}", expected_mapped.size(), threads, mapped.size()));
+            }
+            for (std::size_t i = 0; i < mapped.size(); ++i) {
+                if (!(mapped.channel(i) == expected_mapped.channel(i))) {
+                    throw std::runtime_error(fmt::format("Mapped channel {} loaded with {} threads does not match: {}", i, threads, mapped.name(i)));
+                }
+            }
+            const std::optional<core::io::Layout> layout = mapped.get_layout();
+            const std::optional<core::io::Layout> expected_layout = expected_mapped.get_layout();
+            if (layout.has_value() != expected_layout.has_value() || (layout && (layout->rows_end != expected_layout->rows_end || layout->rows.size() != expected_layout->rows.size()))) {
+                throw std::runtime_error(fmt::format("Layout with {} threads does not match", threads));
+            }
+        }
+        fmt::print("core::io::load() passed: every thread count matches a single thread.\n");
 
-        // Remove the channel from the table
-        if (!table.remove("Noriyaro")) {
-            throw std::runtime_error("Failed to remove the channel from the table");
+        // A malformed row must be reported the same way, even with another malformed row after it
+        const std::size_t middle = text.find("<tr><td>", text.size() / 2);
+        text.insert(text.rfind("</table>"), "<tr><td><a href=\"https://www.youtube.com/@late\">Late</a></td></tr>\n");
+        text.insert(middle, "<tr><td><a href=\"https://www.youtube.com/@broken\">Broken</a><td>Row</td></tr>\n");
+        std::ofstream(temp_file, std::ios::binary | std::ios::trunc) << text;
+        const auto get_error = [&temp_file](const std::size_t threads) {
+            try {
+                static_cast<void>(core::io::load(temp_file, false, threads));
+            }
+            catch (const std::runtime_error &e) {
+                return std::string(e.what());
+            }
+            throw std::runtime_error(fmt::format("Malformed row was not reported with {} threads", threads));
+        };
+        const std::string expected_error = get_error(1);
+        for (const std::size_t threads : std::initializer_list<std::size_t>{2, 3, 7, 64}) {
+            const std::string error = get_error(threads);
+            if (error != expected_error) {
+                throw std::runtime_error(fmt::format("Error with {} threads does not match: {}", threads, error));
+            }
         }
-        fmt::print("modules::disk::Table::remove() passed: removed channel from the table.\n");
+        fmt::print("core::io::load() passed: every thread count reports the first malformed row: {}\n", expected_error);
 
         return EXIT_SUCCESS;
     }
     catch (const std::exception &e) {
-        fmt::print(stderr, "modules::disk::Table() failed: {}\n", e.what());
+        fmt::print(stderr, "core::io::load() failed: {}\n", e.what());
+        return EXIT_FAILURE;
+    }
+}
+
+int test_html::row_cache()
+{
+    try {
+        // Get path to the resources directory
+        const auto temp_file = (core::paths::get_resources_directory(TEST_EXECUTABLE_NAME) / "test_row_cache.html");
+
+        // get_resources_directory will create the directory if it doesn't exist, but we want to ensure that tests are isolated
+        // TempDir removes the directory before creating it again
+        const helpers::TempDir temp_dir(std::filesystem::path(temp_file).parent_path());
+
+        core::store::ChannelStore channels;
+        for (std::size_t i = 0; i < 100; ++i) {
+            static_cast<void>(channels.insert(fmt::format("Channel {:03}", i), fmt::format("https://www.youtube.com/@channel{}", i), fmt::format("Description {}", i)));
+        }
+
+        // The saved file and its layout must match a save without the cache, however many rows were reused
+        core::io::RowCache cache;
+        const auto check = [&](const std::size_t rendered_rows) {
+            const core::io::Layout layout = core::io::save(temp_file, channels, cache, core::io::Durability::None);
+            const std::string expected = core::io::render(channels);
+            const core::io::Layout expected_layout = core::io::save(temp_dir.get() / "expected.html", channels, core::io::Durability::None);
+            if (std::string(core::io::MappedFile(temp_file).view()) != expected) {
+                throw std::runtime_error("Saved file differs from the rendered table");
+            }
+            if (layout.rows_end != expected_layout.rows_end || layout.rows.size() != expected_layout.rows.size() ||
+                !std::equal(layout.rows.cbegin(), layout.rows.cend(), expected_layout.rows.cbegin(), [](const core::io::ByteRange &a, const core::io::ByteRange &b) { return a.begin == b.begin && a.end == b.end; })) {
+                throw std::runtime_error("Layout differs from a save without the cache");
+            }
+            if (cache.get_rendered_rows() != rendered_rows) {
+                throw std::runtime_error(fmt::format("Expected {} rows to be rendered, got {}", rendered_rows, cache.get_rendered_rows()));
+            }
+        };
+        check(100);
+        check(0);
+        fmt::print("core::io::RowCache passed: unchanged rows are not rendered again.\n");
+
+        // Only new rows are rendered, whether inserted one at a time or in bulk; the new channel takes the slot of the removed one, whose row must not be reused
+        const std::uint32_t removed_slot = channels.slot(10);
+        cache.erase(removed_slot);
+        channels.erase(10);
+        const std::size_t inserted = channels.insert("Channel 050a", "https://www.youtube.com/@channel50a", "Inserted");
+        if (channels.slot(inserted) != removed_slot || channels.slot(inserted - 1) != 50) {
+            throw std::runtime_error("Slots were not kept stable by the store");
+        }
+        const std::vector<std::size_t> indices = channels.insert(std::vector<core::store::ChannelView>{
+            core::store::ChannelView{"Channel 999", "https://www.youtube.com/@channel999", "Last"},
+            core::store::ChannelView{"Channel 000", "https://www.youtube.com/@channel0b", "Equal names keep their order"},
+            core::store::ChannelView{"A channel", "https://www.youtube.com/@a", "First"},
+        });
+        if (indices != std::vector<std::size_t>{0, 2, 102} || channels.link(2) != "https://www.youtube.com/@channel0b") {
+            throw std::runtime_error("Bulk insert returned the wrong indices");
+        }
+        check(4);
+        fmt::print("core::io::RowCache passed: only inserted rows are rendered.\n");
+
+        // Removing most rows compacts the arena, and resetting the cache renders every row again
+        for (std::size_t i = 90; i > 10; --i) {
+            cache.erase(channels.slot(i));
+            channels.erase(i);
+        }
+        check(0);
+        cache.reset();
+        check(channels.size());
+        fmt::print("core::io::RowCache passed: rows intact after compaction and reset.\n");
+
+        return EXIT_SUCCESS;
+    }
+    catch (const std::exception &e) {
+        fmt::print(stderr, "core::io::RowCache failed: {}\n", e.what());
+        return EXIT_FAILURE;
+    }
+}
+
+int test_html::virtual_page()
+{
+    try {
+        // Get path to the resources directory
+        const auto temp_file = (core::paths::get_resources_directory(TEST_EXECUTABLE_NAME) / "test_virtual_page.html");
+        const auto expected_file = (core::paths::get_resources_directory(TEST_EXECUTABLE_NAME) / "test_virtual_page_expected.html");
+
+        // get_resources_directory will create the directory if it doesn't exist, but we want to ensure that tests are isolated
+        // TempDir removes the directory before creating it again
+        const helpers::TempDir temp_dir(std::filesystem::path(temp_file).parent_path());
+
+        // The page must not contain anything that the loader would take for a row
+        if (core::render::VirtualHtml::header.find("<tr") != std::string_view::npos || core::render::VirtualHtml::footer.find("<tr") != std::string_view::npos) {
+            throw std::runtime_error("Page contains a row tag outside of the rows");
+        }
+
+        // A small table exported as a virtualized page loads back like the static one
+        core::store::ChannelStore channels;
+        static_cast<void>(channels.insert("Noriyaro", "https://www.youtube.com/@noriyaro/videos", "JP Drifting"));
+        static_cast<void>(channels.insert("Donut", "https://www.youtube.com/@donut", "Car culture &amp; more"));
+        core::io::write_file(temp_file, core::render::render(channels, core::render::Format::VirtualHtml), core::io::Durability::None);
+        const std::vector<core::io::Channel> small = core::io::load(temp_file, false);
+        if (small.size() != 2 || !(small[0] == core::io::Channel("Donut", "https://www.youtube.com/@donut", "Car culture &amp; more")) || small[1].name != "Noriyaro") {
+            throw std::runtime_error("Channels differ after loading a virtualized page");
+        }
+        fmt::print("core::render::VirtualHtml passed: page loaded back.\n");
+
+        // Above the threshold, "save" switches to the virtualized page, and the file loads back
+        for (std::size_t i = 0; i < core::io::virtual_threshold; ++i) {
+            static_cast<void>(channels.insert(fmt::format("Channel {:05}", i), fmt::format("https://www.youtube.com/@channel{}", i), fmt::format("Description {}", i)));
+        }
+        static_cast<void>(core::io::save(temp_file, channels, core::io::Durability::None));
+        const std::string saved(core::io::MappedFile(temp_file).view());
+        if (saved.compare(0, core::render::VirtualHtml::header.size(), core::render::VirtualHtml::header) != 0 || saved != core::io::render(channels)) {
+            throw std::runtime_error("Large table was not saved as a virtualized page");
+        }
+        if (core::io::load(temp_file, false).size() != channels.size()) {
+            throw std::runtime_error("Channels differ after loading a large virtualized page");
+        }
+        fmt::print("core::io::save() passed: large table saved as a virtualized page.\n");
+
+        // Edits are compacted into a virtualized page, matching a full rewrite
+        {
+            modules::disk::Table table(temp_file);
+            static_cast<void>(table.add(core::io::Channel("Engineering Explained", "https://www.youtube.com/@EngineeringExplained", "Car Engineering")));
+            if (!table.remove("Channel 05000")) {
+                throw std::runtime_error("Failed to remove the channel from the table");
+            }
+            table.flush();
+            static_cast<void>(core::io::save(expected_file, table.get_channels(), core::io::Durability::None));
+            if (std::string(core::io::MappedFile(temp_file).view()) != std::string(core::io::MappedFile(expected_file).view())) {
+                throw std::runtime_error("File does not match a full rewrite after editing");
+            }
+        }
+        fmt::print("modules::disk::Table passed: edits compacted into a virtualized page.\n");
+
+        return EXIT_SUCCESS;
+    }
+    catch (const std::exception &e) {
+        fmt::print(stderr, "core::render::VirtualHtml failed: {}\n", e.what());
+        return EXIT_FAILURE;
+    }
+}
+
+int test_http::parse_request()
+{
+    try {
+        // Pipelined requests are parsed one at a time, and header names are matched in any case
+        const std::string pipelined = "GET /?view=1 HTTP/1.1\r\n"
+                                      "Host: 127.0.0.1\r\n"
+                                      "accept-encoding: br, GZIP;q=0.5\r\n"
+                                      "If-None-Match: W/\"abc\"\r\n"
+                                      "\r\n"
+                                      "HEAD /events HTTP/1.0\r\n"
+                                      "\r\n";
+        core::http::Request request;
+        const std::optional<std::size_t> first = core::http::parse_request(pipelined, request);
+        if (!first || *first != pipelined.find("HEAD") || request.method != "GET" || request.path != "/" || !request.accepts_gzip || !request.keep_alive || !core::http::matches_etag(request.if_none_match, "\"abc\"")) {
+            throw std::runtime_error("First request was not parsed");
+        }
+        const std::optional<std::size_t> second = core::http::parse_request(std::string_view(pipelined).substr(*first), request);
+        if (!second || *first + *second != pipelined.size() || request.method != "HEAD" || request.path != "/events" || request.accepts_gzip || request.keep_alive) {
+            throw std::runtime_error("Second request was not parsed");
+        }
+        if (core::http::parse_request("GET / HTTP/1.1\r\nHost: 127.0.0.1\r\n", request)) {
+            throw std::runtime_error("Incomplete request was parsed");
+        }
+        fmt::print("core::http::parse_request() passed: pipelined requests are parsed.\n");
+
+        // Headers that change the response
+        const auto parse = [](const std::string &headers) {
+            core::http::Request parsed;
+            static_cast<void>(core::http::parse_request("GET / HTTP/1.1\r\n" + headers + "\r\n", parsed));
+            return parsed;
+        };
+        if (parse("Accept-Encoding: gzip;q=0\r\n").accepts_gzip || parse("Accept-Encoding: identity\r\n").accepts_gzip || !parse("Accept-Encoding: *\r\n").accepts_gzip) {
+            throw std::runtime_error("Accept-Encoding was misread");
+        }
+        if (parse("Connection: close\r\n").keep_alive || !parse("Connection: keep-alive\r\n").keep_alive) {
+            throw std::runtime_error("Connection was misread");
+        }
+        if (!core::http::matches_etag("\"a\", \"b\"", "\"b\"") || !core::http::matches_etag("*", "\"b\"") || core::http::matches_etag("\"a\"", "\"b\"")) {
+            throw std::runtime_error("If-None-Match was misread");
+        }
+        fmt::print("core::http::parse_request() passed: headers are read.\n");
+
+        // Malformed, unsupported and oversized requests are rejected
+        for (const std::string &invalid : {std::string("GET\r\n\r\n"), std::string("GET / HTTP/2\r\n\r\n"), std::string("GET http://example.com/ HTTP/1.1\r\n\r\n"), std::string("GET / HTTP/1.1\r\nNo colon\r\n\r\n"), std::string("POST / HTTP/1.1\r\nContent-Length: 5\r\n\r\nhello"), std::string("GET / HTTP/1.1\r\n") + std::string(core::http::max_request_size, 'x')}) {
+            bool rejected = false;
+            try {
+                static_cast<void>(core::http::parse_request(invalid, request));
+            }
+            catch (const std::invalid_argument &) {
+                rejected = true;
+            }
+            if (!rejected) {
+                throw std::runtime_error(fmt::format("Invalid request was accepted: {}", invalid.substr(0, 40)));
+            }
+        }
+        std::string status;
+        core::http::append_status_line(status, 304);
+        if (status != "HTTP/1.1 304 Not Modified\r\n") {
+            throw std::runtime_error(fmt::format("Wrong status line: {}", status));
+        }
+        fmt::print("core::http::parse_request() passed: invalid requests are rejected.\n");
+
+        return EXIT_SUCCESS;
+    }
+    catch (const std::exception &e) {
+        fmt::print(stderr, "core::http failed: {}\n", e.what());
+        return EXIT_FAILURE;
+    }
+}
+
+int test_import::read()
+{
+    try {
+        // Get path to the resources directory
+        const auto temp_directory = core::paths::get_resources_directory(TEST_EXECUTABLE_NAME);
+
+        // get_resources_directory will create the directory if it doesn't exist, but we want to ensure that tests are isolated
+        // TempDir removes the directory before creating it again
+        const helpers::TempDir temp_dir(temp_directory);
+
+        // Read a file with every chunk size from a single byte up, so that every record straddles a chunk boundary at some point
+        const auto read_all = [](const std::filesystem::path &path,
+                                 const std::string &content) {
+            {
+                std::ofstream file(path, std::ios::binary);
+                file << content;
+            }
+            const std::optional<core::import::Format> format = core::import::detect_format(path);
+            if (!format) {
+                throw std::runtime_error(fmt::format("Format of '{}' not detected", path.string()));
+            }
+            std::vector<core::import::Record> expected;
+            for (const std::size_t chunk_size : {std::size_t{1}, std::size_t{2}, std::size_t{7}, std::size_t{64 * 1024}}) {
+                std::vector<core::import::Record> records;
+                std::size_t last_bytes = 0;
+                core::import::read(
+                    path, *format, [&records](const core::import::Record &record) { records.push_back(record); },
+                    [&last_bytes](const core::import::Progress &progress) { last_bytes = static_cast<std::size_t>(progress.bytes_read); },
+                    chunk_size);
+                if (last_bytes != content.size()) {
+                    throw std::runtime_error(fmt::format("Progress ended at {} of {} bytes", last_bytes, content.size()));
+                }
+                if (chunk_size == 1) {
+                    expected = records;
+                    continue;
+                }
+                for (std::size_t i = 0; i < records.size() && records.size() == expected.size(); ++i) {
+                    if (!(records[i].channel == expected[i].channel) || records[i].line != expected[i].line || records[i].error != expected[i].error) {
+                        throw std::runtime_error(fmt::format("Record {} differs with a chunk size of {}", i, chunk_size));
+                    }
+                }
+                if (records.size() != expected.size()) {
+                    throw std::runtime_error(fmt::format("Expected {} records with a chunk size of {}, got {}", expected.size(), chunk_size, records.size()));
+                }
+            }
+            return expected;
+        };
+
+        // CSV from Google Takeout, with a BOM, CRLF, a quoted comma, an escaped quote and a quoted line break
+        const std::vector<core::import::Record> csv = read_all(temp_directory / "subscriptions.csv",
+                                                               "\xEF\xBB\xBF"
+                                                               "Channel Id,Channel Url,Channel Title\r\n"
+                                                               "UCabc,http://www.youtube.com/channel/UCabc,Noriyaro\r\n"
+                                                               "UCdef,,\"Tom, \"\"Jerry\"\"\"\r\n"
+                                                               "\r\n"
+                                                               "UCghi,http://www.youtube.com/channel/UCghi,\"Two\nLines\"\r\n"
+                                                               ",,\r\n");
+        if (csv.size() != 4 ||
+            !(csv[0].channel == core::io::Channel("Noriyaro", "http://www.youtube.com/channel/UCabc", "")) ||
+            !(csv[1].channel == core::io::Channel("Tom, \"Jerry\"", "https://www.youtube.com/channel/UCdef", "")) ||
+            csv[2].channel.name != "Two\nLines" || csv[2].line != 5 ||
+            csv[3].error != "missing name" || csv[3].line != 7) {
+            throw std::runtime_error("CSV records do not match");
+        }
+        fmt::print("core::import::read() passed: CSV read.\n");
+
+        // JSON Lines, with escapes, a surrogate pair, ignored values and an invalid line
+        const std::vector<core::import::Record> jsonl = read_all(temp_directory / "subscriptions.jsonl",
+                                                                 "{\"name\": \"Noriyaro\", \"url\": \"https://www.youtube.com/@noriyaro\", \"description\": \"JP \\\"Drifting\\\"\"}\n"
+                                                                 "{\"title\": \"\\u30CE\\uD83D\\uDE97\", \"channel_id\": \"UCabc\", \"videos\": [1, {\"a\": \"]\"}], \"live\": false}\n"
+                                                                 "\n"
+                                                                 "{\"name\": \"Broken\n");
+        if (jsonl.size() != 3 ||
+            !(jsonl[0].channel == core::io::Channel("Noriyaro", "https://www.youtube.com/@noriyaro", "JP \"Drifting\"")) ||
+            !(jsonl[1].channel == core::io::Channel("\xE3\x83\x8E\xF0\x9F\x9A\x97", "https://www.youtube.com/channel/UCabc", "")) ||
+            jsonl[2].error.empty() || jsonl[2].line != 4) {
+            throw std::runtime_error("JSON Lines records do not match");
+        }
+        fmt::print("core::import::read() passed: JSON Lines read.\n");
+
+        // OPML from a feed reader, with a folder, entities, a comment and a feed URL
+        const std::vector<core::import::Record> opml = read_all(temp_directory / "subscriptions.opml",
+                                                                "<?xml version=\"1.0\"?>\n"
+                                                                "<opml version=\"1.1\"><body>\n"
+                                                                "<!-- <outline text=\"Commented\" htmlUrl=\"https://example.com\"/> -->\n"
+                                                                "<outline text=\"YouTube\" title=\"YouTube\">\n"
+                                                                "  <outline text=\"Tom &amp; Jerry &#x30CE;\" htmlUrl='https://www.youtube.com/@tom?a=1&amp;b=2'/>\n"
+                                                                "  <outline title=\"Noriyaro\" type=\"rss\"\n"
+                                                                "           xmlUrl=\"https://www.youtube.com/feeds/videos.xml?channel_id=UCabc\"/>\n"
+                                                                "</outline>\n"
+                                                                "</body></opml>\n");
+        if (opml.size() != 2 ||
+            !(opml[0].channel == core::io::Channel("Tom & Jerry \xE3\x83\x8E", "https://www.youtube.com/@tom?a=1&b=2", "")) || opml[0].line != 5 ||
+            !(opml[1].channel == core::io::Channel("Noriyaro", "https://www.youtube.com/channel/UCabc", "")) || opml[1].line != 6) {
+            throw std::runtime_error("OPML records do not match");
+        }
+        fmt::print("core::import::read() passed: OPML read.\n");
+
+        // An unterminated quote at the end of the file is reported as an invalid record
+        const std::vector<core::import::Record> unterminated = read_all(temp_directory / "unterminated.csv", "Noriyaro,https://www.youtube.com/@noriyaro,\"JP\n");
+        if (unterminated.size() != 1 || unterminated[0].error.empty()) {
+            throw std::runtime_error("Unterminated quote was not reported");
+        }
+        if (core::import::detect_format("subscriptions.txt")) {
+            throw std::runtime_error("Unknown extension was detected");
+        }
+        fmt::print("core::import::read() passed: invalid input reported.\n");
+
+        return EXIT_SUCCESS;
+    }
+    catch (const std::exception &e) {
+        fmt::print(stderr, "core::import::read() failed: {}\n", e.what());
+        return EXIT_FAILURE;
+    }
+}
+
+int test_render::formats()
+{
+    try {
+        // Get path to the resources directory
+        const auto temp_directory = core::paths::get_resources_directory(TEST_EXECUTABLE_NAME);
+
+        // get_resources_directory will create the directory if it doesn't exist, but we want to ensure that tests are isolated
+        // TempDir removes the directory before creating it again
+        const helpers::TempDir temp_dir(temp_directory);
+
+        // Fields with characters that each format must escape
+        core::store::ChannelStore channels;
+        static_cast<void>(channels.insert("Tom | \"Jerry\", [1]", "https://example.com/a (b)", "Line\nbreak"));
+        static_cast<void>(channels.insert("Noriyaro", "https://www.youtube.com/@noriyaro/videos", "JP Drifting"));
+
+        // HTML is exactly what the table is saved as
+        if (core::render::render(channels, core::render::Format::Html) != core::io::render(channels)) {
+            throw std::runtime_error("HTML does not match the saved table");
+        }
+
+        const std::string markdown = core::render::render(channels, core::render::Format::Markdown);
+        const std::string expected_markdown = "| Channel | Description |\n"
+                                              "| --- | --- |\n"
+                                              "| [Noriyaro](https://www.youtube.com/@noriyaro/videos) | JP Drifting |\n"
+                                              "| [Tom \\| \"Jerry\", \\[1\\]](https://example.com/a%20%28b%29) | Line break |\n";
+        if (markdown != expected_markdown) {
+            throw std::runtime_error(fmt::format("Unexpected Markdown:\n{}", markdown));
+        }
+
+        const std::string csv = core::render::render(channels, core::render::Format::Csv);
+        const std::string expected_csv = "name,link,description\n"
+                                         "Noriyaro,https://www.youtube.com/@noriyaro/videos,JP Drifting\n"
+                                         "\"Tom | \"\"Jerry\"\", [1]\",https://example.com/a (b),\"Line\nbreak\"\n";
+        if (csv != expected_csv) {
+            throw std::runtime_error(fmt::format("Unexpected CSV:\n{}", csv));
+        }
+
+        const std::string json = core::render::render(channels, core::render::Format::Json);
+        const std::string expected_json = "[\n"
+                                          "  {\"name\": \"Noriyaro\", \"link\": \"https://www.youtube.com/@noriyaro/videos\", \"description\": \"JP Drifting\"},\n"
+                                          "  {\"name\": \"Tom | \\\"Jerry\\\", [1]\", \"link\": \"https://example.com/a (b)\", \"description\": \"Line\\nbreak\"}\n"
+                                          "]\n";
+        if (json != expected_json || core::render::render(core::store::ChannelStore(), core::render::Format::Json) != "[\n]\n") {
+            throw std::runtime_error(fmt::format("Unexpected JSON:\n{}", json));
+        }
+        fmt::print("core::render::render() passed: every format rendered.\n");
+
+        // CSV and JSON exports are read back by the importer
+        for (const auto &[filename, document] : {std::pair<std::string, std::string>{"export.csv", csv}, std::pair<std::string, std::string>{"export.json", json}}) {
+            const std::filesystem::path path = temp_directory / filename;
+            core::io::write_file(path, document, core::io::Durability::None);
+            std::vector<core::io::Channel> imported;
+            core::import::read(path, *core::import::detect_format(path), [&imported](const core::import::Record &record) {
+                if (!record.error.empty()) {
+                    throw std::runtime_error(fmt::format("Line {}: {}", record.line, record.error));
+                }
+                imported.push_back(record.channel);
+            });
+            if (imported.size() != channels.size()) {
+                throw std::runtime_error(fmt::format("Expected {} channels from '{}', got {}", channels.size(), filename, imported.size()));
+            }
+            for (std::size_t i = 0; i < imported.size(); ++i) {
+                if (!(imported[i] == core::io::Channel(std::string(channels.name(i)), std::string(channels.link(i)), std::string(channels.description(i))))) {
+                    throw std::runtime_error(fmt::format("Channel {} of '{}' does not round-trip", i, filename));
+                }
+            }
+        }
+        fmt::print("core::render::render() passed: CSV and JSON exports imported.\n");
+
+        return EXIT_SUCCESS;
+    }
+    catch (const std::exception &e) {
+        fmt::print(stderr, "core::render::render() failed: {}\n", e.what());
+        return EXIT_FAILURE;
+    }
+}
+
+int test_search::find()
+{
+    try {
+        core::search::TrigramIndex index;
+        index.insert("Noriyaro", "https://www.youtube.com/@noriyaro/videos", "JP Drifting");
+        index.insert("Engineering Explained", "https://www.youtube.com/@EngineeringExplained", "Car Engineering");
+        index.insert("Donut", "https://www.youtube.com/@donut", "Car culture and comedy");
+        index.insert("チャンネル", "https://www.youtube.com/@channel/videos", "日本語");
+
+        // An exact name scores 1, a typo still finds the channel, and case and punctuation are ignored
+        const auto expect_first = [&index](const std::string &query, const std::string &name) {
+            const std::vector<core::search::Match> matches = index.find(query, 10);
+            if (matches.empty() || matches.front().name != name) {
+                throw std::runtime_error(fmt::format("Query '{}' did not find '{}' first", query, name));
+            }
+            return matches;
+        };
+        if (expect_first("Noriyaro", "Noriyaro").front().score != 1.0) {
+            throw std::runtime_error("Exact name did not score 1");
+        }
+        expect_first("noriyoro", "Noriyaro");
+        expect_first("ENGINEERING-explaind", "Engineering Explained");
+        expect_first("drifting", "Noriyaro");
+        expect_first("チャンネル", "チャンネル");
+        if (!index.find("xyzzy", 10).empty() || !index.find("  ", 10).empty()) {
+            throw std::runtime_error("Unrelated query found a channel");
+        }
+
+        // Results are ordered by score, then by name, and cut at the limit
+        const std::vector<core::search::Match> cars = index.find("car", 10);
+        if (cars.size() != 2 || cars[0].name != "Donut" || cars[1].name != "Engineering Explained" || index.find("car", 1).size() != 1) {
+            throw std::runtime_error("Matches are not ordered by score and name");
+        }
+        fmt::print("core::search::TrigramIndex::find() passed: channels ranked by similarity.\n");
+
+        // Removed channels must disappear, also after the compaction that removing most channels triggers
+        if (index.erase("Noriyaro", "https://www.youtube.com/@other") || !index.erase("Noriyaro", "https://www.youtube.com/@noriyaro/videos") || index.erase("Noriyaro", "https://www.youtube.com/@noriyaro/videos") || index.erase("Unknown", "")) {
+            throw std::runtime_error("Erase did not remove exactly one channel");
+        }
+        if (!index.find("noriyaro", 10).empty()) {
+            throw std::runtime_error("Removed channel was found");
+        }
+        static_cast<void>(index.erase("Donut", "https://www.youtube.com/@donut"));
+        static_cast<void>(index.erase("チャンネル", "https://www.youtube.com/@channel/videos"));
+        index.insert("Noriyaro", "https://www.youtube.com/@noriyaro/videos", "JP Drifting");
+        if (index.size() != 2 || expect_first("car", "Engineering Explained").size() != 1 || expect_first("noriyaro", "Noriyaro").front().score != 1.0) {
+            throw std::runtime_error("Index out of sync after compaction");
+        }
+        fmt::print("core::search::TrigramIndex::erase() passed: removed channels are not found.\n");
+
+        // The table keeps its index in sync with every change after the first search
+        const auto temp_file = (core::paths::get_resources_directory(TEST_EXECUTABLE_NAME) / "test_search.html");
+        const helpers::TempDir temp_dir(std::filesystem::path(temp_file).parent_path());
+        modules::disk::Table table(temp_file);
+        static_cast<void>(table.add(core::io::Channel("Noriyaro", "https://www.youtube.com/@noriyaro/videos", "JP Drifting")));
+        if (table.find("noriyaro", 10).size() != 1) {
+            throw std::runtime_error("Table did not find its channel");
+        }
+        static_cast<void>(table.add(core::io::Channel("Donut", "https://www.youtube.com/@donut", "Car culture")));
+        static_cast<void>(table.remove("Noriyaro"));
+        const std::vector<core::search::Match> found = table.find("donut", 10);
+        if (found.size() != 1 || found.front().name != "Donut" || !table.find("noriyaro", 10).empty()) {
+            throw std::runtime_error("Table index out of sync after add and remove");
+        }
+        fmt::print("modules::disk::Table::find() passed: index follows add and remove.\n");
+
+        // Channels that share a name are told apart by their links, so each match locates its own channel
+        static_cast<void>(table.add(core::io::Channel("Garage", "https://www.youtube.com/@garage1", "First garage")));
+        static_cast<void>(table.add(core::io::Channel("Garage", "https://www.youtube.com/@garage2", "Second garage")));
+        const auto get_descriptions = [&table]() {
+            std::vector<std::string> descriptions;
+            for (const core::search::Match &match : table.find("garage", 10)) {
+                const std::optional<std::size_t> position = table.get_channels().find(match.name, match.link);
+                if (!position) {
+                    throw std::runtime_error(fmt::format("Match '{}' ({}) is not in the table", match.name, match.link));
+                }
+                descriptions.emplace_back(table.get_channels().description(*position));
+            }
+            std::sort(descriptions.begin(), descriptions.end());
+            return descriptions;
+        };
+        if (get_descriptions() != std::vector<std::string>{"First garage", "Second garage"}) {
+            throw std::runtime_error("Channels that share a name were not both found");
+        }
+
+        // Removing by name removes the first of them, from both the table and the index
+        static_cast<void>(table.remove("Garage"));
+        if (get_descriptions() != std::vector<std::string>{"Second garage"}) {
+            throw std::runtime_error("Index removed a different channel than the table");
+        }
+        fmt::print("modules::disk::Table::find() passed: channels that share a name are told apart.\n");
+
+        return EXIT_SUCCESS;
+    }
+    catch (const std::exception &e) {
+        fmt::print(stderr, "core::search::TrigramIndex failed: {}\n", e.what());
+        return EXIT_FAILURE;
+    }
+}
+
+int test_shard::index()
+{
+    try {
+        // Names are sharded by their first letter, ignoring case, and everything else goes to the last shard
+        if (core::shard::get_shard("Noriyaro") != 13 || core::shard::get_shard("noriyaro") != 13 || core::shard::get_shard("Zed") != 25 ||
+            core::shard::get_shard("チャンネル") != 26 || core::shard::get_shard("3Blue1Brown") != 26 || core::shard::get_shard("") != 26) {
+            throw std::runtime_error("Channel assigned to the wrong shard");
+        }
+        for (std::size_t shard = 0; shard < core::shard::count; ++shard) {
+            if (core::shard::parse_key(core::shard::get_key(shard)) != shard) {
+                throw std::runtime_error(fmt::format("Key of shard {} does not parse back", shard));
+            }
+        }
+        if (core::shard::get_key(26) != "other" || core::shard::parse_key("N") || core::shard::parse_key("../n") || core::shard::parse_key("")) {
+            throw std::runtime_error("Unexpected shard key");
+        }
+        if (core::shard::get_path(std::filesystem::path("dir") / "subscriptions.html", 13) != std::filesystem::path("dir") / "subscriptions-n.html") {
+            throw std::runtime_error(fmt::format("Unexpected shard path: {}", core::shard::get_path(std::filesystem::path("dir") / "subscriptions.html", 13).string()));
+        }
+        fmt::print("core::shard::get_shard() passed: channels assigned to shards.\n");
+
+        // The index page lists its shards, and holds nothing that the loader would take for a row
+        const std::string page = core::shard::render_index(std::filesystem::path("dir") / "my subscriptions.html", {0, 13, 26});
+        if (!core::shard::is_index(page) || core::shard::is_index(core::render::Html::header) || page.find("<tr") != std::string::npos) {
+            throw std::runtime_error("Index page not recognized");
+        }
+        if (page.find("href=\"my%20subscriptions-n.html\"") == std::string::npos) {
+            throw std::runtime_error("Index page does not link to the shard files");
+        }
+        if (core::shard::read_index(page) != std::vector<std::size_t>{0, 13, 26}) {
+            throw std::runtime_error("Shards differ after reading the index page");
+        }
+        bool threw = false;
+        try {
+            static_cast<void>(core::shard::read_index("<a href=\"x.html\" data-shard=\"../x\">X</a>"));
+        }
+        catch (const std::runtime_error &) {
+            threw = true;
+        }
+        if (!threw) {
+            throw std::runtime_error("Unknown shard in the index page was accepted");
+        }
+        fmt::print("core::shard::render_index() passed: index page read back.\n");
+
+        return EXIT_SUCCESS;
+    }
+    catch (const std::exception &e) {
+        fmt::print(stderr, "core::shard failed: {}\n", e.what());
+        return EXIT_FAILURE;
+    }
+}
+
+int test_shell::build_command()
+{
+    try {
+        const std::vector<std::string> test_paths = {
+            "~/data.html",
+            "/Users/USER/Library/Application Support/yt-table/Resources/subscriptions.html",
+            "C:\\Program Files",
+            "C:\\Program Files (x86)",
+            "C:\\Users\\USER\\AppData\\Local\\yt-table\\Resources\\subscriptions.html",
+            "~/ダタ.html",  // Japanese characters
+        };
+        // Define platform-specific commands
+        const std::vector<std::string> possible_beginnings = {"open", "xdg-open", "start"};
+
+        for (const auto &path : test_paths) {
+            const std::string command = core::shell::build_command(path);
+
+            // Check if the command begins with one of the possible commands
+            if (!std::any_of(possible_beginnings.cbegin(), possible_beginnings.cend(),
+                             [&command](const std::string &beginning) { return command.rfind(beginning, 0) == 0; })) {
+                throw std::runtime_error("Build command '" + command + "' does not begin with a valid platform-specific command");
+            }
+
+            // Extract the path from the command (assuming the path is after the first space)
+            const auto first_space_pos = command.find(' ');
+            if (first_space_pos == std::string::npos) {
+                throw std::runtime_error("No path found in command '" + command + "'");
+            }
+
+            const std::string extracted_path = command.substr(first_space_pos + 1);
+
+            // Check if the extracted path is wrapped in quotes
+            if (extracted_path.front() != '"' || extracted_path.back() != '"') {
+                throw std::runtime_error("Path in built command '" + command + "' is not wrapped in quotes");
+            }
+        }
+        fmt::print("core::shell::impl::build_command() passed: built platform-specific command for paths.\n");
+        return EXIT_SUCCESS;
+    }
+    catch (const std::exception &e) {
+        fmt::print(stderr, "core::shell::impl::build_command() failed: {}\n", e.what());
+        return EXIT_FAILURE;
+    }
+}
+
+int test_simd::search()
+{
+    try {
+        // Every kernel must give the same answers as the scalar kernel, wherever the answer is relative to the vector width
+        std::vector<core::simd::Kernel> kernels;
+        for (const core::simd::Kernel kernel : {core::simd::Kernel::Sse2, core::simd::Kernel::Avx2}) {
+            if (core::simd::is_supported(kernel)) {
+                kernels.push_back(kernel);
+            }
+        }
+        constexpr std::string_view set = "<>&\"'=/";
+        constexpr std::string_view whitespace = " \t\n\v\f\r";
+        std::uint32_t state = 1;
+        for (std::size_t size = 0; size <= 100; ++size) {
+            for (std::size_t repetition = 0; repetition < 20; ++repetition) {
+                // Mostly whitespace or plain letters, with a few bytes of the set, so answers fall at every offset
+                std::string text;
+                for (std::size_t i = 0; i < size; ++i) {
+                    state = state * 1103515245 + 12345;
+                    const std::uint32_t roll = (state >> 16) % 100;
+                    text += roll < 3 ? set[roll % set.size()] : roll < 60 ? whitespace[roll % whitespace.size()] : static_cast<char>(roll % 2 == 0 ? 'A' + roll % 26 : 'a' + roll % 26);
+                }
+                const std::size_t pos = size == 0 ? 0 : repetition % size;
+                for (const core::simd::Kernel kernel : kernels) {
+                    if (core::simd::find_any_of(text, set, pos, kernel) != core::simd::find_any_of(text, set, pos, core::simd::Kernel::Scalar) || core::simd::find_any_of(text, set, pos) != core::simd::find_any_of(text, set, pos, core::simd::Kernel::Scalar)) {
+                        throw std::runtime_error(fmt::format("Kernel {} disagrees on find_any_of in '{}'", static_cast<int>(kernel), text));
+                    }
+                }
+            }
+        }
+        const std::string spaces = std::string(70, ' ') + "\t\r\n<td>";
+        if (core::simd::find_any_of(spaces, "<") != 73 || core::simd::find_any_of(spaces, "x") != spaces.size() || core::simd::find_any_of(spaces, "<", 100) != spaces.size()) {
+            throw std::runtime_error("Searches do not match");
+        }
+        fmt::print("core::simd::find_any_of() passed: {} vector kernels agree with the scalar kernel.\n", kernels.size());
+
+        // Every whitespace byte of "\s" is skipped, from any offset
+        const std::string indent = " \t\n\v\f\r<td>";
+        if (core::simd::skip_whitespace(indent) != 6 || core::simd::skip_whitespace(indent, 6) != 6 || core::simd::skip_whitespace(indent, 100) != indent.size() || core::simd::skip_whitespace("  ") != 2) {
+            throw std::runtime_error("Whitespace was not skipped");
+        }
+        fmt::print("core::simd::skip_whitespace() passed: whitespace skipped.\n");
+
+        // Tags match whatever the case of the text, and only where the whole tag fits
+        const std::string rows = "<TR><Td>" + std::string(20, ' ') + "</tR>";
+        if (!core::simd::starts_with_icase(rows, 0, "<tr>") || !core::simd::starts_with_icase(rows, 4, "<td>") || !core::simd::starts_with_icase(rows, 28, "</tr>") || !core::simd::starts_with_icase(rows, 0, "")) {
+            throw std::runtime_error("Missed a tag");
+        }
+        if (core::simd::starts_with_icase(rows, 0, "<td>") || core::simd::starts_with_icase(rows, 29, "</tr>") || core::simd::starts_with_icase(rows, 100, "<tr>") || core::simd::starts_with_icase("<tR", 0, "<tr>") || core::simd::starts_with_icase("[TR>", 0, "{tr>")) {
+            throw std::runtime_error("Matched a wrong tag");
+        }
+        fmt::print("core::simd::starts_with_icase() passed: tags matched ignoring case.\n");
+
+        return EXIT_SUCCESS;
+    }
+    catch (const std::exception &e) {
+        fmt::print(stderr, "core::simd failed: {}\n", e.what());
+        return EXIT_FAILURE;
+    }
+}
+
+int test_store::insert_erase()
+{
+    try {
+        core::store::ChannelStore store;
+        for (std::size_t i = 0; i < 100; ++i) {
+            store.insert(fmt::format("Channel {:03}", i), fmt::format("https://www.youtube.com/@channel{}", i), fmt::format("Description {}", i));
+        }
+
+        // Remove every channel with an odd number, which wastes enough space to trigger compaction
+        for (std::size_t i = 100; i > 0; i -= 2) {
+            store.erase(i - 1);
+        }
+        if (store.size() != 50) {
+            throw std::runtime_error(fmt::format("Expected 50 channels, got {}", store.size()));
+        }
+
+        // Every remaining channel must still be intact, in order
+        std::size_t expected = 0;
+        for (const core::store::ChannelView channel : store) {
+            if (channel.name != fmt::format("Channel {:03}", expected) ||
+                channel.link != fmt::format("https://www.youtube.com/@channel{}", expected) ||
+                channel.description != fmt::format("Description {}", expected)) {
+                throw std::runtime_error(fmt::format("Channel {} does not match: {}", expected, channel.name));
+            }
+            expected += 2;
+        }
+        fmt::print("core::store::ChannelStore passed: channels intact after erase and compaction.\n");
+
+        // Inserting many channels at once must grow the hash index with them, even into an empty store
+        std::vector<std::string> names;
+        for (std::size_t i = 1000; i > 0; --i) {
+            names.push_back(fmt::format("Channel {:04}", i - 1));
+        }
+        std::vector<core::store::ChannelView> views;
+        for (const std::string &name : names) {
+            views.push_back(core::store::ChannelView{name, "https://www.youtube.com/@channel", "Description"});
+        }
+        core::store::ChannelStore bulk;
+        const std::vector<std::size_t> indices = bulk.insert(views);
+        if (bulk.size() != 1000 || indices.size() != 1000 || indices.back() != 999 || bulk.name(0) != "Channel 0000" || !bulk.contains("Channel 0999")) {
+            throw std::runtime_error("Bulk insert into an empty store failed");
+        }
+        fmt::print("core::store::ChannelStore passed: bulk insert into an empty store.\n");
+        return EXIT_SUCCESS;
+    }
+    catch (const std::exception &e) {
+        fmt::print(stderr, "core::store::ChannelStore failed: {}\n", e.what());
+        return EXIT_FAILURE;
+    }
+}
+
+int test_store::index()
+{
+    try {
+        // Insert in a scrambled order (37 is coprime with 1000, so every number appears once)
+        core::store::ChannelStore store;
+        for (std::size_t i = 0; i < 1000; ++i) {
+            const std::size_t n = (i * 37) % 1000;
+            const std::size_t index = store.insert(fmt::format("Channel {:04}", n), "https://www.youtube.com/@channel", "Description");
+            if (store.name(index) != fmt::format("Channel {:04}", n)) {
+                throw std::runtime_error(fmt::format("Insert of channel {} returned the wrong index {}", n, index));
+            }
+        }
+        for (std::size_t i = 1; i < store.size(); ++i) {
+            if (store.name(i - 1) > store.name(i)) {
+                throw std::runtime_error(fmt::format("Channels not sorted at index {}", i));
+            }
+        }
+
+        // Every name must be found at its sorted position, unknown names must be rejected
+        for (std::size_t i = 0; i < 1000; ++i) {
+            const std::optional<std::size_t> found = store.find(fmt::format("Channel {:04}", i));
+            if (!found || *found != i) {
+                throw std::runtime_error(fmt::format("Channel {} not found at index {}", i, i));
+            }
+        }
+        if (store.contains("Channel 1000") || store.find("Channel") || store.contains("")) {
+            throw std::runtime_error("Found a channel that was never inserted");
+        }
+
+        // Duplicate names are kept in insertion order, and find returns the first one
+        const std::size_t duplicate = store.insert("Channel 0500", "https://www.youtube.com/@duplicate", "Duplicate");
+        if (duplicate != 501 || store.find("Channel 0500") != std::optional<std::size_t>(500) || store.link(501) != "https://www.youtube.com/@duplicate") {
+            throw std::runtime_error(fmt::format("Duplicate inserted at index {}", duplicate));
+        }
+        if (store.find("Channel 0500", "https://www.youtube.com/@duplicate") != std::optional<std::size_t>(501) || store.find("Channel 0500", "https://www.youtube.com/@missing")) {
+            throw std::runtime_error("Duplicate was not found by its link");
+        }
+        store.erase(500);
+        if (store.find("Channel 0500") != std::optional<std::size_t>(500) || store.link(500) != "https://www.youtube.com/@duplicate") {
+            throw std::runtime_error("Erasing the first duplicate lost the second one");
+        }
+
+        // Erase everything but every tenth channel, which reuses buckets and compacts the arenas, then insert again into the freed slots
+        for (std::size_t i = 1000; i > 0; --i) {
+            if ((i - 1) % 10 != 0) {
+                store.erase(i - 1);
+            }
+        }
+        for (std::size_t i = 0; i < 1000; ++i) {
+            if (store.contains(fmt::format("Channel {:04}", i)) != (i % 10 == 0)) {
+                throw std::runtime_error(fmt::format("Index out of sync for channel {} after erase", i));
+            }
+        }
+        store.insert("Channel 0001", "https://www.youtube.com/@channel1", "Description 1");
+        if (store.find("Channel 0001") != std::optional<std::size_t>(1) || store.link(1) != "https://www.youtube.com/@channel1" || store.name(2) != "Channel 0010") {
+            throw std::runtime_error("Reinserted channel not found at its sorted position");
+        }
+
+        store.clear();
+        if (!store.empty() || store.contains("Channel 0000")) {
+            throw std::runtime_error("Store not empty after clear");
+        }
+        fmt::print("core::store::ChannelStore passed: hash index and sorted order stay in sync.\n");
+        return EXIT_SUCCESS;
+    }
+    catch (const std::exception &e) {
+        fmt::print(stderr, "core::store::ChannelStore failed: {}\n", e.what());
+        return EXIT_FAILURE;
+    }
+}
+
+int test_strings::trim_whitespace()
+{
+    try {
+        const std::string test_string = "  hello  ";
+        const std::string trimmed_string = core::strings::trim_whitespace(test_string);
+        if (trimmed_string != "hello") {
+            throw std::runtime_error("Trimmed string does not match expected value");
+        }
+        fmt::print("core::strings::trim_whitespace() passed: trimmed whitespace from '{}'.\n", test_string);
+
+        // The view overload trims the same way, without copying, including whitespace longer than a vector
+        const std::string padded = std::string(40, ' ') + "\t\r\nhello world\f\v " + std::string(40, '\n');
+        const std::string_view trimmed_view = core::strings::trim_whitespace(std::string_view(padded));
+        if (trimmed_view != "hello world" || trimmed_view.data() != padded.data() + 43 || !core::strings::trim_whitespace(std::string_view(padded.data(), 40)).empty()) {
+            throw std::runtime_error("Trimmed view does not match expected value");
+        }
+        fmt::print("core::strings::trim_whitespace() passed: trimmed a view in place.\n");
+        return EXIT_SUCCESS;
+    }
+    catch (const std::exception &e) {
+        fmt::print(stderr, "core::strings::trim_whitespace() failed: {}\n", e.what());
+        return EXIT_FAILURE;
+    }
+}
+
+int test_url::channel_key()
+{
+    try {
+        // Every spelling of the same channel must produce the same key
+        const std::initializer_list<std::pair<std::string_view, std::string_view>> cases = {
+            {"https://www.youtube.com/@noriyaro/videos", "youtube.com/@noriyaro"},
+            {"https://www.youtube.com/@Noriyaro", "youtube.com/@noriyaro"},
+            {"http://m.youtube.com/@noriyaro/", "youtube.com/@noriyaro"},
+            {"  youtube.com//@NORIYARO/featured?view=0#about  ", "youtube.com/@noriyaro"},
+            {"HTTPS://WWW.YOUTUBE.COM:443/@noriyaro/streams", "youtube.com/@noriyaro"},
+            {"https://www.youtube.com/@%E3%83%8E%E3%83%AA", "youtube.com/@ノリ"},
+            {"https://www.youtube.com/channel/UCabcDEF123/videos", "youtube.com/channel/UCabcDEF123"},
+            {"https://music.youtube.com/channel/UCabcDEF123", "youtube.com/channel/UCabcDEF123"},
+            {"https://www.youtube.com/c/EngineeringExplained", "youtube.com/c/engineeringexplained"},
+            {"https://www.youtube.com/user/EngineeringExplained/about", "youtube.com/user/engineeringexplained"},
+            {"https://Example.org/Some/Path/?utm=1", "example.org/Some/Path"},
+            {"https://www.youtube.com/", "youtube.com"},
+            {"", ""},
+            {"https:///", ""},
+        };
+        for (const auto &[link, expected] : cases) {
+            const std::string key = core::url::get_channel_key(link);
+            if (key != expected) {
+                throw std::runtime_error(fmt::format("Expected key '{}' for '{}', got '{}'", expected, link, key));
+            }
+        }
+
+        // Channel IDs are case-sensitive, so they must not be lowercased into each other
+        if (core::url::get_channel_key("https://www.youtube.com/channel/UCabc") == core::url::get_channel_key("https://www.youtube.com/channel/UCABC")) {
+            throw std::runtime_error("Channel IDs that differ in case produced the same key");
+        }
+        fmt::print("core::url::get_channel_key() passed: link spellings canonicalized.\n");
+        return EXIT_SUCCESS;
+    }
+    catch (const std::exception &e) {
+        fmt::print(stderr, "core::url::get_channel_key() failed: {}\n", e.what());
+        return EXIT_FAILURE;
+    }
+}
+
+int test_disk::save_load()
+{
+    try {
+        // Get path to the resources directory
+        const auto temp_file = (core::paths::get_resources_directory(TEST_EXECUTABLE_NAME) / "test_table.html");
+
+        // get_resources_directory will create the directory if it doesn't exist, but we want to ensure that tests are isolated
+        // TempDir removes the directory before creating it again
+        const helpers::TempDir temp_dir(std::filesystem::path(temp_file).parent_path());
+
+        // Create a table at the temporary file path
+        modules::disk::Table table(temp_file);
+        fmt::print("modules::disk::Table() passed: created table at {}.\n", temp_file.string());
+
+        // Add a channel to the table
+        if (!table.add(core::io::Channel("Noriyaro", "https://www.youtube.com/@noriyaro/videos", "JP Drifting"))) {
+            throw std::runtime_error("Failed to add the channel to the table");
+        }
+        fmt::print("modules::disk::Table::add() passed: added channel to the table.\n");
+
+        // Remove the channel from the table
+        if (!table.remove("Noriyaro")) {
+            throw std::runtime_error("Failed to remove the channel from the table");
+        }
+        fmt::print("modules::disk::Table::remove() passed: removed channel from the table.\n");
+
+        return EXIT_SUCCESS;
+    }
+    catch (const std::exception &e) {
+        fmt::print(stderr, "modules::disk::Table() failed: {}\n", e.what());
+        return EXIT_FAILURE;
+    }
+}
+
+int test_disk::compaction()
+{
+    try {
+        // Get path to the resources directory
+        const auto temp_file = (core::paths::get_resources_directory(TEST_EXECUTABLE_NAME) / "test_compaction.html");
+        const auto expected_file = (core::paths::get_resources_directory(TEST_EXECUTABLE_NAME) / "test_compaction_expected.html");
+        const auto journal_file = core::journal::get_path(temp_file);
+
+        // get_resources_directory will create the directory if it doesn't exist, but we want to ensure that tests are isolated
+        // TempDir removes the directory before creating it again
+        const helpers::TempDir temp_dir(std::filesystem::path(temp_file).parent_path());
+
+        // Read a whole file into a string
+        const auto read_file = [](const std::filesystem::path &path) {
+            std::ifstream file(path, std::ios::binary);
+            return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        };
+
+        // The compacted file must be byte-for-byte identical to a full rewrite of the same channels
+        const auto check = [&](const modules::disk::Table &table, const std::string &step) {
+            static_cast<void>(core::io::save(expected_file, table.get_channels()));
+            if (read_file(temp_file) != read_file(expected_file)) {
+                throw std::runtime_error(fmt::format("File does not match a full rewrite after {}", step));
+            }
+        };
+
+        {
+            // Add channels out of order, then remove some; each edit only appends to the journal, so the file is left as it was
+            modules::disk::Table table(temp_file);
+            const std::string original = read_file(temp_file);
+            static_cast<void>(table.add(core::io::Channel("Noriyaro", "https://www.youtube.com/@noriyaro/videos", "JP Drifting")));
+            static_cast<void>(table.add(core::io::Channel("Engineering Explained", "https://www.youtube.com/@EngineeringExplained", "Car Engineering")));
+            static_cast<void>(table.add(core::io::Channel("チャンネル", "https://www.youtube.com/@channel/videos", "日本語")));  // Japanese characters
+            static_cast<void>(table.add(core::io::Channel("Hugh Jeffreys", "https://www.youtube.com/@HughJeffreys/videos", "Phone Repairs")));
+            if (!table.remove("Hugh Jeffreys") || !table.remove("チャンネル")) {
+                throw std::runtime_error("Failed to remove the channels from the table");
+            }
+            if (read_file(temp_file) != original || !table.is_dirty()) {
+                throw std::runtime_error("File was rewritten by a single edit");
+            }
+            if (!std::filesystem::exists(journal_file) || std::filesystem::file_size(journal_file) > 1024) {
+                throw std::runtime_error("Edits were not appended to the journal");
+            }
+            if (table.get_channels().name(0) != "Engineering Explained" || table.get_channels().name(1) != "Noriyaro") {
+                throw std::runtime_error("Channels are not sorted after editing");
+            }
+
+            // Flushing compacts the journal into the file
+            table.flush();
+            check(table, "flushing");
+            if (table.is_dirty() || std::filesystem::exists(journal_file)) {
+                throw std::runtime_error("Journal was not cleared by flushing");
+            }
+        }
+        fmt::print("modules::disk::Table passed: single edits journaled, then compacted by a flush.\n");
+
+        {
+            // An edit that was never compacted is replayed by the next load, which rewrites the file
+            {
+                modules::disk::Table table(temp_file);
+                static_cast<void>(table.add(core::io::Channel("Aaa", "https://www.youtube.com/@aaa", "First")));
+            }
+            if (core::io::load(temp_file, false).size() != 2) {
+                throw std::runtime_error("File was rewritten when the table was destroyed");
+            }
+            modules::disk::Table table(temp_file);
+            if (!table.contains("Aaa") || std::filesystem::exists(journal_file)) {
+                throw std::runtime_error("Journaled edit was not replayed on load");
+            }
+            check(table, "replaying");
+        }
+        fmt::print("modules::disk::Table passed: uncompacted edits replayed on load.\n");
+
+        {
+            // Once the journal grows past the threshold, the next edit compacts it into the file
+            modules::disk::Table table(temp_file, core::io::Durability::None);
+            const std::string description(4096, 'x');
+            std::size_t count = 0;
+            while (std::filesystem::exists(journal_file) || count == 0) {
+                if (count > modules::disk::Table::journal_compaction_threshold / description.size() + 1) {
+                    throw std::runtime_error("Journal grew past the threshold without being compacted");
+                }
+                static_cast<void>(table.add(core::io::Channel(fmt::format("Channel {:04}", count), fmt::format("https://www.youtube.com/@channel{}", count), description)));
+                ++count;
+            }
+            check(table, "passing the threshold");
+            for (std::size_t i = 0; i < count; ++i) {
+                static_cast<void>(table.remove(fmt::format("Channel {:04}", i)));
+            }
+            table.flush();
+        }
+        fmt::print("modules::disk::Table passed: journal compacted past the threshold.\n");
+
+#if !defined(_WIN32)
+        {
+            // Cap the size of written files, so the journal append fails partway through; a full disk fails the same way, and unlike a read-only file, the cap also holds for root
+            {
+                modules::disk::Table table(temp_file);
+                const std::string original = read_file(temp_file);
+                rlimit old_limit;
+                if (getrlimit(RLIMIT_FSIZE, &old_limit) != 0) {
+                    throw std::runtime_error("Failed to get the file size limit");
+                }
+                rlimit new_limit = old_limit;
+                new_limit.rlim_cur = 16;
+                static_cast<void>(std::signal(SIGXFSZ, SIG_IGN));
+                if (setrlimit(RLIMIT_FSIZE, &new_limit) != 0) {
+                    throw std::runtime_error("Failed to set the file size limit");
+                }
+                bool failed = false;
+                try {
+                    static_cast<void>(table.add(core::io::Channel("Mmm", "https://www.youtube.com/@mmm", "Middle")));
+                }
+                catch (const std::runtime_error &) {
+                    failed = true;
+                }
+                static_cast<void>(setrlimit(RLIMIT_FSIZE, &old_limit));
+                if (!failed) {
+                    throw std::runtime_error("Journal append past the file size limit did not fail");
+                }
+                if (read_file(temp_file) != original) {
+                    throw std::runtime_error("File was changed by a failed journal append");
+                }
+
+                // The failed edit is retried by the next one
+                static_cast<void>(table.add(core::io::Channel("Nnn", "https://www.youtube.com/@nnn", "Next")));
+            }
+
+            // Both edits must be replayed, which they are not if the retry was appended after the torn write
+            modules::disk::Table table(temp_file);
+            if (!table.contains("Mmm") || !table.contains("Nnn")) {
+                throw std::runtime_error("Edits after a failed journal append were lost");
+            }
+            check(table, "a failed journal append");
+        }
+        fmt::print("modules::disk::Table passed: failed journal append retried without losing edits.\n");
+#endif
+
+        return EXIT_SUCCESS;
+    }
+    catch (const std::exception &e) {
+        fmt::print(stderr, "modules::disk::Table compaction failed: {}\n", e.what());
+        return EXIT_FAILURE;
+    }
+}
+
+int test_disk::batch()
+{
+    try {
+        // Get path to the resources directory
+        const auto temp_file = (core::paths::get_resources_directory(TEST_EXECUTABLE_NAME) / "test_batch.html");
+
+        // get_resources_directory will create the directory if it doesn't exist, but we want to ensure that tests are isolated
+        // TempDir removes the directory before creating it again
+        const helpers::TempDir temp_dir(std::filesystem::path(temp_file).parent_path());
+
+        modules::disk::Table table(temp_file);
+        {
+            modules::disk::Table::Batch batch(table);
+            for (std::size_t i = 0; i < 100; ++i) {
+                static_cast<void>(table.add(core::io::Channel(fmt::format("Channel {:03}", i), fmt::format("https://www.youtube.com/@channel{}", i), "Description")));
+            }
+            if (!table.remove("Channel 050")) {
+                throw std::runtime_error("Failed to remove the channel from the table");
+            }
+
+            // Nothing may reach the disk before the batch is committed
+            if (!table.is_dirty() || !core::io::load(temp_file, false).empty()) {
+                throw std::runtime_error("Batch was written to disk before being committed");
+            }
+        }
+
+        // Leaving the scope commits the batch with a single save
+        if (table.is_dirty() || core::io::load(temp_file, false).size() != 99) {
+            throw std::runtime_error("Batch was not written to disk after being committed");
+        }
+        fmt::print("modules::disk::Table::Batch passed: changes written once on commit.\n");
+
+        // After a batch, edits are journaled one at a time, and reach the file with the next flush
+        static_cast<void>(table.add(core::io::Channel("Aaa", "https://www.youtube.com/@aaa", "First")));
+        if (!table.is_dirty() || !std::filesystem::exists(core::journal::get_path(temp_file))) {
+            throw std::runtime_error("Change after the batch was not journaled");
+        }
+        table.flush();
+        if (table.is_dirty() || core::io::load(temp_file, false).size() != 100) {
+            throw std::runtime_error("Change after the batch was not written to disk by a flush");
+        }
+        fmt::print("modules::disk::Table::Batch passed: changes after the batch journaled, then flushed.\n");
+
+        return EXIT_SUCCESS;
+    }
+    catch (const std::exception &e) {
+        fmt::print(stderr, "modules::disk::Table::Batch failed: {}\n", e.what());
+        return EXIT_FAILURE;
+    }
+}
+
+int test_disk::dedupe()
+{
+    try {
+        // Get path to the resources directory
+        const auto temp_file = (core::paths::get_resources_directory(TEST_EXECUTABLE_NAME) / "test_dedupe.html");
+
+        // get_resources_directory will create the directory if it doesn't exist, but we want to ensure that tests are isolated
+        // TempDir removes the directory before creating it again
+        const helpers::TempDir temp_dir(std::filesystem::path(temp_file).parent_path());
+
+        // Write a table with duplicates directly, like a merge of two tables would
+        core::io::save(temp_file, std::vector<core::io::Channel>{
+                                      core::io::Channel("Noriyaro", "https://www.youtube.com/@noriyaro/videos", "JP Drifting"),
+                                      core::io::Channel("Noriyaro (mobile)", "https://m.youtube.com/@Noriyaro", "JP Drifting"),
+                                      core::io::Channel("Hugh Jeffreys", "https://www.youtube.com/@HughJeffreys", "Phone Repairs"),
+                                      core::io::Channel("Noriyaro again", "https://www.youtube.com/@noriyaro/?si=abc", "JP Drifting"),
+                                      core::io::Channel("Engineering Explained", "https://www.youtube.com/@EngineeringExplained", "Car Engineering"),
+                                  });
+
+        modules::disk::Table table(temp_file);
+
+        // Adding another spelling of a known link must be rejected
+        if (table.add(core::io::Channel("Hugh", "http://youtube.com/@hughjeffreys/videos", "Duplicate")) || !table.contains_link("https://www.youtube.com/@HUGHJEFFREYS")) {
+            throw std::runtime_error("Duplicate link was not rejected");
+        }
+        fmt::print("modules::disk::Table::add() passed: duplicate link rejected.\n");
+
+        // Dedupe keeps the first channel (in sorted order) of each group
+        const std::size_t removed = table.dedupe();
+        const std::vector<core::io::Channel> loaded = core::io::load(temp_file, false);
+        if (removed != 2 || loaded.size() != 3 || loaded[2].name != "Noriyaro") {
+            throw std::runtime_error(fmt::format("Expected 2 duplicates removed and 3 channels on disk, got {} and {}", removed, loaded.size()));
+        }
+        if (table.dedupe() != 0) {
+            throw std::runtime_error("Dedupe removed channels from a table without duplicates");
+        }
+
+        // Removing the kept channel frees its link for a new channel
+        if (!table.remove("Noriyaro") || !table.add(core::io::Channel("Noriyaro", "https://www.youtube.com/@noriyaro", "JP Drifting"))) {
+            throw std::runtime_error("Link was not freed after removing its channel");
+        }
+        fmt::print("modules::disk::Table::dedupe() passed: duplicates collapsed.\n");
+
+        return EXIT_SUCCESS;
+    }
+    catch (const std::exception &e) {
+        fmt::print(stderr, "modules::disk::Table::dedupe() failed: {}\n", e.what());
+        return EXIT_FAILURE;
+    }
+}
+
+int test_disk::bulk_add()
+{
+    try {
+        // Get path to the resources directory
+        const auto temp_file = (core::paths::get_resources_directory(TEST_EXECUTABLE_NAME) / "test_bulk_add.html");
+
+        // get_resources_directory will create the directory if it doesn't exist, but we want to ensure that tests are isolated
+        // TempDir removes the directory before creating it again
+        const helpers::TempDir temp_dir(std::filesystem::path(temp_file).parent_path());
+
+        modules::disk::Table table(temp_file);
+        if (!table.add(core::io::Channel("Hugh Jeffreys", "https://www.youtube.com/@HughJeffreys", "Phone Repairs"))) {
+            throw std::runtime_error("Failed to add the first channel");
+        }
+
+        // Unsorted input, with a known link and a repeat within the input
+        const std::vector<bool> added = table.add(std::vector<core::io::Channel>{
+            core::io::Channel("Noriyaro", "https://www.youtube.com/@noriyaro/videos", "JP Drifting"),
+            core::io::Channel("Hugh", "https://m.youtube.com/@hughjeffreys", "Duplicate"),
+            core::io::Channel("Engineering Explained", "https://www.youtube.com/@EngineeringExplained", "Car Engineering"),
+            core::io::Channel("Noriyaro again", "https://www.youtube.com/@Noriyaro", "Duplicate"),
+            core::io::Channel("Alpha", "https://example.com/alpha", "First"),
+        });
+        if (added != std::vector<bool>{true, false, true, false, true}) {
+            throw std::runtime_error("Duplicates were not rejected");
+        }
+
+        // The table stays sorted, and the file matches it
+        const std::vector<core::io::Channel> loaded = core::io::load(temp_file, false);
+        const std::vector<std::string> expected = {"Alpha", "Engineering Explained", "Hugh Jeffreys", "Noriyaro"};
+        if (loaded.size() != expected.size() || table.get_channels().size() != expected.size()) {
+            throw std::runtime_error(fmt::format("Expected {} channels, got {}", expected.size(), loaded.size()));
+        }
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+            if (loaded[i].name != expected[i] || table.get_channels().name(i) != expected[i]) {
+                throw std::runtime_error(fmt::format("Expected '{}' at position {}, got '{}'", expected[i], i, loaded[i].name));
+            }
+        }
+        if (!table.contains("Alpha") || !table.remove("Noriyaro") || table.contains_link("https://www.youtube.com/@noriyaro")) {
+            throw std::runtime_error("Index does not match the added channels");
+        }
+        fmt::print("modules::disk::Table::add() passed: channels added in bulk.\n");
+
+        return EXIT_SUCCESS;
+    }
+    catch (const std::exception &e) {
+        fmt::print(stderr, "modules::disk::Table::add() failed: {}\n", e.what());
+        return EXIT_FAILURE;
+    }
+}
+
+int test_disk::snapshot()
+{
+    try {
+        // Get path to the resources directory
+        const auto temp_file = (core::paths::get_resources_directory(TEST_EXECUTABLE_NAME) / "test_snapshot.html");
+        const auto expected_file = (core::paths::get_resources_directory(TEST_EXECUTABLE_NAME) / "test_snapshot_expected.html");
+        const auto snapshot_file = core::snapshot::get_path(temp_file);
+
+        // get_resources_directory will create the directory if it doesn't exist, but we want to ensure that tests are isolated
+        // TempDir removes the directory before creating it again
+        const helpers::TempDir temp_dir(std::filesystem::path(temp_file).parent_path());
+
+        // Read a whole file into a string
+        const auto read_file = [](const std::filesystem::path &path) {
+            std::ifstream file(path, std::ios::binary);
+            return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        };
+
+        // The table must hold exactly these channels, and the file must match a full rewrite of them
+        const auto check = [&](const modules::disk::Table &table, const std::vector<std::string> &expected, const std::string &step) {
+            const core::store::ChannelStore &channels = table.get_channels();
+            if (channels.size() != expected.size()) {
+                throw std::runtime_error(fmt::format("Expected {} channels {}, got {}", expected.size(), step, channels.size()));
+            }
+            for (std::size_t i = 0; i < expected.size(); ++i) {
+                if (channels.name(i) != expected[i]) {
+                    throw std::runtime_error(fmt::format("Expected '{}' at position {} {}, got '{}'", expected[i], i, step, channels.name(i)));
+                }
+            }
+            static_cast<void>(core::io::save(expected_file, channels));
+            if (read_file(temp_file) != read_file(expected_file)) {
+                throw std::runtime_error(fmt::format("File does not match a full rewrite {}", step));
+            }
+        };
+
+        {
+            modules::disk::Table table(temp_file);
+            static_cast<void>(table.add(core::io::Channel("Noriyaro", "https://www.youtube.com/@noriyaro/videos", "JP Drifting")));
+            static_cast<void>(table.add(core::io::Channel("チャンネル", "https://www.youtube.com/@channel/videos", "日本語")));  // Japanese characters
+            static_cast<void>(table.add(core::io::Channel("Hugh Jeffreys", "https://www.youtube.com/@HughJeffreys/videos", "Phone Repairs")));
+            table.flush();
+        }
+        if (!std::filesystem::exists(snapshot_file)) {
+            throw std::runtime_error("Snapshot was not written when the table was destroyed");
+        }
+        {
+            // Load from the snapshot, which must hold the same channels as the file
+            const core::snapshot::MappedSnapshot snapshot(temp_file);
+            if (snapshot.size() != 3 || snapshot.name(0) != "Hugh Jeffreys" || snapshot.link(1) != "https://www.youtube.com/@noriyaro/videos" || snapshot.description(2) != "日本語" || snapshot.key(1) != core::url::get_channel_key("https://www.youtube.com/@noriyaro/videos")) {
+                throw std::runtime_error("Snapshot does not hold the channels");
+            }
+            modules::disk::Table table(temp_file);
+            check(table, {"Hugh Jeffreys", "Noriyaro", "チャンネル"}, "after loading the snapshot");
+            if (!table.contains_link("https://m.youtube.com/@noriyaro") || table.add(core::io::Channel("Hugh", "https://www.youtube.com/@hughjeffreys", "Duplicate"))) {
+                throw std::runtime_error("Links were not indexed from the snapshot");
+            }
+            static_cast<void>(table.add(core::io::Channel("Aaa", "https://www.youtube.com/@aaa", "First")));
+            table.flush();
+            check(table, {"Aaa", "Hugh Jeffreys", "Noriyaro", "チャンネル"}, "after editing a table loaded from the snapshot");
+        }
+        fmt::print("core::snapshot passed: table reloaded from the snapshot.\n");
+
+        // Edit the file by hand, which must make the snapshot stale
+        core::io::save(temp_file, std::vector<core::io::Channel>{core::io::Channel("Edited", "https://www.youtube.com/@edited", "By hand")});
+        try {
+            const core::snapshot::MappedSnapshot snapshot(temp_file);
+            throw std::logic_error("Stale snapshot was accepted");
+        }
+        catch (const std::runtime_error &) {
+        }
+        {
+            const modules::disk::Table table(temp_file);
+            check(table, {"Edited"}, "after editing the file by hand");
+        }
+
+        // Corrupt the refreshed snapshot, which must fall back to parsing the file
+        {
+            std::string contents = read_file(snapshot_file);
+            contents.back() = static_cast<char>(contents.back() ^ 0x20);
+            std::ofstream(snapshot_file, std::ios::binary | std::ios::trunc) << contents;
+        }
+        {
+            const modules::disk::Table table(temp_file);
+            check(table, {"Edited"}, "after corrupting the snapshot");
+        }
+        const core::snapshot::MappedSnapshot snapshot(temp_file);
+        if (snapshot.size() != 1 || snapshot.name(0) != "Edited") {
+            throw std::runtime_error("Corrupt snapshot was not rebuilt");
+        }
+        fmt::print("core::snapshot passed: stale and corrupt snapshots are rebuilt.\n");
+
+        return EXIT_SUCCESS;
+    }
+    catch (const std::exception &e) {
+        fmt::print(stderr, "core::snapshot failed: {}\n", e.what());
+        return EXIT_FAILURE;
+    }
+}
+
+int test_disk::journal()
+{
+    try {
+        // Get path to the resources directory
+        const auto temp_file = (core::paths::get_resources_directory(TEST_EXECUTABLE_NAME) / "test_journal.html");
+        const auto crash_file = (core::paths::get_resources_directory(TEST_EXECUTABLE_NAME) / "test_journal_crash.html");
+
+        // get_resources_directory will create the directory if it doesn't exist, but we want to ensure that tests are isolated
+        // TempDir removes the directory before creating it again
+        const helpers::TempDir temp_dir(std::filesystem::path(temp_file).parent_path());
+
+        // Copy the table and its journal, as a crash would leave them behind
+        const auto simulate_crash = [&]() {
+            std::filesystem::copy_file(temp_file, crash_file, std::filesystem::copy_options::overwrite_existing);
+            std::filesystem::copy_file(core::journal::get_path(temp_file), core::journal::get_path(crash_file), std::filesystem::copy_options::overwrite_existing);
+        };
+
+        modules::disk::Table table(temp_file);
+        static_cast<void>(table.add(core::io::Channel("Hugh Jeffreys", "https://www.youtube.com/@HughJeffreys", "Phone Repairs")));
+        static_cast<void>(table.add(core::io::Channel("Hugh Again", "https://m.youtube.com/@hughjeffreys", "Duplicate")));
+        table.flush();
+        {
+            modules::disk::Table::Batch outer(table);
+            {
+                modules::disk::Table::Batch command(table);
+                static_cast<void>(table.add(core::io::Channel("Noriyaro", "https://www.youtube.com/@noriyaro/videos", "JP Drifting")));
+                static_cast<void>(table.add(core::io::Channel("チャンネル", "https://www.youtube.com/@channel/videos", "日本語")));  // Japanese characters
+            }
+            {
+                modules::disk::Table::Batch command(table);
+                static_cast<void>(table.remove("Noriyaro"));
+                static_cast<void>(table.dedupe());
+            }
+
+            // A nested commit syncs the journal, but leaves the file alone
+            if (core::io::load(temp_file, false).size() != 1 || !std::filesystem::exists(core::journal::get_path(temp_file))) {
+                throw std::runtime_error("Nested commit did not go to the journal");
+            }
+            simulate_crash();
+
+            // Changes that were never committed must not be replayed, even if half of them reached the disk
+            static_cast<void>(table.add(core::io::Channel("Uncommitted", "https://www.youtube.com/@uncommitted", "Lost")));
+            std::ofstream(core::journal::get_path(crash_file), std::ios::binary | std::ios::app) << std::string(20, '\x01');
+        }
+        if (std::filesystem::exists(core::journal::get_path(temp_file)) || core::io::load(temp_file, false).size() != 3) {
+            throw std::runtime_error("Outermost commit did not compact the journal");
+        }
+        fmt::print("core::journal passed: nested commits are journaled and compacted.\n");
+
+        {
+            // Loading the crashed table replays the journal and rewrites the file
+            const modules::disk::Table crashed(crash_file);
+            const std::vector<core::io::Channel> loaded = core::io::load(crash_file, false);
+            const std::vector<std::string> expected = {"Hugh Jeffreys", "チャンネル"};
+            if (loaded.size() != expected.size() || crashed.get_channels().size() != expected.size()) {
+                throw std::runtime_error(fmt::format("Expected {} channels after replaying, got {}", expected.size(), loaded.size()));
+            }
+            for (std::size_t i = 0; i < expected.size(); ++i) {
+                if (loaded[i].name != expected[i] || crashed.get_channels().name(i) != expected[i]) {
+                    throw std::runtime_error(fmt::format("Expected '{}' at position {} after replaying, got '{}'", expected[i], i, loaded[i].name));
+                }
+            }
+            if (std::filesystem::exists(core::journal::get_path(crash_file))) {
+                throw std::runtime_error("Journal was not removed after replaying");
+            }
+        }
+        fmt::print("core::journal passed: crashed table is recovered from the journal.\n");
+
+        // Replaying a journal whose changes already reached the file changes nothing, as after a crash right before the journal is removed
+        {
+            modules::disk::Table::Batch outer(table);
+            {
+                modules::disk::Table::Batch command(table);
+                static_cast<void>(table.add(core::io::Channel("Aaa", "https://www.youtube.com/@aaa", "First")));
+            }
+            std::filesystem::copy_file(core::journal::get_path(temp_file), core::journal::get_path(crash_file), std::filesystem::copy_options::overwrite_existing);
+        }
+        std::filesystem::copy_file(temp_file, crash_file, std::filesystem::copy_options::overwrite_existing);
+        {
+            const modules::disk::Table crashed(crash_file);
+            if (crashed.get_channels().size() != 4 || crashed.get_channels().name(0) != "Aaa" || crashed.get_channels().name(1) != "Hugh Jeffreys") {
+                throw std::runtime_error("Replaying an already compacted journal changed the table");
+            }
+        }
+        fmt::print("core::journal passed: replaying is idempotent.\n");
+
+        return EXIT_SUCCESS;
+    }
+    catch (const std::exception &e) {
+        fmt::print(stderr, "core::journal failed: {}\n", e.what());
+        return EXIT_FAILURE;
+    }
+}
+
+int test_disk::watch()
+{
+    try {
+        // Only the chunks around an edit are reported as changed, even though the edit moved the rest of the file
+        {
+            std::string text(300000, ' ');
+            for (std::size_t i = 0; i < text.size(); ++i) {
+                text[i] = static_cast<char>('a' + i % 26);
+            }
+            core::watch::ChunkHashes hashes;
+            core::watch::hash_chunks(hashes, text);
+            std::string edited = text;
+            edited.insert(200000, "inserted");
+            const std::optional<core::watch::Change> change = core::watch::find_change(hashes, edited);
+            if (core::watch::find_change(hashes, text) || !change || change->begin > 200000 || change->old_end < 200000 ||
+                change->new_end != change->old_end + 8 || change->old_end - change->begin > 2 * core::watch::chunk_size) {
+                throw std::runtime_error("Changed chunks were not narrowed down");
+            }
+        }
+        fmt::print("core::watch::find_change() passed: an edit is narrowed down to its chunks.\n");
+
+        // Get path to the resources directory
+        const auto temp_file = (core::paths::get_resources_directory(TEST_EXECUTABLE_NAME) / "test_watch.html");
+
+        // get_resources_directory will create the directory if it doesn't exist, but we want to ensure that tests are isolated
+        // TempDir removes the directory before creating it again
+        const helpers::TempDir temp_dir(std::filesystem::path(temp_file).parent_path());
+
+        // Edit the file as another program would
+        const auto read_file = [&temp_file]() {
+            std::ifstream file(temp_file, std::ios::binary);
+            return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        };
+        const auto write_file = [&temp_file](const std::string &contents) {
+            std::ofstream(temp_file, std::ios::binary | std::ios::trunc) << contents;
+        };
+        const auto get_row = [](const std::string &contents, const std::string &text) {
+            const std::size_t position = contents.find(text);
+            const std::size_t begin = contents.rfind('\n', contents.rfind("<tr>", position)) + 1;
+            const std::size_t end = contents.find('\n', contents.find("</tr>", position)) + 1;
+            return std::pair<std::size_t, std::size_t>(begin, end - begin);
+        };
+
+        // The table, and the file it writes, must both hold the expected channels
+        modules::disk::Table table(temp_file);
+        const auto check = [&table, &temp_file](const std::vector<std::string> &expected) {
+            table.flush();
+            const std::vector<core::io::Channel> loaded = core::io::load(temp_file, false);
+            if (loaded.size() != expected.size() || table.get_channels().size() != expected.size()) {
+                throw std::runtime_error(fmt::format("Expected {} channels, got {} on disk and {} in memory", expected.size(), loaded.size(), table.get_channels().size()));
+            }
+            for (std::size_t i = 0; i < expected.size(); ++i) {
+                if (loaded[i].name != expected[i] || table.get_channels().name(i) != expected[i]) {
+                    throw std::runtime_error(fmt::format("Expected '{}' at position {}, got '{}' on disk and '{}' in memory", expected[i], i, loaded[i].name, table.get_channels().name(i)));
+                }
+            }
+        };
+        table.watch();
+        static_cast<void>(table.add(core::io::Channel("Hugh Jeffreys", "https://www.youtube.com/@HughJeffreys", "Phone Repairs")));
+        static_cast<void>(table.add(core::io::Channel("Noriyaro", "https://www.youtube.com/@noriyaro/videos", "JP Drifting")));
+        static_cast<void>(table.add(core::io::Channel("チャンネル", "https://www.youtube.com/@channel/videos", "日本語")));  // Japanese characters
+        table.flush();
+
+        // An edited row and a new row are picked up, and later changes are written next to them
+        std::string contents = read_file();
+        contents.replace(contents.find("JP Drifting"), 11, "Drifting in Japan");
+        contents.insert(get_row(contents, ">Noriyaro<").first, core::io::format_row("Mint", "https://www.youtube.com/@mint", "Added by hand"));
+        write_file(contents);
+        if (!table.refresh() || table.get_channels().description(*table.get_channels().find("Noriyaro")) != "Drifting in Japan") {
+            throw std::runtime_error("Edit made by another program was not picked up");
+        }
+        if (table.refresh()) {
+            throw std::runtime_error("Unchanged file was picked up again");
+        }
+        static_cast<void>(table.add(core::io::Channel("Zed", "https://www.youtube.com/@zed", "Last")));
+        check({"Hugh Jeffreys", "Mint", "Noriyaro", "Zed", "チャンネル"});
+        fmt::print("modules::disk::Table::refresh() passed: changed rows are patched in.\n");
+
+        // A row removed by another program while changes are pending is merged with them, instead of being written back
+        {
+            modules::disk::Table::Batch outer(table);
+            static_cast<void>(table.add(core::io::Channel("Aaa", "https://www.youtube.com/@aaa", "First")));
+            contents = read_file();
+            const auto [begin, length] = get_row(contents, ">Hugh Jeffreys<");
+            write_file(contents.erase(begin, length));
+        }
+        check({"Aaa", "Mint", "Noriyaro", "Zed", "チャンネル"});
+        fmt::print("modules::disk::Table::refresh() passed: pending changes are merged with the file.\n");
+
+        // A malformed file is reported, and not overwritten, until it is fixed
+        contents = read_file();
+        std::string broken = contents;
+        broken.erase(broken.find("</tr>", broken.find(">Mint<")), 5);
+        write_file(broken);
+        bool rejected = false;
+        try {
+            static_cast<void>(table.add(core::io::Channel("Bbb", "https://www.youtube.com/@bbb", "Second")));
+        }
+        catch (const std::runtime_error &) {
+            rejected = true;
+        }
+        if (!rejected || read_file() != broken || table.contains("Bbb")) {
+            throw std::runtime_error("Malformed file was overwritten");
+        }
+        write_file(contents);
+        static_cast<void>(table.add(core::io::Channel("Bbb", "https://www.youtube.com/@bbb", "Second")));
+        check({"Aaa", "Bbb", "Mint", "Noriyaro", "Zed", "チャンネル"});
+        fmt::print("modules::disk::Table::refresh() passed: malformed file is not overwritten.\n");
+
+        return EXIT_SUCCESS;
+    }
+    catch (const std::exception &e) {
+        fmt::print(stderr, "modules::disk::Table::refresh() failed: {}\n", e.what());
+        return EXIT_FAILURE;
+    }
+}
+
+int test_disk::sharded()
+{
+    try {
+        // Get path to the resources directory
+        const auto temp_file = (core::paths::get_resources_directory(TEST_EXECUTABLE_NAME) / "test_sharded.html");
+        const auto expected_file = (core::paths::get_resources_directory(TEST_EXECUTABLE_NAME) / "test_sharded_expected.html");
+
+        // get_resources_directory will create the directory if it doesn't exist, but we want to ensure that tests are isolated
+        // TempDir removes the directory before creating it again
+        const helpers::TempDir temp_dir(std::filesystem::path(temp_file).parent_path());
+
+        // Read a whole file into a string
+        const auto read_file = [](const std::filesystem::path &path) {
+            std::ifstream file(path, std::ios::binary);
+            return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        };
+        const auto shard_path = [&temp_file](const std::string_view name) {
+            return core::shard::get_path(temp_file, core::shard::get_shard(name));
+        };
+
+        {
+            // Splitting a table writes one file per leading letter, and replaces the table with the index page
+            modules::disk::Table table(temp_file, core::io::Durability::None);
+            static_cast<void>(table.add(core::io::Channel("Noriyaro", "https://www.youtube.com/@noriyaro/videos", "JP Drifting")));
+            static_cast<void>(table.add(core::io::Channel("Donut", "https://www.youtube.com/@donut", "Car culture")));
+            static_cast<void>(table.add(core::io::Channel("donkey", "https://www.youtube.com/@donkey", "Lowercase")));
+            static_cast<void>(table.add(core::io::Channel("Engineering Explained", "https://www.youtube.com/@EngineeringExplained", "Car Engineering")));
+            static_cast<void>(table.add(core::io::Channel("チャンネル", "https://www.youtube.com/@channel/videos", "日本語")));  // Japanese characters
+            table.set_sharded(true);
+            if (!table.is_sharded() || !core::shard::is_index(read_file(temp_file)) || core::io::load(temp_file, false).size() != 0) {
+                throw std::runtime_error("Table was not replaced with the index page");
+            }
+            for (const std::string_view name : {"Noriyaro", "Donut", "Engineering Explained", "チャンネル"}) {
+                if (!std::filesystem::exists(shard_path(name))) {
+                    throw std::runtime_error(fmt::format("Missing shard file of '{}'", name));
+                }
+            }
+            static_cast<void>(core::io::save(expected_file, std::vector<core::store::ChannelView>{{"Donut", "https://www.youtube.com/@donut", "Car culture"}, {"donkey", "https://www.youtube.com/@donkey", "Lowercase"}}, core::io::Durability::None));
+            if (read_file(shard_path("Donut")) != read_file(expected_file)) {
+                throw std::runtime_error("Shard file differs from a table of its channels");
+            }
+            fmt::print("modules::disk::Table::set_sharded() passed: table split into shard files.\n");
+
+            // Compacting an edit rewrites only the shard of the channel; the index page only changes when a shard file is created or emptied
+            const auto old_time = std::filesystem::last_write_time(temp_file) - std::chrono::hours(1);
+            for (const std::filesystem::path &path : {temp_file, shard_path("Noriyaro"), shard_path("Donut")}) {
+                std::filesystem::last_write_time(path, old_time);
+            }
+            static_cast<void>(table.add(core::io::Channel("Dragon", "https://www.youtube.com/@dragon", "Added")));
+            table.flush();
+            if (std::filesystem::last_write_time(shard_path("Donut")) == old_time) {
+                throw std::runtime_error("Shard file of the added channel was not rewritten");
+            }
+            if (std::filesystem::last_write_time(shard_path("Noriyaro")) != old_time || std::filesystem::last_write_time(temp_file) != old_time) {
+                throw std::runtime_error("Adding a channel rewrote other files than its shard");
+            }
+            static_cast<void>(table.add(core::io::Channel("Apple", "https://www.youtube.com/@apple", "New shard")));
+            if (!table.remove("Noriyaro")) {
+                throw std::runtime_error("Failed to remove the channel from the table");
+            }
+            table.flush();
+            if (std::filesystem::exists(shard_path("Noriyaro"))) {
+                throw std::runtime_error("Emptied shard file was not deleted");
+            }
+            if (core::shard::read_index(read_file(temp_file)) != std::vector<std::size_t>{0, 3, 4, 26}) {
+                throw std::runtime_error("Index page does not list the shard files");
+            }
+            fmt::print("modules::disk::Table passed: edits rewrite only their shard.\n");
+        }
+
+        {
+            // Reopening loads every shard file, in sorted order, and notices changes made to them by other programs
+            modules::disk::Table table(temp_file, core::io::Durability::None);
+            std::vector<std::string> names;
+            for (const core::store::ChannelView channel : table.get_channels()) {
+                names.emplace_back(channel.name);
+            }
+            if (!table.is_sharded() || names != std::vector<std::string>{"Apple", "Donut", "Dragon", "Engineering Explained", "donkey", "チャンネル"}) {
+                throw std::runtime_error("Channels differ after loading the shard files");
+            }
+            table.watch();
+            static_cast<void>(core::io::save(shard_path("Engineering Explained"), std::vector<core::store::ChannelView>{{"ElectroBOOM", "https://www.youtube.com/@ElectroBOOM", "Added by hand"}, {"Engineering Explained", "https://www.youtube.com/@EngineeringExplained", "Car Engineering"}}, core::io::Durability::None));
+            if (!table.refresh() || !table.contains("ElectroBOOM") || table.get_channels().size() != 7) {
+                throw std::runtime_error("Change to a shard file was not picked up");
+            }
+            fmt::print("modules::disk::Table passed: shard files loaded and refreshed.\n");
+
+            // Joining the shards writes the whole table back to the file, and deletes the shard files
+            table.set_sharded(false);
+            if (table.is_sharded() || std::filesystem::exists(shard_path("Donut")) || core::io::load(temp_file, false).size() != 7) {
+                throw std::runtime_error("Shard files were not joined into a single file");
+            }
+            fmt::print("modules::disk::Table::set_sharded() passed: shard files joined.\n");
+        }
+
+        return EXIT_SUCCESS;
+    }
+    catch (const std::exception &e) {
+        fmt::print(stderr, "modules::disk::Table (sharded) failed: {}\n", e.what());
+        return EXIT_FAILURE;
+    }
+}
+
+int test_web::document()
+{
+    try {
+        // Enough channels for several segments
+        core::store::ChannelStore channels;
+        for (std::size_t i = 0; i < 5000; ++i) {
+            static_cast<void>(channels.insert(fmt::format("Channel {:04}", i), fmt::format("https://www.youtube.com/@channel{}", i), "Description"));
+        }
+        modules::web::Document document;
+        const std::string empty_etag = document.get_etag();
+        if (!document.update(channels) || document.get_etag() == empty_etag || document.update(channels)) {
+            throw std::runtime_error("Entity tag does not follow the channels");
+        }
+
+        // The plain body is the saved table, with the live reload script at the end of the body
+        const auto get_body = [&document](const bool gzip) {
+            std::string body;
+            for (const std::shared_ptr<const std::string> &part : document.get_parts(gzip)) {
+                body.append(*part);
+            }
+            return body;
+        };
+        const auto get_expected = [&channels]() {
+            std::string expected = core::render::render(channels, core::render::Format::Html);
+            expected.insert(expected.rfind("  </body>"), modules::web::live_reload_script);
+            return expected;
+        };
+        if (get_body(false) != get_expected()) {
+            throw std::runtime_error("Document differs from the rendered table");
+        }
+        fmt::print("modules::web::Document::update() passed: document matches the table.\n");
+
+        // Changing a channel renders only its segment again
+        const std::string etag = document.get_etag();
+        channels.erase(channels.find("Channel 2500").value());
+        static_cast<void>(channels.insert("Channel 2500", "https://www.youtube.com/@channel2500", "Changed"));
+        if (!document.update(channels) || document.get_rendered_segments() != 1 || document.get_etag() == etag || get_body(false) != get_expected()) {
+            throw std::runtime_error(fmt::format("Changed channel rendered {} segments", document.get_rendered_segments()));
+        }
+        fmt::print("modules::web::Document::update() passed: only the changed segment is rendered.\n");
+
+        // The compressed body is a single gzip member of the plain body
+        const std::string plain = get_body(false);
+        const std::string compressed = get_body(true);
+        const auto read_word = [&compressed](const std::size_t offset) {
+            std::uint32_t word = 0;
+            for (std::size_t i = 0; i < 4; ++i) {
+                word |= static_cast<std::uint32_t>(static_cast<unsigned char>(compressed[offset + i])) << (8 * i);
+            }
+            return word;
+        };
+        if (compressed.compare(0, core::gzip::header.size(), core::gzip::header) != 0 || read_word(compressed.size() - 8) != core::gzip::crc32(plain) || read_word(compressed.size() - 4) != plain.size() || compressed.size() * 4 > plain.size()) {
+            throw std::runtime_error("Compressed document has a wrong header or trailer");
+        }
+        fmt::print("modules::web::Document::get_parts() passed: {} bytes compressed into {} bytes.\n", plain.size(), compressed.size());
+
+        return EXIT_SUCCESS;
+    }
+    catch (const std::exception &e) {
+        fmt::print(stderr, "modules::web::Document failed: {}\n", e.what());
         return EXIT_FAILURE;
     }
 }